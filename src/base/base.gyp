@@ -40,6 +40,7 @@
       'toolsets': ['host', 'target'],
       'sources': [
         'cpu_stats.cc',
+        'memory_usage.cc',
         'process.cc',
         'process_mutex.cc',
         'run_level.cc',
@@ -81,6 +81,7 @@
       'sources': [
         'codegen_bytearray_stream_test.cc',
         'cpu_stats_test.cc',
+        'memory_usage_test.cc',
         'process_mutex_test.cc',
         'stopwatch_test.cc',
         'unnamed_event_test.cc',
@@ -94,6 +94,12 @@ template <class T> class FreeList {
     size_ = size;
   }
 
+  // Returns the bytes of the chunks, assuming that all of them have the
+  // current chunk size.
+  size_t GetAllocatedBytes() const {
+    return pool_.size() * size_ * sizeof(T);
+  }
+
  private:
   std::vector<T *> pool_;
   size_t current_index_;
@@ -133,6 +139,10 @@ template <class T> class ObjectPool {
     freelist_.set_size(size);
   }
 
+  size_t GetAllocatedBytes() const {
+    return released_.capacity() * sizeof(T *) + freelist_.GetAllocatedBytes();
+  }
+
  private:
   std::vector<T *> released_;
   FreeList<T> freelist_;
@@ -0,0 +1,72 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "base/memory_usage.h"
+
+#include <sstream>
+
+namespace mozc {
+
+MemoryUsage::Scope::Scope(MemoryUsage *usage, StringPiece name)
+    : usage_(usage), prefix_size_(usage->prefix_.size()) {
+  name.AppendToString(&usage_->prefix_);
+  usage_->prefix_.push_back('/');
+}
+
+MemoryUsage::Scope::~Scope() {
+  usage_->prefix_.resize(prefix_size_);
+}
+
+MemoryUsage::MemoryUsage() = default;
+MemoryUsage::~MemoryUsage() = default;
+
+void MemoryUsage::Add(StringPiece name, size_t bytes) {
+  string full_name = prefix_;
+  name.AppendToString(&full_name);
+  entries_[full_name] += bytes;
+}
+
+size_t MemoryUsage::GetTotalBytes() const {
+  size_t total = 0;
+  for (const auto &entry : entries_) {
+    total += entry.second;
+  }
+  return total;
+}
+
+string MemoryUsage::DebugString() const {
+  std::ostringstream os;
+  os << "total=" << GetTotalBytes();
+  for (const auto &entry : entries_) {
+    os << ' ' << entry.first << '=' << entry.second;
+  }
+  return os.str();
+}
+
+}  // namespace mozc
@@ -0,0 +1,92 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef MOZC_BASE_MEMORY_USAGE_H_
+#define MOZC_BASE_MEMORY_USAGE_H_
+
+#include <map>
+#include <string>
+
+#include "base/port.h"
+#include "base/string_piece.h"
+
+namespace mozc {
+
+// Collects the heap memory held by components, so that one can see which of
+// them grows.  Components report the bytes they allocate under names relative
+// to the current scope, and the names are joined with '/', e.g.,
+// "engine/dictionary/system/key_trie".  The numbers are estimates from the
+// sizes of containers and strings; they don't include allocator overhead.
+//
+// Usage:
+//   void Foo::CollectMemoryUsage(MemoryUsage *usage) const {
+//     usage->Add("table", table_.capacity() * sizeof(table_[0]));
+//     MemoryUsage::Scope scope(usage, "bar");
+//     bar_->CollectMemoryUsage(usage);  // Reported as ".../bar/..."
+//   }
+class MemoryUsage {
+ public:
+  // Appends |name| to the scope of |usage| while this instance is alive.
+  class Scope {
+   public:
+    Scope(MemoryUsage *usage, StringPiece name);
+    ~Scope();
+
+   private:
+    MemoryUsage *usage_;
+    const size_t prefix_size_;
+
+    DISALLOW_COPY_AND_ASSIGN(Scope);
+  };
+
+  MemoryUsage();
+  ~MemoryUsage();
+
+  // Adds |bytes| to the usage of |name| in the current scope.
+  void Add(StringPiece name, size_t bytes);
+
+  // Returns the sum of all the usages.
+  size_t GetTotalBytes() const;
+
+  // Returns the usages keyed by the full names.
+  const std::map<string, size_t> &entries() const { return entries_; }
+
+  // Returns a single line summary, e.g., "total=1024 engine/connector=512 ...".
+  string DebugString() const;
+
+ private:
+  string prefix_;
+  std::map<string, size_t> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryUsage);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_BASE_MEMORY_USAGE_H_
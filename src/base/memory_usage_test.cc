@@ -0,0 +1,61 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "base/memory_usage.h"
+
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace {
+
+TEST(MemoryUsageTest, Scope) {
+  MemoryUsage usage;
+  usage.Add("a", 1);
+  {
+    MemoryUsage::Scope scope(&usage, "b");
+    usage.Add("c", 2);
+    {
+      MemoryUsage::Scope nested_scope(&usage, "d");
+      usage.Add("e", 4);
+    }
+    usage.Add("c", 8);
+  }
+  usage.Add("f", 16);
+
+  EXPECT_EQ(4, usage.entries().size());
+  EXPECT_EQ(1, usage.entries().at("a"));
+  EXPECT_EQ(10, usage.entries().at("b/c"));
+  EXPECT_EQ(4, usage.entries().at("b/d/e"));
+  EXPECT_EQ(16, usage.entries().at("f"));
+  EXPECT_EQ(31, usage.GetTotalBytes());
+  EXPECT_EQ("total=31 a=1 b/c=10 b/d/e=4 f=16", usage.DebugString());
+}
+
+}  // namespace
+}  // namespace mozc
@@ -298,4 +298,38 @@ int Mmap::MaybeMUnlock(const void *addr, size_t len) {
 
 #undef MOZC_HAVE_MLOCK
 
+#if defined(OS_WIN) || defined(OS_NACL)
+# define MOZC_HAVE_MADVISE 0
+#else  // defined(OS_WIN) || defined(OS_NACL)
+# define MOZC_HAVE_MADVISE 1
+#endif  // defined(OS_WIN) || defined(OS_NACL)
+
+#if MOZC_HAVE_MADVISE
+int Mmap::MaybeAdvise(const void *addr, size_t len, AccessAdvice advice) {
+  int flag = MADV_NORMAL;
+  switch (advice) {
+    case WILL_NEED:
+      flag = MADV_WILLNEED;
+      break;
+    case RANDOM:
+      flag = MADV_RANDOM;
+      break;
+    default:
+      break;
+  }
+  // madvise requires the address to be aligned to the page boundary.
+  const uintptr_t page_size = static_cast<uintptr_t>(getpagesize());
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(addr);
+  const uintptr_t aligned_begin = begin & ~(page_size - 1);
+  return madvise(reinterpret_cast<void *>(aligned_begin),
+                 len + (begin - aligned_begin), flag);
+}
+#else  // MOZC_HAVE_MADVISE
+int Mmap::MaybeAdvise(const void *addr, size_t len, AccessAdvice advice) {
+  return -1;
+}
+#endif  // MOZC_HAVE_MADVISE
+
+#undef MOZC_HAVE_MADVISE
+
 }  // namespace mozc
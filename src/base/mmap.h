@@ -63,6 +63,18 @@ class Mmap : public MmapSyncInterface {
   static int MaybeMLock(const void *addr, size_t len);
   static int MaybeMUnlock(const void *addr, size_t len);
 
+  // Advises the kernel how the mapped range is going to be accessed, so that
+  // it can read the pages ahead (WILL_NEED) or avoid reading ahead (RANDOM).
+  // The range is extended to page boundaries.  Like the mlock functions
+  // above, this calls madvise where it's available, and returns -1 on the
+  // other platforms.
+  enum AccessAdvice {
+    NORMAL,
+    WILL_NEED,
+    RANDOM,
+  };
+  static int MaybeAdvise(const void *addr, size_t len, AccessAdvice advice);
+
 #ifndef MOZC_USE_PEPPER_FILE_IO
   char &operator[](size_t n) { return *(text_ + n); }
   char operator[](size_t n) const { return *(text_ + n); }
@@ -109,5 +109,28 @@ TEST(MmapTest, MaybeMLockTest) {
   }
 }
 
+TEST(MmapTest, MaybeAdviseTest) {
+  const string filename = FileUtil::JoinPath(FLAGS_test_tmpdir, "test.db");
+  const size_t kFileSize = 16384;
+  {
+    OutputFileStream ofs(filename.c_str(), std::ios::out | std::ios::binary);
+    EXPECT_TRUE(ofs.good());
+    ofs << string(kFileSize, 'a');
+  }
+  Mmap mmap;
+  ASSERT_TRUE(mmap.Open(filename.c_str(), "r"));
+#if defined(OS_WIN) || defined(OS_NACL)
+  EXPECT_EQ(-1, Mmap::MaybeAdvise(mmap.begin(), mmap.size(),
+                                  Mmap::WILL_NEED));
+#else  // defined(OS_WIN) || defined(OS_NACL)
+  // Unaligned ranges are extended to the page boundaries.
+  EXPECT_EQ(0, Mmap::MaybeAdvise(mmap.begin() + 10, 4096, Mmap::WILL_NEED));
+  EXPECT_EQ(0, Mmap::MaybeAdvise(mmap.begin(), mmap.size(), Mmap::RANDOM));
+  EXPECT_EQ(0, Mmap::MaybeAdvise(mmap.begin(), mmap.size(), Mmap::NORMAL));
+#endif  // defined(OS_WIN) || defined(OS_NACL)
+  mmap.Close();
+  FileUtil::Unlink(filename);
+}
+
 }  // namespace
 }  // namespace mozc
@@ -53,6 +53,7 @@
 #include "ipc/ipc.h"
 #include "protocol/commands.pb.h"
 #include "protocol/config.pb.h"
+#include "protocol/output_delta_util.h"
 
 #ifdef OS_WIN
 #include "base/win_util.h"
@@ -67,7 +68,6 @@ namespace client {
 
 namespace {
 const char kServerAddress[]    = "session";  // name for the IPC connection.
-const int    kResultBufferSize = 8192 * 32;   // size of IPC buffer
 const size_t kMaxPlayBackSize  = 512;   // size of maximum history
 
 #ifdef DEBUG
@@ -83,17 +83,34 @@ const int kDefaultTimeout = 30000;    // 30 sec for opt
 // called from Destructor. When an application calls DeleteSession
 // explicitly, the default timeout is used.
 const int kDeleteSessionOnDestructorTimeout = 1000;  // 1 sec
+
+// Returns true if the output of |input| can be delta-encoded for the
+// session |id|.
+bool IsDeltaOutputCommand(const commands::Input &input, uint64 id) {
+  if (id == 0 || input.id() != id) {
+    return false;
+  }
+  switch (input.type()) {
+    case commands::Input::SEND_KEY:
+    case commands::Input::SEND_KEYS:
+    case commands::Input::TEST_SEND_KEY:
+    case commands::Input::SEND_COMMAND:
+      return true;
+    default:
+      return false;
+  }
+}
 }  // namespace
 
 Client::Client()
     : id_(0),
       server_launcher_(new ServerLauncher),
-      result_(new char[kResultBufferSize]),
       timeout_(kDefaultTimeout),
       server_status_(SERVER_UNKNOWN),
       server_protocol_version_(0),
       server_process_id_(0),
-      last_mode_(commands::DIRECT) {
+      last_mode_(commands::DIRECT),
+      output_base_sequence_(0) {
   client_factory_ = IPCClientFactory::GetIPCClientFactory();
 }
 
@@ -229,7 +246,9 @@ void Client::PlaybackHistory() {
 
 void Client::PushHistory(const commands::Input &input,
                           const commands::Output &output) {
-  if (!output.has_consumed() || !output.consumed()) {
+  // The keys of SEND_KEYS but the last one may have been consumed.
+  if (input.type() != commands::Input::SEND_KEYS &&
+      (!output.has_consumed() || !output.consumed())) {
     // Do not remember unconsumed input.
     return;
   }
@@ -248,7 +267,8 @@ void Client::PushHistory(const commands::Input &input,
   // found context boundary.
   // don't regard the empty output (output without preedit) as the context
   // boundary, as the IMEOn command make the empty output.
-  if (input.type() == commands::Input::SEND_KEY &&
+  if ((input.type() == commands::Input::SEND_KEY ||
+       input.type() == commands::Input::SEND_KEYS) &&
       output.has_result()) {
     ResetHistory();
   }
@@ -323,6 +343,56 @@ bool Client::SendCommandWithContext(const commands::SessionCommand &command,
   return EnsureCallCommand(&input, output);
 }
 
+bool Client::SendKeysWithContext(const std::vector<commands::KeyEvent> &keys,
+                                 const commands::Context &context,
+                                 commands::Output *output) {
+  commands::Input input;
+  input.set_type(commands::Input::SEND_KEYS);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    input.add_keys()->CopyFrom(keys[i]);
+  }
+  // If the pointer of |context| is not the default_instance, update the data.
+  if (&context != &commands::Context::default_instance()) {
+    input.mutable_context()->CopyFrom(context);
+  }
+  return EnsureCallCommand(&input, output);
+}
+
+bool Client::SendKeysWithOutputs(const std::vector<commands::KeyEvent> &keys,
+                                 std::vector<commands::Output> *outputs) {
+  DCHECK(outputs);
+  outputs->clear();
+  if (keys.empty()) {
+    return false;
+  }
+  commands::Input input;
+  input.set_type(commands::Input::SEND_KEYS);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    input.add_keys()->CopyFrom(keys[i]);
+    // The last output is returned as the output itself.
+    if (i + 1 < keys.size()) {
+      input.add_output_key_indices(i);
+    }
+  }
+  commands::Output output;
+  if (!EnsureCallCommand(&input, &output)) {
+    return false;
+  }
+
+  outputs->resize(keys.size());
+  for (size_t i = 0; i < output.key_outputs_size(); ++i) {
+    commands::Output::KeyOutput *key_output = output.mutable_key_outputs(i);
+    if (key_output->index() + 1 >= keys.size()) {
+      LOG(ERROR) << "Invalid key output index: " << key_output->index();
+      continue;
+    }
+    (*outputs)[key_output->index()].Swap(key_output->mutable_output());
+  }
+  output.clear_key_outputs();
+  outputs->back().Swap(&output);
+  return true;
+}
+
 bool Client::CheckVersionOrRestartServer() {
   commands::Input input;
   commands::Output output;
@@ -423,10 +493,14 @@ void Client::set_client_capability(const commands::Capability &capability) {
 
 bool Client::CreateSession() {
   id_ = 0;
+  output_base_sequence_ = 0;
+  output_base_.Clear();
   commands::Input input;
   input.set_type(commands::Input::CREATE_SESSION);
 
   input.mutable_capability()->CopyFrom(client_capability_);
+  // The outputs are restored in Call().
+  input.mutable_capability()->set_delta_output(true);
 
   commands::ApplicationInfo *info = input.mutable_application_info();
   DCHECK(info);
@@ -575,9 +649,9 @@ bool Client::PingServer() const {
   string request;
   input.SerializeToString(&request);
 
-  size_t size = kResultBufferSize;
-  if (!client->Call(request.data(), request.size(),
-                    result_.get(), &size, timeout_)) {
+  size_t size = 0;
+  if (!client->CallWithGrowableBuffer(request.data(), request.size(),
+                                      &result_, &size, timeout_)) {
     LOG(ERROR) << "IPCClient::Call failed: " << client->GetLastIPCError();
     return false;
   }
@@ -626,7 +700,14 @@ bool Client::Call(const commands::Input &input,
 
   // Serialize
   string request;
-  input.SerializeToString(&request);
+  const bool delta_output = IsDeltaOutputCommand(input, id_);
+  if (delta_output && output_base_sequence_ != 0) {
+    commands::Input input_with_base(input);
+    input_with_base.set_output_base_sequence(output_base_sequence_);
+    input_with_base.SerializeToString(&request);
+  } else {
+    input.SerializeToString(&request);
+  }
 
   // Call IPC
   std::unique_ptr<IPCClientInterface> client(
@@ -672,9 +753,9 @@ bool Client::Call(const commands::Input &input,
   // Drop DebugString() as it raises segmentation fault.
   // http://b/2126375
   // TODO(taku): Investigate the error in detail.
-  size_t size = kResultBufferSize;
-  if (!client->Call(request.data(), request.size(),
-                    result_.get(), &size, timeout_)) {
+  size_t size = 0;
+  if (!client->CallWithGrowableBuffer(request.data(), request.size(),
+                                      &result_, &size, timeout_)) {
     LOG(ERROR) << "Call failure";
     //               << input.DebugString();
     if (client->GetLastIPCError() == IPC_TIMEOUT_ERROR) {
@@ -686,13 +767,20 @@ bool Client::Call(const commands::Input &input,
     return false;
   }
 
-  if (!output->ParseFromArray(result_.get(), size)) {
+  if (!output->ParseFromArray(result_.data(), size)) {
     LOG(ERROR) << "Parse failure of the result of the request:";
     //               << input.DebugString();
     server_status_ = SERVER_BROKEN_MESSAGE;
     return false;
   }
 
+  if (delta_output && output->has_delta() && !RestoreDeltaOutput(output)) {
+    LOG(ERROR) << "Cannot restore the delta-encoded output";
+    // Re-issue the session to get a complete output.
+    server_status_ = SERVER_INVALID_SESSION;
+    return false;
+  }
+
   DCHECK(server_status_ == SERVER_OK ||
          server_status_ == SERVER_INVALID_SESSION ||
          server_status_ == SERVER_SHUTDOWN ||
@@ -705,6 +793,23 @@ bool Client::Call(const commands::Input &input,
   return true;
 }
 
+bool Client::RestoreDeltaOutput(commands::Output *output) {
+  const commands::OutputDelta &delta = output->delta();
+  if (delta.has_base_sequence()) {
+    if (output_base_sequence_ == 0 ||
+        delta.base_sequence() != output_base_sequence_) {
+      output_base_sequence_ = 0;
+      output_base_.Clear();
+      return false;
+    }
+    OutputDeltaUtil::DecodeDelta(output_base_, output);
+  }
+  output_base_sequence_ = delta.sequence();
+  output->clear_delta();
+  output_base_.CopyFrom(*output);
+  return true;
+}
+
 bool Client::StartServer() {
   if (server_launcher_.get() != NULL) {
     return server_launcher_->StartServer(this);
@@ -45,6 +45,7 @@
         '../ipc/ipc.gyp:ipc',
         '../protocol/protocol.gyp:commands_proto',
         '../protocol/protocol.gyp:config_proto',
+        '../protocol/protocol.gyp:output_delta_util',
       ],
       'export_dependent_settings': [
         '../protocol/protocol.gyp:commands_proto',
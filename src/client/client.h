@@ -121,6 +121,14 @@ class Client : public ClientInterface {
   bool SendCommandWithContext(const commands::SessionCommand &command,
                               const commands::Context &context,
                               commands::Output *output);
+  bool SendKeysWithContext(const std::vector<commands::KeyEvent> &keys,
+                           const commands::Context &context,
+                           commands::Output *output);
+  // Sends |keys| in one round trip as SendKeys() does, and stores the
+  // outputs of all the keys to |outputs| in the order of |keys|.  Used by
+  // the clients which reply to each key event, e.g. the emacs helper.
+  bool SendKeysWithOutputs(const std::vector<commands::KeyEvent> &keys,
+                           std::vector<commands::Output> *outputs);
 
   bool GetConfig(config::Config *config);
   bool SetConfig(const config::Config &config);
@@ -217,6 +225,11 @@ class Client : public ClientInterface {
   bool CallAndCheckVersion(const commands::Input &input,
                            commands::Output *output);
 
+  // Restores |output| from the last output of the session if it is
+  // delta-encoded, and makes it the base of the next output.
+  // Returns false if the base output is not available.
+  bool RestoreDeltaOutput(commands::Output *output);
+
   // Making a journal inputs to restore
   // the current state even when mozc_server crashes
   void PlaybackHistory();
@@ -244,7 +257,9 @@ class Client : public ClientInterface {
   uint64 id_;
   IPCClientFactoryInterface *client_factory_;
   std::unique_ptr<ServerLauncherInterface> server_launcher_;
-  std::unique_ptr<char[]> result_;
+  // Receive buffer of the responses, reused across calls.  Mutable since
+  // PingServer() also receives into it.
+  mutable string result_;
   std::unique_ptr<config::Config> preferences_;
   int timeout_;
   ServerStatus server_status_;
@@ -255,6 +270,10 @@ class Client : public ClientInterface {
   // Remember the composition mode of input session for playback.
   commands::CompositionMode last_mode_;
   commands::Capability client_capability_;
+  // The last complete output of the session and its OutputDelta::sequence.
+  // The sequence is 0 if no output is available.
+  uint64 output_base_sequence_;
+  commands::Output output_base_;
 };
 
 }  // namespace client
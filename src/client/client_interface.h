@@ -33,6 +33,7 @@
 #define MOZC_CLIENT_CLIENT_INTERFACE_H_
 
 #include <string>
+#include <vector>
 #include "base/port.h"
 #include "protocol/commands.pb.h"
 
@@ -150,6 +151,16 @@ class ClientInterface {
                                   output);
   }
 
+  // Sends |keys| in one round trip.  |output| is the output of the last key.
+  // The outputs of the other keys which need handling, e.g. with a result,
+  // are in |output->key_outputs()|.
+  bool SendKeys(const std::vector<commands::KeyEvent> &keys,
+                commands::Output *output) {
+    return SendKeysWithContext(keys,
+                               commands::Context::default_instance(),
+                               output);
+  }
+
   virtual bool SendKeyWithContext(const commands::KeyEvent &key,
                                   const commands::Context &context,
                                   commands::Output *output) = 0;
@@ -159,6 +170,9 @@ class ClientInterface {
   virtual bool SendCommandWithContext(const commands::SessionCommand &command,
                                       const commands::Context &context,
                                       commands::Output *output) = 0;
+  virtual bool SendKeysWithContext(const std::vector<commands::KeyEvent> &keys,
+                                   const commands::Context &context,
+                                   commands::Output *output) = 0;
 
   // The methods below don't call
   // StartServer even if server is not available. This treatment
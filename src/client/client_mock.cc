@@ -124,6 +124,25 @@ MockImplementationWithContextAndOutput(SendCommandWithContext,
 
 #undef MockImplementationWithContextAndOutput
 
+bool ClientMock::SendKeysWithContext(
+    const std::vector<commands::KeyEvent> &keys,
+    const commands::Context &context,
+    commands::Output *output) {
+  function_counter_["SendKeysWithContext"]++;
+  called_SendKeysWithContext_ = keys;
+  std::map<string, commands::Output>::const_iterator it =
+      outputs_.find("SendKeysWithContext");
+  if (it != outputs_.end()) {
+    output->CopyFrom(it->second);
+  }
+  std::map<string, bool>::const_iterator retval =
+      return_bool_values_.find("SendKeysWithContext");
+  if (retval != return_bool_values_.end()) {
+    return retval->second;
+  }
+  return false;
+}
+
 
 // Exceptional methods.
 // GetConfig needs to obtain the "called_config_".
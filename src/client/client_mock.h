@@ -32,6 +32,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "client/client_interface.h"
 #include "protocol/commands.pb.h"
 
@@ -55,6 +56,9 @@ class ClientMock : public client::ClientInterface {
   bool SendCommandWithContext(const commands::SessionCommand &command,
                               const commands::Context &context,
                               commands::Output *output);
+  bool SendKeysWithContext(const std::vector<commands::KeyEvent> &keys,
+                           const commands::Context &context,
+                           commands::Output *output);
   bool GetConfig(config::Config *config);
   bool SetConfig(const config::Config &config);
   bool ClearUserHistory();
@@ -93,6 +97,12 @@ class ClientMock : public client::ClientInterface {
   TEST_METHODS(TestSendKeyWithContext, commands::KeyEvent);
   TEST_METHODS(SendCommandWithContext, commands::SessionCommand);
 #undef TEST_METHODS
+  const std::vector<commands::KeyEvent> &called_SendKeysWithContext() const {
+    return called_SendKeysWithContext_;
+  }
+  void set_output_SendKeysWithContext(const commands::Output &output) {
+    outputs_["SendKeysWithContext"].CopyFrom(output);
+  }
 
  private:
   // Counter increments each time the function called.  This method is
@@ -105,6 +115,8 @@ class ClientMock : public client::ClientInterface {
 
   std::map<string, commands::Output> outputs_;
 
+  std::vector<commands::KeyEvent> called_SendKeysWithContext_;
+
   config::Config called_config_;
 };
 }  // namespace client
@@ -32,6 +32,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/number_util.h"
@@ -407,6 +408,125 @@ TEST_F(ClientTest, SendCommandWithContext) {
   EXPECT_EQ(kSuppressSuggestion, input.context().suppress_suggestion());
 }
 
+TEST_F(ClientTest, SendKeys) {
+  const int mock_id = 123;
+  EXPECT_TRUE(SetupConnection(mock_id));
+
+  std::vector<commands::KeyEvent> keys(3);
+  keys[0].set_key_code('a');
+  keys[1].set_key_code('b');
+  keys[2].set_special_key(commands::KeyEvent::ENTER);
+
+  commands::Output mock_output;
+  mock_output.set_id(mock_id);
+  mock_output.set_consumed(true);
+  SetMockOutput(mock_output);
+
+  commands::Output output;
+  EXPECT_TRUE(client_->SendKeys(keys, &output));
+  EXPECT_EQ(mock_output.consumed(), output.consumed());
+
+  commands::Input input;
+  GetGeneratedInput(&input);
+  EXPECT_EQ(mock_id, input.id());
+  EXPECT_EQ(commands::Input::SEND_KEYS, input.type());
+  ASSERT_EQ(3, input.keys_size());
+  EXPECT_EQ('a', input.keys(0).key_code());
+  EXPECT_EQ('b', input.keys(1).key_code());
+  EXPECT_EQ(commands::KeyEvent::ENTER, input.keys(2).special_key());
+}
+
+TEST_F(ClientTest, SendKeysWithOutputs) {
+  const int mock_id = 123;
+  EXPECT_TRUE(SetupConnection(mock_id));
+
+  std::vector<commands::KeyEvent> keys(3);
+  keys[0].set_key_code('a');
+  keys[1].set_key_code('b');
+  keys[2].set_key_code('c');
+
+  commands::Output mock_output;
+  mock_output.set_id(mock_id);
+  mock_output.set_consumed(true);
+  mock_output.mutable_preedit()->set_cursor(3);
+  for (int i = 0; i < 2; ++i) {
+    commands::Output::KeyOutput *key_output = mock_output.add_key_outputs();
+    key_output->set_index(i);
+    key_output->mutable_output()->set_consumed(true);
+    key_output->mutable_output()->mutable_preedit()->set_cursor(i + 1);
+  }
+  SetMockOutput(mock_output);
+
+  std::vector<commands::Output> outputs;
+  EXPECT_TRUE(client_->SendKeysWithOutputs(keys, &outputs));
+  ASSERT_EQ(3, outputs.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(i + 1, outputs[i].preedit().cursor());
+  }
+  EXPECT_EQ(0, outputs[2].key_outputs_size());
+
+  // All the outputs but the last one are requested.
+  commands::Input input;
+  GetGeneratedInput(&input);
+  EXPECT_EQ(commands::Input::SEND_KEYS, input.type());
+  ASSERT_EQ(3, input.keys_size());
+  ASSERT_EQ(2, input.output_key_indices_size());
+  EXPECT_EQ(0, input.output_key_indices(0));
+  EXPECT_EQ(1, input.output_key_indices(1));
+}
+
+TEST_F(ClientTest, DeltaOutput) {
+  const int mock_id = 123;
+  EXPECT_TRUE(SetupConnection(mock_id));
+
+  commands::KeyEvent key_event;
+  key_event.set_special_key(commands::KeyEvent::DOWN);
+
+  commands::Output mock_output;
+  mock_output.set_id(mock_id);
+  mock_output.set_consumed(true);
+  commands::Candidates *candidates = mock_output.mutable_candidates();
+  candidates->set_focused_index(0);
+  candidates->set_size(2);
+  candidates->set_position(0);
+  for (int i = 0; i < 2; ++i) {
+    commands::Candidates::Candidate *candidate = candidates->add_candidate();
+    candidate->set_index(i);
+    candidate->set_value(Util::StringPrintf("candidate%d", i));
+  }
+  mock_output.mutable_delta()->set_sequence(1);
+  SetMockOutput(mock_output);
+
+  commands::Output output;
+  EXPECT_TRUE(client_->SendKey(key_event, &output));
+  EXPECT_FALSE(output.has_delta());
+  EXPECT_EQ(0, output.candidates().focused_index());
+  EXPECT_EQ(2, output.candidates().candidate_size());
+
+  commands::Input input;
+  GetGeneratedInput(&input);
+  EXPECT_FALSE(input.has_output_base_sequence());
+
+  // The next output only carries the new focused index.
+  commands::Output delta_output;
+  delta_output.set_id(mock_id);
+  delta_output.set_consumed(true);
+  delta_output.mutable_delta()->set_sequence(2);
+  delta_output.mutable_delta()->set_base_sequence(1);
+  delta_output.mutable_delta()->set_candidates_focused_index(1);
+  SetMockOutput(delta_output);
+
+  output.Clear();
+  EXPECT_TRUE(client_->SendKey(key_event, &output));
+  EXPECT_FALSE(output.has_delta());
+  EXPECT_EQ(1, output.candidates().focused_index());
+  ASSERT_EQ(2, output.candidates().candidate_size());
+  EXPECT_EQ("candidate1", output.candidates().candidate(1).value());
+
+  GetGeneratedInput(&input);
+  EXPECT_EQ(1, input.output_base_sequence());
+}
+
 TEST_F(ClientTest, SetConfig) {
   const int mock_id = 0;
   EXPECT_TRUE(SetupConnection(mock_id));
@@ -36,6 +36,7 @@
 #include <unistd.h>
 #endif  // OS_WIN
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 
@@ -66,11 +67,13 @@ const char kServerName[] = "session";
 // Wait at most kServerWaitTimeout msec until server gets ready
 const uint32 kServerWaitTimeout = 20000;  // 20 sec
 
-// for every 1000m sec, check server
+// Check server with the interval starting from 20 msec and doubling up
+// to 1000 msec.  The server accepts connections right after it starts.
+const uint32 kInitialRetryIntervalForServer = 20;
 const uint32 kRetryIntervalForServer = 1000;
 
-// Try 20 times to check mozc_server is running
-const uint32 kTrial = 20;
+// Keep checking mozc_server for 20 sec
+const uint32 kServerPingTimeout = 20000;
 
 #ifdef DEBUG
 // Load special flags for server.
@@ -219,11 +222,14 @@ bool ServerLauncher::StartServer(ClientInterface *client) {
   }
 
   // Try to connect mozc_server just in case.
-  for (int trial = 0; trial < kTrial; ++trial) {
+  uint32 interval = kInitialRetryIntervalForServer;
+  for (uint32 waited = 0; waited < kServerPingTimeout;) {
     if (client->PingServer()) {
       return true;
     }
-    Util::Sleep(kRetryIntervalForServer);
+    Util::Sleep(interval);
+    waited += interval;
+    interval = min(interval * 2, kRetryIntervalForServer);
   }
 
   LOG(ERROR) << kProductNameInEnglish << " cannot be launched";
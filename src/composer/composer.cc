@@ -31,6 +31,8 @@
 
 #include "composer/composer.h"
 
+#include <algorithm>
+
 #include "base/flags.h"
 #include "base/logging.h"
 #include "base/util.h"
@@ -205,6 +207,7 @@ Composer::Composer(const Table *table,
       input_field_type_(commands::Context::NORMAL),
       shifted_sequence_count_(0),
       composition_(new Composition(table)),
+      t13n_cache_revision_(0),
       typing_corrector_(table,
                         FLAGS_max_typing_correction_query_candidates,
                         FLAGS_max_typing_correction_query_results),
@@ -218,6 +221,10 @@ Composer::Composer(const Table *table,
 
 Composer::~Composer() {}
 
+Composer::TransliterationCacheEntry::TransliterationCacheEntry() {
+  std::fill(generated, generated + arraysize(generated), false);
+}
+
 void Composer::Reset() {
   EditErase();
   ResetInputMode();
@@ -886,11 +893,32 @@ void Composer::GetSubTransliteration(
     const size_t position,
     const size_t size,
     string *transliteration) const {
-  const Transliterators::Transliterator t12r = GetTransliterator(type);
-  string result;
-  GetTransliteratedText(t12r, position, size, &result);
-  transliteration->clear();
-  Transliterate(type, result, transliteration);
+  DCHECK(transliteration);
+  if (static_cast<size_t>(type) >= transliteration::NUM_T13N_TYPES) {
+    LOG(ERROR) << "Unknown TransliterationType: " << type;
+    GetTransliteratedText(Transliterators::CONVERSION_STRING, position, size,
+                          transliteration);
+    return;
+  }
+
+  // The conversion and the rewriters ask for the same ranges several times
+  // per composition (e.g. on every segment resize), so each type is built
+  // once per composition revision.
+  const uint64 revision = composition_->GetRevision();
+  if (revision != t13n_cache_revision_) {
+    t13n_cache_.clear();
+    t13n_cache_revision_ = revision;
+  }
+  TransliterationCacheEntry *entry =
+      &t13n_cache_[std::make_pair(position, size)];
+  if (!entry->generated[type]) {
+    string result;
+    GetTransliteratedText(GetTransliterator(type), position, size, &result);
+    entry->values[type].clear();
+    Transliterate(type, result, &entry->values[type]);
+    entry->generated[type] = true;
+  }
+  transliteration->assign(entry->values[type]);
 }
 
 void Composer::GetSubTransliterations(
@@ -906,6 +934,18 @@ void Composer::GetSubTransliterations(
   }
 }
 
+bool Composer::IsSubTransliterationCachedForTest(
+    transliteration::TransliterationType type,
+    size_t position,
+    size_t size) const {
+  if (composition_->GetRevision() != t13n_cache_revision_) {
+    return false;
+  }
+  const TransliterationCache::const_iterator it =
+      t13n_cache_.find(std::make_pair(position, size));
+  return it != t13n_cache_.end() && it->second.generated[type];
+}
+
 bool Composer::EnableInsert() const {
   if (GetLength() >= max_length_) {
     // do not accept long chars to prevent DOS attack.
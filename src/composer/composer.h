@@ -32,9 +32,11 @@
 #ifndef MOZC_COMPOSER_COMPOSER_H_
 #define MOZC_COMPOSER_COMPOSER_H_
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/port.h"
@@ -179,6 +181,8 @@ class Composer {
   void GetTransliterations(transliteration::Transliterations *t13ns) const;
 
   // Generate substrings of specified transliteration.
+  // Each transliteration is generated on its first request for the range and
+  // reused until the composition is modified.
   void GetSubTransliteration(const transliteration::TransliterationType type,
                              const size_t position,
                              const size_t size,
@@ -189,6 +193,13 @@ class Composer {
                               size_t size,
                               transliteration::Transliterations *t13ns) const;
 
+  // Returns true if the transliteration of |type| for the range has been
+  // generated for the current composition.
+  bool IsSubTransliterationCachedForTest(
+      transliteration::TransliterationType type,
+      size_t position,
+      size_t size) const;
+
   // Check if the preedit is can be modified.
   bool EnableInsert() const;
 
@@ -248,6 +259,15 @@ class Composer {
                              const size_t size,
                              string *output) const;
 
+  // Transliterations of a range of the composition, filled in per type.
+  struct TransliterationCacheEntry {
+    TransliterationCacheEntry();
+    bool generated[transliteration::NUM_T13N_TYPES];
+    string values[transliteration::NUM_T13N_TYPES];
+  };
+  typedef std::map<std::pair<size_t, size_t>, TransliterationCacheEntry>
+      TransliterationCache;
+
   size_t position_;
   // Whether the next insertion is the beginning of typing after an
   // editing command like SetInputMode or not.  Some conversion rules
@@ -265,6 +285,11 @@ class Composer {
   size_t shifted_sequence_count_;
   std::unique_ptr<CompositionInterface> composition_;
 
+  // Transliterations keyed by (position, size), which are valid while the
+  // revision of |composition_| is |t13n_cache_revision_|.
+  mutable uint64 t13n_cache_revision_;
+  mutable TransliterationCache t13n_cache_;
+
   TypingCorrector typing_corrector_;
 
   // The original text for the composition.  The value is usually
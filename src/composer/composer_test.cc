@@ -514,6 +514,40 @@ TEST_F(ComposerTest, GetSubTransliterations) {
             transliterations[transliteration::HALF_KATAKANA]);
 }
 
+TEST_F(ComposerTest, GetSubTransliterationAfterEdit) {
+  // "か"
+  table_->AddRule("ka", "\xe3\x81\x8b", "");
+  // "な"
+  table_->AddRule("na", "\xe3\x81\xaa", "");
+
+  composer_->InsertCharacter("ka");
+  string t13n;
+  composer_->GetSubTransliteration(transliteration::HIRAGANA, 0, 1, &t13n);
+  // "か"
+  EXPECT_EQ("\xe3\x81\x8b", t13n);
+  composer_->GetSubTransliteration(transliteration::HALF_ASCII, 0, 1, &t13n);
+  EXPECT_EQ("ka", t13n);
+
+  // Cached transliterations must not survive an edit.
+  composer_->Backspace();
+  composer_->InsertCharacter("na");
+  composer_->GetSubTransliteration(transliteration::HIRAGANA, 0, 1, &t13n);
+  // "な"
+  EXPECT_EQ("\xe3\x81\xaa", t13n);
+  composer_->GetSubTransliteration(transliteration::HALF_ASCII, 0, 1, &t13n);
+  EXPECT_EQ("na", t13n);
+
+  // Neither may they be shared with a copy which is edited afterwards.
+  Composer copied(NULL, request_.get(), config_.get());
+  copied.CopyFrom(*composer_);
+  copied.Backspace();
+  copied.InsertCharacter("ka");
+  copied.GetSubTransliteration(transliteration::HALF_ASCII, 0, 1, &t13n);
+  EXPECT_EQ("ka", t13n);
+  composer_->GetSubTransliteration(transliteration::HALF_ASCII, 0, 1, &t13n);
+  EXPECT_EQ("na", t13n);
+}
+
 TEST_F(ComposerTest, GetStringFunctions) {
   // "か"
   table_->AddRule("ka", "\xe3\x81\x8b", "");
@@ -32,6 +32,8 @@
 
 #include <set>
 #include <string>
+
+#include "base/port.h"
 #include "composer/internal/transliterators.h"
 
 namespace mozc {
@@ -115,6 +117,11 @@ class CompositionInterface {
   // Return true if the composition is adviced to be committed immediately.
   virtual bool ShouldCommit() const = 0;
 
+  // Return an identifier of the current contents.  It changes whenever the
+  // composition may have been modified and is never shared by two
+  // compositions in the process, so it can be used as a cache key.
+  virtual uint64 GetRevision() const = 0;
+
   // Get clone of the composition.
   // This class does NOT take the ownership of the return value.
   //
@@ -29,6 +29,7 @@
 
 #include "composer/internal/composition.h"
 
+#include <atomic>
 #include <memory>
 
 #include "base/logging.h"
@@ -40,15 +41,30 @@
 
 namespace mozc {
 namespace composer {
+namespace {
+
+// Revisions are taken from a process-wide sequence so that a clone or a
+// new composition never reuses the revision of another one.
+uint64 NextRevision() {
+  static std::atomic<uint64> last_revision(0);
+  return ++last_revision;
+}
+
+}  // namespace
 
 Composition::Composition(const Table *table)
-    : table_(table), input_t12r_(Transliterators::CONVERSION_STRING) {}
+    : table_(table),
+      input_t12r_(Transliterators::CONVERSION_STRING),
+      revision_(NextRevision()),
+      length_cache_valid_(false),
+      length_cache_(0) {}
 
 Composition::~Composition() {
   Erase();
 }
 
 void Composition::Erase() {
+  InvalidateCache();
   CharChunkList::iterator it;
   for (it = chunks_.begin(); it != chunks_.end(); ++it) {
     delete *it;
@@ -75,6 +91,7 @@ size_t Composition::InsertInput(size_t pos, const CompositionInput &input) {
   if (input.Empty()) {
     return pos;
   }
+  InvalidateCache();
 
   CharChunkList::iterator right_chunk;
   MaybeSplitChunkAt(pos, &right_chunk);
@@ -98,6 +115,7 @@ size_t Composition::InsertInput(size_t pos, const CompositionInput &input) {
 
 // Deletes a right-hand character of the composition.
 size_t Composition::DeleteAt(const size_t position) {
+  InvalidateCache();
   CharChunkList::iterator chunk_it;
   const size_t original_size = GetLength();
   size_t new_position = position;
@@ -120,12 +138,14 @@ size_t Composition::DeleteAt(const size_t position) {
     if ((*chunk_it)->GetLength(Transliterators::LOCAL) <= 1) {
       delete *chunk_it;
       chunks_.erase(chunk_it);
+      InvalidateCache();
       continue;
     }
 
     CharChunk *left_deleted_chunk_ptr = NULL;
     (*chunk_it)->SplitChunk(Transliterators::LOCAL, 1, &left_deleted_chunk_ptr);
     std::unique_ptr<CharChunk> left_deleted_chunk(left_deleted_chunk_ptr);
+    InvalidateCache();
   }
   return new_position;
 }
@@ -139,10 +159,10 @@ size_t Composition::ConvertPosition(
     return position_from;
   }
 
-  CharChunkList::iterator chunk_it;
+  CharChunkList::const_iterator chunk_it;
   size_t inner_position_from;
-  GetChunkAt(position_from, transliterator_from,
-             &chunk_it, &inner_position_from);
+  FindChunkAt(position_from, transliterator_from,
+              &chunk_it, &inner_position_from);
 
   // No chunk was found, return 0 as a fallback.
   if (chunk_it == chunks_.end()) {
@@ -204,6 +224,7 @@ void Composition::SetTransliterator(
   if (chunks_.empty()) {
     return;
   }
+  InvalidateCache();
 
   CharChunkList::iterator chunk_it;
   size_t inner_position_from;
@@ -224,22 +245,42 @@ void Composition::SetTransliterator(
 
 Transliterators::Transliterator
 Composition::GetTransliterator(size_t position) {
-  // Due to GetChunkAt is not a const funcion, this function cannot be
-  // a const function.
-  CharChunkList::iterator chunk_it;
+  CharChunkList::const_iterator chunk_it;
   size_t inner_position;
-  GetChunkAt(position, Transliterators::LOCAL, &chunk_it, &inner_position);
+  FindChunkAt(position, Transliterators::LOCAL, &chunk_it, &inner_position);
   return (*chunk_it)->GetTransliterator(Transliterators::LOCAL);
 }
 
 size_t Composition::GetLength() const {
-  return GetPosition(Transliterators::LOCAL, chunks_.end());
+  if (!length_cache_valid_) {
+    length_cache_ = GetPosition(Transliterators::LOCAL, chunks_.end());
+    length_cache_valid_ = true;
+  }
+  return length_cache_;
 }
 
 void Composition::GetStringWithModes(
     Transliterators::Transliterator transliterator,
     const TrimMode trim_mode,
     string* composition) const {
+  if (static_cast<size_t>(transliterator) >=
+          Transliterators::NUM_OF_TRANSLITERATOR ||
+      static_cast<size_t>(trim_mode) >= kNumTrimModes) {
+    BuildStringWithModes(transliterator, trim_mode, composition);
+    return;
+  }
+  CachedString *cache = &string_cache_[transliterator][trim_mode];
+  if (!cache->valid) {
+    BuildStringWithModes(transliterator, trim_mode, &cache->value);
+    cache->valid = true;
+  }
+  composition->assign(cache->value);
+}
+
+void Composition::BuildStringWithModes(
+    Transliterators::Transliterator transliterator,
+    const TrimMode trim_mode,
+    string* composition) const {
   composition->clear();
   if (chunks_.empty()) {
     // This is not an error. For example, the composition should be empty for
@@ -280,6 +321,13 @@ void Composition::GetExpandedStringsWithTransliterator(
     std::set<string> *expanded) const {
   DCHECK(base);
   DCHECK(expanded);
+  if (expanded_cache_.valid &&
+      expanded_cache_.transliterator == transliterator) {
+    base->assign(expanded_cache_.base);
+    *expanded = expanded_cache_.expanded;
+    return;
+  }
+
   base->clear();
   expanded->clear();
   if (chunks_.empty()) {
@@ -295,20 +343,17 @@ void Composition::GetExpandedStringsWithTransliterator(
   chunks_.back()->AppendTrimedResult(transliterator, base);
   // Get expanded from the last chunk
   chunks_.back()->GetExpandedResults(expanded);
+
+  expanded_cache_.valid = true;
+  expanded_cache_.transliterator = transliterator;
+  expanded_cache_.base = *base;
+  expanded_cache_.expanded = *expanded;
 }
 
 void Composition::GetString(string *composition) const {
-  composition->clear();
-  if (chunks_.empty()) {
-    VLOG(1) << "The composition size is zero.";
-    return;
-  }
-
-  for (CharChunkList::const_iterator it = chunks_.begin();
-       it != chunks_.end();
-       ++it) {
-    (*it)->AppendResult(Transliterators::LOCAL, composition);
-  }
+  // Appending the results of all the chunks with the local transliterators
+  // is what ASIS mode does, so the cached string is shared with it.
+  GetStringWithModes(Transliterators::LOCAL, ASIS, composition);
 }
 
 void Composition::GetStringWithTransliterator(
@@ -337,6 +382,18 @@ void Composition::GetChunkAt(const size_t position,
                              Transliterators::Transliterator transliterator,
                              CharChunkList::iterator *chunk_it,
                              size_t *inner_position) {
+  // The caller may modify the chunk through the returned iterator.
+  InvalidateCache();
+  CharChunkList::const_iterator const_it;
+  FindChunkAt(position, transliterator, &const_it, inner_position);
+  // Erasing an empty range converts a const_iterator to an iterator in O(1).
+  *chunk_it = chunks_.erase(const_it, const_it);
+}
+
+void Composition::FindChunkAt(const size_t position,
+                              Transliterators::Transliterator transliterator,
+                              CharChunkList::const_iterator *chunk_it,
+                              size_t *inner_position) const {
   if (chunks_.empty()) {
     *inner_position = 0;
     *chunk_it = chunks_.begin();
@@ -344,7 +401,7 @@ void Composition::GetChunkAt(const size_t position,
   }
 
   size_t rest_pos = position;
-  CharChunkList::iterator it;
+  CharChunkList::const_iterator it;
   for (it = chunks_.begin(); it != chunks_.end(); ++it) {
     const size_t chunk_length = (*it)->GetLength(transliterator);
     if (rest_pos <= chunk_length) {
@@ -373,6 +430,7 @@ size_t Composition::GetPosition(
 // Return the left CharChunk and the right it.
 CharChunk *Composition::MaybeSplitChunkAt(const size_t pos,
                                           CharChunkList::iterator *it) {
+  InvalidateCache();
   // The position is the beginning of composition.
   if (pos <= 0) {
     *it = chunks_.begin();
@@ -397,6 +455,7 @@ CharChunk *Composition::MaybeSplitChunkAt(const size_t pos,
 void Composition::CombinePendingChunks(
     CharChunkList::iterator it, const CompositionInput &input) {
   // Combine |**it| and |**(--it)| into |**it| as long as possible.
+  InvalidateCache();
   const string &next_input =
     input.has_conversion() ? input.conversion() : input.raw();
 
@@ -416,6 +475,7 @@ void Composition::CombinePendingChunks(
 
 // Insert a chunk to the prev of it.
 CharChunkList::iterator Composition::InsertChunk(CharChunkList::iterator *it) {
+  InvalidateCache();
   CharChunk *new_chunk = new CharChunk(input_t12r_, table_);
   return chunks_.insert(*it, new_chunk);
 }
@@ -458,6 +518,7 @@ Composition *Composition::CloneImpl() const {
 // Return charchunk to be inserted and iterator of the *next* char chunk.
 CharChunkList::iterator Composition::GetInsertionChunk(
     CharChunkList::iterator *it) {
+  InvalidateCache();
   if (*it == chunks_.begin()) {
     return InsertChunk(it);
   }
@@ -475,8 +536,20 @@ void Composition::SetInputMode(Transliterators::Transliterator transliterator) {
 }
 
 void Composition::SetTable(const Table *table) {
+  InvalidateCache();
   table_ = table;
 }
 
+void Composition::InvalidateCache() {
+  revision_ = NextRevision();
+  length_cache_valid_ = false;
+  for (size_t i = 0; i < Transliterators::NUM_OF_TRANSLITERATOR; ++i) {
+    for (size_t j = 0; j < kNumTrimModes; ++j) {
+      string_cache_[i][j].valid = false;
+    }
+  }
+  expanded_cache_.valid = false;
+}
+
 }  // namespace composer
 }  // namespace mozc
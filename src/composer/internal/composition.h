@@ -101,6 +101,10 @@ class Composition : public CompositionInterface {
   // Return true if the composition is adviced to be committed immediately.
   virtual bool ShouldCommit() const;
 
+  virtual uint64 GetRevision() const {
+    return revision_;
+  }
+
   // Get a clone.
   // Clone is a thin wrapper of CloneImpl.
   // CloneImpl is created to write test codes without dynamic_cast.
@@ -142,13 +146,55 @@ class Composition : public CompositionInterface {
   }
 
  private:
+  // The number of TrimMode values, used to size |string_cache_|.
+  static const size_t kNumTrimModes = FIX + 1;
+
+  struct CachedString {
+    CachedString() : valid(false) {}
+    bool valid;
+    string value;
+  };
+
+  struct CachedExpandedStrings {
+    CachedExpandedStrings()
+        : valid(false), transliterator(Transliterators::LOCAL) {}
+    bool valid;
+    Transliterators::Transliterator transliterator;
+    string base;
+    std::set<string> expanded;
+  };
+
   void GetStringWithModes(Transliterators::Transliterator transliterator,
                           TrimMode trim_mode,
                           string *output) const;
+  void BuildStringWithModes(Transliterators::Transliterator transliterator,
+                            TrimMode trim_mode,
+                            string *output) const;
+
+  // Const version of GetChunkAt.  This does not invalidate the caches.
+  void FindChunkAt(size_t position,
+                   Transliterators::Transliterator transliterator,
+                   CharChunkList::const_iterator *chunk_it,
+                   size_t *inner_position) const;
+
+  // Drops all the memoized results and advances the revision.  Every
+  // non-const method calls this as the chunks may be modified through it
+  // (including via the iterators returned to the caller).
+  void InvalidateCache();
 
   const Table *table_;
   CharChunkList chunks_;
   Transliterators::Transliterator input_t12r_;
+  uint64 revision_;
+
+  // Memoized results of the const accessors.  The composer queries the same
+  // strings (preedit, conversion query, prediction query, ...) several times
+  // per key event, so they are built once per edit.
+  mutable bool length_cache_valid_;
+  mutable size_t length_cache_;
+  mutable CachedString
+      string_cache_[Transliterators::NUM_OF_TRANSLITERATOR][kNumTrimModes];
+  mutable CachedExpandedStrings expanded_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(Composition);
 };
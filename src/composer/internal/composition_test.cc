@@ -2021,6 +2021,67 @@ TEST_F(CompositionTest, SetTransliteratorOnEmpty) {
   EXPECT_EQ(1, composition_->GetLength());
 }
 
+TEST_F(CompositionTest, CachedStringsFollowEdits) {
+  table_->AddRule("a", "\xe3\x81\x82", "");  // "あ"
+  table_->AddRule("ka", "\xe3\x81\x8b", "");  // "か"
+  table_->AddRule("n", "\xe3\x82\x93", "");  // "ん"
+  table_->AddRule("na", "\xe3\x81\xaa", "");  // "な"
+
+  size_t pos = InsertCharacters("ka", 0, composition_.get());
+  // "か"
+  EXPECT_EQ("\xe3\x81\x8b", GetString(*composition_));
+  EXPECT_EQ("ka", GetRawString(*composition_));
+  EXPECT_EQ(1, composition_->GetLength());
+
+  // The second queries are served from the cache.
+  EXPECT_EQ("\xe3\x81\x8b", GetString(*composition_));
+  EXPECT_EQ("ka", GetRawString(*composition_));
+
+  pos = InsertCharacters("n", pos, composition_.get());
+  // "かn"
+  EXPECT_EQ("\xe3\x81\x8bn", GetString(*composition_));
+  EXPECT_EQ("kan", GetRawString(*composition_));
+  EXPECT_EQ(2, composition_->GetLength());
+
+  string output;
+  composition_->GetStringWithTrimMode(TRIM, &output);
+  // "か"
+  EXPECT_EQ("\xe3\x81\x8b", output);
+  composition_->GetStringWithTrimMode(FIX, &output);
+  // "かん"
+  EXPECT_EQ("\xe3\x81\x8b\xe3\x82\x93", output);
+
+  string base;
+  std::set<string> expanded;
+  composition_->GetExpandedStrings(&base, &expanded);
+  // "か"
+  EXPECT_EQ("\xe3\x81\x8b", base);
+  // "ん"
+  EXPECT_TRUE(expanded.find("\xe3\x82\x93") != expanded.end());
+  // "な"
+  EXPECT_TRUE(expanded.find("\xe3\x81\xaa") != expanded.end());
+
+  pos = InsertCharacters("a", pos, composition_.get());
+  // "かな"
+  EXPECT_EQ("\xe3\x81\x8b\xe3\x81\xaa", GetString(*composition_));
+  composition_->GetExpandedStrings(&base, &expanded);
+  EXPECT_EQ("\xe3\x81\x8b\xe3\x81\xaa", base);
+  EXPECT_TRUE(expanded.empty());
+
+  composition_->DeleteAt(0);
+  // "な"
+  EXPECT_EQ("\xe3\x81\xaa", GetString(*composition_));
+  EXPECT_EQ("na", GetRawString(*composition_));
+  EXPECT_EQ(1, composition_->GetLength());
+
+  composition_->SetTransliterator(0, 1, Transliterators::HALF_ASCII);
+  EXPECT_EQ("na", GetString(*composition_));
+
+  composition_->Erase();
+  EXPECT_EQ("", GetString(*composition_));
+  EXPECT_EQ(0, composition_->GetLength());
+}
+
 TEST_F(CompositionTest, Clone) {
   Composition src(table_.get());
   src.SetInputMode(Transliterators::FULL_KATAKANA);
@@ -100,6 +100,11 @@ class Connector::Row {
     return true;
   }
 
+  size_t GetAllocatedBytes() const {
+    return sizeof(*this) + chunk_bits_index_.GetAllocatedBytes() +
+           compact_bits_index_.GetAllocatedBytes();
+  }
+
  private:
   SimpleSuccinctBitVectorIndex chunk_bits_index_;
   SimpleSuccinctBitVectorIndex compact_bits_index_;
@@ -129,7 +134,9 @@ Connector::Connector(const char *connection_data,
       cache_size_(cache_size),
       cache_hash_mask_(cache_size - 1),
       cache_key_(new uint32[cache_size]),
-      cache_value_(new int[cache_size]) {
+      cache_value_(new int[cache_size]),
+      num_lookups_(0),
+      num_cache_misses_(0) {
   const uint16 *ptr = reinterpret_cast<const uint16 *>(connection_data);
   CHECK_EQ(kConnectorMagicNumber, ptr[0]);
   resolution_ = ptr[1];
@@ -186,9 +193,11 @@ Connector::~Connector() {
 int Connector::GetTransitionCost(uint16 rid, uint16 lid) const {
   const uint32 index = EncodeKey(rid, lid);
   const uint32 bucket = GetHashValue(rid, lid, cache_hash_mask_);
+  ++num_lookups_;
   if (cache_key_[bucket] == index) {
     return cache_value_[bucket];
   }
+  ++num_cache_misses_;
   const int value = LookupCost(rid, lid);
   cache_key_[bucket] = index;
   cache_value_[bucket] = value;
@@ -203,6 +212,15 @@ void Connector::ClearCache() {
   std::fill(cache_key_.get(), cache_key_.get() + cache_size_, kInvalidCacheKey);
 }
 
+size_t Connector::GetAllocatedBytes() const {
+  size_t bytes = rows_.capacity() * sizeof(Row *) +
+                 cache_size_ * (sizeof(cache_key_[0]) + sizeof(cache_value_[0]));
+  for (size_t i = 0; i < rows_.size(); ++i) {
+    bytes += rows_[i]->GetAllocatedBytes();
+  }
+  return bytes;
+}
+
 int Connector::LookupCost(uint16 rid, uint16 lid) const {
   uint16 value;
   if (!rows_[rid]->GetValue(lid, &value)) {
@@ -55,6 +55,14 @@ class Connector {
 
   void ClearCache();
 
+  // Number of GetTransitionCost() calls and of the calls missed the cache
+  // since the construction.  Like the cache, they are not thread-safe.
+  uint64 num_lookups() const { return num_lookups_; }
+  uint64 num_cache_misses() const { return num_cache_misses_; }
+
+  // Returns the bytes allocated for the rows and the cache.
+  size_t GetAllocatedBytes() const;
+
  private:
   class Row;
 
@@ -68,6 +76,8 @@ class Connector {
   const uint32 cache_hash_mask_;
   mutable std::unique_ptr<uint32[]> cache_key_;
   mutable std::unique_ptr<int[]> cache_value_;
+  mutable uint64 num_lookups_;
+  mutable uint64 num_cache_misses_;
 
   DISALLOW_COPY_AND_ASSIGN(Connector);
 };
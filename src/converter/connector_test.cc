@@ -79,10 +79,14 @@ TEST(ConnectorTest, CompareWithRawData) {
       EXPECT_EQ(data[i].cost, actual);
 
       // Cache hit case.
+      const uint64 num_cache_misses = connector->num_cache_misses();
       actual = connector->GetTransitionCost(data[i].rid, data[i].lid);
       EXPECT_EQ(data[i].cost, actual);
+      EXPECT_EQ(num_cache_misses, connector->num_cache_misses());
     }
   }
+  EXPECT_EQ(3 * 2 * data.size(), connector->num_lookups());
+  EXPECT_LE(connector->num_cache_misses(), 3 * data.size());
 }
 #endif  // !OS_NACL
 
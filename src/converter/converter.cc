@@ -34,9 +34,11 @@
 #include <string>
 #include <vector>
 
+#include "base/flags.h"
 #include "base/logging.h"
 #include "base/number_util.h"
 #include "base/port.h"
+#include "base/singleton.h"
 #include "base/util.h"
 #include "composer/composer.h"
 #include "converter/immutable_converter_interface.h"
@@ -46,6 +48,7 @@
 #include "dictionary/suppression_dictionary.h"
 #include "prediction/predictor_interface.h"
 #include "request/conversion_request.h"
+#include "request/conversion_stats.h"
 #include "rewriter/rewriter_interface.h"
 #include "transliteration/transliteration.h"
 #include "usage_stats/usage_stats.h"
@@ -54,11 +57,77 @@ using mozc::dictionary::POSMatcher;
 using mozc::dictionary::SuppressionDictionary;
 using mozc::usage_stats::UsageStats;
 
+DEFINE_bool(conversion_stats, false,
+            "Collect the work done for each conversion request, such as the "
+            "lattice size and the dictionary lookups, and log it.");
+DEFINE_int32(conversion_stats_log_interval, 100,
+             "Log the histograms of the conversion stats every "
+             "\"conversion_stats_log_interval\" requests.");
+
 namespace mozc {
 namespace {
 
 const size_t kErrorIndex = static_cast<size_t>(-1);
 
+const char *GetRequestTypeName(Segments::RequestType request_type) {
+  switch (request_type) {
+    case Segments::PREDICTION:
+      return "prediction";
+    case Segments::SUGGESTION:
+      return "suggestion";
+    case Segments::PARTIAL_PREDICTION:
+      return "partial_prediction";
+    case Segments::PARTIAL_SUGGESTION:
+      return "partial_suggestion";
+    default:
+      return "conversion";
+  }
+}
+
+// Collects the ConversionStats of a request while this instance is alive if
+// --conversion_stats is set and the caller hasn't attached stats by itself.
+// The stats are logged and added to the histograms on destruction.
+class ScopedConversionStats {
+ public:
+  ScopedConversionStats(const ConversionRequest &request, const char *name)
+      : original_request_(request), name_(name),
+        enabled_(FLAGS_conversion_stats && request.stats() == NULL) {
+    if (enabled_) {
+      request_.CopyFrom(request);
+      request_.set_stats(&stats_);
+    }
+  }
+
+  ~ScopedConversionStats() {
+    if (!enabled_) {
+      return;
+    }
+    LOG(INFO) << name_ << ": " << stats_.DebugString();
+    ConversionStatsHistograms *histograms =
+        Singleton<ConversionStatsHistograms>::get();
+    histograms->Add(stats_);
+    if (FLAGS_conversion_stats_log_interval > 0 &&
+        histograms->num_stats() % FLAGS_conversion_stats_log_interval == 0) {
+      LOG(INFO) << "Conversion stats histograms:" << std::endl
+                << histograms->DebugString();
+    }
+  }
+
+  // Returns the request to use for the conversion.
+  const ConversionRequest &request() const {
+    return enabled_ ? request_ : original_request_;
+  }
+
+ private:
+  const ConversionRequest &original_request_;
+  const char *name_;
+  const bool enabled_;
+  ConversionRequest request_;
+  ConversionStats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedConversionStats);
+};
+
 size_t GetSegmentIndex(const Segments *segments,
                        size_t segment_index) {
   const size_t history_segments_size = segments->history_segments_size();
@@ -229,8 +298,10 @@ void ConverterImpl::Init(const POSMatcher *pos_matcher,
   general_noun_id_ = pos_matcher_->GetGeneralNounId();
 }
 
-bool ConverterImpl::StartConversionForRequest(const ConversionRequest &request,
-                                              Segments *segments) const {
+bool ConverterImpl::StartConversionForRequest(
+    const ConversionRequest &original_request, Segments *segments) const {
+  ScopedConversionStats scoped_stats(original_request, "conversion");
+  const ConversionRequest &request = scoped_stats.request();
   if (!request.has_composer()) {
     LOG(ERROR) << "Request doesn't have composer";
     return false;
@@ -342,10 +413,13 @@ void ConverterImpl::MaybeSetConsumedKeySizeToSegment(size_t consumed_key_size,
 }
 
 // TODO(noriyukit): |key| can be a member of ConversionRequest.
-bool ConverterImpl::Predict(const ConversionRequest &request,
+bool ConverterImpl::Predict(const ConversionRequest &original_request,
                             const string &key,
                             const Segments::RequestType request_type,
                             Segments *segments) const {
+  ScopedConversionStats scoped_stats(
+      original_request, GetRequestTypeName(request_type));
+  const ConversionRequest &request = scoped_stats.request();
   const Segments::RequestType original_request_type = segments->request_type();
   if ((original_request_type != Segments::PREDICTION &&
        original_request_type != Segments::PARTIAL_PREDICTION) ||
@@ -624,6 +698,17 @@ bool ConverterImpl::CommitPartialSuggestionSegmentValue(
   return true;
 }
 
+bool ConverterImpl::GetCandidates(Segments *segments,
+                                  size_t segment_index,
+                                  size_t candidate_size) const {
+  segment_index = GetSegmentIndex(segments, segment_index);
+  if (segment_index == kErrorIndex) {
+    return false;
+  }
+
+  return rewriter_->ExpandCandidates(segments, segment_index, candidate_size);
+}
+
 bool ConverterImpl::FocusSegmentValue(Segments *segments,
                                       size_t segment_index,
                                       int    candidate_index) const {
@@ -670,9 +755,11 @@ bool ConverterImpl::CommitSegments(
 }
 
 bool ConverterImpl::ResizeSegment(Segments *segments,
-                                  const ConversionRequest &request,
+                                  const ConversionRequest &original_request,
                                   size_t segment_index,
                                   int offset_length) const {
+  ScopedConversionStats scoped_stats(original_request, "resize_segment");
+  const ConversionRequest &request = scoped_stats.request();
   if (segments->request_type() != Segments::CONVERSION) {
     return false;
   }
@@ -781,11 +868,13 @@ bool ConverterImpl::ResizeSegment(Segments *segments,
 }
 
 bool ConverterImpl::ResizeSegment(Segments *segments,
-                                  const ConversionRequest &request,
+                                  const ConversionRequest &original_request,
                                   size_t start_segment_index,
                                   size_t segments_size,
                                   const uint8 *new_size_array,
                                   size_t array_size) const {
+  ScopedConversionStats scoped_stats(original_request, "resize_segment");
+  const ConversionRequest &request = scoped_stats.request();
   if (segments->request_type() != Segments::CONVERSION) {
     return false;
   }
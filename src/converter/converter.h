@@ -104,6 +104,9 @@ class ConverterImpl : public ConverterInterface {
       int candidate_index,
       const string &current_segment_key,
       const string &new_segment_key) const;
+  virtual bool GetCandidates(Segments *segments,
+                             size_t segment_index,
+                             size_t candidate_size) const;
   virtual bool FocusSegmentValue(Segments *segments,
                                  size_t segment_index,
                                  int candidate_index) const;
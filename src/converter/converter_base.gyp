@@ -124,6 +124,7 @@
         '../dictionary/dictionary_base.gyp:suppression_dictionary',
         '../protocol/protocol.gyp:commands_proto',
         '../protocol/protocol.gyp:config_proto',
+        '../request/request.gyp:conversion_request',
         '../rewriter/rewriter_base.gyp:gen_rewriter_files#host',
         'connector',
         'immutable_converter_interface',
@@ -110,9 +110,10 @@ class ConverterInterface {
   virtual bool ReconstructHistory(Segments *segments,
                                   const string &preceding_text) const = 0;
 
-  // Expand the bunsetsu-segment at "segment_index" by candidate_size
-  // DEPRECATED: This method doesn't take any effect.
-  // TODO(taku): remove this method.
+  // Expand the bunsetsu-segment at "segment_index" so that the candidates
+  // deferred by the rewriters are materialized within the first
+  // "candidate_size" candidates. This method must be called before the
+  // candidates are shown to the user.
   virtual bool GetCandidates(Segments *segments,
                              size_t segment_index,
                              size_t candidate_size) const {
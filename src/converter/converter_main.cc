@@ -137,6 +137,7 @@ string CandidateAttributesToString(uint32 attrs) {
   ADD_STR(TYPING_CORRECTION);
   ADD_STR(AUTO_PARTIAL_SUGGESTION);
   ADD_STR(USER_HISTORY_PREDICTION);
+  ADD_STR(VARIANTS_DEFERRED);
 
 #undef ADD_STR
   string s;
@@ -60,6 +60,7 @@
 #include "protocol/commands.pb.h"
 #include "protocol/config.pb.h"
 #include "request/conversion_request.h"
+#include "request/conversion_stats.h"
 
 using mozc::dictionary::DictionaryInterface;
 using mozc::dictionary::POSMatcher;
@@ -269,6 +270,27 @@ Lattice *GetLattice(Segments *segments, bool is_prediction) {
   return lattice;
 }
 
+// Records the number of nodes at each position of |lattice| if it is the
+// largest lattice in |stats|.
+void RecordLatticeSize(const Lattice &lattice, ConversionStats *stats) {
+  std::vector<uint32> nodes_per_position(lattice.key().size(), 0);
+  uint64 total = 0;
+  for (size_t pos = 0; pos < nodes_per_position.size(); ++pos) {
+    for (const Node *node = lattice.begin_nodes(pos);
+         node != NULL; node = node->bnext) {
+      ++nodes_per_position[pos];
+    }
+    total += nodes_per_position[pos];
+  }
+  uint64 current_total = 0;
+  for (size_t i = 0; i < stats->nodes_per_position.size(); ++i) {
+    current_total += stats->nodes_per_position[i];
+  }
+  if (total >= current_total) {
+    stats->nodes_per_position.swap(nodes_per_position);
+  }
+}
+
 }  // namespace
 
 ImmutableConverterImpl::ImmutableConverterImpl(
@@ -754,6 +776,19 @@ class NodeListBuilderWithCacheEnabled : public NodeListBuilderForLookupPrefix {
   }
 };
 
+// Adds a lookup by |builder|, which was created with |limit|, to |stats|.
+void RecordLookup(const BaseNodeListBuilder &builder, int limit,
+                  ConversionStats *stats) {
+  if (stats == NULL) {
+    return;
+  }
+  ++stats->dictionary_lookups;
+  stats->tokens_decoded += limit - builder.limit();
+  if (builder.limit() <= 0) {
+    ++stats->lookups_at_node_limit;
+  }
+}
+
 }  // namespace
 
 Node *ImmutableConverterImpl::Lookup(const int begin_pos,
@@ -768,12 +803,14 @@ Node *ImmutableConverterImpl::Lookup(const int begin_pos,
   const size_t len = end_pos - begin_pos;
 
   lattice->node_allocator()->set_max_nodes_size(8192);
+  const int limit = lattice->node_allocator()->max_nodes_size();
   Node *result_node = NULL;
   if (is_reverse) {
     BaseNodeListBuilder builder(
         lattice->node_allocator(),
         lattice->node_allocator()->max_nodes_size());
     dictionary_->LookupReverse(StringPiece(begin, len), request, &builder);
+    RecordLookup(builder, limit, request.stats());
     result_node = builder.result();
   } else {
     if (is_prediction) {
@@ -781,6 +818,7 @@ Node *ImmutableConverterImpl::Lookup(const int begin_pos,
           lattice->node_allocator(),
           lattice->cache_info(begin_pos) + 1);
       dictionary_->LookupPrefix(StringPiece(begin, len), request, &builder);
+      RecordLookup(builder, limit, request.stats());
       result_node = builder.result();
       lattice->SetCacheInfo(begin_pos, len);
     } else {
@@ -789,6 +827,7 @@ Node *ImmutableConverterImpl::Lookup(const int begin_pos,
           lattice->node_allocator(),
           lattice->node_allocator()->max_nodes_size());
       dictionary_->LookupPrefix(StringPiece(begin, len), request, &builder);
+      RecordLookup(builder, limit, request.stats());
       result_node = builder.result();
     }
   }
@@ -1259,6 +1298,8 @@ void ImmutableConverterImpl::MakeLatticeNodesForPredictiveNodes(
           pos_matcher_);
       suffix_dictionary_->LookupPredictive(
           StringPiece(key.data() + pos, key.size() - pos), request, &builder);
+      RecordLookup(builder, lattice->node_allocator()->max_nodes_size(),
+                   request.stats());
       if (builder.result() != NULL) {
         lattice->Insert(pos, builder.result());
       }
@@ -1289,6 +1330,8 @@ void ImmutableConverterImpl::MakeLatticeNodesForPredictiveNodes(
           pos_matcher_);
       dictionary_->LookupPredictive(
           StringPiece(key.data() + pos, key.size() - pos), request, &builder);
+      RecordLookup(builder, lattice->node_allocator()->max_nodes_size(),
+                   request.stats());
       if (builder.result() != NULL) {
         lattice->Insert(pos, builder.result());
       }
@@ -1667,13 +1710,15 @@ void ImmutableConverterImpl::InsertFirstSegmentToCandidates(
     const Lattice &lattice,
     const std::vector<uint16> &group,
     size_t max_candidates_size,
-    FilterType filter_type) const {
+    FilterType filter_type,
+    ConversionStats *stats) const {
   const size_t only_first_segment_candidate_pos =
       segments->conversion_segment(0).candidates_size();
   InsertCandidates(segments, lattice, group,
                    max_candidates_size,
                    ONLY_FIRST_SEGMENT,
-                   filter_type);
+                   filter_type,
+                   stats);
   // Note that inserted candidates might consume the entire key.
   // e.g. key: "なのは", value: "ナノは"
   // Erase them later.
@@ -1799,7 +1844,8 @@ void ImmutableConverterImpl::InsertCandidates(
     const std::vector<uint16> &group,
     size_t max_candidates_size,
     InsertCandidatesType type,
-    FilterType filter_type) const {
+    FilterType filter_type,
+    ConversionStats *stats) const {
   // skip HIS_NODE(s)
   Node *prev = lattice.bos_nodes();
   for (Node *node = lattice.bos_nodes()->next;
@@ -1863,6 +1909,11 @@ void ImmutableConverterImpl::InsertCandidates(
     begin_pos = string::npos;
     prev = node;
   }
+
+  if (stats != NULL) {
+    stats->nbest_pops += nbest_generator.num_pops();
+    stats->candidates_filtered += nbest_generator.num_filtered_candidates();
+  }
 }
 
 bool ImmutableConverterImpl::MakeSegments(const ConversionRequest &request,
@@ -1896,7 +1947,7 @@ bool ImmutableConverterImpl::MakeSegments(const ConversionRequest &request,
            max_candidates_size - kOnlyFirstSegmentCandidateSize : 1);
       InsertCandidates(segments, lattice, group,
                        single_segment_candidates_size, SINGLE_SEGMENT,
-                       filter_type);
+                       filter_type, request.stats());
 
       // Even if single_segment_candidates_size + kOnlyFirstSegmentCandidateSize
       // is greater than max_candidates_size, we cannot skip
@@ -1913,11 +1964,11 @@ bool ImmutableConverterImpl::MakeSegments(const ConversionRequest &request,
               single_segment_candidates_size + kOnlyFirstSegmentCandidateSize);
       InsertFirstSegmentToCandidates(
           segments, lattice, group, only_first_segment_candidates_size,
-          filter_type);
+          filter_type, request.stats());
     } else {
       InsertCandidates(
           segments, lattice, group, max_candidates_size, SINGLE_SEGMENT,
-          filter_type);
+          filter_type, request.stats());
     }
   } else {
     DCHECK(!request.create_partial_candidates());
@@ -1937,7 +1988,7 @@ bool ImmutableConverterImpl::MakeSegments(const ConversionRequest &request,
         segments->conversion_segments_size();
     InsertCandidates(
         segments, lattice, group, max_candidates_size, MULTI_SEGMENTS,
-        filter_type);
+        filter_type, request.stats());
     if (old_conversion_segments_size > 0) {
       segments->erase_segments(segments->history_segments_size(),
                                old_conversion_segments_size);
@@ -1965,14 +2016,29 @@ bool ImmutableConverterImpl::ConvertForRequest(
 
   Lattice *lattice = GetLattice(segments, is_prediction);
 
+  ConversionStats *stats = request.stats();
+  const uint64 connector_lookups = connector_->num_lookups();
+  const uint64 connector_cache_misses = connector_->num_cache_misses();
+  const uint64 nodes_allocated =
+      (lattice == NULL) ? 0 : lattice->node_allocator()->num_allocated();
+  if (stats != NULL) {
+    ++stats->conversions;
+  }
+
   if (!MakeLattice(request, segments, lattice)) {
     LOG(WARNING) << "could not make lattice";
     return false;
   }
+  if (stats != NULL) {
+    stats->nodes_allocated +=
+        lattice->node_allocator()->num_allocated() - nodes_allocated;
+    RecordLatticeSize(*lattice, stats);
+  }
 
   std::vector<uint16> group;
   MakeGroup(*segments, &group);
 
+  const uint64 viterbi_connector_lookups = connector_->num_lookups();
   if (is_prediction) {
     if (!PredictionViterbi(*segments, lattice)) {
       LOG(WARNING) << "prediction_viterbi failed";
@@ -1984,6 +2050,11 @@ bool ImmutableConverterImpl::ConvertForRequest(
       return false;
     }
   }
+  if (stats != NULL) {
+    // Each edge costs one transition cost lookup.
+    stats->viterbi_edges +=
+        connector_->num_lookups() - viterbi_connector_lookups;
+  }
 
   VLOG(2) << lattice->DebugString();
   if (!MakeSegments(request, *lattice, group, segments)) {
@@ -1991,6 +2062,11 @@ bool ImmutableConverterImpl::ConvertForRequest(
     return false;
   }
 
+  if (stats != NULL) {
+    stats->connector_lookups += connector_->num_lookups() - connector_lookups;
+    stats->connector_cache_misses +=
+        connector_->num_cache_misses() - connector_cache_misses;
+  }
   return true;
 }
 
@@ -47,6 +47,7 @@
 
 namespace mozc {
 
+struct ConversionStats;
 struct Node;
 class ImmutableConverterInterface;
 class Lattice;
@@ -147,18 +148,21 @@ class ImmutableConverterImpl : public ImmutableConverterInterface {
 
   // Inserts first segment from conversion result to candidates.
   // Costs will be modified using the existing candidates.
+  // The N-best search is counted in |stats| unless it is NULL.
   void InsertFirstSegmentToCandidates(Segments *segments,
                                       const Lattice &lattice,
                                       const std::vector<uint16> &group,
                                       size_t max_candidates_size,
-                                      FilterType filter_type) const;
+                                      FilterType filter_type,
+                                      ConversionStats *stats) const;
 
   void InsertCandidates(Segments *segments,
                         const Lattice &lattice,
                         const std::vector<uint16> &group,
                         size_t max_candidates_size,
                         InsertCandidatesType type,
-                        FilterType filter_type) const;
+                        FilterType filter_type,
+                        ConversionStats *stats) const;
 
   // Helper function for InsertCandidates().
   // Returns true if |node| is valid node for segment end.
@@ -57,6 +57,7 @@
 #include "prediction/suggestion_filter.h"
 #include "protocol/commands.pb.h"
 #include "request/conversion_request.h"
+#include "request/conversion_stats.h"
 #include "testing/base/public/googletest.h"
 #include "testing/base/public/gunit.h"
 
@@ -421,6 +422,60 @@ TEST(ImmutableConverterTest, NoInnerSegmenBoundaryForConversion) {
   }
 }
 
+TEST(ImmutableConverterTest, ConversionStats) {
+  std::unique_ptr<MockDataAndImmutableConverter> data_and_converter(
+      new MockDataAndImmutableConverter);
+  const string kRequestKey =
+      // "わたしのなまえはなかのです"
+      "\xe3\x82\x8f\xe3\x81\x9f\xe3\x81\x97\xe3\x81\xae\xe3\x81\xaa\xe3"
+      "\x81\xbe\xe3\x81\x88\xe3\x81\xaf\xe3\x81\xaa\xe3\x81\x8b\xe3\x81"
+      "\xae\xe3\x81\xa7\xe3\x81\x99";
+  ConversionStats stats;
+  ConversionRequest request;
+  request.set_stats(&stats);
+
+  Segments segments;
+  segments.set_request_type(Segments::CONVERSION);
+  segments.add_segment()->set_key(kRequestKey);
+  ASSERT_TRUE(
+      data_and_converter->GetConverter()->ConvertForRequest(request,
+                                                            &segments));
+
+  EXPECT_EQ(1, stats.conversions);
+  ASSERT_EQ(kRequestKey.size(), stats.nodes_per_position.size());
+  uint64 lattice_nodes = 0;
+  for (size_t i = 0; i < stats.nodes_per_position.size(); ++i) {
+    lattice_nodes += stats.nodes_per_position[i];
+  }
+  EXPECT_LT(0, stats.nodes_per_position[0]);
+  EXPECT_LT(0, lattice_nodes);
+  EXPECT_LE(lattice_nodes, stats.nodes_allocated);
+  EXPECT_LT(0, stats.dictionary_lookups);
+  EXPECT_LT(0, stats.tokens_decoded);
+  EXPECT_EQ(0, stats.lookups_at_node_limit);
+  EXPECT_LT(0, stats.viterbi_edges);
+  EXPECT_LE(stats.viterbi_edges, stats.connector_lookups);
+  EXPECT_LE(stats.connector_cache_misses, stats.connector_lookups);
+  EXPECT_LT(0, stats.nbest_pops);
+  EXPECT_TRUE(stats.prediction_results.empty());
+
+  // The counters accumulate over the conversions of the request.
+  const uint64 dictionary_lookups = stats.dictionary_lookups;
+  segments.Clear();
+  segments.set_request_type(Segments::CONVERSION);
+  segments.add_segment()->set_key(kRequestKey);
+  ASSERT_TRUE(
+      data_and_converter->GetConverter()->ConvertForRequest(request,
+                                                            &segments));
+  EXPECT_EQ(2, stats.conversions);
+  EXPECT_EQ(2 * dictionary_lookups, stats.dictionary_lookups);
+  EXPECT_EQ(kRequestKey.size(), stats.nodes_per_position.size());
+
+  stats.Clear();
+  EXPECT_EQ(0, stats.conversions);
+  EXPECT_TRUE(stats.nodes_per_position.empty());
+}
+
 TEST(ImmutableConverterTest, NotConnectedTest) {
   std::unique_ptr<MockDataAndImmutableConverter> data_and_converter(
       new MockDataAndImmutableConverter);
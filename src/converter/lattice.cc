@@ -362,6 +362,13 @@ void Lattice::SetCacheInfo(const size_t pos, const size_t len) {
   cache_info_[pos] = len;
 }
 
+size_t Lattice::GetAllocatedBytes() const {
+  return key_.capacity() +
+      (begin_nodes_.capacity() + end_nodes_.capacity()) * sizeof(Node *) +
+      cache_info_.capacity() * sizeof(size_t) +
+      node_allocator_->GetAllocatedBytes();
+}
+
 void Lattice::ResetNodeCost() {
   for (size_t i = 0; i <= key_.size(); ++i) {
     if (begin_nodes_[i] != NULL) {
@@ -103,6 +103,10 @@ class Lattice {
   // setter
   void SetCacheInfo(const size_t pos, const size_t len);
 
+  // returns an estimate of the heap memory held by the nodes and the index.
+  // The strings owned by the nodes are not counted.
+  size_t GetAllocatedBytes() const;
+
   // revert the wcost of nodes if it has ENABLE_CACHE attribute.
   // This function is needed for wcost may be changed during conversion
   // process for some heuristic methods.
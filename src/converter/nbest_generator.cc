@@ -123,7 +123,9 @@ NBestGenerator::NBestGenerator(const SuppressionDictionary *suppression_dic,
           apply_suggestion_filter_for_exact_match)),
       viterbi_result_checked_(false),
       check_mode_(STRICT),
-      boundary_checker_(NULL) {
+      boundary_checker_(NULL),
+      num_pops_(0),
+      num_filtered_candidates_(0) {
   DCHECK(suppression_dictionary_);
   DCHECK(segmenter);
   DCHECK(connector);
@@ -323,7 +325,7 @@ bool NBestGenerator::Next(const string &original_key,
         // Viterbi best result was tried to be inserted but reverted.
       case CandidateFilter::BAD_CANDIDATE:
       default:
-        // do nothing
+        ++num_filtered_candidates_;
         break;
     }
   }
@@ -335,6 +337,7 @@ bool NBestGenerator::Next(const string &original_key,
     const QueueElement *top = agenda_.Top();
     DCHECK(top);
     agenda_.Pop();
+    ++num_pops_;
     const Node *rnode = top->node;
     CHECK(rnode);
 
@@ -366,8 +369,8 @@ bool NBestGenerator::Next(const string &original_key,
           return false;
         case CandidateFilter::BAD_CANDIDATE:
         default:
+          ++num_filtered_candidates_;
           break;
-          // do nothing
       }
     } else {
       const QueueElement *best_left_elm = NULL;
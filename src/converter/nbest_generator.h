@@ -100,6 +100,12 @@ class NBestGenerator {
             Segment::Candidate *candidate,
             Segments::RequestType request_type);
 
+  // Number of elements popped from the agenda and of the candidates rejected
+  // by the candidate filter since the construction.  Reset() doesn't clear
+  // them.
+  size_t num_pops() const { return num_pops_; }
+  size_t num_filtered_candidates() const { return num_filtered_candidates_; }
+
  private:
   enum BoundaryCheckResult {
     VALID = 0,
@@ -189,6 +195,9 @@ class NBestGenerator {
 
   BoundaryChecker boundary_checker_;
 
+  size_t num_pops_;
+  size_t num_filtered_candidates_;
+
   DISALLOW_COPY_AND_ASSIGN(NBestGenerator);
 };
 
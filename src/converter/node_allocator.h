@@ -40,7 +40,7 @@ namespace mozc {
 class NodeAllocator {
  public:
   NodeAllocator() : node_freelist_(1024), max_nodes_size_(8192),
-                    node_count_(0) {}
+                    node_count_(0), num_allocated_(0) {}
   ~NodeAllocator() {}
 
   Node *NewNode() {
@@ -48,6 +48,7 @@ class NodeAllocator {
     DCHECK(node);
     node->Init();
     ++node_count_;
+    ++num_allocated_;
     return node;
   }
 
@@ -69,10 +70,21 @@ class NodeAllocator {
     return node_count_;
   }
 
+  // Returns the number of NewNode() calls since the construction.  Unlike
+  // node_count(), Free() doesn't reset it.
+  uint64 num_allocated() const {
+    return num_allocated_;
+  }
+
+  size_t GetAllocatedBytes() const {
+    return node_freelist_.GetAllocatedBytes();
+  }
+
  private:
   FreeList<Node> node_freelist_;
   size_t max_nodes_size_;
   size_t node_count_;
+  uint64 num_allocated_;
 
   DISALLOW_COPY_AND_ASSIGN(NodeAllocator);
 };
@@ -234,6 +234,13 @@ bool QualityRegressionUtil::ConvertAndTest(const TestItem &item,
     return true;
   }
 
+  // Expand the candidates as they are shown in the candidate window.
+  for (size_t i = 0; i < segments_->conversion_segments_size(); ++i) {
+    converter_->GetCandidates(
+        segments_.get(), i,
+        segments_->conversion_segment(i).candidates_size());
+  }
+
   for (size_t i = 0; i < segments_->segments_size(); ++i) {
     *actual_value += segments_->segment(i).candidate(0).value;
   }
@@ -437,6 +437,31 @@ void Segment::CopyFrom(const Segment &src) {
   }
 }
 
+namespace {
+
+size_t GetCandidateStringBytes(const Segment::Candidate &candidate) {
+  return candidate.key.capacity() + candidate.value.capacity() +
+      candidate.content_key.capacity() + candidate.content_value.capacity() +
+      candidate.prefix.capacity() + candidate.suffix.capacity() +
+      candidate.description.capacity() + candidate.usage_title.capacity() +
+      candidate.usage_description.capacity();
+}
+
+}  // namespace
+
+size_t Segment::GetAllocatedBytes() const {
+  size_t bytes = key_.capacity() + candidates_.size() * sizeof(Candidate *) +
+      meta_candidates_.capacity() * sizeof(Candidate) +
+      pool_->GetAllocatedBytes();
+  for (size_t i = 0; i < candidates_.size(); ++i) {
+    bytes += GetCandidateStringBytes(*candidates_[i]);
+  }
+  for (size_t i = 0; i < meta_candidates_.size(); ++i) {
+    bytes += GetCandidateStringBytes(meta_candidates_[i]);
+  }
+  return bytes;
+}
+
 string Segment::DebugString() const {
   std::stringstream os;
   os << "[segtype=" << segment_type() << " key=" << key() << std::endl;
@@ -711,6 +736,19 @@ Lattice *Segments::mutable_cached_lattice() {
   return cached_lattice_.get();
 }
 
+size_t Segments::GetAllocatedBytes() const {
+  size_t bytes = segments_.size() * sizeof(Segment *) +
+      revert_entries_.capacity() * sizeof(RevertEntry) +
+      pool_->GetAllocatedBytes();
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    bytes += segments_[i]->GetAllocatedBytes();
+  }
+  if (cached_lattice_ != nullptr) {
+    bytes += cached_lattice_->GetAllocatedBytes();
+  }
+  return bytes;
+}
+
 string Segments::DebugString() const {
   std::stringstream os;
   os << "{" << std::endl;
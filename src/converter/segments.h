@@ -104,6 +104,9 @@ class Segment {
       AUTO_PARTIAL_SUGGESTION = 1 << 13,
       // Predicted from user prediction history.
       USER_HISTORY_PREDICTION = 1 << 14,
+      // Full/half width alternative is not inserted yet. It is inserted
+      // when the candidates of the segment are expanded.
+      VARIANTS_DEFERRED = 1 << 15,
     };
 
     enum Command {
@@ -345,6 +348,10 @@ class Segment {
 
   string DebugString() const;
 
+  // Returns an estimate of the heap memory held by this segment, including
+  // the strings of the candidates.
+  size_t GetAllocatedBytes() const;
+
  private:
   SegmentType segment_type_;
   // Note that |key_| is shorter than usual when partial suggestion is
@@ -477,6 +484,9 @@ class Segments {
   // Dump Segments structure
   string DebugString() const;
 
+  // Estimate of the heap memory held by the segments and the cached lattice.
+  size_t GetAllocatedBytes() const;
+
   // Revert entries
   void clear_revert_entries();
   size_t revert_entries_size() const;
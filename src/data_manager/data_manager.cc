@@ -385,7 +385,29 @@ DataManager::Status DataManager::InitFromFile(const string &path,
     return Status::MMAP_FAILURE;
   }
   const StringPiece data(mmap_.begin(), mmap_.size());
-  return InitFromArray(data, magic);
+  DataSetReader reader;
+  if (!reader.Init(data, magic)) {
+    LOG(ERROR) << "Binary data of size " << data.size() << " is broken";
+    return Status::DATA_BROKEN;
+  }
+  // Advise before parsing the data so that hot pages are read in parallel.
+  AdviseAccessPattern(reader);
+  return InitFromReader(reader);
+}
+
+void DataManager::AdviseAccessPattern(const DataSetReader &reader) {
+  for (const auto &hint : reader.name_to_access_hint_map()) {
+    StringPiece data;
+    if (!reader.Get(hint.first, &data) || data.empty()) {
+      continue;
+    }
+    const Mmap::AccessAdvice advice =
+        hint.second == DataSetMetadata::Entry::HOT ? Mmap::WILL_NEED
+                                                   : Mmap::RANDOM;
+    if (Mmap::MaybeAdvise(data.data(), data.size(), advice) != 0) {
+      VLOG(1) << "Failed to advise the access pattern of " << hint.first;
+    }
+  }
 }
 
 DataManager::Status DataManager::InitUserPosManagerDataFromArray(
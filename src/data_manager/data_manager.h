@@ -142,6 +142,10 @@ class DataManager : public DataManagerInterface {
  private:
   Status InitFromReader(const DataSetReader &reader);
 
+  // Advises the kernel how each data in the mmapped data set is accessed,
+  // following the access hints recorded in the data set.
+  void AdviseAccessPattern(const DataSetReader &reader);
+
   Mmap mmap_;
   StringPiece pos_matcher_data_;
   StringPiece user_pos_token_array_data_;
@@ -124,8 +124,30 @@
       ],
       'dependencies': [
         '../base/base.gyp:base',
+        '../base/base.gyp:hash',
         '../base/base.gyp:serialized_string_array',
       ],
     },
   ],
+  'conditions': [
+    ['OS=="linux"', {
+      'targets': [
+        {
+          'target_name': 'dataset_layout_main',
+          'type': 'executable',
+          'toolsets': [ 'host' ],
+          'sources': [
+            'dataset_layout_main.cc',
+          ],
+          'dependencies': [
+            '../base/base.gyp:base',
+            '../base/base.gyp:base_core',
+            'dataset_proto',
+            'dataset_reader',
+            'dataset_writer',
+          ],
+        },
+      ],
+    }],
+  ],
 }
@@ -0,0 +1,229 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Tool to lay out a data set file so that the data accessed at runtime are
+// packed at the front of the file, and to record access hints for them.
+//
+// Usage
+// $ ./path/to/artifacts/dataset_layout_main \
+//   --input=/path/to/mozc.data \
+//   --output=/path/to/output \
+//   --replay_command="command using /path/to/mozc.data"
+//
+// The tool drops the pages of the input file from the page cache, runs the
+// replay command, which should load the input file and run a representative
+// workload (e.g., a session replay with the server using the data file),
+// and then checks which pages of each data stayed in the page cache with
+// mincore().  The data of which at least --hot_threshold of the pages were
+// touched are moved to the front and marked HOT, and the data never touched
+// are moved to the end and marked COLD.  DataManager advises the kernel
+// following these hints when it mmaps the output file.
+//
+// Note: readahead during the replay may mark neighbouring pages as touched.
+// Run the replay on a host with small readahead for a precise result.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "base/file_stream.h"
+#include "base/file_util.h"
+#include "base/flags.h"
+#include "base/init_mozc.h"
+#include "base/logging.h"
+#include "base/mmap.h"
+#include "base/util.h"
+#include "data_manager/dataset.pb.h"
+#include "data_manager/dataset_reader.h"
+#include "data_manager/dataset_writer.h"
+
+DEFINE_string(input, "", "Input data set file");
+DEFINE_string(output, "", "Output data set file");
+DEFINE_string(magic, "\\xEF\\x4D\\x4F\\x5A\\x43\\x0D\\x0A",
+              "Hex-encoded magic number of the data set");
+DEFINE_string(replay_command, "",
+              "Command loading the input file and running a workload");
+DEFINE_double(hot_threshold, 0.3,
+              "Minimum ratio of touched pages to mark the data as HOT");
+
+namespace mozc {
+namespace {
+
+struct Section {
+  string name;
+  StringPiece data;
+  int alignment;
+  size_t num_pages;
+  size_t num_touched_pages;
+  DataSetMetadata::Entry::AccessHint access_hint;
+};
+
+// Returns the maximum alignment in bits that |offset| satisfies, which is at
+// least the alignment specified when the data set was written.
+int GetAlignment(size_t offset) {
+  for (int alignment = 64; alignment > 8; alignment /= 2) {
+    if (offset % (alignment / 8) == 0) {
+      return alignment;
+    }
+  }
+  return 8;
+}
+
+bool SectionLessThan(const Section &lhs, const Section &rhs) {
+  // HOT data first in descending order of the ratio of touched pages, then
+  // NORMAL data, and COLD data at last.
+  const double lhs_ratio =
+      static_cast<double>(lhs.num_touched_pages) / lhs.num_pages;
+  const double rhs_ratio =
+      static_cast<double>(rhs.num_touched_pages) / rhs.num_pages;
+  if (lhs.access_hint != rhs.access_hint) {
+    if (lhs.access_hint == DataSetMetadata::Entry::HOT) {
+      return true;
+    }
+    if (rhs.access_hint == DataSetMetadata::Entry::HOT) {
+      return false;
+    }
+    return lhs.access_hint == DataSetMetadata::Entry::NORMAL;
+  }
+  return lhs.access_hint == DataSetMetadata::Entry::HOT &&
+         lhs_ratio > rhs_ratio;
+}
+
+// Drops the cached pages of |filename| so that the replay starts with a cold
+// cache.
+void DropPageCache(const string &filename) {
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Failed to open " << filename;
+  // Dirty pages, e.g., of a file just built, are not dropped.
+  ::fdatasync(fd);
+  CHECK_EQ(0, ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED))
+      << "Failed to drop the page cache of " << filename;
+  ::close(fd);
+}
+
+// Returns the residency of each page of |filename| in the page cache.
+std::vector<unsigned char> GetResidentPages(const string &filename) {
+  Mmap mmap;
+  CHECK(mmap.Open(filename.c_str(), "r")) << "Failed to mmap " << filename;
+  const size_t page_size = getpagesize();
+  std::vector<unsigned char> pages((mmap.size() + page_size - 1) / page_size);
+  CHECK_EQ(0, ::mincore(mmap.begin(), mmap.size(), pages.data()))
+      << "mincore() failed";
+  return pages;
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  mozc::InitMozc(argv[0], &argc, &argv, true);
+
+  CHECK(!FLAGS_input.empty()) << "--input is required";
+  CHECK(!FLAGS_output.empty()) << "--output is required";
+  CHECK(!FLAGS_replay_command.empty()) << "--replay_command is required";
+  string magic;
+  CHECK(mozc::Util::Unescape(FLAGS_magic, &magic))
+      << "magic number is not a proper hex-escaped string: " << FLAGS_magic;
+
+  // Read the input into memory, as the pages mapped by this process would
+  // stay in the page cache.
+  string image;
+  {
+    mozc::InputFileStream ifs(FLAGS_input.c_str(),
+                              ios_base::in | ios_base::binary);
+    CHECK(ifs.good()) << "Failed to open " << FLAGS_input;
+    image = ifs.Read();
+  }
+  mozc::DataSetReader reader;
+  CHECK(reader.Init(image, magic)) << "Broken data set: " << FLAGS_input;
+
+  mozc::DropPageCache(FLAGS_input);
+  LOG(INFO) << "Running " << FLAGS_replay_command;
+  CHECK_EQ(0, system(FLAGS_replay_command.c_str()))
+      << "Replay command failed: " << FLAGS_replay_command;
+  const std::vector<unsigned char> pages =
+      mozc::GetResidentPages(FLAGS_input);
+
+  const size_t page_size = getpagesize();
+  std::vector<mozc::Section> sections;
+  for (const auto &entry : reader.name_to_data_map()) {
+    mozc::Section section;
+    section.name = entry.first;
+    section.data = entry.second;
+    const size_t offset = entry.second.data() - image.data();
+    section.alignment = mozc::GetAlignment(offset);
+    const size_t begin_page = offset / page_size;
+    const size_t end_page =
+        (offset + std::max<size_t>(entry.second.size(), 1) + page_size - 1) /
+        page_size;
+    section.num_pages = end_page - begin_page;
+    section.num_touched_pages = 0;
+    for (size_t i = begin_page; i < end_page && i < pages.size(); ++i) {
+      if (pages[i] & 1) {
+        ++section.num_touched_pages;
+      }
+    }
+    if (section.num_touched_pages == 0) {
+      section.access_hint = mozc::DataSetMetadata::Entry::COLD;
+    } else if (section.num_touched_pages >=
+               FLAGS_hot_threshold * section.num_pages) {
+      section.access_hint = mozc::DataSetMetadata::Entry::HOT;
+    } else {
+      section.access_hint = mozc::DataSetMetadata::Entry::NORMAL;
+    }
+    sections.push_back(section);
+  }
+  std::stable_sort(sections.begin(), sections.end(), mozc::SectionLessThan);
+
+  const string tmpfile = FLAGS_output + ".tmp";
+  {
+    mozc::DataSetWriter writer(magic);
+    for (const auto &section : sections) {
+      LOG(INFO) << section.name << ": " << section.num_touched_pages << "/"
+                << section.num_pages << " pages touched, "
+                << mozc::DataSetMetadata::Entry::AccessHint_Name(
+                       section.access_hint);
+      writer.Add(section.name, section.alignment, section.data,
+                 section.access_hint);
+    }
+    mozc::OutputFileStream output(tmpfile.c_str(),
+                                  ios_base::out | ios_base::binary);
+    writer.Finish(&output);
+    output.close();
+  }
+  CHECK(mozc::FileUtil::AtomicRename(tmpfile, FLAGS_output))
+      << "Failed to rename " << tmpfile << " to " << FLAGS_output;
+
+  return 0;
+}
@@ -33,7 +33,6 @@
 #include "base/port.h"
 #include "base/unverified_sha1.h"
 #include "base/util.h"
-#include "data_manager/dataset.pb.h"
 
 namespace mozc {
 namespace {
@@ -48,6 +47,7 @@ DataSetReader::~DataSetReader() = default;
 
 bool DataSetReader::Init(StringPiece memblock, StringPiece magic) {
   name_to_data_map_.clear();
+  name_to_access_hint_map_.clear();
 
   // Initializes |name_to_data_map_| from |memblock|.  For binary data format,
   // see dataset.proto.
@@ -128,6 +128,9 @@ bool DataSetReader::Init(StringPiece memblock, StringPiece magic) {
       return false;
     }
     name_to_data_map_[e.name()] = memblock.substr(e.offset(), e.size());
+    if (e.access_hint() != DataSetMetadata::Entry::NORMAL) {
+      name_to_access_hint_map_[e.name()] = e.access_hint();
+    }
     prev_chunk_end = e.offset() + e.size();
   }
 
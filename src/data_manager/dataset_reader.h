@@ -34,6 +34,7 @@
 #include <string>
 
 #include "base/string_piece.h"
+#include "data_manager/dataset.pb.h"
 
 namespace mozc {
 
@@ -60,9 +61,18 @@ class DataSetReader {
     return name_to_data_map_;
   }
 
+  // Returns the access hints of the data recorded in the data set.  The data
+  // not in this map is accessed normally.
+  const std::map<string, DataSetMetadata::Entry::AccessHint> &
+  name_to_access_hint_map() const {
+    return name_to_access_hint_map_;
+  }
+
  private:
   // The value points to a block of the specified |memblock|.
   std::map<string, StringPiece> name_to_data_map_;
+  std::map<string, DataSetMetadata::Entry::AccessHint>
+      name_to_access_hint_map_;
 };
 
 }  // namespace mozc
@@ -79,6 +79,27 @@ TEST(DataSetReaderTest, ValidData) {
   EXPECT_FALSE(r.Get("foo", &data));
 }
 
+TEST(DataSetReaderTest, AccessHint) {
+  string image;
+  {
+    DataSetWriter w(GetTestMagicNumber());
+    w.Add("hot", 32, "HOT", DataSetMetadata::Entry::HOT);
+    w.Add("normal", 32, "NORMAL");
+    w.Add("cold", 32, "COLD", DataSetMetadata::Entry::COLD);
+    std::stringstream out;
+    w.Finish(&out);
+    image = out.str();
+  }
+
+  DataSetReader r;
+  ASSERT_TRUE(r.Init(image, GetTestMagicNumber()));
+  const auto &hints = r.name_to_access_hint_map();
+  ASSERT_EQ(2, hints.size());
+  EXPECT_EQ(DataSetMetadata::Entry::HOT, hints.at("hot"));
+  EXPECT_EQ(DataSetMetadata::Entry::COLD, hints.at("cold"));
+  EXPECT_EQ(0, hints.count("normal"));
+}
+
 TEST(DataSetReaderTest, InvalidMagicString) {
   const string &magic = GetTestMagicNumber();
   DataSetReader r;
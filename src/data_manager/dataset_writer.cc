@@ -52,12 +52,20 @@ DataSetWriter::DataSetWriter(StringPiece magic)
 DataSetWriter::~DataSetWriter() = default;
 
 void DataSetWriter::Add(const string &name, int alignment, StringPiece data) {
+  Add(name, alignment, data, DataSetMetadata::Entry::NORMAL);
+}
+
+void DataSetWriter::Add(const string &name, int alignment, StringPiece data,
+                        DataSetMetadata::Entry::AccessHint access_hint) {
   CHECK(seen_names_.insert(name).second) << name << " was already added";
   AppendPadding(alignment);
   DataSetMetadata::Entry *entry = metadata_.add_entries();
   entry->set_name(name);
   entry->set_offset(image_.size());
   entry->set_size(data.size());
+  if (access_hint != DataSetMetadata::Entry::NORMAL) {
+    entry->set_access_hint(access_hint);
+  }
   data.AppendToString(&image_);
 }
 
@@ -51,6 +51,10 @@ class DataSetWriter {
   // specified bit boundary (8, 16, 32, or 64).
   void Add(const string &name, int alignment, StringPiece data);
 
+  // Similar to Add() above but also records how the data is accessed.
+  void Add(const string &name, int alignment, StringPiece data,
+           DataSetMetadata::Entry::AccessHint access_hint);
+
   // Similar to Add() for StringPiece but data is read from file.
   void AddFile(const string &name, int alignment, const string &filepath);
 
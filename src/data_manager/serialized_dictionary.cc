@@ -38,6 +38,7 @@
 #include <vector>
 
 #include "base/file_stream.h"
+#include "base/hash.h"
 #include "base/logging.h"
 #include "base/number_util.h"
 #include "base/port.h"
@@ -82,6 +83,12 @@ void LoadTokens(std::istream *ifs, std::map<string, TokenList> *dic) {
   }
 }
 
+uint32 GetKeyIndex(StringPiece token_array_data, size_t token_index) {
+  return *reinterpret_cast<const uint32 *>(
+      token_array_data.data() +
+      token_index * SerializedDictionary::kTokenByteLength);
+}
+
 }  // namespace
 
 SerializedDictionary::SerializedDictionary(StringPiece token_array,
@@ -89,15 +96,68 @@ SerializedDictionary::SerializedDictionary(StringPiece token_array,
     : token_array_(token_array) {
   DCHECK(VerifyData(token_array, string_array_data));
   string_array_.Set(string_array_data);
+  BuildKeyDirectory();
 }
 
 SerializedDictionary::~SerializedDictionary() {}
 
 SerializedDictionary::IterRange SerializedDictionary::equal_range(
     StringPiece key) const {
-  // TODO(noriyukit): Instead of comparing key as string, we can do binary
-  // search using key index to minimize string comparison cost.
-  return std::equal_range(begin(), end(), key);
+  const uint32 fingerprint = Hash::Fingerprint32(key);
+  for (uint32 slot = fingerprint & key_directory_mask_; ;
+       slot = (slot + 1) & key_directory_mask_) {
+    const uint32 token_index_plus_one = key_directory_[2 * slot + 1];
+    if (token_index_plus_one == 0) {
+      return IterRange(end(), end());
+    }
+    if (key_directory_[2 * slot] != fingerprint) {
+      continue;
+    }
+    const iterator first = begin() + (token_index_plus_one - 1);
+    if (first.key() != key) {
+      continue;
+    }
+    // The tokens of the same key are adjacent and share the key index.
+    const uint32 key_index = first.key_index();
+    iterator last = first + 1;
+    while (last != end() && last.key_index() == key_index) {
+      ++last;
+    }
+    return IterRange(first, last);
+  }
+}
+
+void SerializedDictionary::BuildKeyDirectory() {
+  // Since tokens are sorted by key, the first token of each key is the one
+  // whose key index differs from the previous token's.
+  const size_t num_tokens = size();
+  std::vector<uint32> first_tokens;
+  for (size_t i = 0; i < num_tokens; ++i) {
+    if (i == 0 ||
+        GetKeyIndex(token_array_, i) != GetKeyIndex(token_array_, i - 1)) {
+      first_tokens.push_back(i);
+    }
+  }
+
+  // Keep the table at most half full so that probing ends at an empty slot
+  // soon.
+  size_t num_slots = 1;
+  while (num_slots < 2 * first_tokens.size()) {
+    num_slots *= 2;
+  }
+  key_directory_mask_ = num_slots - 1;
+  key_directory_.reset(new uint32[2 * num_slots]());
+  uint32 *slots = key_directory_.get();
+  for (const uint32 token_index : first_tokens) {
+    const uint32 fingerprint = Hash::Fingerprint32(
+        string_array_[GetKeyIndex(token_array_, token_index)]);
+    uint32 slot = fingerprint & key_directory_mask_;
+    while (slots[2 * slot + 1] != 0) {
+      slot = (slot + 1) & key_directory_mask_;
+    }
+    slots[2 * slot] = fingerprint;
+    slots[2 * slot + 1] = token_index + 1;
+  }
 }
 
 std::pair<StringPiece, StringPiece> SerializedDictionary::Compile(
@@ -33,6 +33,7 @@
 #include <istream>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -105,6 +106,24 @@ namespace mozc {
 // byte boundary by the insertion of padding.  String values of a token (key,
 // value, description, additional_description) can be retrieved from the string
 // array by index.
+//
+// ** Key directory
+// To look up keys without binary search over strings, equal_range() uses an
+// open addressing hash table of the keys, which is built when the dictionary
+// is loaded.  The table is an array of 2^n slots of 8 bytes:
+//
+// Slot layout (8 bytes)
+// +---------------------------------------+
+// | Fingerprint32 of key (4 bytes)        |
+// + - - - - - - - - - - - - - - - - - - - +
+// | Index of the first token of key + 1,  |
+// | or 0 for an empty slot (4 bytes)      |
+// +---------------------------------------+
+//
+// The table is at most half full, and collisions are resolved by linear
+// probing.  A key is confirmed by one string comparison, and the rest of its
+// tokens are found by comparing key indices, as the same keys share the same
+// index.
 class SerializedDictionary {
  public:
   struct CompilerToken {
@@ -311,7 +330,7 @@ class SerializedDictionary {
                          StringPiece string_array_data);
 
   // Both |token_array| and |string_array_data| must be aligned at 4-byte
-  // boundary.
+  // boundary.  The key directory is built from them.
   SerializedDictionary(StringPiece token_array, StringPiece string_array_data);
   ~SerializedDictionary();
 
@@ -336,8 +355,12 @@ class SerializedDictionary {
   IterRange equal_range(StringPiece key) const;
 
  private:
+  void BuildKeyDirectory();
+
   StringPiece token_array_;
   SerializedStringArray string_array_;
+  std::unique_ptr<uint32[]> key_directory_;
+  uint32 key_directory_mask_;
 };
 
 }  // namespace mozc
@@ -29,6 +29,7 @@
 
 #include "data_manager/serialized_dictionary.h"
 
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -180,5 +181,38 @@ TEST_F(SerializedDictionaryTest, EqualRange) {
   }
 }
 
+TEST(SerializedDictionaryManyKeysTest, EqualRange) {
+  // Enough keys to make some of them collide in the key directory.
+  const int kNumKeys = 1000;
+  std::stringstream ifs;
+  for (int i = 0; i < kNumKeys; ++i) {
+    // Every third key has two tokens.
+    const int num_tokens = (i % 3 == 0) ? 2 : 1;
+    for (int j = 0; j < num_tokens; ++j) {
+      ifs << "key" << i << "\t1\t1\t" << (100 + j) << "\tvalue" << i << "_"
+          << j << "\n";
+    }
+  }
+  std::unique_ptr<uint32[]> buf1, buf2;
+  const std::pair<StringPiece, StringPiece> data =
+      SerializedDictionary::Compile(&ifs, &buf1, &buf2);
+  SerializedDictionary dic(data.first, data.second);
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    const string key = "key" + std::to_string(i);
+    auto range = dic.equal_range(key);
+    ASSERT_EQ((i % 3 == 0) ? 2 : 1, range.second - range.first) << key;
+    for (int j = 0; range.first != range.second; ++range.first, ++j) {
+      EXPECT_EQ(key, range.first.key());
+      EXPECT_EQ("value" + std::to_string(i) + "_" + std::to_string(j),
+                range.first.value());
+    }
+  }
+  for (const char *key : {"", "key", "key1000", "mozc"}) {
+    auto range = dic.equal_range(key);
+    EXPECT_EQ(range.first, range.second) << key;
+  }
+}
+
 }  // namespace
 }  // namespace mozc
@@ -29,9 +29,12 @@
 
 #include "dictionary/dictionary_impl.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/string_piece.h"
 #include "base/util.h"
 #include "dictionary/dictionary_interface.h"
@@ -163,6 +166,29 @@ void DictionaryImpl::LookupPredictive(
   }
 }
 
+void DictionaryImpl::LookupPredictiveMulti(
+    const std::vector<StringPiece> &keys,
+    const ConversionRequest &conversion_request,
+    const std::vector<Callback *> &callbacks) const {
+  DCHECK_EQ(keys.size(), callbacks.size());
+  std::vector<std::unique_ptr<CallbackWithFilter>> callbacks_with_filter;
+  std::vector<Callback *> filtered_callbacks;
+  for (size_t i = 0; i < callbacks.size(); ++i) {
+    callbacks_with_filter.emplace_back(new CallbackWithFilter(
+        conversion_request.config().use_spelling_correction(),
+        conversion_request.config().use_zip_code_conversion(),
+        conversion_request.config().use_t13n_conversion(),
+        pos_matcher_,
+        suppression_dictionary_,
+        callbacks[i]));
+    filtered_callbacks.push_back(callbacks_with_filter.back().get());
+  }
+  for (size_t i = 0; i < dics_.size(); ++i) {
+    dics_[i]->LookupPredictiveMulti(keys, conversion_request,
+                                    filtered_callbacks);
+  }
+}
+
 void DictionaryImpl::LookupPrefix(
     StringPiece key,
     const ConversionRequest &conversion_request,
@@ -232,6 +258,21 @@ bool DictionaryImpl::Reload() {
   return user_dictionary_->Reload();
 }
 
+void DictionaryImpl::CollectMemoryUsage(MemoryUsage *usage) const {
+  {
+    MemoryUsage::Scope scope(usage, "system");
+    system_dictionary_->CollectMemoryUsage(usage);
+  }
+  {
+    MemoryUsage::Scope scope(usage, "value");
+    value_dictionary_->CollectMemoryUsage(usage);
+  }
+  {
+    MemoryUsage::Scope scope(usage, "user");
+    user_dictionary_->CollectMemoryUsage(usage);
+  }
+}
+
 void DictionaryImpl::PopulateReverseLookupCache(StringPiece str) const {
   for (size_t i = 0; i < dics_.size(); ++i) {
     dics_[i]->PopulateReverseLookupCache(str);
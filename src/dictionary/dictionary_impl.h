@@ -66,6 +66,10 @@ class DictionaryImpl : public DictionaryInterface {
   virtual void LookupPredictive(StringPiece key,
                                 const ConversionRequest &conversion_request,
                                 Callback *callback) const;
+  virtual void LookupPredictiveMulti(
+      const std::vector<StringPiece> &keys,
+      const ConversionRequest &conversion_request,
+      const std::vector<Callback *> &callbacks) const;
   virtual void LookupPrefix(StringPiece key,
                             const ConversionRequest &conversion_request,
                             Callback *callback) const;
@@ -84,6 +88,7 @@ class DictionaryImpl : public DictionaryInterface {
   virtual bool Reload();
   virtual void PopulateReverseLookupCache(StringPiece str) const;
   virtual void ClearReverseLookupCache() const;
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const;
 
  private:
   enum LookupType {
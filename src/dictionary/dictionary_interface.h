@@ -39,6 +39,9 @@
 #include "request/conversion_request.h"
 
 namespace mozc {
+
+class MemoryUsage;
+
 namespace dictionary {
 
 class DictionaryInterface {
@@ -120,6 +123,19 @@ class DictionaryInterface {
                                 const ConversionRequest &conversion_request,
                                 Callback *callback) const = 0;
 
+  // Runs LookupPredictive() for each key in |keys| with the callback at the
+  // same index of |callbacks|.  Implementations may share the traversal for
+  // common prefixes of the keys, e.g., for typing correction queries.  The
+  // default implementation looks up the keys one by one.
+  virtual void LookupPredictiveMulti(
+      const std::vector<StringPiece> &keys,
+      const ConversionRequest &conversion_request,
+      const std::vector<Callback *> &callbacks) const {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      LookupPredictive(keys[i], conversion_request, callbacks[i]);
+    }
+  }
+
   virtual void LookupPrefix(StringPiece key,
                             const ConversionRequest &conversion_request,
                             Callback *callback) const = 0;
@@ -147,6 +163,9 @@ class DictionaryInterface {
   virtual void PopulateReverseLookupCache(StringPiece str) const {}
   virtual void ClearReverseLookupCache() const {}
 
+  // Reports the heap memory held by this dictionary to |usage|.
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const {}
+
   // Sync mutable dictionary data into local disk.
   virtual bool Sync() { return true; }
 
@@ -29,19 +29,135 @@
 
 #include "dictionary/suppression_dictionary.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/hash.h"
 #include "base/logging.h"
 #include "base/mutex.h"
 
 namespace mozc {
 namespace dictionary {
 namespace {
-const char kDelimiter = '\t';
+
+// Fingerprint of the empty string, used for entries whose key or value is
+// empty.
+inline uint64 EmptyFingerprint() {
+  return Hash::Fingerprint(StringPiece());
+}
+
+// Returns the fingerprint of (key, value) from those of key and value.  The
+// pair is hashed from the two parts so that no concatenated string is built.
+inline uint64 CombineFingerprints(uint64 key_fp, uint64 value_fp) {
+  uint64 h = key_fp ^ (value_fp + GG_ULONGLONG(0x9e3779b97f4a7c15) +
+                       (key_fp << 6) + (key_fp >> 2));
+  h ^= h >> 33;
+  h *= GG_ULONGLONG(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  // 0 is reserved for empty slots of FingerprintSet.
+  return h == 0 ? 1 : h;
+}
+
+// Counts a running reader in the scope.
+class ScopedReader {
+ public:
+  explicit ScopedReader(std::atomic<int> *num_readers)
+      : num_readers_(num_readers) {
+    num_readers_->fetch_add(1);
+  }
+  ~ScopedReader() {
+    num_readers_->fetch_sub(1);
+  }
+
+ private:
+  std::atomic<int> *num_readers_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedReader);
+};
+
 }  // namespace
 
+// Immutable open-addressing hash set of fingerprints with linear probing.
+class SuppressionDictionary::FingerprintSet {
+ public:
+  FingerprintSet(const std::vector<uint64> &fingerprints,
+                 bool has_key_empty, bool has_value_empty)
+      : mask_(0),
+        size_(0),
+        has_key_empty_(has_key_empty),
+        has_value_empty_(has_value_empty) {
+    // Keep the load factor at most 1/2.
+    size_t capacity = 4;
+    while (capacity < 2 * fingerprints.size()) {
+      capacity *= 2;
+    }
+    table_.assign(capacity, 0);
+    mask_ = capacity - 1;
+    for (size_t i = 0; i < fingerprints.size(); ++i) {
+      Insert(fingerprints[i]);
+    }
+  }
+
+  bool Contains(uint64 fp) const {
+    for (size_t i = fp & mask_; ; i = (i + 1) & mask_) {
+      if (table_[i] == fp) {
+        return true;
+      }
+      if (table_[i] == 0) {
+        return false;
+      }
+    }
+  }
+
+  // Appends all the fingerprints to |output|.
+  void AppendTo(std::vector<uint64> *output) const {
+    for (size_t i = 0; i < table_.size(); ++i) {
+      if (table_[i] != 0) {
+        output->push_back(table_[i]);
+      }
+    }
+  }
+
+  bool empty() const { return size_ == 0; }
+  bool has_key_empty() const { return has_key_empty_; }
+  bool has_value_empty() const { return has_value_empty_; }
+
+ private:
+  void Insert(uint64 fp) {
+    for (size_t i = fp & mask_; ; i = (i + 1) & mask_) {
+      if (table_[i] == fp) {
+        return;
+      }
+      if (table_[i] == 0) {
+        table_[i] = fp;
+        ++size_;
+        return;
+      }
+    }
+  }
+
+  std::vector<uint64> table_;
+  size_t mask_;
+  size_t size_;
+  const bool has_key_empty_;
+  const bool has_value_empty_;
+
+  DISALLOW_COPY_AND_ASSIGN(FingerprintSet);
+};
+
 SuppressionDictionary::SuppressionDictionary()
-    : locked_(false), has_key_empty_(false), has_value_empty_(false) {}
+    : snapshot_(new FingerprintSet(std::vector<uint64>(), false, false)),
+      num_readers_(0),
+      is_empty_(true),
+      staged_has_key_empty_(false),
+      staged_has_value_empty_(false),
+      locked_(false) {}
 
-SuppressionDictionary::~SuppressionDictionary() {}
+SuppressionDictionary::~SuppressionDictionary() {
+  delete snapshot_.load();
+}
 
 bool SuppressionDictionary::AddEntry(
     const string &key, const string &value) {
@@ -56,14 +172,15 @@ bool SuppressionDictionary::AddEntry(
   }
 
   if (key.empty()) {
-    has_key_empty_ = true;
+    staged_has_key_empty_ = true;
   }
 
   if (value.empty()) {
-    has_value_empty_ = true;
+    staged_has_value_empty_ = true;
   }
 
-  dic_.insert(key + kDelimiter + value);
+  staged_.push_back(CombineFingerprints(Hash::Fingerprint(key),
+                                        Hash::Fingerprint(value)));
 
   return true;
 }
@@ -73,59 +190,76 @@ void SuppressionDictionary::Clear() {
     LOG(ERROR) << "Dictionary is not locked";
     return;
   }
-  has_key_empty_ = false;
-  has_value_empty_ = false;
-  dic_.clear();
+  staged_has_key_empty_ = false;
+  staged_has_value_empty_ = false;
+  staged_.clear();
 }
 
 void SuppressionDictionary::Lock() {
   scoped_lock l(&mutex_);
+  if (locked_) {
+    return;
+  }
+  // Start from the published entries so that AddEntry() without Clear()
+  // appends to them.
+  // Snapshots are deleted only under |mutex_|.
+  const FingerprintSet *snapshot = snapshot_.load();
+  staged_.clear();
+  snapshot->AppendTo(&staged_);
+  staged_has_key_empty_ = snapshot->has_key_empty();
+  staged_has_value_empty_ = snapshot->has_value_empty();
   locked_ = true;
 }
 
 void SuppressionDictionary::UnLock() {
   scoped_lock l(&mutex_);
+  if (!locked_) {
+    return;
+  }
+  const FingerprintSet *snapshot = new FingerprintSet(
+      staged_, staged_has_key_empty_, staged_has_value_empty_);
+  retired_.emplace_back(snapshot_.exchange(snapshot));
+  is_empty_.store(snapshot->empty(), std::memory_order_release);
+  std::vector<uint64>().swap(staged_);
   locked_ = false;
+
+  // The readers starting from now on see |snapshot|, so all the retired
+  // entries can be deleted when no reader is running.  Otherwise they are
+  // kept until the next UnLock().
+  if (num_readers_.load() == 0) {
+    retired_.clear();
+  }
 }
 
 bool SuppressionDictionary::IsEmpty() const {
-  if (locked_) {
-    return true;
-  }
-  return dic_.empty();
+  return is_empty_.load(std::memory_order_acquire);
 }
 
 bool SuppressionDictionary::SuppressEntry(
-    const string &key, const string &value) const {
-  if (dic_.empty()) {
+    StringPiece key, StringPiece value) const {
+  if (IsEmpty()) {
     // Almost all users don't use word supresssion function.
     // We can return false as early as possible
     return false;
   }
 
-  if (locked_) {
-    VLOG(2) << "Dictionary is locked now";
-    return false;
-  }
+  const ScopedReader reader(&num_readers_);
+  const FingerprintSet *snapshot = snapshot_.load();
 
-  string lookup_key = key;
-  lookup_key.append(1, kDelimiter).append(value);
-  if (dic_.find(lookup_key) != dic_.end()) {
+  const uint64 key_fp = Hash::Fingerprint(key);
+  const uint64 value_fp = Hash::Fingerprint(value);
+  if (snapshot->Contains(CombineFingerprints(key_fp, value_fp))) {
     return true;
   }
 
-  if (has_key_empty_) {
-    lookup_key.assign(1, kDelimiter).append(value);
-    if (dic_.find(lookup_key) != dic_.end()) {
-      return true;
-    }
+  if (snapshot->has_key_empty() &&
+      snapshot->Contains(CombineFingerprints(EmptyFingerprint(), value_fp))) {
+    return true;
   }
 
-  if (has_value_empty_) {
-    lookup_key.assign(key).append(1, kDelimiter);
-    if (dic_.find(lookup_key) != dic_.end()) {
-      return true;
-    }
+  if (snapshot->has_value_empty() &&
+      snapshot->Contains(CombineFingerprints(key_fp, EmptyFingerprint()))) {
+    return true;
   }
 
   return false;
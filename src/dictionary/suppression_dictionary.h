@@ -30,29 +30,37 @@
 #ifndef MOZC_DICTIONARY_SUPPRESSION_DICTIONARY_H_
 #define MOZC_DICTIONARY_SUPPRESSION_DICTIONARY_H_
 
-#include <set>
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/mutex.h"
 #include "base/port.h"
+#include "base/string_piece.h"
 
 namespace mozc {
 namespace dictionary {
 
+// Set of (key, value) pairs to be suppressed from conversion results.
+//
+// Entries are kept as 64-bit fingerprints of (key, value) in an immutable
+// open-addressing hash table.  Entries added between Lock() and UnLock() are
+// staged separately and published as a new table by UnLock(), so lookups
+// never allocate, never block and keep using the previous entries while the
+// dictionary is being reloaded.  A replaced table is deleted by UnLock() once
+// no lookup is running.
 class SuppressionDictionary {
  public:
   SuppressionDictionary();
   virtual ~SuppressionDictionary();
 
   // Locks dictionary.
-  // Need to lock before calling AddEntry() or Clear().
-  // When the dictionary is locked, Supress() return false.
-  //
-  // NOTE:
-  // Lock() and SupressWord() must be called synchronously.
+  // Need to lock before calling AddEntry() or Clear().  The entries staged by
+  // them are not visible to SuppressEntry() until UnLock() is called.
   void Lock();
 
-  // Unlocks dictionary.
+  // Unlocks dictionary and publishes the staged entries.
   void UnLock();
 
   // Returns true if the dictionary is locked.
@@ -66,19 +74,34 @@ class SuppressionDictionary {
   // Note: this method is thread unsafe.
   void Clear();
 
-  // Returns true if SuppressionDictionary doesn't have any entries.
+  // Returns true if SuppressionDictionary doesn't have any published entries.
   bool IsEmpty() const;
 
-  // Returns true if |word| should be suppressed.  If the current dictionay is
-  // "locked" via Lock() method, this function always return false.  Lock() and
-  // SuppressWord() must be called synchronously.
-  bool SuppressEntry(const string &key, const string &value) const;
+  // Returns true if |word| should be suppressed.  This method is thread safe
+  // and can be called while the dictionary is locked, in which case the
+  // entries published by the last UnLock() are used.
+  bool SuppressEntry(StringPiece key, StringPiece value) const;
 
  private:
-  std::set<string> dic_;
+  class FingerprintSet;
+
+  // Published entries, owned by this object.
+  std::atomic<const FingerprintSet *> snapshot_;
+  // Number of SuppressEntry() calls which may be reading |snapshot_|.
+  mutable std::atomic<int> num_readers_;
+  // Entries replaced by UnLock() which may still be read.  Guarded by
+  // |mutex_|.
+  std::vector<std::unique_ptr<const FingerprintSet>> retired_;
+  // True if |snapshot_| has no entries.  Checked before loading |snapshot_|
+  // since almost all users have no entries.
+  std::atomic<bool> is_empty_;
+
+  // Entries staged between Lock() and UnLock().
+  std::vector<uint64> staged_;
+  bool staged_has_key_empty_;
+  bool staged_has_value_empty_;
+
   bool locked_;
-  bool has_key_empty_;
-  bool has_value_empty_;
   Mutex mutex_;
 
   DISALLOW_COPY_AND_ASSIGN(SuppressionDictionary);
@@ -29,6 +29,8 @@
 
 #include "dictionary/suppression_dictionary.h"
 
+#include <atomic>
+
 #include "base/logging.h"
 #include "base/number_util.h"
 #include "base/singleton.h"
@@ -69,9 +71,9 @@ TEST(SupressionDictionary, BasicTest) {
     // Not locked
     EXPECT_FALSE(dic->AddEntry("test", "test"));
 
-    // locked now => SuppressEntry always returns false
+    // Published entries stay effective while locked.
     dic->Lock();
-    EXPECT_FALSE(dic->SuppressEntry("key1", "value1"));
+    EXPECT_TRUE(dic->SuppressEntry("key1", "value1"));
     dic->UnLock();
 
     EXPECT_TRUE(dic->SuppressEntry("key1", "value1"));
@@ -101,6 +103,57 @@ TEST(SupressionDictionary, BasicTest) {
   }
 }
 
+TEST(SupressionDictionary, ReloadTest) {
+  SuppressionDictionary dic;
+
+  dic.Lock();
+  EXPECT_TRUE(dic.AddEntry("key1", "value1"));
+  dic.UnLock();
+  EXPECT_TRUE(dic.SuppressEntry("key1", "value1"));
+
+  // Entries staged during reload are not visible until UnLock(), while the
+  // previous ones keep working.
+  dic.Lock();
+  dic.Clear();
+  EXPECT_TRUE(dic.AddEntry("key2", "value2"));
+  EXPECT_FALSE(dic.IsEmpty());
+  EXPECT_TRUE(dic.SuppressEntry("key1", "value1"));
+  EXPECT_FALSE(dic.SuppressEntry("key2", "value2"));
+  dic.UnLock();
+  EXPECT_FALSE(dic.SuppressEntry("key1", "value1"));
+  EXPECT_TRUE(dic.SuppressEntry("key2", "value2"));
+
+  // AddEntry() without Clear() appends to the published entries.
+  dic.Lock();
+  EXPECT_TRUE(dic.AddEntry("key3", ""));
+  dic.UnLock();
+  EXPECT_TRUE(dic.SuppressEntry("key2", "value2"));
+  EXPECT_TRUE(dic.SuppressEntry("key3", "value3"));
+  EXPECT_FALSE(dic.SuppressEntry("key1", "value1"));
+
+  dic.Lock();
+  dic.Clear();
+  dic.UnLock();
+  EXPECT_TRUE(dic.IsEmpty());
+  EXPECT_FALSE(dic.SuppressEntry("key2", "value2"));
+}
+
+TEST(SupressionDictionary, ManyEntriesTest) {
+  SuppressionDictionary dic;
+  dic.Lock();
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(dic.AddEntry("key" + NumberUtil::SimpleItoa(i),
+                             "value" + NumberUtil::SimpleItoa(i)));
+  }
+  dic.UnLock();
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(dic.SuppressEntry("key" + NumberUtil::SimpleItoa(i),
+                                  "value" + NumberUtil::SimpleItoa(i)));
+    EXPECT_FALSE(dic.SuppressEntry("key" + NumberUtil::SimpleItoa(i),
+                                   "value" + NumberUtil::SimpleItoa(i + 1)));
+  }
+}
+
 class DictionaryLoaderThread : public Thread {
  public:
   virtual void Run() {
@@ -144,6 +197,50 @@ TEST(SupressionDictionary, ThreadTest) {
   dic->UnLock();
 }
 
+// Looks up an entry which every reloaded dictionary has until stopped.
+class SuppressEntryThread : public Thread {
+ public:
+  explicit SuppressEntryThread(const SuppressionDictionary *dic)
+      : dic_(dic), stop_(false), num_misses_(0) {}
+
+  virtual void Run() {
+    while (!stop_.load()) {
+      if (!dic_->SuppressEntry("key", "value")) {
+        ++num_misses_;
+      }
+    }
+  }
+
+  void Stop() { stop_.store(true); }
+  int num_misses() const { return num_misses_; }
+
+ private:
+  const SuppressionDictionary *dic_;
+  std::atomic<bool> stop_;
+  int num_misses_;
+};
+
+TEST(SupressionDictionary, ReloadWhileSuppressing) {
+  SuppressionDictionary dic;
+  dic.Lock();
+  EXPECT_TRUE(dic.AddEntry("key", "value"));
+  dic.UnLock();
+
+  SuppressEntryThread thread(&dic);
+  thread.Start("SuppressionDictionaryTest");
+  // The replaced entries are deleted while the other thread reads them.
+  for (int i = 0; i < 1000; ++i) {
+    dic.Lock();
+    dic.Clear();
+    EXPECT_TRUE(dic.AddEntry("key", "value"));
+    EXPECT_TRUE(dic.AddEntry("key" + NumberUtil::SimpleItoa(i), "value"));
+    dic.UnLock();
+  }
+  thread.Stop();
+  thread.Join();
+  EXPECT_EQ(0, thread.num_misses());
+}
+
 }  // namespace
 }  // namespace dictionary
 }  // namespace mozc
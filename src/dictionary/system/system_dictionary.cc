@@ -57,6 +57,7 @@
 #include <vector>
 
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/mmap.h"
 #include "base/port.h"
 #include "base/string_piece.h"
@@ -299,6 +300,14 @@ class SystemDictionary::ReverseLookupCache {
     return true;
   }
 
+  // Returns an estimate of the heap memory held by |results|, counting each
+  // tree node as the value plus three links and the color.
+  size_t GetAllocatedBytes() const {
+    return results.size() *
+        (sizeof(std::multimap<int, ReverseLookupResult>::value_type) +
+         4 * sizeof(void *));
+  }
+
   std::multimap<int, ReverseLookupResult> results;
 
  private:
@@ -369,6 +378,14 @@ class SystemDictionary::ReverseLookupIndex {
 
   ~ReverseLookupIndex() {}
 
+  size_t GetAllocatedBytes() const {
+    size_t bytes = index_size_ * sizeof(ReverseLookupResultArray);
+    for (size_t i = 0; i < index_size_; ++i) {
+      bytes += index_[i].size * sizeof(ReverseLookupResult);
+    }
+    return bytes;
+  }
+
   void FillResultMap(const std::set<int> &id_set,
                      std::multimap<int, ReverseLookupResult> *result_map) {
     for (std::set<int>::const_iterator id_itr  = id_set.begin();
@@ -621,38 +638,42 @@ bool SystemDictionary::HasValue(StringPiece value) const {
   return false;
 }
 
-void SystemDictionary::CollectPredictiveNodesInBfsOrder(
-    StringPiece encoded_key,
+void SystemDictionary::MovePredictiveStates(
+    char target_char,
     const KeyExpansionTable &table,
+    const std::vector<PredictiveLookupSearchState> &states,
+    std::vector<PredictiveLookupSearchState> *next) const {
+  const ExpandedKey &chars = table.ExpandKey(target_char);
+  for (size_t i = 0; i < states.size(); ++i) {
+    PredictiveLookupSearchState state = states[i];
+    for (key_trie_.MoveToFirstChild(&state.node);
+         key_trie_.IsValidNode(state.node);
+         key_trie_.MoveToNextSibling(&state.node)) {
+      const char c = key_trie_.GetEdgeLabelToParentNode(state.node);
+      if (!chars.IsHit(c)) {
+        continue;
+      }
+      const bool is_expanded = state.is_expanded || c != target_char;
+      next->push_back(PredictiveLookupSearchState(state.node,
+                                                  state.key_pos + 1,
+                                                  is_expanded));
+    }
+  }
+}
+
+void SystemDictionary::CollectPredictiveNodesInBfsOrder(
+    const std::vector<PredictiveLookupSearchState> &key_end_states,
     size_t limit,
     std::vector<PredictiveLookupSearchState> *result) const {
   std::queue<PredictiveLookupSearchState> queue;
-  queue.push(PredictiveLookupSearchState(LoudsTrie::Node(), 0, false));
-  do {
+  for (size_t i = 0; i < key_end_states.size(); ++i) {
+    queue.push(key_end_states[i]);
+  }
+  while (!queue.empty()) {
     PredictiveLookupSearchState state = queue.front();
     queue.pop();
 
-    // Update traversal state for |encoded_key| and its expanded keys.
-    if (state.key_pos < encoded_key.size()) {
-      const char target_char = encoded_key[state.key_pos];
-      const ExpandedKey &chars = table.ExpandKey(target_char);
-
-      for (key_trie_.MoveToFirstChild(&state.node);
-           key_trie_.IsValidNode(state.node);
-           key_trie_.MoveToNextSibling(&state.node)) {
-        const char c = key_trie_.GetEdgeLabelToParentNode(state.node);
-        if (!chars.IsHit(c)) {
-          continue;
-        }
-        const bool is_expanded = state.is_expanded || c != target_char;
-        queue.push(PredictiveLookupSearchState(state.node,
-                                               state.key_pos + 1,
-                                               is_expanded));
-      }
-      continue;
-    }
-
-    // Collect prediction keys (state.key_pos >= encoded_key.size()).
+    // Collect prediction keys.
     if (key_trie_.IsTerminalNode(state.node)) {
       result->push_back(state);
     }
@@ -686,9 +707,25 @@ void SystemDictionary::CollectPredictiveNodesInBfsOrder(
                                              state.key_pos + 1,
                                              state.is_expanded));
     }
-  } while (!queue.empty());
+  }
+}
+
+const KeyExpansionTable &SystemDictionary::GetKeyExpansionTable(
+    const ConversionRequest &conversion_request) const {
+  return conversion_request.IsKanaModifierInsensitiveConversion() ?
+      hiragana_expansion_table_ : KeyExpansionTable::GetDefaultInstance();
 }
 
+namespace {
+
+// TODO(noriyukit): Lookup limit should be implemented at caller side by using
+// callback mechanism.  This hard-coding limits the capability and generality
+// of dictionary module.  CollectPredictiveNodesInBfsOrder() and the callback
+// loop should be integrated for this purpose.
+const size_t kPredictiveLookupLimit = 64;
+
+}  // namespace
+
 void SystemDictionary::LookupPredictive(
     StringPiece key,
     const ConversionRequest &conversion_request,
@@ -705,19 +742,100 @@ void SystemDictionary::LookupPredictive(
     return;
   }
 
-  const KeyExpansionTable &table =
-      conversion_request.IsKanaModifierInsensitiveConversion() ?
-      hiragana_expansion_table_ : KeyExpansionTable::GetDefaultInstance();
+  const KeyExpansionTable &table = GetKeyExpansionTable(conversion_request);
+  std::vector<PredictiveLookupSearchState> states, next;
+  states.push_back(PredictiveLookupSearchState(LoudsTrie::Node(), 0, false));
+  for (size_t i = 0; i < encoded_key.size() && !states.empty(); ++i) {
+    next.clear();
+    MovePredictiveStates(encoded_key[i], table, states, &next);
+    states.swap(next);
+  }
+
+  std::vector<PredictiveLookupSearchState> result;
+  result.reserve(kPredictiveLookupLimit);
+  CollectPredictiveNodesInBfsOrder(states, kPredictiveLookupLimit, &result);
+  RunPredictiveCallback(key, encoded_key.size(), result, callback);
+}
+
+void SystemDictionary::LookupPredictiveMulti(
+    const std::vector<StringPiece> &keys,
+    const ConversionRequest &conversion_request,
+    const std::vector<Callback *> &callbacks) const {
+  DCHECK_EQ(keys.size(), callbacks.size());
+  const KeyExpansionTable &table = GetKeyExpansionTable(conversion_request);
+
+  std::vector<string> encoded_keys(keys.size());
+  std::vector<size_t> order;
+  order.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    // Same as LookupPredictive(), empty and too long keys have no results.
+    if (keys[i].empty()) {
+      continue;
+    }
+    codec_->EncodeKey(keys[i], &encoded_keys[i]);
+    if (encoded_keys[i].size() > LoudsTrie::kMaxDepth) {
+      continue;
+    }
+    order.push_back(i);
+  }
+
+  // Visit the keys in lexicographic order so that each key shares the trie
+  // traversal with the previous one up to their longest common prefix.
+  // |prefix_states[d]| holds the states matching the first d characters of
+  // the previously visited key.
+  std::sort(order.begin(), order.end(),
+            [&encoded_keys](size_t lhs, size_t rhs) {
+              return encoded_keys[lhs] < encoded_keys[rhs];
+            });
+  std::vector<std::vector<PredictiveLookupSearchState>> prefix_states(1);
+  prefix_states[0].push_back(
+      PredictiveLookupSearchState(LoudsTrie::Node(), 0, false));
+  const string *prev_key = nullptr;
+  std::vector<std::vector<PredictiveLookupSearchState>> key_end_states(
+      keys.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    const string &encoded_key = encoded_keys[order[i]];
+    size_t depth = 0;
+    if (prev_key != nullptr) {
+      const size_t max_depth = min(prev_key->size(), encoded_key.size());
+      while (depth < max_depth && (*prev_key)[depth] == encoded_key[depth]) {
+        ++depth;
+      }
+    }
+    depth = min(depth, prefix_states.size() - 1);
+    prefix_states.resize(depth + 1);
+    for (; depth < encoded_key.size() && !prefix_states[depth].empty();
+         ++depth) {
+      prefix_states.push_back(std::vector<PredictiveLookupSearchState>());
+      MovePredictiveStates(encoded_key[depth], table, prefix_states[depth],
+                           &prefix_states[depth + 1]);
+    }
+    if (depth == encoded_key.size()) {
+      key_end_states[order[i]] = prefix_states[depth];
+    }
+    prev_key = &encoded_key;
+  }
 
-  // TODO(noriyukit): Lookup limit should be implemented at caller side by using
-  // callback mechanism.  This hard-coding limits the capability and generality
-  // of dictionary module.  CollectPredictiveNodesInBfsOrder() and the following
-  // loop for callback should be integrated for this purpose.
-  const size_t kLookupLimit = 64;
+  // Run the callbacks in the original order of |keys|.
   std::vector<PredictiveLookupSearchState> result;
-  result.reserve(kLookupLimit);
-  CollectPredictiveNodesInBfsOrder(encoded_key, table, kLookupLimit, &result);
+  result.reserve(kPredictiveLookupLimit);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (key_end_states[i].empty()) {
+      continue;
+    }
+    result.clear();
+    CollectPredictiveNodesInBfsOrder(key_end_states[i], kPredictiveLookupLimit,
+                                     &result);
+    RunPredictiveCallback(keys[i], encoded_keys[i].size(), result,
+                          callbacks[i]);
+  }
+}
 
+void SystemDictionary::RunPredictiveCallback(
+    StringPiece key,
+    size_t encoded_key_size,
+    const std::vector<PredictiveLookupSearchState> &result,
+    Callback *callback) const {
   // Reused buffer and instances inside the following loop.
   char encoded_actual_key_buffer[LoudsTrie::kMaxDepth + 1];
   string decoded_key, actual_key_str;
@@ -734,7 +852,7 @@ void SystemDictionary::LookupPredictive(
         key_trie_.RestoreKeyString(state.node, encoded_actual_key_buffer);
     const StringPiece encoded_actual_key_prediction_suffix =
         encoded_actual_key.substr(
-            encoded_key.size(), encoded_actual_key.size() - encoded_key.size());
+            encoded_key_size, encoded_actual_key.size() - encoded_key_size);
 
     // decoded_key = "くーぐる" (= key + prediction suffix)
     decoded_key.clear();
@@ -1110,6 +1228,20 @@ void SystemDictionary::ClearReverseLookupCache() const {
   reverse_lookup_cache_.reset();
 }
 
+void SystemDictionary::CollectMemoryUsage(MemoryUsage *usage) const {
+  usage->Add("key_trie", key_trie_.GetAllocatedBytes());
+  usage->Add("value_trie", value_trie_.GetAllocatedBytes());
+  usage->Add("token_array", token_array_.GetAllocatedBytes());
+  if (reverse_lookup_index_ != nullptr) {
+    usage->Add("reverse_lookup_index",
+               reverse_lookup_index_->GetAllocatedBytes());
+  }
+  if (reverse_lookup_cache_ != nullptr) {
+    usage->Add("reverse_lookup_cache",
+               reverse_lookup_cache_->GetAllocatedBytes());
+  }
+}
+
 namespace {
 
 class FilterTokenForRegisterReverseLookupTokensForT13N {
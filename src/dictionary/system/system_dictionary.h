@@ -108,6 +108,12 @@ class SystemDictionary : public DictionaryInterface {
                                 const ConversionRequest &converter_request,
                                 Callback *callback) const;
 
+  // Traverses the key trie once for the common prefixes of |keys|.
+  virtual void LookupPredictiveMulti(
+      const std::vector<StringPiece> &keys,
+      const ConversionRequest &converter_request,
+      const std::vector<Callback *> &callbacks) const;
+
   virtual void LookupPrefix(StringPiece key,
                             const ConversionRequest &converter_request,
                             Callback *callback) const;
@@ -123,6 +129,8 @@ class SystemDictionary : public DictionaryInterface {
   virtual void PopulateReverseLookupCache(StringPiece str) const;
   virtual void ClearReverseLookupCache() const;
 
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const;
+
  private:
   class ReverseLookupCache;
   class ReverseLookupIndex;
@@ -153,12 +161,34 @@ class SystemDictionary : public DictionaryInterface {
       char *actual_key_buffer,
       string *actual_prefix) const;
 
-  void CollectPredictiveNodesInBfsOrder(
-      StringPiece encoded_key,
+  // Advances every state in |states| by one key character, |target_char|, or
+  // one of its expansions in |table|, and appends the resulting states to
+  // |next| in BFS order.
+  void MovePredictiveStates(
+      char target_char,
       const KeyExpansionTable &table,
+      const std::vector<PredictiveLookupSearchState> &states,
+      std::vector<PredictiveLookupSearchState> *next) const;
+
+  // Collects terminal nodes under |key_end_states|, the states matching a
+  // whole encoded key, in BFS order.
+  void CollectPredictiveNodesInBfsOrder(
+      const std::vector<PredictiveLookupSearchState> &key_end_states,
       size_t limit,
       std::vector<PredictiveLookupSearchState> *result) const;
 
+  // Runs |callback| for the nodes collected by
+  // CollectPredictiveNodesInBfsOrder() for |key|.
+  void RunPredictiveCallback(
+      StringPiece key,
+      size_t encoded_key_size,
+      const std::vector<PredictiveLookupSearchState> &result,
+      Callback *callback) const;
+
+  // Returns the expansion table for |conversion_request|.
+  const KeyExpansionTable &GetKeyExpansionTable(
+      const ConversionRequest &conversion_request) const;
+
   storage::louds::LoudsTrie key_trie_;
   storage::louds::LoudsTrie value_trie_;
   storage::louds::BitVectorBasedArray token_array_;
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <climits>
+#include <cmath>
 #include <cstring>
 #include <sstream>
 #include <unordered_set>
@@ -54,6 +55,9 @@ DEFINE_bool(preserve_intermediate_dictionary, false,
             "preserve inetemediate dictionary file.");
 DEFINE_int32(min_key_length_to_use_small_cost_encoding, 6,
              "minimum key length to use 1 byte cost encoding.");
+DEFINE_bool(use_louds_tail_compression, false,
+            "store the tails of keys and values in nested tries to make the "
+            "dictionary smaller.");
 
 namespace mozc {
 namespace dictionary {
@@ -79,6 +83,13 @@ struct TokenGreaterThan {
   }
 };
 
+// Returns the relative frequency of the token estimated from its cost, which
+// is roughly -500 * log(probability). The louds tries are laid out with these
+// as weights so that the paths for frequent keys and values are found first.
+double GetTokenWeight(const Token &token) {
+  return exp(-token.cost / 500.0);
+}
+
 void WriteSectionToFile(const DictionaryFileSection &section,
                         const string &filename) {
   OutputFileStream ofs(filename.c_str(), std::ios::binary | std::ios::out);
@@ -321,6 +332,8 @@ void SystemDictionaryBuilder::BuildFrequentPos(
 
 
 void SystemDictionaryBuilder::BuildValueTrie(const KeyInfoList &key_info_list) {
+  value_trie_builder_->set_use_tail_compression(
+      FLAGS_use_louds_tail_compression);
   for (KeyInfoList::const_iterator itr = key_info_list.begin();
        itr != key_info_list.end(); ++itr) {
     const KeyInfo &key_info = *itr;
@@ -333,7 +346,7 @@ void SystemDictionaryBuilder::BuildValueTrie(const KeyInfoList &key_info_list) {
       }
       string value_str;
       codec_->EncodeValue(token_info.token->value, &value_str);
-      value_trie_builder_->Add(value_str);
+      value_trie_builder_->Add(value_str, GetTokenWeight(*token_info.token));
     }
   }
   value_trie_builder_->Build();
@@ -421,11 +434,16 @@ void SystemDictionaryBuilder::SetValueType(KeyInfoList *key_info_list) const {
 }
 
 void SystemDictionaryBuilder::BuildKeyTrie(const KeyInfoList &key_info_list) {
+  key_trie_builder_->set_use_tail_compression(FLAGS_use_louds_tail_compression);
   for (KeyInfoList::const_iterator itr = key_info_list.begin();
        itr != key_info_list.end(); ++itr) {
     string key_str;
     codec_->EncodeKey(itr->key, &key_str);
-    key_trie_builder_->Add(key_str);
+    double weight = 0;
+    for (size_t i = 0; i < itr->tokens.size(); ++i) {
+      weight += GetTokenWeight(*itr->tokens[i].token);
+    }
+    key_trie_builder_->Add(key_str, weight);
   }
   key_trie_builder_->Build();
 }
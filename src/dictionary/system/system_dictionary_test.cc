@@ -712,6 +712,59 @@ TEST_F(SystemDictionaryTest, LookupPredictive_CutOffEmulatingBFS) {
   EXPECT_FALSE(callback.IsFound(tokens[1]));
 }
 
+TEST_F(SystemDictionaryTest, LookupPredictiveMulti) {
+  std::vector<Token *> source_tokens;
+  ScopedElementsDeleter<std::vector<Token *>> deleter(&source_tokens);
+  text_dict_->CollectTokens(&source_tokens);
+  BuildSystemDictionary(source_tokens, 10000);
+  unique_ptr<SystemDictionary> system_dic(
+      SystemDictionary::Builder(dic_fn_).Build());
+  ASSERT_TRUE(system_dic.get() != NULL)
+      << "Failed to open dictionary source: " << dic_fn_;
+
+  // Keys sharing prefixes, in random order, with an empty key and a duplicate.
+  const char *kKeys[] = {
+      "\xe3\x81\x82\xe3\x81\x84",  // "あい"
+      "\xe3\x81\x8b",              // "か"
+      "\xe3\x81\x82",              // "あ"
+      "",
+      "\xe3\x81\x8b\xe3\x81\xa3\xe3\x81\x93",  // "かっこ"
+      "\xe3\x81\x82\xe3\x81\x84\xe3\x81\x86",  // "あいう"
+      "\xe3\x81\x82\xe3\x81\x84",  // "あい"
+      "\xe3\x81\x8b\xe3\x81\xa4\xe3\x81\x93",  // "かつこ"
+  };
+
+  for (int kana_modifier_insensitive = 0; kana_modifier_insensitive < 2;
+       ++kana_modifier_insensitive) {
+    request_.set_kana_modifier_insensitive_conversion(
+        kana_modifier_insensitive);
+    config_.set_use_kana_modifier_insensitive_conversion(
+        kana_modifier_insensitive);
+
+    std::vector<StringPiece> keys;
+    std::vector<unique_ptr<CollectTokenCallback>> callbacks;
+    std::vector<DictionaryInterface::Callback *> callback_ptrs;
+    for (size_t i = 0; i < arraysize(kKeys); ++i) {
+      keys.push_back(kKeys[i]);
+      callbacks.emplace_back(new CollectTokenCallback());
+      callback_ptrs.push_back(callbacks.back().get());
+    }
+    system_dic->LookupPredictiveMulti(keys, convreq_, callback_ptrs);
+
+    // The results should be the same as those of LookupPredictive().
+    for (size_t i = 0; i < arraysize(kKeys); ++i) {
+      CollectTokenCallback expected;
+      system_dic->LookupPredictive(kKeys[i], convreq_, &expected);
+      const std::vector<Token> &actual = callbacks[i]->tokens();
+      ASSERT_EQ(expected.tokens().size(), actual.size()) << kKeys[i];
+      for (size_t j = 0; j < actual.size(); ++j) {
+        EXPECT_EQ(expected.tokens()[j].key, actual[j].key);
+        EXPECT_EQ(expected.tokens()[j].value, actual[j].value);
+      }
+    }
+  }
+}
+
 TEST_F(SystemDictionaryTest, LookupExact) {
   std::vector<Token *> source_tokens;
 
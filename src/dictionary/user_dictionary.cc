@@ -39,6 +39,7 @@
 #include "base/file_util.h"
 #include "base/hash.h"
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/mutex.h"
 #include "base/singleton.h"
 #include "base/stl_util.h"
@@ -137,6 +138,15 @@ class UserDictionary::TokensIndex : public std::vector<UserPOS::Token *> {
     clear();
   }
 
+  size_t GetAllocatedBytes() const {
+    size_t bytes = capacity() * sizeof(UserPOS::Token *);
+    for (const UserPOS::Token *token : *this) {
+      bytes += sizeof(*token) + token->key.capacity() +
+          token->value.capacity() + token->comment.capacity();
+    }
+    return bytes;
+  }
+
   void Load(const user_dictionary::UserDictionaryStorage &storage) {
     Clear();
     std::set<uint64> seen;
@@ -517,6 +527,11 @@ bool UserDictionary::Reload() {
   return true;
 }
 
+void UserDictionary::CollectMemoryUsage(MemoryUsage *usage) const {
+  scoped_reader_lock l(mutex_.get());
+  usage->Add("tokens_index", tokens_->GetAllocatedBytes());
+}
+
 namespace {
 
 class FindValueCallback : public DictionaryInterface::Callback {
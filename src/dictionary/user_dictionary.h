@@ -87,6 +87,8 @@ class UserDictionary : public DictionaryInterface {
   // Reloads dictionary asynchronously
   bool Reload() override;
 
+  void CollectMemoryUsage(MemoryUsage *usage) const override;
+
   // Waits until reloader finishes
   void WaitForReloader();
 
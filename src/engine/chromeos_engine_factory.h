@@ -30,8 +30,11 @@
 #ifndef MOZC_ENGINE_CHROMEOS_ENGINE_FACTORY_H_
 #define MOZC_ENGINE_CHROMEOS_ENGINE_FACTORY_H_
 
+#include <memory>
+
 #include "data_manager/chromeos/chromeos_data_manager.h"
 #include "engine/engine.h"
+#include "engine/minimal_engine.h"
 
 namespace mozc {
 
@@ -46,6 +49,14 @@ class ChromeOsEngineFactory {
     return Engine::CreateDesktopEngineHelper<chromeos::ChromeOsDataManager>()
         .release();
   }
+
+  // Creates an instance of MinimalEngine with the same data set. It is cheap
+  // to create and can serve the sessions while Create() is running. The
+  // caller is responsible for deleting the returned object.
+  static MinimalEngine *CreateMinimal() {
+    return new MinimalEngine(std::unique_ptr<const DataManagerInterface>(
+        new chromeos::ChromeOsDataManager()));
+  }
 };
 
 }  // namespace mozc
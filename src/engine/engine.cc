@@ -32,6 +32,7 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/port.h"
 #include "converter/connector.h"
 #include "converter/converter.h"
@@ -87,6 +88,7 @@ class UserDataManagerImpl final : public UserDataManagerInterface {
   bool ClearUserPredictionEntry(
       const string &key, const string &value) override;
   bool Wait() override;
+  bool Retire() override;
 
  private:
   PredictorInterface *predictor_;
@@ -133,6 +135,13 @@ bool UserDataManagerImpl::Wait() {
   return predictor_->Wait();
 }
 
+bool UserDataManagerImpl::Retire() {
+  // The storages of the rewriters are mapped from the files, so the writes
+  // are shared with the newer engine.
+  const bool rewriter_synced = rewriter_->Sync();
+  return predictor_->Retire() && rewriter_synced;
+}
+
 }  // namespace
 
 std::unique_ptr<Engine> Engine::CreateDesktopEngine(
@@ -292,4 +301,26 @@ bool Engine::Reload() {
   return user_dictionary_->Reload();
 }
 
+void Engine::CollectMemoryUsage(MemoryUsage *usage) const {
+  if (connector_ != nullptr) {
+    usage->Add("connector", connector_->GetAllocatedBytes());
+  }
+  if (dictionary_ != nullptr) {
+    MemoryUsage::Scope scope(usage, "dictionary");
+    dictionary_->CollectMemoryUsage(usage);
+  }
+  if (suffix_dictionary_ != nullptr) {
+    MemoryUsage::Scope scope(usage, "suffix_dictionary");
+    suffix_dictionary_->CollectMemoryUsage(usage);
+  }
+  if (predictor_ != nullptr) {
+    MemoryUsage::Scope scope(usage, "predictor");
+    predictor_->CollectMemoryUsage(usage);
+  }
+  if (rewriter_ != nullptr) {
+    MemoryUsage::Scope scope(usage, "rewriter");
+    rewriter_->CollectMemoryUsage(usage);
+  }
+}
+
 }  // namespace mozc
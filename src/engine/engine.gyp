@@ -73,6 +73,30 @@
         '../rewriter/rewriter.gyp:rewriter',
       ],
     },
+    {
+      'target_name': 'engine_loader',
+      'type': 'static_library',
+      'sources': [
+        'engine_loader.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+      ],
+    },
+    {
+      'target_name': 'minimal_engine',
+      'type': 'static_library',
+      'sources': [
+        'minimal_engine.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../composer/composer.gyp:composer',
+        '../converter/converter_base.gyp:segments',
+        '../dictionary/dictionary_base.gyp:suppression_dictionary',
+        '../request/request.gyp:conversion_request',
+      ],
+    },
     {
       'target_name': 'mock_converter_engine',
       'type': 'static_library',
@@ -93,6 +117,7 @@
         '../data_manager/oss/oss_data_manager.gyp:oss_data_manager',
         '../prediction/prediction.gyp:prediction',
         'engine',
+        'minimal_engine',
       ],
     },
     {
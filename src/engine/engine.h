@@ -111,6 +111,8 @@ class Engine : public EngineInterface {
     return data_manager_.get();
   }
 
+  void CollectMemoryUsage(MemoryUsage *usage) const override;
+
  private:
   // Initializes the object by the given data manager and predictor factory
   // function.  Predictor factory is used to select DefaultPredictor and
@@ -38,6 +38,7 @@
 namespace mozc {
 
 class ConverterInterface;
+class MemoryUsage;
 class PredictorInterface;
 class UserDataManagerInterface;
 
@@ -73,6 +74,9 @@ class EngineInterface {
   // Gets the data manager.
   virtual const DataManagerInterface *GetDataManager() const = 0;
 
+  // Reports the heap memory held by the modules to |usage|.
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const {}
+
  protected:
   EngineInterface() {}
 
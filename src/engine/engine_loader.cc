@@ -0,0 +1,98 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "engine/engine_loader.h"
+
+#include <atomic>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/thread.h"
+
+namespace mozc {
+
+class EngineLoader::Loader : public Thread {
+ public:
+  explicit Loader(FactoryFunction factory)
+      : factory_(factory), started_(false), ready_(false) {}
+  ~Loader() override = default;
+
+  void Run() override {
+    engine_.reset(factory_());
+    LOG_IF(ERROR, !engine_) << "Failed to build the engine";
+    // Publishes |engine_| to the thread calling IsReady().
+    ready_.store(engine_ != nullptr, std::memory_order_release);
+  }
+
+ private:
+  friend class EngineLoader;
+  const FactoryFunction factory_;
+  std::unique_ptr<EngineInterface> engine_;
+  // True from StartLoading() until Release().  Accessed only by the owner
+  // thread of EngineLoader.
+  bool started_;
+  // True after |engine_| is built.
+  std::atomic<bool> ready_;
+};
+
+EngineLoader::EngineLoader(FactoryFunction factory)
+    : loader_(new Loader(factory)) {
+  DCHECK(factory);
+}
+
+EngineLoader::~EngineLoader() {
+  // The factory may be still running.
+  loader_->Join();
+}
+
+void EngineLoader::StartLoading() {
+  if (loader_->started_) {
+    return;
+  }
+  loader_->started_ = true;
+  loader_->SetJoinable(true);
+  loader_->Start("EngineLoader");
+}
+
+bool EngineLoader::IsReady() const {
+  return loader_->ready_.load(std::memory_order_acquire);
+}
+
+std::unique_ptr<EngineInterface> EngineLoader::Release() {
+  if (!loader_->started_) {
+    return nullptr;
+  }
+  loader_->Join();
+  loader_->started_ = false;
+  loader_->ready_.store(false, std::memory_order_relaxed);
+  return std::move(loader_->engine_);
+}
+
+}  // namespace mozc
@@ -0,0 +1,78 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef MOZC_ENGINE_ENGINE_LOADER_H_
+#define MOZC_ENGINE_ENGINE_LOADER_H_
+
+#include <memory>
+
+#include "base/port.h"
+#include "engine/engine_interface.h"
+
+namespace mozc {
+
+// Builds an engine in a background thread so that the caller can keep
+// serving requests, e.g., with MinimalEngine, while the data is loaded.
+// Usage:
+//   EngineLoader loader(&CreateEngine);
+//   loader.StartLoading();
+//   ...
+//   if (loader.IsReady()) {
+//     std::unique_ptr<EngineInterface> engine = loader.Release();
+//   }
+class EngineLoader {
+ public:
+  // Creates an engine. The caller is responsible for deleting it.
+  typedef EngineInterface *(*FactoryFunction)();
+
+  explicit EngineLoader(FactoryFunction factory);
+  ~EngineLoader();
+
+  // Starts building the engine. Does nothing while the engine is being
+  // built or is ready.
+  void StartLoading();
+
+  // Returns true if the engine is built and not released yet.
+  bool IsReady() const;
+
+  // Waits for the engine to be built and returns it. Returns nullptr if
+  // loading is not started or the engine is already released.
+  std::unique_ptr<EngineInterface> Release();
+
+ private:
+  class Loader;
+  std::unique_ptr<Loader> loader_;
+
+  DISALLOW_COPY_AND_ASSIGN(EngineLoader);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_ENGINE_ENGINE_LOADER_H_
@@ -0,0 +1,275 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "engine/minimal_engine.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/logging.h"
+#include "composer/composer.h"
+#include "converter/converter_interface.h"
+#include "converter/segments.h"
+#include "engine/user_data_manager_interface.h"
+#include "prediction/predictor_interface.h"
+#include "request/conversion_request.h"
+
+namespace mozc {
+namespace {
+
+// Sets |key| to a new conversion segment whose only candidate is |key|.
+bool AddAsIsSegment(const string &key, Segments *segments) {
+  if (key.empty()) {
+    return false;
+  }
+  segments->clear_conversion_segments();
+  Segment *segment = segments->add_segment();
+  DCHECK(segment);
+  segment->set_key(key);
+  Segment::Candidate *candidate = segment->add_candidate();
+  DCHECK(candidate);
+  candidate->Init();
+  candidate->key = key;
+  candidate->value = key;
+  candidate->content_key = key;
+  candidate->content_value = key;
+  candidate->attributes |= Segment::Candidate::NO_LEARNING;
+  return true;
+}
+
+class MinimalConverter : public ConverterInterface {
+ public:
+  MinimalConverter() = default;
+  ~MinimalConverter() override = default;
+
+  bool StartConversionForRequest(const ConversionRequest &request,
+                                 Segments *segments) const override {
+    if (!request.has_composer()) {
+      return false;
+    }
+    string key;
+    request.composer().GetQueryForConversion(&key);
+    segments->set_request_type(Segments::CONVERSION);
+    return AddAsIsSegment(key, segments);
+  }
+
+  bool StartConversion(Segments *segments,
+                       const string &key) const override {
+    segments->set_request_type(Segments::CONVERSION);
+    return AddAsIsSegment(key, segments);
+  }
+
+  bool StartReverseConversion(Segments *segments,
+                              const string &key) const override {
+    return false;
+  }
+
+  bool StartPredictionForRequest(const ConversionRequest &request,
+                                 Segments *segments) const override {
+    return false;
+  }
+
+  bool StartPrediction(Segments *segments,
+                       const string &key) const override {
+    return false;
+  }
+
+  bool StartSuggestionForRequest(const ConversionRequest &request,
+                                 Segments *segments) const override {
+    return false;
+  }
+
+  bool StartSuggestion(Segments *segments,
+                       const string &key) const override {
+    return false;
+  }
+
+  bool StartPartialPredictionForRequest(
+      const ConversionRequest &request, Segments *segments) const override {
+    return false;
+  }
+
+  bool StartPartialPrediction(Segments *segments,
+                              const string &key) const override {
+    return false;
+  }
+
+  bool StartPartialSuggestionForRequest(
+      const ConversionRequest &request, Segments *segments) const override {
+    return false;
+  }
+
+  bool StartPartialSuggestion(Segments *segments,
+                              const string &key) const override {
+    return false;
+  }
+
+  bool FinishConversion(const ConversionRequest &request,
+                        Segments *segments) const override {
+    // Nothing is learned, so the context is not kept either.
+    segments->Clear();
+    return true;
+  }
+
+  bool CancelConversion(Segments *segments) const override {
+    segments->clear_conversion_segments();
+    return true;
+  }
+
+  bool ResetConversion(Segments *segments) const override {
+    segments->Clear();
+    return true;
+  }
+
+  bool RevertConversion(Segments *segments) const override {
+    segments->clear_revert_entries();
+    return true;
+  }
+
+  bool ReconstructHistory(Segments *segments,
+                          const string &preceding_text) const override {
+    return false;
+  }
+
+  bool CommitSegmentValue(Segments *segments,
+                          size_t segment_index,
+                          int candidate_index) const override {
+    if (segment_index >= segments->conversion_segments_size() ||
+        candidate_index != 0) {
+      return false;
+    }
+    segments->mutable_conversion_segment(segment_index)->set_segment_type(
+        Segment::FIXED_VALUE);
+    return true;
+  }
+
+  bool CommitPartialSuggestionSegmentValue(
+      Segments *segments,
+      size_t segment_index,
+      int candidate_index,
+      const string &current_segment_key,
+      const string &new_segment_key) const override {
+    return false;
+  }
+
+  bool FocusSegmentValue(Segments *segments,
+                         size_t segment_index,
+                         int candidate_index) const override {
+    return true;
+  }
+
+  bool FreeSegmentValue(Segments *segments,
+                        size_t segment_index) const override {
+    return true;
+  }
+
+  bool CommitSegments(
+      Segments *segments,
+      const std::vector<size_t> &candidate_index) const override {
+    return false;
+  }
+
+  bool ResizeSegment(Segments *segments,
+                     const ConversionRequest &request,
+                     size_t segment_index,
+                     int offset_length) const override {
+    return false;
+  }
+
+  bool ResizeSegment(Segments *segments,
+                     const ConversionRequest &request,
+                     size_t start_segment_index,
+                     size_t segments_size,
+                     const uint8 *new_size_array,
+                     size_t array_size) const override {
+    return false;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(MinimalConverter);
+};
+
+class MinimalPredictor : public PredictorInterface {
+ public:
+  MinimalPredictor() : name_("MinimalPredictor") {}
+  ~MinimalPredictor() override = default;
+
+  bool PredictForRequest(const ConversionRequest &request,
+                         Segments *segments) const override {
+    return false;
+  }
+
+  const string &GetPredictorName() const override { return name_; }
+
+ private:
+  const string name_;
+
+  DISALLOW_COPY_AND_ASSIGN(MinimalPredictor);
+};
+
+// Keeps no user data. The user data is loaded by the full Engine.
+class MinimalUserDataManager : public UserDataManagerInterface {
+ public:
+  MinimalUserDataManager() = default;
+  ~MinimalUserDataManager() override = default;
+
+  bool Sync() override { return true; }
+  bool Reload() override { return true; }
+  // Nothing is cleared.  See SessionHandler::ClearUserData().
+  bool ClearUserHistory() override { return false; }
+  bool ClearUserPrediction() override { return false; }
+  bool ClearUnusedUserPrediction() override { return false; }
+  bool ClearUserPredictionEntry(const string &key,
+                                const string &value) override {
+    return false;
+  }
+  bool Wait() override { return true; }
+  bool Retire() override { return true; }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(MinimalUserDataManager);
+};
+
+}  // namespace
+
+MinimalEngine::MinimalEngine(
+    std::unique_ptr<const DataManagerInterface> data_manager)
+    : data_manager_(std::move(data_manager)),
+      suppression_dictionary_(new dictionary::SuppressionDictionary),
+      converter_(new MinimalConverter),
+      predictor_(new MinimalPredictor),
+      user_data_manager_(new MinimalUserDataManager) {
+  CHECK(data_manager_);
+}
+
+MinimalEngine::~MinimalEngine() = default;
+
+}  // namespace mozc
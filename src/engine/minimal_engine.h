@@ -0,0 +1,93 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// An engine without dictionaries. It serves the sessions with composition
+// and direct input while the full Engine is being built, e.g., right after
+// the server starts.
+
+#ifndef MOZC_ENGINE_MINIMAL_ENGINE_H_
+#define MOZC_ENGINE_MINIMAL_ENGINE_H_
+
+#include <memory>
+
+#include "base/port.h"
+#include "base/string_piece.h"
+#include "data_manager/data_manager_interface.h"
+#include "dictionary/suppression_dictionary.h"
+#include "engine/engine_interface.h"
+
+namespace mozc {
+
+class ConverterInterface;
+class PredictorInterface;
+class UserDataManagerInterface;
+
+// The converter of this engine returns the reading as the only candidate and
+// the predictor returns no candidates. The data manager is used only for the
+// composition tables.
+class MinimalEngine : public EngineInterface {
+ public:
+  explicit MinimalEngine(
+      std::unique_ptr<const DataManagerInterface> data_manager);
+  ~MinimalEngine() override;
+
+  ConverterInterface *GetConverter() const override {
+    return converter_.get();
+  }
+  PredictorInterface *GetPredictor() const override {
+    return predictor_.get();
+  }
+  dictionary::SuppressionDictionary *GetSuppressionDictionary() override {
+    return suppression_dictionary_.get();
+  }
+  bool Reload() override { return true; }
+  UserDataManagerInterface *GetUserDataManager() override {
+    return user_data_manager_.get();
+  }
+  StringPiece GetDataVersion() const override {
+    return data_manager_->GetDataVersion();
+  }
+  const DataManagerInterface *GetDataManager() const override {
+    return data_manager_.get();
+  }
+
+ private:
+  std::unique_ptr<const DataManagerInterface> data_manager_;
+  std::unique_ptr<dictionary::SuppressionDictionary> suppression_dictionary_;
+  std::unique_ptr<ConverterInterface> converter_;
+  std::unique_ptr<PredictorInterface> predictor_;
+  std::unique_ptr<UserDataManagerInterface> user_data_manager_;
+
+  DISALLOW_COPY_AND_ASSIGN(MinimalEngine);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_ENGINE_MINIMAL_ENGINE_H_
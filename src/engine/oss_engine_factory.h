@@ -30,8 +30,11 @@
 #ifndef MOZC_ENGINE_OSS_ENGINE_FACTORY_H_
 #define MOZC_ENGINE_OSS_ENGINE_FACTORY_H_
 
+#include <memory>
+
 #include "data_manager/oss/oss_data_manager.h"
 #include "engine/engine.h"
+#include "engine/minimal_engine.h"
 
 namespace mozc {
 
@@ -44,6 +47,14 @@ class OssEngineFactory {
   static Engine *Create() {
     return Engine::CreateMobileEngineHelper<oss::OssDataManager>().release();
   }
+
+  // Creates an instance of MinimalEngine with the same data set. It is cheap
+  // to create and can serve the sessions while Create() is running. The
+  // caller is responsible for deleting the returned object.
+  static MinimalEngine *CreateMinimal() {
+    return new MinimalEngine(std::unique_ptr<const DataManagerInterface>(
+        new oss::OssDataManager()));
+  }
 };
 
 }  // namespace mozc
@@ -63,6 +63,12 @@ class UserDataManagerInterface {
 
   // Waits for syncer thread to complete.
   virtual bool Wait() = 0;
+
+  // Saves mutable user data to local file system, waiting for the
+  // completion, and stops saving it afterwards.  Called off the request path
+  // when a retired engine is released; the newer engine then merges the saved
+  // data with Reload().
+  virtual bool Retire() = 0;
 };
 
 }  // namespace mozc
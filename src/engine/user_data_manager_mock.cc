@@ -73,6 +73,11 @@ bool UserDataManagerMock::Wait() {
   return true;
 }
 
+bool UserDataManagerMock::Retire() {
+  function_counters_["Retire"]++;
+  return true;
+}
+
 int UserDataManagerMock::GetFunctionCallCount(const string &name) {
   return function_counters_[name];
 }
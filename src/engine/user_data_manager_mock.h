@@ -54,6 +54,7 @@ class UserDataManagerMock : public UserDataManagerInterface {
   bool ClearUserPredictionEntry(const string &key,
                                 const string &value) override;
   bool Wait() override;
+  bool Retire() override;
 
   int GetFunctionCallCount(const string &name);
 
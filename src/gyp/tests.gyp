@@ -47,6 +47,7 @@
         '../ipc/ipc.gyp:ipc_all_test',
         '../net/net_test.gyp:net_all_test',
         '../prediction/prediction_test.gyp:prediction_all_test',
+        '../protocol/protocol_test.gyp:protocol_all_test',
         '../renderer/renderer.gyp:renderer_all_test',
         '../rewriter/rewriter_test.gyp:rewriter_all_test',
         # Currently 'server_all_test' does not exist.
@@ -85,9 +85,36 @@ void IPCServer::Wait() {
   }
 }
 
+bool IPCServer::ProcessRequest(const char *request,
+                               size_t request_size,
+                               string *response) {
+  // Process() writes to a fixed-size buffer.  The buffer is allocated once
+  // and left uninitialized, and only the bytes written are copied.
+  if (process_buffer_.get() == NULL) {
+    process_buffer_.reset(new char[IPC_RESPONSESIZE]);
+  }
+  size_t response_size = IPC_RESPONSESIZE;
+  const bool result =
+      Process(request, request_size, process_buffer_.get(), &response_size);
+  response->assign(process_buffer_.get(), response_size);
+  return result;
+}
+
 IPCClientInterface::~IPCClientInterface() {
 }
 
+bool IPCClientInterface::CallWithGrowableBuffer(const char *request,
+                                                size_t request_size,
+                                                string *buffer,
+                                                size_t *response_size,
+                                                int32 timeout) {
+  if (buffer->size() < IPC_MAX_FIXED_RESPONSESIZE) {
+    buffer->resize(IPC_MAX_FIXED_RESPONSESIZE);
+  }
+  *response_size = buffer->size();
+  return Call(request, request_size, &(*buffer)[0], response_size, timeout);
+}
+
 IPCClientFactoryInterface::~IPCClientFactoryInterface() {
 }
 
@@ -45,9 +45,15 @@ namespace mozc {
 class IPCPathManager;
 class Thread;
 
+// IPC_RESPONSESIZE is the initial size of the response buffer of
+// IPCServer.  See IPCServer::ProcessRequest().
+// IPC_MAX_FIXED_RESPONSESIZE is the maximum size of the response received by
+// IPCClientInterface::CallWithGrowableBuffer() on the platforms whose clients
+// cannot grow the buffer, i.e. other than Linux.
 enum {
   IPC_REQUESTSIZE = 16 * 8192,
   IPC_RESPONSESIZE = 16 * 8192,
+  IPC_MAX_FIXED_RESPONSESIZE = 32 * 8192,
 };
 
 // increment this value if protocol has changed.
@@ -78,6 +84,17 @@ class IPCClientInterface {
                     size_t *response_size,
                     int32 timeout) = 0;
 
+  // Same as Call(), but the response is received to |buffer|, which grows
+  // to the size of the response, and its size is stored to |response_size|.
+  // |buffer| never shrinks so that the caller can reuse it across calls.
+  // The default implementation receives at most IPC_MAX_FIXED_RESPONSESIZE
+  // bytes with Call().
+  virtual bool CallWithGrowableBuffer(const char *request,
+                                      size_t request_size,
+                                      string *buffer,
+                                      size_t *response_size,
+                                      int32 timeout);
+
   virtual uint32 GetServerProtocolVersion() const = 0;
   virtual const string &GetServerProductVersion() const = 0;
   virtual uint32 GetServerProcessId() const = 0;
@@ -154,6 +171,15 @@ class IPCClient : public IPCClientInterface {
             size_t *response_size,
             int32 timeout);  // msec
 
+#if !defined(OS_WIN) && !defined(OS_MACOSX)
+  // Receives the whole response however large it is.
+  bool CallWithGrowableBuffer(const char *request,
+                              size_t request_size,
+                              string *buffer,
+                              size_t *response_size,
+                              int32 timeout);  // msec
+#endif  // !OS_WIN && !OS_MACOSX
+
   IPCErrorType GetLastIPCError() const {
     return last_ipc_error_;
   }
@@ -252,6 +278,14 @@ class IPCServer {
                        char *response,
                        size_t *response_size) = 0;
 
+  // Same as Process(), but the response is written to |response|, which can
+  // grow beyond IPC_RESPONSESIZE.  |response| is reused across requests so
+  // that the server can serialize its output directly into it.  The default
+  // implementation calls Process() with a buffer of IPC_RESPONSESIZE.
+  virtual bool ProcessRequest(const char *request,
+                              size_t request_size,
+                              string *response);
+
   // Start select loop. It goes into infinite loop.
   void Loop();
 
@@ -276,7 +310,9 @@ class IPCServer {
 
  private:
   char request_[IPC_REQUESTSIZE];
-  char response_[IPC_RESPONSESIZE];
+  string response_;
+  // Buffer given to Process() by the default ProcessRequest().
+  std::unique_ptr<char[]> process_buffer_;
   bool connected_;
   std::unique_ptr<Thread> server_thread_;
 
@@ -30,6 +30,7 @@
 #include "ipc/ipc.h"
 
 #include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "base/flags.h"
@@ -121,6 +122,40 @@ class EchoServer: public mozc::IPCServer {
     return true;
   }
 };
+
+// Returns a response larger than IPC_RESPONSESIZE.
+const size_t kLargeResponseSize = mozc::IPC_RESPONSESIZE + 1024;
+
+class LargeResponseServer: public mozc::IPCServer {
+ public:
+  LargeResponseServer(const string &path,
+                      int32 num_connections,
+                      int32 timeout,
+                      size_t response_size) :
+      IPCServer(path, num_connections, timeout),
+      response_size_(response_size) {}
+  virtual bool Process(const char *input_buffer,
+                       size_t input_length,
+                       char *output_buffer,
+                       size_t *output_length) {
+    // Not used since ProcessRequest() is overridden.
+    *output_length = 0;
+    return false;
+  }
+  virtual bool ProcessRequest(const char *request,
+                              size_t request_size,
+                              string *response) {
+    if (::memcmp("kill", request, 4) == 0) {
+      response->clear();
+      return false;
+    }
+    response->assign(response_size_, request[0]);
+    return true;
+  }
+
+ private:
+  const size_t response_size_;
+};
 }  // namespace
 
 TEST(IPCTest, IPCTest) {
@@ -168,3 +203,70 @@ TEST(IPCTest, IPCTest) {
 
   con.Wait();
 }
+
+TEST(IPCTest, LargeResponseTest) {
+  mozc::SystemUtil::SetUserProfileDirectory(FLAGS_test_tmpdir);
+#ifdef OS_MACOSX
+  mozc::TestMachPortManager manager;
+#endif
+
+  LargeResponseServer server(kServerAddress, 10, 1000, kLargeResponseSize);
+#ifdef OS_MACOSX
+  server.SetMachPortManager(&manager);
+#endif
+  server.LoopAndReturn();
+
+  std::unique_ptr<char[]> buf(new char[kLargeResponseSize]);
+  for (int i = 0; i < 2; ++i) {
+    mozc::IPCClient con(kServerAddress, "");
+#ifdef OS_MACOSX
+    con.SetMachPortManager(&manager);
+#endif
+    ASSERT_TRUE(con.Connected());
+    const string input(1, static_cast<char>('a' + i));
+    size_t length = kLargeResponseSize;
+    ASSERT_TRUE(con.Call(input.data(), input.size(), buf.get(), &length,
+                         1000));
+    EXPECT_EQ(string(kLargeResponseSize, input[0]), string(buf.get(), length));
+  }
+
+  mozc::IPCClient kill(kServerAddress, "");
+  const char kill_cmd[32] = "kill";
+  char output[32];
+  size_t output_size = sizeof(output);
+#ifdef OS_MACOSX
+  kill.SetMachPortManager(&manager);
+#endif
+  kill.Call(kill_cmd, strlen(kill_cmd), output, &output_size, 1000);
+
+  server.Wait();
+}
+
+#if defined(OS_LINUX)
+// The client grows its buffer beyond IPC_MAX_FIXED_RESPONSESIZE.
+TEST(IPCTest, GrowableBufferTest) {
+  mozc::SystemUtil::SetUserProfileDirectory(FLAGS_test_tmpdir);
+  const size_t kResponseSize = mozc::IPC_MAX_FIXED_RESPONSESIZE * 3 + 1;
+  LargeResponseServer server(kServerAddress, 10, 1000, kResponseSize);
+  server.LoopAndReturn();
+
+  string buffer;
+  for (int i = 0; i < 2; ++i) {
+    mozc::IPCClient con(kServerAddress, "");
+    ASSERT_TRUE(con.Connected());
+    const string input(1, static_cast<char>('a' + i));
+    size_t length = 0;
+    ASSERT_TRUE(con.CallWithGrowableBuffer(input.data(), input.size(),
+                                           &buffer, &length, 1000));
+    EXPECT_EQ(string(kResponseSize, input[0]), buffer.substr(0, length));
+  }
+
+  mozc::IPCClient kill(kServerAddress, "");
+  const char kill_cmd[32] = "kill";
+  char output[32];
+  size_t output_size = sizeof(output);
+  kill.Call(kill_cmd, strlen(kill_cmd), output, &output_size, 1000);
+
+  server.Wait();
+}
+#endif  // OS_LINUX
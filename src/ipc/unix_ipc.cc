@@ -208,6 +208,40 @@ bool RecvMessage(int socket,
   return true;
 }
 
+// Same as RecvMessage(), but |buf| grows until the peer closes the socket.
+bool RecvGrowableMessage(int socket,
+                         string *buf,
+                         size_t *buf_length,
+                         int timeout,
+                         IPCErrorType *last_ipc_error) {
+  if (buf->size() < IPC_RESPONSESIZE) {
+    buf->resize(IPC_RESPONSESIZE);
+  }
+  ssize_t read_length = 0;
+  *buf_length = 0;
+  do {
+    if (*buf_length == buf->size()) {
+      buf->resize(buf->size() * 2);
+    }
+    if (IsReadTimeout(socket, timeout)) {
+      LOG(WARNING) << "Read timeout " << timeout;
+      *last_ipc_error = IPC_TIMEOUT_ERROR;
+      return false;
+    }
+    read_length = ::recv(socket, &(*buf)[*buf_length],
+                         buf->size() - *buf_length, 0);
+    if (read_length < 0) {
+      LOG(ERROR) << "an error occurred during recv(): " << strerror(errno);
+      *buf_length = 0;
+      *last_ipc_error = IPC_READ_ERROR;
+      return false;
+    }
+    *buf_length += read_length;
+  } while (read_length != 0);
+  VLOG(1) << *buf_length << " bytes received";
+  return true;
+}
+
 void SetCloseOnExecFlag(int fd) {
   int flags = ::fcntl(fd, F_GETFD, 0);
   if (flags < 0) {
@@ -348,6 +382,29 @@ bool IPCClient::Call(const char *request_,
   return true;
 }
 
+bool IPCClient::CallWithGrowableBuffer(const char *request,
+                                       size_t request_size,
+                                       string *buffer,
+                                       size_t *response_size,
+                                       int32 timeout) {
+  last_ipc_error_ = IPC_NO_ERROR;
+  if (!SendMessage(socket_, request, request_size, timeout,
+                   &last_ipc_error_)) {
+    LOG(ERROR) << "SendMessage failed";
+    return false;
+  }
+  // See Call() for the half-close.
+  ::shutdown(socket_, SHUT_WR);
+
+  if (!RecvGrowableMessage(socket_, buffer, response_size, timeout,
+                           &last_ipc_error_)) {
+    LOG(ERROR) << "RecvGrowableMessage failed";
+    return false;
+  }
+  VLOG(1) << "Call succeeded";
+  return true;
+}
+
 bool IPCClient::Connected() const {
   return connected_;
 }
@@ -457,19 +514,17 @@ void IPCServer::Loop() {
       continue;
     }
     size_t request_size = sizeof(request_);
-    size_t response_size = sizeof(response_);
     if (RecvMessage(new_sock,
                     &request_[0],
                     &request_size, timeout_, &last_ipc_error)) {
-      if (!Process(&request_[0], request_size,
-                   &response_[0], &response_size)) {
+      if (!ProcessRequest(&request_[0], request_size, &response_)) {
         LOG(WARNING) << "Process() failed";
         error = true;
       }
-      if (response_size > 0) {
+      if (!response_.empty()) {
         SendMessage(new_sock,
-                    &response_[0],
-                    response_size, timeout_, &last_ipc_error);
+                    response_.data(),
+                    response_.size(), timeout_, &last_ipc_error);
       }
     }
 
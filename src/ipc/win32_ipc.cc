@@ -496,7 +496,7 @@ IPCServer::IPCServer(const string &name,
                                      ? PIPE_UNLIMITED_INSTANCES
                                      : num_connections),
                                     sizeof(request_),
-                                    sizeof(response_),
+                                    IPC_RESPONSESIZE,
                                     0,
                                     &security_attributes);
   const DWORD create_named_pipe_error = ::GetLastError();
@@ -603,15 +603,13 @@ void IPCServer::Loop() {
     if (RecvIPCMessage(pipe_handle_.get(), pipe_event_.get(),
                        &request_[0], &request_size, timeout_,
                        kReadTypeData, &last_ipc_error)) {
-      size_t response_size = sizeof(response_);
-      if (!Process(&request_[0], request_size,
-                   &response_[0], &response_size)) {
+      if (!ProcessRequest(&request_[0], request_size, &response_)) {
         connected_ = false;
       }
 
       // When Process() returns 0 result, force to call DisconnectNamedPipe()
       // instead of checking ACK message
-      if (response_size == 0) {
+      if (response_.empty()) {
         LOG(WARNING) << "Process() return 0 result";
         ::DisconnectNamedPipe(pipe_handle_.get());
         continue;
@@ -619,7 +617,8 @@ void IPCServer::Loop() {
 
       // Send a response
       SendIPCMessage(pipe_handle_.get(), pipe_event_.get(),
-                     &response_[0], response_size, timeout_, &last_ipc_error);
+                     response_.data(), response_.size(), timeout_,
+                     &last_ipc_error);
     }
 
     // Special treatment for Windows per discussion with thatanaka:
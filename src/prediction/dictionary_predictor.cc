@@ -35,6 +35,7 @@
 #include <cmath>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
@@ -59,6 +60,7 @@
 #include "protocol/commands.pb.h"
 #include "protocol/config.pb.h"
 #include "request/conversion_request.h"
+#include "request/conversion_stats.h"
 #include "usage_stats/usage_stats.h"
 
 // This flag is set by predictor.cc
@@ -139,6 +141,33 @@ bool IsTypingCorrectionEnabled(const ConversionRequest &request) {
          FLAGS_enable_typing_correction;
 }
 
+// Returns the bits of the options with which the dictionary lookup results
+// may differ.
+uint32 GetLookupOptions(const ConversionRequest &request) {
+  const config::Config &config = request.config();
+  return (config.use_spelling_correction() ? 1 : 0) |
+         (config.use_zip_code_conversion() ? 2 : 0) |
+         (config.use_t13n_conversion() ? 4 : 0) |
+         (request.IsKanaModifierInsensitiveConversion() ? 8 : 0);
+}
+
+// Gets the key typed after the history and its possible subsequent
+// characters for bigram lookup.
+// Example1 roman input: for "あk", we will get |base|, "あ" and |expanded|,
+// "か", "き", etc
+// Example2 kana input: for "あか", we will get |base|, "あ" and |expanded|,
+// "か", and "が".
+void GetQueryForBigram(const ConversionRequest &request,
+                       const Segments &segments,
+                       string *base, std::set<string> *expanded) {
+  if (!request.has_composer() ||
+      !FLAGS_enable_expansion_for_dictionary_predictor) {
+    *base = segments.conversion_segment(0).key();
+    return;
+  }
+  request.composer().GetQueriesForPrediction(base, expanded);
+}
+
 }  // namespace
 
 class DictionaryPredictor::PredictiveLookupCallback
@@ -304,6 +333,9 @@ DictionaryPredictor::~DictionaryPredictor() {}
 
 void DictionaryPredictor::Finish(
     const ConversionRequest &request, Segments *segments) {
+  // The committed value becomes the new history.
+  bigram_cache_ = BigramCache();
+
   if (segments->request_type() == Segments::REVERSE_CONVERSION) {
     // Do nothing for REVERSE_CONVERSION.
     return;
@@ -410,6 +442,10 @@ bool DictionaryPredictor::AggregatePrediction(
                                       results);
   }
 
+  if (request.stats() != NULL) {
+    RecordPredictionResults(*results, request.stats());
+  }
+
   if (results->empty()) {
     VLOG(2) << "|result| is empty";
     return false;
@@ -640,6 +676,31 @@ void DictionaryPredictor::SetDebugDescription(PredictionTypes types,
   }
 }
 
+// static
+void DictionaryPredictor::RecordPredictionResults(
+    const std::vector<Result> &results, ConversionStats *stats) {
+  DCHECK(stats);
+  static const struct {
+    PredictionType type;
+    const char *name;
+  } kTypeNames[] = {
+    {UNIGRAM, "UNIGRAM"},
+    {BIGRAM, "BIGRAM"},
+    {REALTIME, "REALTIME"},
+    {SUFFIX, "SUFFIX"},
+    {ENGLISH, "ENGLISH"},
+    {TYPING_CORRECTION, "TYPING_CORRECTION"},
+    {REALTIME_TOP, "REALTIME_TOP"},
+  };
+  for (size_t i = 0; i < results.size(); ++i) {
+    for (size_t j = 0; j < arraysize(kTypeNames); ++j) {
+      if (results[i].types & kTypeNames[j].type) {
+        ++stats->prediction_results[kTypeNames[j].name];
+      }
+    }
+  }
+}
+
 // Returns cost for |result| when it's transitioned from |rid|.  Suffix penalty
 // is also added for non-realtime results.
 int DictionaryPredictor::GetLMCost(const Result &result, int rid) const {
@@ -1458,19 +1519,49 @@ void DictionaryPredictor::AddBigramResultsFromHistory(
     const ConversionRequest &request,
     const Segments &segments,
     std::vector<Result> *results) const {
-  // Check that history_key/history_value are in the dictionary.
-  FindValueCallback find_history_callback(history_value);
-  dictionary_->LookupPrefix(history_key, request, &find_history_callback);
+  BigramCache *cache = &bigram_cache_;
+  const uint32 lookup_options = GetLookupOptions(request);
+  if (cache->history_key != history_key ||
+      cache->history_value != history_value ||
+      cache->lookup_options != lookup_options) {
+    *cache = BigramCache();
+    cache->history_key = history_key;
+    cache->history_value = history_value;
+    cache->lookup_options = lookup_options;
+    // Check that history_key/history_value are in the dictionary.
+    FindValueCallback find_history_callback(history_value);
+    dictionary_->LookupPrefix(history_key, request, &find_history_callback);
+    cache->history_found = find_history_callback.found();
+    if (cache->history_found) {
+      cache->history_token = find_history_callback.token();
+    }
+  }
 
   // History value is not found in the dictionary.
   // User may create this the history candidate from T13N or segment
   // expand/shrinkg operations.
-  if (!find_history_callback.found()) {
+  if (!cache->history_found) {
     return;
   }
 
   const size_t cutoff_threshold = GetCandidateCutoffThreshold(segments);
   const size_t prev_results_size = results->size();
+
+  string base;
+  std::set<string> expanded;
+  GetQueryForBigram(request, segments, &base, &expanded);
+  const string input_key = history_key + base;
+  // The cached results are the same as the lookup unless the lookup would
+  // reach the limit with the results added so far.
+  if (cache->has_results &&
+      cache->input_key == input_key &&
+      cache->expanded == expanded &&
+      prev_results_size + cache->results.size() < cutoff_threshold) {
+    results->insert(results->end(),
+                    cache->results.begin(), cache->results.end());
+    return;
+  }
+
   GetPredictiveResultsForBigram(
       *dictionary_, history_key, history_value, request, segments, BIGRAM,
       cutoff_threshold, results);
@@ -1496,9 +1587,19 @@ void DictionaryPredictor::AddBigramResultsFromHistory(
       Util::GetScriptType(Util::SubString(history_value,
                                           history_value_size - 1, 1));
   for (size_t i = prev_results_size; i < results->size(); ++i) {
-    CheckBigramResult(find_history_callback.token(), history_ctype,
+    CheckBigramResult(cache->history_token, history_ctype,
                       last_history_ctype, request, &(*results)[i]);
   }
+
+  if (results->size() < cutoff_threshold) {
+    cache->has_results = true;
+    cache->input_key = input_key;
+    cache->expanded.swap(expanded);
+    cache->results.assign(results->begin() + prev_results_size,
+                          results->end());
+  } else {
+    cache->has_results = false;
+  }
 }
 
 // Filter out irrelevant bigrams. For example, we don't want to
@@ -1633,27 +1734,10 @@ void DictionaryPredictor::GetPredictiveResultsForBigram(
     PredictionTypes types,
     size_t lookup_limit,
     std::vector<Result> *results) const {
-  if (!request.has_composer() ||
-      !FLAGS_enable_expansion_for_dictionary_predictor) {
-    const string &query_key = segments.conversion_segment(0).key();
-    string input_key = history_key;
-    input_key.append(query_key);
-    const bool is_zero_query = query_key.empty();
-    PredictiveBigramLookupCallback callback(
-        types, lookup_limit, input_key.size(), NULL, history_value,
-        is_zero_query, results);
-    dictionary.LookupPredictive(input_key, request, &callback);
-    return;
-  }
-
   // If we have ambiguity for the input, get expanded key.
-  // Example1 roman input: for "あk", we will get |base|, "あ" and |expanded|,
-  // "か", "き", etc
-  // Example2 kana input: for "あか", we will get |base|, "あ" and |expanded|,
-  // "か", and "が".
   string base;
   std::set<string> expanded;
-  request.composer().GetQueriesForPrediction(&base, &expanded);
+  GetQueryForBigram(request, segments, &base, &expanded);
   string input_key = history_key;
   input_key.append(base);
   const bool is_zero_query = base.empty();
@@ -1735,22 +1819,49 @@ void DictionaryPredictor::GetPredictiveResultsUsingTypingCorrection(
     return;
   }
 
+  // |results| may already hold the results of the other lookups, which count
+  // toward |lookup_limit|.
+  if (results->size() >= lookup_limit) {
+    return;
+  }
+  size_t remaining = lookup_limit - results->size();
+
   std::vector<composer::TypeCorrectedQuery> queries;
   request.composer().GetTypeCorrectedQueriesForPrediction(&queries);
+  if (queries.empty()) {
+    return;
+  }
+
+  // Look up all the queries at once so that the dictionary can share the
+  // traversal for their common prefixes.  Each query collects its own results
+  // up to the remaining budget, and they are merged below in the order of the
+  // queries.
+  std::vector<string> input_keys(queries.size());
+  std::vector<StringPiece> keys(queries.size());
+  std::vector<std::vector<Result>> query_results(queries.size());
+  std::vector<std::unique_ptr<PredictiveLookupCallback>> callbacks;
+  std::vector<DictionaryInterface::Callback *> callback_ptrs;
   for (size_t query_index = 0; query_index < queries.size(); ++query_index) {
     const composer::TypeCorrectedQuery &query = queries[query_index];
-    const string input_key = history_key + query.base;
-    const size_t previous_results_size = results->size();
-    PredictiveLookupCallback callback(
-        types, lookup_limit, input_key.size(),
-        query.expanded.empty() ? NULL : &query.expanded, false, results);
-    dictionary.LookupPredictive(input_key, request, &callback);
+    input_keys[query_index] = history_key + query.base;
+    keys[query_index] = input_keys[query_index];
+    callbacks.emplace_back(new PredictiveLookupCallback(
+        types, remaining, input_keys[query_index].size(),
+        query.expanded.empty() ? NULL : &query.expanded, false,
+        &query_results[query_index]));
+    callback_ptrs.push_back(callbacks.back().get());
+  }
+  dictionary.LookupPredictiveMulti(keys, request, callback_ptrs);
 
-    for (size_t i = previous_results_size; i < results->size(); ++i) {
-      results->at(i).wcost += query.cost;
+  for (size_t query_index = 0; query_index < queries.size(); ++query_index) {
+    std::vector<Result> &query_result = query_results[query_index];
+    const size_t size = min(query_result.size(), remaining);
+    for (size_t i = 0; i < size; ++i) {
+      results->push_back(query_result[i]);
+      results->back().wcost += queries[query_index].cost;
     }
-    lookup_limit -= results->size() - previous_results_size;
-    if (lookup_limit <= 0) {
+    remaining -= size;
+    if (remaining == 0) {
       break;
     }
   }
@@ -31,6 +31,7 @@
 #define MOZC_PREDICTION_DICTIONARY_PREDICTOR_H_
 
 #include <functional>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -53,6 +54,8 @@
 
 namespace mozc {
 
+struct ConversionStats;
+
 // Dictionary-based predictor
 class DictionaryPredictor : public PredictorInterface {
  public:
@@ -209,6 +212,7 @@ class DictionaryPredictor : public PredictorInterface {
               GetRealtimeCandidateMaxSizeWithActualConverter);
   FRIEND_TEST(DictionaryPredictorTest, GetCandidateCutoffThreshold);
   FRIEND_TEST(DictionaryPredictorTest, AggregateUnigramPrediction);
+  FRIEND_TEST(DictionaryPredictorTest, BigramCache);
   FRIEND_TEST(DictionaryPredictorTest, AggregateBigramPrediction);
   FRIEND_TEST(DictionaryPredictorTest, AggregateZeroQueryBigramPrediction);
   FRIEND_TEST(DictionaryPredictorTest, AggregateSuffixPrediction);
@@ -230,7 +234,9 @@ class DictionaryPredictor : public PredictorInterface {
   FRIEND_TEST(DictionaryPredictorTest, SetLMCostForUserDictionaryWord);
   FRIEND_TEST(DictionaryPredictorTest, SetDescription);
   FRIEND_TEST(DictionaryPredictorTest, SetDebugDescription);
+  FRIEND_TEST(DictionaryPredictorTest, RecordPredictionResults);
   FRIEND_TEST(DictionaryPredictorTest, GetZeroQueryCandidates);
+  FRIEND_TEST(DictionaryPredictorTest, TypingCorrectionLookupLimit);
 
   typedef std::pair<string, ZeroQueryType> ZeroQueryResult;
 
@@ -268,7 +274,8 @@ class DictionaryPredictor : public PredictorInterface {
                         const Segments &segments,
                         std::vector<Result> *results) const;
 
-  // Adds prediction results from history key and value.
+  // Adds prediction results from history key and value.  The results are
+  // cached in |bigram_cache_|.
   void AddBigramResultsFromHistory(const string &history_key,
                                    const string &history_value,
                                    const ConversionRequest &request,
@@ -468,6 +475,10 @@ class DictionaryPredictor : public PredictorInterface {
   static void SetDebugDescription(PredictionTypes types,
                                   string *description);
 
+  // Counts |results| per prediction type in |stats|.
+  static void RecordPredictionResults(const std::vector<Result> &results,
+                                      ConversionStats *stats);
+
   const ConverterInterface *converter_;
   const ImmutableConverterInterface *immutable_converter_;
   const dictionary::DictionaryInterface *dictionary_;
@@ -480,6 +491,27 @@ class DictionaryPredictor : public PredictorInterface {
   ZeroQueryDict zero_query_dict_;
   ZeroQueryDict zero_query_number_dict_;
 
+  // The history token and the bigram results for the last history.  The
+  // history does not change while the user types the next word, and the same
+  // input is often looked up again, e.g., by suggestion and then prediction.
+  // Cleared by Finish().
+  struct BigramCache {
+    string history_key;
+    string history_value;
+    // Config options that change the dictionary lookup results.
+    uint32 lookup_options = 0;
+    bool history_found = false;
+    dictionary::Token history_token;
+    // The results for the lookup key |input_key| and |expanded|, after
+    // CheckBigramResult().  Valid if |has_results| is true.  Only the
+    // results not truncated by the lookup limit are cached.
+    bool has_results = false;
+    string input_key;
+    std::set<string> expanded;
+    std::vector<Result> results;
+  };
+  mutable BigramCache bigram_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(DictionaryPredictor);
 };
 
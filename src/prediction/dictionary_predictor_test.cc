@@ -68,6 +68,7 @@
 #include "protocol/commands.pb.h"
 #include "protocol/config.pb.h"
 #include "request/conversion_request.h"
+#include "request/conversion_stats.h"
 #include "session/request_test_util.h"
 #include "testing/base/public/gmock.h"
 #include "testing/base/public/googletest.h"
@@ -336,6 +337,23 @@ ACTION_P4(LookupPrefixOneToken, key, value, lid, rid) {
   arg2->OnToken(key, key, token);
 }
 
+// Action to call the third argument of LookupPredictive with |num_tokens|
+// tokens whose key is the lookup key and whose values are "<key>:<index>".
+// Offers |num_tokens| tokens for the key, and counts the offered tokens in
+// |*num_offered|.
+ACTION_P2(LookupPredictiveTokens, num_tokens, num_offered) {
+  for (int i = 0; i < num_tokens; ++i) {
+    ++*num_offered;
+    Token token;
+    token.key = arg0.as_string();
+    token.value = Util::StringPrintf("%s:%d", token.key.c_str(), i);
+    if (arg2->OnToken(arg0, arg0, token) ==
+        DictionaryInterface::Callback::TRAVERSE_DONE) {
+      return;
+    }
+  }
+}
+
 void MakeSegmentsForSuggestion(const string key, Segments *segments) {
   segments->Clear();
   segments->set_max_prediction_candidates_size(10);
@@ -608,6 +626,17 @@ class DictionaryPredictorTest : public ::testing::Test {
     }
   }
 
+  // Inserts |text| with the mobile QWERTY table and a mock typing model so
+  // that the composer has typing corrections to |corrected_key_codes|.
+  void InsertInputSequenceForTypingCorrection(const string &text,
+                                              const uint32 *corrected_key_codes,
+                                              composer::Composer *composer) {
+    table_->LoadFromFile("system://qwerty_mobile-hiragana.tsv");
+    table_->typing_model_.reset(new MockTypingModel());
+    InsertInputSequenceForProbableKeyEvent(text, corrected_key_codes,
+                                           composer);
+  }
+
   void ExpansionForUnigramTestHelper(bool use_expansion) {
     config_->set_use_dictionary_suggest(true);
     config_->set_use_realtime_conversion(false);
@@ -820,9 +849,7 @@ class DictionaryPredictorTest : public ::testing::Test {
     const TestableDictionaryPredictor *predictor =
         data_and_predictor->dictionary_predictor();
 
-    table_->LoadFromFile("system://qwerty_mobile-hiragana.tsv");
-    table_->typing_model_.reset(new MockTypingModel());
-    InsertInputSequenceForProbableKeyEvent(
+    InsertInputSequenceForTypingCorrection(
         key, corrected_key_codes, composer_.get());
 
     Segments segments;
@@ -1446,6 +1473,58 @@ TEST_F(DictionaryPredictorTest, AggregateBigramPrediction) {
   }
 }
 
+TEST_F(DictionaryPredictorTest, BigramCache) {
+  unique_ptr<MockDataAndPredictor> data_and_predictor(
+      CreateDictionaryPredictorWithMockData());
+  TestableDictionaryPredictor *predictor =
+      data_and_predictor->mutable_dictionary_predictor();
+
+  Segments segments;
+  // "あ"
+  MakeSegmentsForSuggestion("\xE3\x81\x82", &segments);
+  // history is "グーグル"
+  const char kHistoryKey[] =
+      "\xE3\x81\x90\xE3\x83\xBC\xE3\x81\x90\xE3\x82\x8B";
+  const char kHistoryValue[] =
+      "\xE3\x82\xB0\xE3\x83\xBC\xE3\x82\xB0\xE3\x83\xAB";
+  PrependHistorySegments(kHistoryKey, kHistoryValue, &segments);
+
+  std::vector<DictionaryPredictor::Result> results;
+  predictor->AggregateBigramPrediction(
+      DictionaryPredictor::BIGRAM, *convreq_, segments, &results);
+  ASSERT_FALSE(results.empty());
+  EXPECT_EQ(kHistoryKey, predictor->bigram_cache_.history_key);
+  EXPECT_TRUE(predictor->bigram_cache_.history_found);
+  EXPECT_TRUE(predictor->bigram_cache_.has_results);
+
+  // The same input gets the same results from the cache.
+  std::vector<DictionaryPredictor::Result> cached_results;
+  predictor->AggregateBigramPrediction(
+      DictionaryPredictor::BIGRAM, *convreq_, segments, &cached_results);
+  ASSERT_EQ(results.size(), cached_results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i].key, cached_results[i].key);
+    EXPECT_EQ(results[i].value, cached_results[i].value);
+    EXPECT_EQ(results[i].types, cached_results[i].types);
+    EXPECT_EQ(results[i].wcost, cached_results[i].wcost);
+  }
+
+  // The cache is not used if the lookup would reach the limit.
+  std::vector<DictionaryPredictor::Result> many_results(
+      predictor->GetCandidateCutoffThreshold(segments) - 1);
+  predictor->AggregateBigramPrediction(
+      DictionaryPredictor::BIGRAM, *convreq_, segments, &many_results);
+  EXPECT_FALSE(predictor->bigram_cache_.has_results);
+
+  // Committing a value clears the cache.
+  predictor->AggregateBigramPrediction(
+      DictionaryPredictor::BIGRAM, *convreq_, segments, &results);
+  EXPECT_TRUE(predictor->bigram_cache_.has_results);
+  predictor->Finish(*convreq_, &segments);
+  EXPECT_TRUE(predictor->bigram_cache_.history_key.empty());
+  EXPECT_FALSE(predictor->bigram_cache_.has_results);
+}
+
 TEST_F(DictionaryPredictorTest, AggregateZeroQueryBigramPrediction) {
   unique_ptr<MockDataAndPredictor> data_and_predictor(
       CreateDictionaryPredictorWithMockData());
@@ -2032,6 +2111,114 @@ TEST_F(DictionaryPredictorTest, AggregateTypeCorrectingPrediction) {
                                     arraysize(kExpectedValues));
 }
 
+TEST_F(DictionaryPredictorTest, TypingCorrectionLookupLimit) {
+  config_->set_use_typing_correction(true);
+  request_->set_special_romanji_table(
+      commands::Request::QWERTY_MOBILE_TO_HIRAGANA);
+
+  unique_ptr<MockDataAndPredictor> data_and_predictor(
+      new MockDataAndPredictor);
+  // CallCheckDictionary is managed by data_and_predictor.
+  CallCheckDictionary *check_dictionary = new CallCheckDictionary;
+  data_and_predictor->Init(check_dictionary, NULL);
+  const TestableDictionaryPredictor *predictor =
+      data_and_predictor->dictionary_predictor();
+
+  const uint32 kCorrectedKeyCodes[] = {'g', 'u', '-', 'g', 'u', 'r', 'u'};
+  InsertInputSequenceForTypingCorrection(
+      "gu-huru", kCorrectedKeyCodes, composer_.get());
+  std::vector<composer::TypeCorrectedQuery> queries;
+  composer_->GetTypeCorrectedQueriesForPrediction(&queries);
+  ASSERT_LE(2, queries.size());
+
+  Segments segments;
+  MakeSegmentsForPrediction("gu-huru", &segments);
+
+  // Every query finds 10 tokens.
+  const int kNumTokens = 10;
+  int num_offered = 0;
+  EXPECT_CALL(*check_dictionary, LookupPredictive(_, _, _))
+      .WillRepeatedly(LookupPredictiveTokens(kNumTokens, &num_offered));
+
+  // Checks that |results| consist of the first |sizes[i]| tokens of the i-th
+  // query, in the order of the queries.
+  auto expect_results = [&queries](const std::vector<size_t> &sizes,
+      const std::vector<TestableDictionaryPredictor::Result> &results) {
+    size_t pos = 0;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      for (size_t j = 0; j < sizes[i]; ++j, ++pos) {
+        ASSERT_LT(pos, results.size());
+        EXPECT_EQ(queries[i].base, results[pos].key);
+        EXPECT_EQ(Util::StringPrintf("%s:%d", queries[i].base.c_str(),
+                                     static_cast<int>(j)),
+                  results[pos].value);
+        EXPECT_EQ(queries[i].cost, results[pos].wcost);
+        EXPECT_EQ(TestableDictionaryPredictor::TYPING_CORRECTION,
+                  results[pos].types);
+      }
+    }
+    EXPECT_EQ(pos, results.size());
+  };
+
+  {
+    // Each query is looked up with the remaining budget, and the results are
+    // merged in the order of the queries until the limit is reached.
+    std::vector<TestableDictionaryPredictor::Result> results;
+    predictor->GetPredictiveResultsUsingTypingCorrection(
+        *check_dictionary, "", *convreq_, segments,
+        TestableDictionaryPredictor::TYPING_CORRECTION, 15, &results);
+    expect_results({10, 5}, results);
+  }
+  {
+    // The first query alone reaches the limit.
+    std::vector<TestableDictionaryPredictor::Result> results;
+    predictor->GetPredictiveResultsUsingTypingCorrection(
+        *check_dictionary, "", *convreq_, segments,
+        TestableDictionaryPredictor::TYPING_CORRECTION, 5, &results);
+    expect_results({5}, results);
+  }
+  {
+    // All the results are kept under a large limit.
+    const size_t kLimit = 1000;
+    ASSERT_LT(kNumTokens * queries.size(), kLimit);
+    std::vector<TestableDictionaryPredictor::Result> results;
+    predictor->GetPredictiveResultsUsingTypingCorrection(
+        *check_dictionary, "", *convreq_, segments,
+        TestableDictionaryPredictor::TYPING_CORRECTION, kLimit, &results);
+    expect_results(std::vector<size_t>(queries.size(), kNumTokens), results);
+  }
+  {
+    // The results of the other lookups count toward the limit, and each query
+    // stops at the remaining budget.
+    const size_t kNumPrevResults = 8;
+    std::vector<TestableDictionaryPredictor::Result> results(kNumPrevResults);
+    for (size_t i = 0; i < kNumPrevResults; ++i) {
+      results[i].key = "prev";
+    }
+    num_offered = 0;
+    predictor->GetPredictiveResultsUsingTypingCorrection(
+        *check_dictionary, "", *convreq_, segments,
+        TestableDictionaryPredictor::TYPING_CORRECTION, 15, &results);
+    ASSERT_EQ(15, results.size());
+    for (size_t i = 0; i < kNumPrevResults; ++i) {
+      EXPECT_EQ("prev", results[i].key);
+    }
+    expect_results({7}, std::vector<TestableDictionaryPredictor::Result>(
+        results.begin() + kNumPrevResults, results.end()));
+    EXPECT_EQ(7 * static_cast<int>(queries.size()), num_offered);
+  }
+  {
+    // Nothing is looked up when the other lookups have used up the limit.
+    std::vector<TestableDictionaryPredictor::Result> results(15);
+    num_offered = 0;
+    predictor->GetPredictiveResultsUsingTypingCorrection(
+        *check_dictionary, "", *convreq_, segments,
+        TestableDictionaryPredictor::TYPING_CORRECTION, 15, &results);
+    EXPECT_EQ(15, results.size());
+    EXPECT_EQ(0, num_offered);
+  }
+}
+
 TEST_F(DictionaryPredictorTest, ZeroQuerySuggestionAfterNumbers) {
   unique_ptr<MockDataAndPredictor> data_and_predictor(
       CreateDictionaryPredictorWithMockData());
@@ -3281,6 +3468,24 @@ TEST_F(DictionaryPredictorTest, SetDebugDescription) {
   }
 }
 
+TEST_F(DictionaryPredictorTest, RecordPredictionResults) {
+  std::vector<TestableDictionaryPredictor::Result> results(3);
+  results[0].types = TestableDictionaryPredictor::UNIGRAM;
+  results[1].types = TestableDictionaryPredictor::UNIGRAM |
+                     TestableDictionaryPredictor::TYPING_CORRECTION;
+  results[2].types = TestableDictionaryPredictor::REALTIME |
+                     TestableDictionaryPredictor::REALTIME_TOP;
+
+  ConversionStats stats;
+  DictionaryPredictor::RecordPredictionResults(results, &stats);
+  EXPECT_EQ(4, stats.prediction_results.size());
+  EXPECT_EQ(2, stats.prediction_results["UNIGRAM"]);
+  EXPECT_EQ(1, stats.prediction_results["TYPING_CORRECTION"]);
+  EXPECT_EQ(1, stats.prediction_results["REALTIME"]);
+  EXPECT_EQ(1, stats.prediction_results["REALTIME_TOP"]);
+  EXPECT_EQ(0, stats.prediction_results.count("BIGRAM"));
+}
+
 TEST_F(DictionaryPredictorTest, PropagateRealtimeConversionBoundary) {
   testing::MockDataManager data_manager;
   unique_ptr<const DictionaryInterface> dictionary(new DictionaryMock);
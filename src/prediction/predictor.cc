@@ -35,6 +35,7 @@
 
 #include "base/flags.h"
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "converter/segments.h"
 #include "protocol/commands.pb.h"
 #include "protocol/config.pb.h"
@@ -122,6 +123,10 @@ bool BasePredictor::Wait() {
   return user_history_predictor_->Wait();
 }
 
+bool BasePredictor::Retire() {
+  return user_history_predictor_->Retire();
+}
+
 bool BasePredictor::Sync() {
   return user_history_predictor_->Sync();
 }
@@ -130,6 +135,17 @@ bool BasePredictor::Reload() {
   return user_history_predictor_->Reload();
 }
 
+void BasePredictor::CollectMemoryUsage(MemoryUsage *usage) const {
+  {
+    MemoryUsage::Scope scope(usage, "dictionary_predictor");
+    dictionary_predictor_->CollectMemoryUsage(usage);
+  }
+  {
+    MemoryUsage::Scope scope(usage, "user_history_predictor");
+    user_history_predictor_->CollectMemoryUsage(usage);
+  }
+}
+
 // static
 PredictorInterface *DefaultPredictor::CreateDefaultPredictor(
     PredictorInterface *dictionary_predictor,
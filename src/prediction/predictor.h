@@ -71,6 +71,11 @@ class BasePredictor : public PredictorInterface {
   // Waits for syncer to complete.
   bool Wait() override;
 
+  // Saves user history and stops saving it afterwards.
+  bool Retire() override;
+
+  void CollectMemoryUsage(MemoryUsage *usage) const override;
+
   // The following interfaces are implemented in derived classes.
   // const string &GetPredictorName() const = 0;
   // bool PredictForRequest(const ConversionRequest &request,
@@ -35,6 +35,7 @@
 namespace mozc {
 
 class ConversionRequest;
+class MemoryUsage;
 class Segments;
 
 class PredictorInterface {
@@ -75,6 +76,13 @@ class PredictorInterface {
   // Waits for syncer thread to complete.
   virtual bool Wait() { return true; }
 
+  // Saves user history to local disk, waiting for the completion, and stops
+  // saving it afterwards.
+  virtual bool Retire() { return true; }
+
+  // Reports the heap memory held by this predictor to |usage|.
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const {}
+
   virtual const string &GetPredictorName() const = 0;
 
  protected:
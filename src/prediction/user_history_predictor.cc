@@ -41,6 +41,7 @@
 #include "base/flags.h"
 #include "base/hash.h"
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/thread.h"
 #include "base/trie.h"
 #include "base/util.h"
@@ -407,6 +408,7 @@ UserHistoryPredictor::UserHistoryPredictor(
       predictor_name_("UserHistoryPredictor"),
       content_word_learning_enabled_(enable_content_word_learning),
       updated_(false),
+      retired_(false),
       dic_(new DicCache(UserHistoryPredictor::cache_size())) {
   AsyncLoad();  // non-blocking
   // Load()  blocking version can be used if any
@@ -440,6 +442,30 @@ bool UserHistoryPredictor::Wait() {
   return true;
 }
 
+bool UserHistoryPredictor::Retire() {
+  WaitForSyncer();
+  const bool result = Save();
+  retired_ = true;
+  return result;
+}
+
+void UserHistoryPredictor::CollectMemoryUsage(MemoryUsage *usage) const {
+  // |dic_| is being rewritten while the syncer loads the history.
+  if (!CheckSyncerAndDelete()) {
+    return;
+  }
+  size_t bytes = dic_->GetAllocatedBytes();
+  for (const DicElement *elm = dic_->Head(); elm != nullptr; elm = elm->next) {
+    bytes += elm->value.SpaceUsed() - sizeof(elm->value);
+  }
+  usage->Add("dic", bytes);
+  size_t roman_keys_bytes = 0;
+  for (const auto &roman_key : roman_keys_) {
+    roman_keys_bytes += sizeof(roman_key) + roman_key.first.capacity();
+  }
+  usage->Add("roman_keys", roman_keys_bytes);
+}
+
 bool UserHistoryPredictor::CheckSyncerAndDelete() const {
   if (syncer_.get() != nullptr) {
     if (syncer_->IsRunning()) {
@@ -502,8 +528,9 @@ bool UserHistoryPredictor::Load() {
   }
 
   for (size_t i = 0; i < history.entries_size(); ++i) {
-    dic_->Insert(EntryFingerprint(history.entries(i)),
-                 history.entries(i));
+    const uint32 fp = EntryFingerprint(history.entries(i));
+    dic_->Insert(fp, history.entries(i));
+    AddRomanKey(fp, history.entries(i).key());
   }
 
   VLOG(1) << "Loaded user histroy, size=" << history.entries_size();
@@ -512,7 +539,7 @@ bool UserHistoryPredictor::Load() {
 }
 
 bool UserHistoryPredictor::Save() {
-  if (!updated_) {
+  if (!updated_ || retired_) {
     return true;
   }
 
@@ -554,6 +581,7 @@ bool UserHistoryPredictor::ClearAllHistory() {
   // Renews DicCache as LRUCache tries to reuse the internal value by
   // using FreeList
   dic_.reset(new DicCache(UserHistoryPredictor::cache_size()));
+  roman_keys_.clear();
 
   // insert a dummy event entry.
   InsertEvent(Entry::CLEAN_ALL_EVENT);
@@ -870,14 +898,99 @@ bool UserHistoryPredictor::RomanFuzzyLookupEntry(
     return false;
   }
 
+  AddSpellingCorrection(*entry, results);
+  return true;
+}
+
+void UserHistoryPredictor::AddSpellingCorrection(
+    const Entry &entry, EntryPriorityQueue *results) const {
   Entry *result = results->NewEntry();
   DCHECK(result);
   result->Clear();
-  result->CopyFrom(*entry);
+  result->CopyFrom(entry);
   result->set_spelling_correction(true);
   results->Push(result);
+}
 
-  return true;
+void UserHistoryPredictor::AddRomanKey(uint32 fp, const string &key) {
+  if (key.empty()) {
+    return;
+  }
+  roman_keys_.insert(std::make_pair(ToRoman(key), fp));
+
+  // Drops the keys of the entries erased or evicted from |dic_|.
+  if (roman_keys_.size() > 2 * dic_->Size() + 16) {
+    for (auto it = roman_keys_.begin(); it != roman_keys_.end();) {
+      if (dic_->HasKey(it->second)) {
+        ++it;
+      } else {
+        it = roman_keys_.erase(it);
+      }
+    }
+  }
+}
+
+void UserHistoryPredictor::LookupRomanFuzzyMatches(
+    const string &roman_input_key, std::unordered_set<uint32> *fps) const {
+  DCHECK(fps);
+  if (roman_input_key.empty()) {
+    return;
+  }
+
+  // Adds the entries whose romanized key starts with |prefix| and matches
+  // |roman_input_key| with one edit.
+  auto add_matches = [this, &roman_input_key, fps](const string &prefix) {
+    for (auto it = roman_keys_.lower_bound(std::make_pair(prefix, 0u));
+         it != roman_keys_.end() && Util::StartsWith(it->first, prefix);
+         ++it) {
+      if (RomanFuzzyPrefixMatch(it->first, roman_input_key)) {
+        fps->insert(it->second);
+      }
+    }
+  };
+
+  // RomanFuzzyPrefixMatch() allows one edit at the first mismatch, so the
+  // romanized key starts with roman_input_key[0, i) followed by either of
+  // 1) the deleted character and roman_input_key[i, size),
+  // 2) roman_input_key[i, size) with the first two characters swapped, or
+  // 3) '-' and roman_input_key[i + 1, size).
+  // The candidates for 1) are found by enumerating the next characters of
+  // the keys starting with roman_input_key[0, i).
+  const size_t size = roman_input_key.size();
+  for (size_t i = 0; i < size; ++i) {
+    const string head = roman_input_key.substr(0, i);
+    auto it = roman_keys_.lower_bound(std::make_pair(head, 0u));
+    if (it == roman_keys_.end() || !Util::StartsWith(it->first, head)) {
+      break;
+    }
+    while (it != roman_keys_.end() && Util::StartsWith(it->first, head)) {
+      if (it->first.size() == i) {
+        ++it;
+        continue;
+      }
+      const char next = it->first[i];
+      if (next != roman_input_key[i]) {
+        add_matches(head + next + roman_input_key.substr(i));
+      }
+      if (static_cast<unsigned char>(next) == 0xFF) {
+        break;
+      }
+      // Skips to the keys with the next character.
+      it = roman_keys_.lower_bound(std::make_pair(head + string(1, next + 1),
+                                                  0u));
+    }
+
+    if (i + 1 < size && roman_input_key[i] != roman_input_key[i + 1]) {
+      string swapped = roman_input_key;
+      swap(swapped[i], swapped[i + 1]);
+      add_matches(swapped);
+    }
+    if (!isalnum(roman_input_key[i])) {
+      string replaced = roman_input_key;
+      replaced[i] = '-';
+      add_matches(replaced);
+    }
+  }
 }
 
 UserHistoryPredictor::Entry *UserHistoryPredictor::AddEntry(
@@ -1331,6 +1444,11 @@ void UserHistoryPredictor::GetResultsFromHistoryDictionary(
   unique_ptr<Trie<string>> expanded;
   GetInputKeyFromSegments(request, segments, &input_key, &base_key, &expanded);
 
+  // The entries matching the misspelled key are looked up in advance, which
+  // is much cheaper than romanizing the key of every entry in the loop.
+  std::unordered_set<uint32> roman_fuzzy_matches;
+  LookupRomanFuzzyMatches(roman_input_key, &roman_fuzzy_matches);
+
   int trial = 0;
   for (const DicElement *elm = dic_->Head(); elm != nullptr; elm = elm->next) {
     if (!IsValidEntryIgnoringRemovedField(
@@ -1347,9 +1465,11 @@ void UserHistoryPredictor::GetResultsFromHistoryDictionary(
     // If a new entry is found, the entry is pushed to the results.
     // TODO(team): make KanaFuzzyLookupEntry().
     if (!LookupEntry(request_type, input_key, base_key, expanded.get(),
-                     &(elm->value), prev_entry, results) &&
-        !RomanFuzzyLookupEntry(roman_input_key, &(elm->value), results)) {
-      continue;
+                     &(elm->value), prev_entry, results)) {
+      if (roman_fuzzy_matches.count(elm->key) == 0) {
+        continue;
+      }
+      AddSpellingCorrection(elm->value, results);
     }
 
     // already found enough results.
@@ -1640,6 +1760,7 @@ void UserHistoryPredictor::Insert(const string &key,
   entry->set_key(key);
   entry->set_value(value);
   entry->set_removed(false);
+  AddRomanKey(dic_key, key);
 
   if (description.empty()) {
     entry->clear_description();
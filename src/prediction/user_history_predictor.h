@@ -34,6 +34,7 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -124,6 +125,13 @@ class UserHistoryPredictor : public PredictorInterface {
   // Implements PredictorInterface.
   bool Wait() override;
 
+  // Implements PredictorInterface.  The history learned after this call is
+  // not saved, as a newer predictor owns the history file.
+  bool Retire() override;
+
+  // Implements PredictorInterface.
+  void CollectMemoryUsage(MemoryUsage *usage) const override;
+
   // Gets user history filename.
   static string GetUserHistoryFileName();
 
@@ -230,6 +238,7 @@ class UserHistoryPredictor : public PredictorInterface {
   FRIEND_TEST(UserHistoryPredictorTest, Regression2843775);
   FRIEND_TEST(UserHistoryPredictorTest, DuplicateString);
   FRIEND_TEST(UserHistoryPredictorTest, SyncTest);
+  FRIEND_TEST(UserHistoryPredictorTest, RetireTest);
   FRIEND_TEST(UserHistoryPredictorTest, GetMatchTypeTest);
   FRIEND_TEST(UserHistoryPredictorTest, FingerPrintTest);
   FRIEND_TEST(UserHistoryPredictorTest, Uint32ToStringTest);
@@ -244,6 +253,7 @@ class UserHistoryPredictor : public PredictorInterface {
   FRIEND_TEST(UserHistoryPredictorTest, MaybeRomanMisspelledKey);
   FRIEND_TEST(UserHistoryPredictorTest, GetRomanMisspelledKey);
   FRIEND_TEST(UserHistoryPredictorTest, RomanFuzzyLookupEntry);
+  FRIEND_TEST(UserHistoryPredictorTest, LookupRomanFuzzyMatches);
   FRIEND_TEST(UserHistoryPredictorTest, ExpandedLookupRoman);
   FRIEND_TEST(UserHistoryPredictorTest, ExpandedLookupKana);
   FRIEND_TEST(UserHistoryPredictorTest, GetMatchTypeFromInputRoman);
@@ -476,6 +486,20 @@ class UserHistoryPredictor : public PredictorInterface {
       const Entry *entry,
       EntryPriorityQueue *results) const;
 
+  // Adds a copy of |entry| to |results| as a spelling correction.
+  void AddSpellingCorrection(const Entry &entry,
+                             EntryPriorityQueue *results) const;
+
+  // Registers the romanized |key| of the entry |fp| in |roman_keys_|.  Must
+  // be called when an entry is added to |dic_|.
+  void AddRomanKey(uint32 fp, const string &key);
+
+  // Collects the fingerprints of the entries whose romanized key has
+  // |roman_input_key| as a fuzzy prefix, i.e., the entries for which
+  // RomanFuzzyLookupEntry() succeeds, without romanizing every entry.
+  void LookupRomanFuzzyMatches(const string &roman_input_key,
+                               std::unordered_set<uint32> *fps) const;
+
   void InsertHistory(RequestType request_type,
                      bool is_suggestion_selected,
                      uint64 last_access_time,
@@ -533,7 +557,13 @@ class UserHistoryPredictor : public PredictorInterface {
 
   bool content_word_learning_enabled_;
   bool updated_;
+  // True after Retire().  Save() does nothing.
+  bool retired_;
   std::unique_ptr<DicCache> dic_;
+  // Romanized keys of the entries in |dic_| paired with their fingerprints.
+  // Sorted for prefix search by LookupRomanFuzzyMatches().  The keys of the
+  // erased entries are dropped lazily by AddRomanKey().
+  std::set<std::pair<string, uint32>> roman_keys_;
   mutable std::unique_ptr<UserHistoryPredictorSyncer> syncer_;
 };
 
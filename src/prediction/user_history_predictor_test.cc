@@ -32,6 +32,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_set>
 
 #include "base/file_util.h"
 #include "base/logging.h"
@@ -233,11 +234,12 @@ class UserHistoryPredictorTest : public ::testing::Test {
   static UserHistoryPredictor::Entry *InsertEntry(
       UserHistoryPredictor *predictor,
       const string &key, const string &value) {
-    UserHistoryPredictor::Entry *e =
-        &predictor->dic_->Insert(predictor->Fingerprint(key, value))->value;
+    const uint32 fp = predictor->Fingerprint(key, value);
+    UserHistoryPredictor::Entry *e = &predictor->dic_->Insert(fp)->value;
     e->set_key(key);
     e->set_value(value);
     e->set_removed(false);
+    predictor->AddRomanKey(fp, key);
     return e;
   }
 
@@ -2095,6 +2097,37 @@ TEST_F(UserHistoryPredictorTest, SyncTest) {
   }
 }
 
+TEST_F(UserHistoryPredictorTest, RetireTest) {
+  UserHistoryPredictor *predictor = GetUserHistoryPredictorWithClearedHistory();
+  auto has_value = [](const string &value) {
+    UserHistoryStorage storage(UserHistoryPredictor::GetUserHistoryFileName());
+    EXPECT_TRUE(storage.Load());
+    for (size_t i = 0; i < storage.entries_size(); ++i) {
+      if (storage.entries(i).value() == value) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // The history learned before Retire() is saved.
+  Segments segments;
+  MakeSegmentsForConversion("abc", &segments);
+  AddCandidate("ABC", &segments);
+  predictor->Finish(*convreq_, &segments);
+  EXPECT_TRUE(predictor->Retire());
+  EXPECT_TRUE(has_value("ABC"));
+
+  // The history learned after Retire() is not.
+  segments.Clear();
+  MakeSegmentsForConversion("def", &segments);
+  AddCandidate("DEF", &segments);
+  predictor->Finish(*convreq_, &segments);
+  predictor->Sync();
+  predictor->WaitForSyncer();
+  EXPECT_FALSE(has_value("DEF"));
+}
+
 TEST_F(UserHistoryPredictorTest, GetMatchTypeTest) {
   EXPECT_EQ(UserHistoryPredictor::NO_MATCH,
             UserHistoryPredictor::GetMatchType("test", ""));
@@ -2914,6 +2947,51 @@ TEST_F(UserHistoryPredictorTest, RomanFuzzyLookupEntry) {
   EXPECT_FALSE(predictor->RomanFuzzyLookupEntry("g=guru", &entry, &results));
 }
 
+TEST_F(UserHistoryPredictorTest, LookupRomanFuzzyMatches) {
+  UserHistoryPredictor *predictor = GetUserHistoryPredictor();
+  predictor->WaitForSyncer();
+  predictor->ClearAllHistory();
+  predictor->WaitForSyncer();
+
+  // "よろしく"
+  const string kYoroshiku =
+      "\xE3\x82\x88\xE3\x82\x8D\xE3\x81\x97\xE3\x81\x8F";
+  // "ぐーぐる"
+  const string kGoogle =
+      "\xE3\x81\x90\xE3\x83\xBC\xE3\x81\x90\xE3\x82\x8B";
+  InsertEntry(predictor, kYoroshiku, "value");
+  InsertEntry(predictor, kGoogle, "value");
+  const uint32 yoroshiku_fp = predictor->Fingerprint(kYoroshiku, "value");
+  const uint32 google_fp = predictor->Fingerprint(kGoogle, "value");
+
+  // The results agree with RomanFuzzyLookupEntry().
+  const struct {
+    const char *roman_input_key;
+    uint32 expected_fp;
+  } kTestCases[] = {
+    {"yorosku", yoroshiku_fp},
+    {"yrosiku", yoroshiku_fp},
+    {"yorsiku", yoroshiku_fp},
+    {"yrsk", 0},
+    {"yorosiku", 0},
+    {"gu=guru", google_fp},
+    {"gu-guru", 0},
+    {"g=guru", 0},
+    {"", 0},
+  };
+  for (const auto &test_case : kTestCases) {
+    std::unordered_set<uint32> fps;
+    predictor->LookupRomanFuzzyMatches(test_case.roman_input_key, &fps);
+    if (test_case.expected_fp == 0) {
+      EXPECT_TRUE(fps.empty()) << test_case.roman_input_key;
+    } else {
+      EXPECT_EQ(1, fps.size()) << test_case.roman_input_key;
+      EXPECT_EQ(1, fps.count(test_case.expected_fp))
+          << test_case.roman_input_key;
+    }
+  }
+}
+
 namespace {
 struct LookupTestData {
   const string entry_key;
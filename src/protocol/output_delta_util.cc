@@ -0,0 +1,131 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "protocol/output_delta_util.h"
+
+#include <string>
+
+#include "base/logging.h"
+#include "base/port.h"
+#include "protocol/commands.pb.h"
+
+namespace mozc {
+namespace {
+
+template <typename T>
+bool IsSameMessage(const T &lhs, const T &rhs) {
+  return lhs.SerializePartialAsString() == rhs.SerializePartialAsString();
+}
+
+// Returns true if |lhs| and |rhs| are the same except for their focused
+// index.  |rhs| should have the focused index.
+template <typename T>
+bool IsSameExceptFocusedIndex(const T &lhs, const T &rhs) {
+  if (!lhs.has_focused_index() || !rhs.has_focused_index()) {
+    return false;
+  }
+  T refocused(lhs);
+  refocused.set_focused_index(rhs.focused_index());
+  return IsSameMessage(refocused, rhs);
+}
+
+}  // namespace
+
+void OutputDeltaUtil::EncodeDelta(const commands::Output &base,
+                                  commands::Output *output) {
+  DCHECK(output);
+  commands::OutputDelta *delta = output->mutable_delta();
+  if (base.has_preedit() && output->has_preedit() &&
+      IsSameMessage(base.preedit(), output->preedit())) {
+    delta->set_same_preedit(true);
+    output->clear_preedit();
+  }
+  if (base.has_status() && output->has_status() &&
+      IsSameMessage(base.status(), output->status())) {
+    delta->set_same_status(true);
+    output->clear_status();
+  }
+  if (base.has_candidates() && output->has_candidates()) {
+    if (IsSameMessage(base.candidates(), output->candidates())) {
+      delta->set_same_candidates(true);
+      output->clear_candidates();
+    } else if (IsSameExceptFocusedIndex(base.candidates(),
+                                        output->candidates())) {
+      delta->set_candidates_focused_index(
+          output->candidates().focused_index());
+      output->clear_candidates();
+    }
+  }
+  if (base.has_all_candidate_words() && output->has_all_candidate_words()) {
+    if (IsSameMessage(base.all_candidate_words(),
+                      output->all_candidate_words())) {
+      delta->set_same_all_candidate_words(true);
+      output->clear_all_candidate_words();
+    } else if (IsSameExceptFocusedIndex(base.all_candidate_words(),
+                                        output->all_candidate_words())) {
+      delta->set_all_candidate_words_focused_index(
+          output->all_candidate_words().focused_index());
+      output->clear_all_candidate_words();
+    }
+  }
+}
+
+bool OutputDeltaUtil::DecodeDelta(const commands::Output &base,
+                                  commands::Output *output) {
+  DCHECK(output);
+  if (!output->has_delta()) {
+    return false;
+  }
+  const commands::OutputDelta &delta = output->delta();
+  if (delta.same_preedit()) {
+    output->mutable_preedit()->CopyFrom(base.preedit());
+  }
+  if (delta.same_status()) {
+    output->mutable_status()->CopyFrom(base.status());
+  }
+  if (delta.same_candidates() || delta.has_candidates_focused_index()) {
+    output->mutable_candidates()->CopyFrom(base.candidates());
+    if (delta.has_candidates_focused_index()) {
+      output->mutable_candidates()->set_focused_index(
+          delta.candidates_focused_index());
+    }
+  }
+  if (delta.same_all_candidate_words() ||
+      delta.has_all_candidate_words_focused_index()) {
+    output->mutable_all_candidate_words()->CopyFrom(
+        base.all_candidate_words());
+    if (delta.has_all_candidate_words_focused_index()) {
+      output->mutable_all_candidate_words()->set_focused_index(
+          delta.all_candidate_words_focused_index());
+    }
+  }
+  return true;
+}
+
+}  // namespace mozc
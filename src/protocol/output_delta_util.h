@@ -0,0 +1,61 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef MOZC_PROTOCOL_OUTPUT_DELTA_UTIL_H_
+#define MOZC_PROTOCOL_OUTPUT_DELTA_UTIL_H_
+
+#include "base/port.h"
+
+namespace mozc {
+namespace commands {
+class Output;
+}  // namespace commands
+
+// Encodes and decodes commands::OutputDelta.  Shared by the server, which
+// omits unchanged fields of outputs, and the client, which restores them.
+class OutputDeltaUtil {
+ public:
+  // Omits the fields of |output| which are unchanged from |base| and marks
+  // them in |output->delta()|.  Both should be complete outputs.  The
+  // sequence numbers in the delta are left to the caller.
+  static void EncodeDelta(const mozc::commands::Output &base,
+                          mozc::commands::Output *output);
+
+  // Restores the fields of |output| omitted by EncodeDelta() from |base|,
+  // which should be the complete output EncodeDelta() was given.
+  // Returns false if |output| is not encoded as a delta.
+  static bool DecodeDelta(const mozc::commands::Output &base,
+                          mozc::commands::Output *output);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(OutputDeltaUtil);
+};
+
+}  // namespace mozc
+#endif  // MOZC_PROTOCOL_OUTPUT_DELTA_UTIL_H_
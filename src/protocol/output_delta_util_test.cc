@@ -0,0 +1,123 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "protocol/output_delta_util.h"
+
+#include "protocol/commands.pb.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace {
+
+void SetTestDataForConversion(commands::Output *output) {
+  output->set_mode(commands::HIRAGANA);
+  output->set_consumed(true);
+  commands::Preedit *preedit = output->mutable_preedit();
+  preedit->set_cursor(4);
+  commands::Preedit::Segment *segment = preedit->add_segment();
+  segment->set_annotation(commands::Preedit::Segment::HIGHLIGHT);
+  segment->set_value("beta");
+  segment->set_value_length(4);
+  segment->set_key("beta");
+  output->mutable_status()->set_activated(true);
+  output->mutable_status()->set_mode(commands::HIRAGANA);
+
+  commands::Candidates *candidates = output->mutable_candidates();
+  commands::CandidateList *all_candidate_words =
+      output->mutable_all_candidate_words();
+  candidates->set_size(9);
+  candidates->set_focused_index(0);
+  all_candidate_words->set_focused_index(0);
+  for (int i = 0; i < 9; ++i) {
+    commands::Candidates::Candidate *candidate = candidates->add_candidate();
+    candidate->set_index(i);
+    candidate->set_id(i);
+    candidate->set_value(string(i + 1, 'b'));
+    commands::CandidateWord *word = all_candidate_words->add_candidates();
+    word->set_index(i);
+    word->set_id(i);
+    word->set_value(string(i + 1, 'b'));
+  }
+}
+
+}  // namespace
+
+TEST(OutputDeltaUtilTest, EncodeAndDecodeDelta) {
+  commands::Output base;
+  SetTestDataForConversion(&base);
+
+  // Only the focus moves.
+  commands::Output output(base);
+  output.mutable_candidates()->set_focused_index(7);
+  output.mutable_all_candidate_words()->set_focused_index(7);
+  output.mutable_preedit()->set_cursor(2);
+  const commands::Output expected(output);
+
+  OutputDeltaUtil::EncodeDelta(base, &output);
+  EXPECT_TRUE(output.has_preedit());
+  EXPECT_FALSE(output.has_candidates());
+  EXPECT_FALSE(output.has_all_candidate_words());
+  EXPECT_FALSE(output.delta().same_preedit());
+  EXPECT_EQ(7, output.delta().candidates_focused_index());
+  EXPECT_EQ(7, output.delta().all_candidate_words_focused_index());
+  EXPECT_GT(expected.ByteSize(), output.ByteSize());
+
+  EXPECT_TRUE(OutputDeltaUtil::DecodeDelta(base, &output));
+  output.clear_delta();
+  EXPECT_EQ(expected.DebugString(), output.DebugString());
+
+  // Nothing changes.
+  output.CopyFrom(base);
+  OutputDeltaUtil::EncodeDelta(base, &output);
+  EXPECT_FALSE(output.has_preedit());
+  EXPECT_FALSE(output.has_status());
+  EXPECT_FALSE(output.has_candidates());
+  EXPECT_TRUE(output.delta().same_preedit());
+  EXPECT_TRUE(output.delta().same_status());
+  EXPECT_TRUE(output.delta().same_candidates());
+  EXPECT_TRUE(output.delta().same_all_candidate_words());
+  EXPECT_TRUE(OutputDeltaUtil::DecodeDelta(base, &output));
+  output.clear_delta();
+  EXPECT_EQ(base.DebugString(), output.DebugString());
+
+  // The candidate window is closed.
+  output.CopyFrom(base);
+  output.clear_candidates();
+  OutputDeltaUtil::EncodeDelta(base, &output);
+  EXPECT_FALSE(output.delta().same_candidates());
+  EXPECT_FALSE(output.delta().has_candidates_focused_index());
+  EXPECT_TRUE(OutputDeltaUtil::DecodeDelta(base, &output));
+  EXPECT_FALSE(output.has_candidates());
+
+  // Not a delta.
+  output.CopyFrom(base);
+  EXPECT_FALSE(OutputDeltaUtil::DecodeDelta(base, &output));
+}
+
+}  // namespace mozc
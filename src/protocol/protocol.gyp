@@ -264,5 +264,16 @@
         'genproto_engine_builder_proto#host',
       ],
     },
+    {
+      'target_name': 'output_delta_util',
+      'type': 'static_library',
+      'sources': [
+        'output_delta_util.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        'commands_proto',
+      ],
+    },
   ],
 }
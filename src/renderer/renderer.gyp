@@ -613,6 +613,7 @@
             'unix/window_manager_test.cc',
           ],
           'dependencies': [
+            '../base/base_test.gyp:clock_mock',
             '../testing/testing.gyp:gtest_main',
             'mozc_renderer_lib',
           ],
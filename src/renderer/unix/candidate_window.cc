@@ -71,6 +71,26 @@ int GetCandidateArrayIndexByCandidateIndex(
   }
   return candidates.candidate_size();
 }
+
+// Returns true if |lhs| and |rhs| are the same except for the focused index.
+bool IsSameExceptForFocus(const commands::Candidates &lhs,
+                          const commands::Candidates &rhs) {
+  if (lhs.has_focused_index() != rhs.has_focused_index() ||
+      lhs.candidate_size() != rhs.candidate_size()) {
+    return false;
+  }
+  commands::Candidates refocused;
+  refocused.CopyFrom(rhs);
+  if (refocused.has_focused_index()) {
+    refocused.set_focused_index(lhs.focused_index());
+  }
+  return refocused.SerializeAsString() == lhs.SerializeAsString();
+}
+
+bool Intersects(const Rect &lhs, const Rect &rhs) {
+  return lhs.Left() < rhs.Right() && rhs.Left() < lhs.Right() &&
+      lhs.Top() < rhs.Bottom() && rhs.Top() < lhs.Bottom();
+}
 }  // namespace
 
 CandidateWindow::CandidateWindow(
@@ -83,12 +103,15 @@ CandidateWindow::CandidateWindow(
       table_layout_(table_layout),
       text_renderer_(text_renderer),
       draw_tool_(draw_tool),
-      cairo_factory_(cairo_factory) {
+      cairo_factory_(cairo_factory),
+      paint_area_(0, 0, 0, 0) {
 }
 
 bool CandidateWindow::OnPaint(GtkWidget *widget, GdkEventExpose* event) {
   draw_tool_->Reset(cairo_factory_->CreateCairoInstance(
       GetCanvasWidget()->window));
+  paint_area_ = Rect(event->area.x, event->area.y,
+                     event->area.width, event->area.height);
 
   DrawBackground();
   DrawShortcutBackground();
@@ -98,6 +121,7 @@ bool CandidateWindow::OnPaint(GtkWidget *widget, GdkEventExpose* event) {
   DrawVScrollBar();
   DrawFooter();
   DrawFrame();
+  paint_area_ = Rect(0, 0, 0, 0);
   return true;
 }
 
@@ -144,6 +168,12 @@ void CandidateWindow::DrawSelectedRect() {
 
 void CandidateWindow::DrawCells() {
   for (size_t i = 0; i < candidates_.candidate_size(); ++i) {
+    // Text rendering is the most expensive part of painting, so skip the
+    // rows which are clipped out anyway.
+    if (!paint_area_.IsRectEmpty() &&
+        !Intersects(table_layout_->GetRowRect(i), paint_area_)) {
+      continue;
+    }
     const commands::Candidates::Candidate &candidate
         = candidates_.candidate(i);
     string shortcut, value, description;
@@ -387,6 +417,10 @@ Size CandidateWindow::Update(const commands::Candidates &candidates) {
       (candidates_.category()  == commands::USAGE))
       << "Unknown candidate category" << candidates_.category();
 
+  if (UpdateFocusOnly(candidates)) {
+    return table_layout_->GetTotalSize();
+  }
+
   candidates_.CopyFrom(candidates);
 
   table_layout_->Initialize(candidates_.candidate_size(), NUMBER_OF_COLUMNS);
@@ -406,6 +440,57 @@ Size CandidateWindow::Update(const commands::Candidates &candidates) {
   return table_layout_->GetTotalSize();
 }
 
+bool CandidateWindow::UpdateFocusOnly(
+    const commands::Candidates &candidates) {
+  if (!IsSameExceptForFocus(candidates_, candidates) ||
+      !table_layout_->IsLayoutFrozen()) {
+    return false;
+  }
+
+  const bool index_visible =
+      candidates_.has_footer() && candidates_.footer().index_visible();
+  if (index_visible) {
+    // The footer is sized with the index guide, so the layout can be kept
+    // only if the new guide has the same size.
+    const Size old_guide_size = text_renderer_->GetPixelSize(
+        FontSpec::FONTSET_FOOTER_INDEX, GetIndexGuideString(candidates_));
+    const Size new_guide_size = text_renderer_->GetPixelSize(
+        FontSpec::FONTSET_FOOTER_INDEX, GetIndexGuideString(candidates));
+    if (old_guide_size.width != new_guide_size.width ||
+        old_guide_size.height != new_guide_size.height) {
+      return false;
+    }
+  }
+
+  if (candidates_.focused_index() == candidates.focused_index()) {
+    return true;
+  }
+
+  const int old_row = GetCandidateArrayIndexByCandidateIndex(
+      candidates_, candidates_.focused_index());
+  candidates_.set_focused_index(candidates.focused_index());
+  const int new_row = GetCandidateArrayIndexByCandidateIndex(
+      candidates_, candidates_.focused_index());
+
+  RedrawRow(old_row);
+  RedrawRow(new_row);
+  if (index_visible) {
+    RedrawRect(table_layout_->GetFooterRect());
+  }
+  return true;
+}
+
+void CandidateWindow::RedrawRow(int row_index) {
+  if (row_index < 0 || row_index >= candidates_.candidate_size()) {
+    return;
+  }
+  // The frame of the selected row is drawn on the border of the row
+  // rectangle, so the area is inflated by one pixel.
+  const Rect row_rect = table_layout_->GetRowRect(row_index);
+  RedrawRect(Rect(row_rect.Left() - 1, row_rect.Top() - 1,
+                  row_rect.Width() + 2, row_rect.Height() + 2));
+}
+
 void CandidateWindow::GetDisplayString(
     const commands::Candidates::Candidate &candidate,
     string *shortcut,
@@ -493,6 +578,8 @@ bool CandidateWindow::SetSendCommandInterface(
 
 void CandidateWindow::ReloadFontConfig(const string &font_description) {
   text_renderer_->ReloadFontConfig(font_description);
+  // Forces the next Update() to lay out the table with the new font.
+  candidates_.Clear();
 }
 
 }  // namespace gtk
@@ -123,6 +123,15 @@ class CandidateWindow : public GtkWindowBase {
   void UpdateCandidatesSize(bool *has_description);
   void UpdateGap2Size(bool has_description);
 
+  // Applies |candidates| without laying out the table again if it differs
+  // from the current candidates only in the focused index.  Only the rows
+  // whose focus changed (and the footer index) are redrawn in that case.
+  // Returns false if a full update is required.
+  bool UpdateFocusOnly(const commands::Candidates &candidates);
+
+  // Queues a redraw of the row at zero oriented |row_index|.
+  void RedrawRow(int row_index);
+
   // TODO(nona): Remove FRIEND_TEST
   FRIEND_TEST(CandidateWindowTest, DrawBackgroundTest);
   FRIEND_TEST(CandidateWindowTest, DrawShortcutBackgroundTest);
@@ -144,6 +153,8 @@ class CandidateWindow : public GtkWindowBase {
   FRIEND_TEST(CandidateWindowTest, UpdateGap2SizeTest);
   FRIEND_TEST(CandidateWindowTest, OnMouseLeftUpTest);
   FRIEND_TEST(CandidateWindowTest, GetSelectedRowIndexTest);
+  FRIEND_TEST(CandidateWindowTest, UpdateFocusOnlyTest);
+  FRIEND_TEST(CandidateWindowTest, DrawCellsInPaintAreaTest);
 
   commands::Candidates candidates_;
   std::unique_ptr<TableLayoutInterface> table_layout_;
@@ -151,6 +162,9 @@ class CandidateWindow : public GtkWindowBase {
   std::unique_ptr<DrawToolInterface> draw_tool_;
   std::unique_ptr<CairoFactoryInterface> cairo_factory_;
   client::SendCommandInterface *send_command_interface_;
+  // The area to be painted by the current OnPaint call.  Cells outside of it
+  // are not rendered.  An empty rectangle means the whole window.
+  Rect paint_area_;
   DISALLOW_COPY_AND_ASSIGN(CandidateWindow);
 };
 
@@ -1474,6 +1474,133 @@ TEST_F(CandidateWindowTest, ReloadFontConfigTest) {
   FinalizeTestKit(&testkit);
 }
 
+TEST_F(CandidateWindowTest, UpdateFocusOnlyTest) {
+  const Rect kRow1Rect(10, 20, 30, 40);
+  const Rect kRow3Rect(10, 100, 30, 40);
+  {
+    SCOPED_TRACE("Changed candidates require full update.");
+    CandidateWindowTestKit testkit = SetUpCandidateWindowWithStrictMock();
+    SetTestCandidates(5, true, true, true, true, true,
+                      &testkit.window->candidates_);
+    commands::Candidates candidates;
+    SetTestCandidates(6, true, true, true, true, true, &candidates);
+    EXPECT_FALSE(testkit.window->UpdateFocusOnly(candidates));
+    FinalizeTestKit(&testkit);
+  }
+  {
+    SCOPED_TRACE("Not frozen layout requires full update.");
+    CandidateWindowTestKit testkit = SetUpCandidateWindowWithStrictMock();
+    SetTestCandidates(5, true, true, true, true, true,
+                      &testkit.window->candidates_);
+    commands::Candidates candidates;
+    candidates.CopyFrom(testkit.window->candidates_);
+    EXPECT_CALL(*testkit.table_layout_mock, IsLayoutFrozen())
+        .WillOnce(Return(false));
+    EXPECT_FALSE(testkit.window->UpdateFocusOnly(candidates));
+    FinalizeTestKit(&testkit);
+  }
+  {
+    SCOPED_TRACE("Only the rows whose focus changed are redrawn.");
+    CandidateWindowTestKit testkit = SetUpCandidateWindowWithStrictMock();
+    SetTestCandidates(5, true, true, true, true, true,
+                      &testkit.window->candidates_);
+    testkit.window->candidates_.set_focused_index(1);
+    commands::Candidates candidates;
+    candidates.CopyFrom(testkit.window->candidates_);
+    candidates.set_focused_index(3);
+    EXPECT_CALL(*testkit.table_layout_mock, IsLayoutFrozen())
+        .WillOnce(Return(true));
+    EXPECT_CALL(*testkit.table_layout_mock, GetRowRect(1))
+        .WillOnce(Return(kRow1Rect));
+    EXPECT_CALL(*testkit.table_layout_mock, GetRowRect(3))
+        .WillOnce(Return(kRow3Rect));
+    EXPECT_CALL(*testkit.gtk_mock,
+                GtkWidgetQueueDrawArea(kDummyWindow, 9, 19, 32, 42));
+    EXPECT_CALL(*testkit.gtk_mock,
+                GtkWidgetQueueDrawArea(kDummyWindow, 9, 99, 32, 42));
+    EXPECT_TRUE(testkit.window->UpdateFocusOnly(candidates));
+    EXPECT_EQ(3, testkit.window->candidates_.focused_index());
+    FinalizeTestKit(&testkit);
+  }
+  {
+    SCOPED_TRACE("The footer index is redrawn if its size is kept.");
+    CandidateWindowTestKit testkit = SetUpCandidateWindowWithStrictMock();
+    SetTestCandidates(5, true, true, true, true, true,
+                      &testkit.window->candidates_);
+    testkit.window->candidates_.set_focused_index(1);
+    testkit.window->candidates_.mutable_footer()->set_index_visible(true);
+    commands::Candidates candidates;
+    candidates.CopyFrom(testkit.window->candidates_);
+    candidates.set_focused_index(3);
+    const Rect kFooterRect(0, 200, 100, 20);
+    EXPECT_CALL(*testkit.table_layout_mock, IsLayoutFrozen())
+        .WillOnce(Return(true));
+    EXPECT_CALL(*testkit.text_renderer_mock,
+                GetPixelSize(FontSpec::FONTSET_FOOTER_INDEX, _))
+        .Times(2)
+        .WillRepeatedly(Return(Size(10, 10)));
+    EXPECT_CALL(*testkit.table_layout_mock, GetRowRect(1))
+        .WillOnce(Return(kRow1Rect));
+    EXPECT_CALL(*testkit.table_layout_mock, GetRowRect(3))
+        .WillOnce(Return(kRow3Rect));
+    EXPECT_CALL(*testkit.table_layout_mock, GetFooterRect())
+        .WillOnce(Return(kFooterRect));
+    EXPECT_CALL(*testkit.gtk_mock,
+                GtkWidgetQueueDrawArea(kDummyWindow, 9, 19, 32, 42));
+    EXPECT_CALL(*testkit.gtk_mock,
+                GtkWidgetQueueDrawArea(kDummyWindow, 9, 99, 32, 42));
+    EXPECT_CALL(*testkit.gtk_mock,
+                GtkWidgetQueueDrawArea(kDummyWindow, 0, 200, 100, 20));
+    EXPECT_TRUE(testkit.window->UpdateFocusOnly(candidates));
+    FinalizeTestKit(&testkit);
+  }
+  {
+    SCOPED_TRACE("Resized footer index requires full update.");
+    CandidateWindowTestKit testkit = SetUpCandidateWindowWithStrictMock();
+    SetTestCandidates(5, true, true, true, true, true,
+                      &testkit.window->candidates_);
+    testkit.window->candidates_.set_size(10);
+    testkit.window->candidates_.set_focused_index(8);
+    testkit.window->candidates_.mutable_footer()->set_index_visible(true);
+    commands::Candidates candidates;
+    candidates.CopyFrom(testkit.window->candidates_);
+    candidates.set_focused_index(9);
+    EXPECT_CALL(*testkit.table_layout_mock, IsLayoutFrozen())
+        .WillOnce(Return(true));
+    EXPECT_CALL(*testkit.text_renderer_mock,
+                GetPixelSize(FontSpec::FONTSET_FOOTER_INDEX, "9/10 "))
+        .WillOnce(Return(Size(10, 10)));
+    EXPECT_CALL(*testkit.text_renderer_mock,
+                GetPixelSize(FontSpec::FONTSET_FOOTER_INDEX, "10/10 "))
+        .WillOnce(Return(Size(12, 10)));
+    EXPECT_FALSE(testkit.window->UpdateFocusOnly(candidates));
+    FinalizeTestKit(&testkit);
+  }
+}
+
+TEST_F(CandidateWindowTest, DrawCellsInPaintAreaTest) {
+  CandidateWindowTestKit testkit = SetUpCandidateWindow();
+  SetTestCandidates(3, true, false, false, false, false,
+                    &testkit.window->candidates_);
+  testkit.window->paint_area_ = Rect(0, 50, 100, 10);
+
+  EXPECT_CALL(*testkit.table_layout_mock, GetRowRect(0))
+      .WillOnce(Return(Rect(0, 0, 100, 20)));
+  EXPECT_CALL(*testkit.table_layout_mock, GetRowRect(1))
+      .WillOnce(Return(Rect(0, 40, 100, 20)));
+  EXPECT_CALL(*testkit.table_layout_mock, GetRowRect(2))
+      .WillOnce(Return(Rect(0, 80, 100, 20)));
+  const Rect kCellRect(0, 40, 50, 20);
+  EXPECT_CALL(*testkit.table_layout_mock,
+              GetCellRect(1, CandidateWindow::COLUMN_CANDIDATE))
+      .WillOnce(Return(kCellRect));
+  EXPECT_CALL(*testkit.text_renderer_mock,
+              RenderText(GetExpectedValue(1, false, false), _,
+                         FontSpec::FONTSET_CANDIDATE));
+  testkit.window->DrawCells();
+  FinalizeTestKit(&testkit);
+}
+
 }  // namespace gtk
 }  // namespace renderer
 }  // namespace mozc
@@ -114,6 +114,11 @@ void GtkWindowBase::Redraw() {
   gtk_->GtkWidgetQueueDrawArea(window_, 0, 0, size.width, size.height);
 }
 
+void GtkWindowBase::RedrawRect(const Rect &rect) {
+  gtk_->GtkWidgetQueueDrawArea(window_, rect.Left(), rect.Top(),
+                               rect.Width(), rect.Height());
+}
+
 // Callbacks
 bool GtkWindowBase::OnDestroy(GtkWidget *widget) {
   gtk_->GtkMainQuit();
@@ -220,6 +220,16 @@ TEST_F(GtkWindowBaseTest, RedrawTest) {
   window.Redraw();
 }
 
+TEST_F(GtkWindowBaseTest, RedrawRectTest) {
+  GtkWrapperMock *mock = GetGtkMock();
+
+  const Rect rect(10, 20, 30, 40);
+  EXPECT_CALL(*mock, GtkWidgetQueueDrawArea(kDummyWindow, 10, 20, 30, 40));
+
+  GtkWindowBase window(mock);
+  window.RedrawRect(rect);
+}
+
 class OverriddenCallTestableGtkWindowBase : public GtkWindowBase {
  public:
   explicit OverriddenCallTestableGtkWindowBase(GtkWrapperInterface *gtk)
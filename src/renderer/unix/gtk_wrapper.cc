@@ -106,6 +106,11 @@ void GtkWrapper::GSourceSetCanRecurse(GSource *source, gboolean can_recurse) {
   g_source_set_can_recurse(source, can_recurse);
 }
 
+guint GtkWrapper::GTimeoutAdd(guint interval, GSourceFunc function,
+                              gpointer data) {
+  return g_timeout_add(interval, function, data);
+}
+
 void GtkWrapper::GtkMain() {
   gtk_main();
 }
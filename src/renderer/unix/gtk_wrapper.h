@@ -58,6 +58,8 @@ class GtkWrapper : public GtkWrapperInterface {
                                   gpointer data,
                                   GDestroyNotify notify);
   virtual void GSourceSetCanRecurse(GSource *source, gboolean can_recurse);
+  virtual guint GTimeoutAdd(guint interval, GSourceFunc function,
+                            gpointer data);
   virtual void GdkThreadsEnter();
   virtual void GdkThreadsLeave();
   virtual void GtkContainerAdd(GtkWidget *container, GtkWidget *widget);
@@ -64,6 +64,8 @@ class GtkWrapperInterface {
                                   gpointer data,
                                   GDestroyNotify notify) = 0;
   virtual void GSourceSetCanRecurse(GSource *source, gboolean can_recurse) = 0;
+  virtual guint GTimeoutAdd(guint interval, GSourceFunc function,
+                            gpointer data) = 0;
   virtual void GdkThreadsEnter() = 0;
   virtual void GdkThreadsLeave() = 0;
   virtual void GtkContainerAdd(GtkWidget *container, GtkWidget *widget) = 0;
@@ -63,6 +63,9 @@ class GtkWrapperMock : public GtkWrapperInterface {
                                         GDestroyNotify notify));
   MOCK_METHOD2(GSourceSetCanRecurse, void(GSource *source,
                                           gboolean can_recurse));
+  MOCK_METHOD3(GTimeoutAdd, guint(guint interval,
+                                  GSourceFunc function,
+                                  gpointer data));
   MOCK_METHOD0(GdkThreadsEnter, void());
   MOCK_METHOD0(GdkThreadsLeave, void());
   MOCK_METHOD2(GtkContainerAdd, void(GtkWidget *container, GtkWidget *widget));
@@ -36,6 +36,13 @@
 namespace mozc {
 namespace renderer {
 namespace gtk {
+namespace {
+
+// The cache is simply cleared when it gets full.  The working set is the
+// strings shown in a few candidate windows, which is far smaller than this.
+const size_t kMaxPixelSizeCacheSize = 1024;
+
+}  // namespace
 
 TextRenderer::TextRenderer(FontSpecInterface *font_spec)
   : font_spec_(font_spec),
@@ -44,6 +51,7 @@ TextRenderer::TextRenderer(FontSpecInterface *font_spec)
 
 void TextRenderer::Initialize(GdkDrawable *drawable) {
   pango_.reset(new PangoWrapper(drawable));
+  pixel_size_cache_.clear();
 }
 
 void TextRenderer::SetUpPangoLayout(const string &str,
@@ -60,8 +68,35 @@ void TextRenderer::SetUpPangoLayout(const string &str,
 
 Size TextRenderer::GetPixelSize(FontSpecInterface::FONT_TYPE font_type,
                                 const string &str) {
+  Size size;
+  if (LookUpPixelSizeCache(font_type, str, &size)) {
+    return size;
+  }
   PangoLayoutWrapper layout(pango_->GetContext());
-  return GetPixelSizeInternal(font_type, str, &layout);
+  size = GetPixelSizeInternal(font_type, str, &layout);
+  InsertPixelSizeCache(font_type, str, size);
+  return size;
+}
+
+bool TextRenderer::LookUpPixelSizeCache(FontSpecInterface::FONT_TYPE font_type,
+                                        const string &str,
+                                        Size *size) const {
+  const PixelSizeCache::const_iterator it =
+      pixel_size_cache_.find(make_pair(font_type, str));
+  if (it == pixel_size_cache_.end()) {
+    return false;
+  }
+  *size = it->second;
+  return true;
+}
+
+void TextRenderer::InsertPixelSizeCache(FontSpecInterface::FONT_TYPE font_type,
+                                        const string &str,
+                                        const Size &size) {
+  if (pixel_size_cache_.size() >= kMaxPixelSizeCacheSize) {
+    pixel_size_cache_.clear();
+  }
+  pixel_size_cache_[make_pair(font_type, str)] = size;
 }
 
 Size TextRenderer::GetPixelSizeInternal(FontSpecInterface::FONT_TYPE font_type,
@@ -113,6 +148,7 @@ void TextRenderer::RenderTextInternal(const string& text,
 
 void TextRenderer::ReloadFontConfig(const string &font_description) {
   font_spec_->Reload(font_description);
+  pixel_size_cache_.clear();
 }
 }  // namespace gtk
 }  // namespace renderer
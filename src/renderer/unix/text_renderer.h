@@ -32,7 +32,9 @@
 
 #include <gtk/gtk.h>
 
+#include <map>
 #include <memory>
+#include <utility>
 
 #include "base/port.h"
 #include "renderer/unix/font_spec_interface.h"
@@ -67,6 +69,21 @@ class TextRenderer : public TextRendererInterface {
   FRIEND_TEST(TextRendererTest, GetPixelSizeTest);
   FRIEND_TEST(TextRendererTest, GetMultilinePixelSizeTest);
   FRIEND_TEST(TextRendererTest, RenderTextTest);
+  FRIEND_TEST(TextRendererTest, PixelSizeCacheTest);
+
+  // Pixel sizes measured by GetPixelSize() keyed by font type and string.
+  // Candidate windows measure the same strings on every update, so caching
+  // them avoids creating a Pango layout for each of them.  The cache is
+  // cleared when the font configuration changes.
+  typedef std::map<std::pair<FontSpecInterface::FONT_TYPE, string>, Size>
+      PixelSizeCache;
+
+  bool LookUpPixelSizeCache(FontSpecInterface::FONT_TYPE font_type,
+                            const string &str,
+                            Size *size) const;
+  void InsertPixelSizeCache(FontSpecInterface::FONT_TYPE font_type,
+                            const string &str,
+                            const Size &size);
 
   void SetUpPangoLayout(const string &str,
                         FontSpecInterface::FONT_TYPE font_type,
@@ -84,6 +101,7 @@ class TextRenderer : public TextRendererInterface {
                                      PangoLayoutWrapperInterface *layout);
   std::unique_ptr<FontSpecInterface> font_spec_;
   std::unique_ptr<PangoWrapperInterface> pango_;
+  PixelSizeCache pixel_size_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(TextRenderer);
 };
@@ -263,6 +263,31 @@ TEST_F(TextRendererTest, ReloadFontConfigTest) {
   text_renderer.ReloadFontConfig(kDummyFontDescription);
 }
 
+TEST_F(TextRendererTest, PixelSizeCacheTest) {
+  FontSpecMock *font_spec_mock = new FontSpecMock();
+  TextRenderer text_renderer(font_spec_mock);
+  const FontSpecInterface::FONT_TYPE kFontType =
+      FontSpecInterface::FONTSET_CANDIDATE;
+
+  Size size;
+  EXPECT_FALSE(text_renderer.LookUpPixelSizeCache(kFontType, "foo", &size));
+
+  text_renderer.InsertPixelSizeCache(kFontType, "foo", Size(12, 34));
+  EXPECT_TRUE(text_renderer.LookUpPixelSizeCache(kFontType, "foo", &size));
+  EXPECT_EQ(12, size.width);
+  EXPECT_EQ(34, size.height);
+
+  // The font type is a part of the key.
+  EXPECT_FALSE(text_renderer.LookUpPixelSizeCache(
+      FontSpecInterface::FONTSET_SHORTCUT, "foo", &size));
+  EXPECT_FALSE(text_renderer.LookUpPixelSizeCache(kFontType, "bar", &size));
+
+  // Reloading the font invalidates the cache.
+  EXPECT_CALL(*font_spec_mock, Reload("Foo,Bar,Baz"));
+  text_renderer.ReloadFontConfig("Foo,Bar,Baz");
+  EXPECT_FALSE(text_renderer.LookUpPixelSizeCache(kFontType, "foo", &size));
+}
+
 }  // namespace gtk
 }  // namespace renderer
 }  // namespace mozc
@@ -34,6 +34,7 @@
 
 #include <memory>
 
+#include "base/clock.h"
 #include "base/logging.h"
 #include "protocol/renderer_command.pb.h"
 #include "renderer/unix/window_manager.h"
@@ -45,6 +46,16 @@ namespace renderer {
 namespace gtk {
 namespace {
 
+// Updates arriving faster than this interval are coalesced.
+const uint64 kFrameIntervalMsec = 16;
+
+uint64 GetTimeInMsec() {
+  uint64 sec = 0;
+  uint32 usec = 0;
+  Clock::GetTimeOfDay(&sec, &usec);
+  return sec * 1000 + usec / 1000;
+}
+
 gboolean mozc_prepare(GSource *source, int *timeout) {
   *timeout = -1;
   return FALSE;
@@ -63,13 +74,15 @@ gboolean mozc_dispatch(GSource *source, GSourceFunc callback,
   char buf[8];
   // Discards read data.
   while (read(watch->poll_fd.fd, buf, 8) > 0) {}
-  watch->unix_server->Render();
+  watch->unix_server->ScheduleRender();
   return TRUE;
 }
 }  // namespace
 
 UnixServer::UnixServer(GtkWrapperInterface *gtk)
-    : gtk_(gtk) {
+    : gtk_(gtk),
+      last_render_time_(0),
+      render_scheduled_(false) {
 }
 
 UnixServer::~UnixServer() {
@@ -99,6 +112,36 @@ bool UnixServer::Render() {
   return true;
 }
 
+void UnixServer::ScheduleRender() {
+  if (render_scheduled_) {
+    // The pending rendering picks up the latest message.
+    return;
+  }
+  // Note that the elapsed time wraps around to a large value if the clock
+  // goes backward, which renders immediately.
+  const uint64 elapsed = GetTimeInMsec() - last_render_time_;
+  if (elapsed >= kFrameIntervalMsec) {
+    RenderNow();
+    return;
+  }
+  render_scheduled_ = true;
+  gtk_->GTimeoutAdd(kFrameIntervalMsec - elapsed, OnRenderTimeout, this);
+}
+
+// static
+gboolean UnixServer::OnRenderTimeout(gpointer data) {
+  UnixServer *server = reinterpret_cast<UnixServer *>(data);
+  server->render_scheduled_ = false;
+  server->RenderNow();
+  // Removes this timeout source.
+  return FALSE;
+}
+
+void UnixServer::RenderNow() {
+  last_render_time_ = GetTimeInMsec();
+  Render();
+}
+
 bool UnixServer::AsyncExecCommand(string *proto_message) {
   {
     // Take the ownership of |proto_message|.
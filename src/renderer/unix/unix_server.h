@@ -60,9 +60,17 @@ class UnixServer : public RendererServer {
 
   virtual bool Render();
 
+  // Renders the latest message, or defers it to the next frame if the
+  // previous rendering happened less than a frame interval ago.  Bursts of
+  // updates are coalesced into one rendering this way.
+  void ScheduleRender();
+
   void OpenPipe();
 
  private:
+  static gboolean OnRenderTimeout(gpointer data);
+  void RenderNow();
+
   string message_;
   Mutex mutex_;
   std::unique_ptr<GtkWrapperInterface> gtk_;
@@ -73,6 +81,11 @@ class UnixServer : public RendererServer {
   // new packet is arrived.
   int pipefd_[2];
 
+  // Time of the last rendering in milliseconds, and whether a deferred
+  // rendering is pending.  Both are accessed only from the gtk-main thread.
+  uint64 last_render_time_;
+  bool render_scheduled_;
+
   DISALLOW_COPY_AND_ASSIGN(UnixServer);
 };
 
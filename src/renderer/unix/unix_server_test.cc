@@ -29,19 +29,34 @@
 
 #include "renderer/unix/unix_server.h"
 
+#include "base/clock.h"
+#include "base/clock_mock.h"
 #include "base/system_util.h"
 #include "renderer/unix/gtk_wrapper_mock.h"
 #include "testing/base/public/gunit.h"
 
 DECLARE_string(test_tmpdir);
 
+using testing::DoAll;
+using testing::Mock;
 using testing::Return;
+using testing::SaveArg;
 using testing::StrictMock;
 using testing::_;
 
 namespace mozc {
 namespace renderer {
 namespace gtk {
+namespace {
+
+class RenderCountingUnixServer : public UnixServer {
+ public:
+  explicit RenderCountingUnixServer(GtkWrapperInterface *gtk)
+      : UnixServer(gtk) {}
+  MOCK_METHOD0(Render, bool());
+};
+
+}  // namespace
 
 class UnixServerTest : public testing::Test {
  protected:
@@ -72,6 +87,45 @@ TEST_F(UnixServerTest, StartMessageLoopTest) {
   server.StartMessageLoop();
 }
 
+TEST_F(UnixServerTest, ScheduleRenderTest) {
+  ClockMock clock(1000, 0);
+  Clock::SetClockForUnitTest(&clock);
+
+  GtkWrapperMock *gtk_mock = new StrictMock<GtkWrapperMock>();
+  RenderCountingUnixServer server(gtk_mock);
+
+  // The first update is rendered immediately.
+  EXPECT_CALL(server, Render()).WillOnce(Return(true));
+  server.ScheduleRender();
+  Mock::VerifyAndClearExpectations(&server);
+
+  // Updates within the frame interval are deferred to one timeout.
+  clock.PutClockForward(0, 5000);
+  GSourceFunc callback = NULL;
+  gpointer data = NULL;
+  EXPECT_CALL(*gtk_mock, GTimeoutAdd(11, _, _))
+      .WillOnce(DoAll(SaveArg<1>(&callback), SaveArg<2>(&data), Return(1)));
+  EXPECT_CALL(server, Render()).Times(0);
+  server.ScheduleRender();
+  server.ScheduleRender();
+  server.ScheduleRender();
+  Mock::VerifyAndClearExpectations(&server);
+  Mock::VerifyAndClearExpectations(gtk_mock);
+  ASSERT_TRUE(callback != NULL);
+
+  clock.PutClockForward(0, 11000);
+  EXPECT_CALL(server, Render()).WillOnce(Return(true));
+  EXPECT_FALSE(callback(data));
+  Mock::VerifyAndClearExpectations(&server);
+
+  // An update after the frame interval is rendered immediately again.
+  clock.PutClockForward(0, 20000);
+  EXPECT_CALL(server, Render()).WillOnce(Return(true));
+  server.ScheduleRender();
+
+  Clock::SetClockForUnitTest(NULL);
+}
+
 }  // namespace gtk
 }  // namespace renderer
 }  // namespace mozc
@@ -42,7 +42,8 @@ ConversionRequest::ConversionRequest()
       use_actual_converter_for_realtime_conversion_(false),
       composer_key_selection_(CONVERSION_KEY),
       skip_slow_rewriters_(false),
-      create_partial_candidates_(false) {}
+      create_partial_candidates_(false),
+      stats_(NULL) {}
 
 ConversionRequest::ConversionRequest(const composer::Composer *c,
                                      const commands::Request *request,
@@ -53,7 +54,8 @@ ConversionRequest::ConversionRequest(const composer::Composer *c,
       use_actual_converter_for_realtime_conversion_(false),
       composer_key_selection_(CONVERSION_KEY),
       skip_slow_rewriters_(false),
-      create_partial_candidates_(false) {}
+      create_partial_candidates_(false),
+      stats_(NULL) {}
 
 ConversionRequest::~ConversionRequest() {}
 
@@ -123,6 +125,14 @@ void ConversionRequest::set_create_partial_candidates(bool value) {
   create_partial_candidates_ = value;
 }
 
+ConversionStats *ConversionRequest::stats() const {
+  return stats_;
+}
+
+void ConversionRequest::set_stats(ConversionStats *stats) {
+  stats_ = stats;
+}
+
 bool ConversionRequest::IsKanaModifierInsensitiveConversion() const {
   return request_->kana_modifier_insensitive_conversion() &&
          config_->use_kana_modifier_insensitive_conversion();
@@ -137,6 +147,7 @@ void ConversionRequest::CopyFrom(const ConversionRequest &request) {
   composer_key_selection_ = request.composer_key_selection_;
   skip_slow_rewriters_ = request.skip_slow_rewriters_;
   create_partial_candidates_ = request.create_partial_candidates_;
+  stats_ = request.stats_;
 }
 
 }  // namespace mozc
@@ -50,6 +50,8 @@ namespace config {
 class Config;
 }  // namespace config
 
+struct ConversionStats;
+
 // Contains utilizable information for conversion, suggestion and prediction,
 // including composition, preceding text, etc.
 // This class doesn't take ownerships of any Composer* argument.
@@ -107,6 +109,12 @@ class ConversionRequest {
 
   bool IsKanaModifierInsensitiveConversion() const;
 
+  // Optional counters filled by the converter and the predictors.  NULL by
+  // default; the counters are collected only when it is set.  Doesn't take
+  // the ownership.
+  ConversionStats *stats() const;
+  void set_stats(ConversionStats *stats);
+
  private:
   // Required fields
   // Input composer to generate a key for conversion, suggestion, etc.
@@ -137,6 +145,9 @@ class ConversionRequest {
   // For example, "私の" is created from composition "わたしのなまえ".
   bool create_partial_candidates_;
 
+  // Output counters.  Mutable through the const request passed around.
+  ConversionStats *stats_;
+
   // TODO(noriyukit): Moves all the members of Segments that are irrelevant to
   // this structure, e.g., Segments::user_history_enabled_ and
   // Segments::request_type_. Also, a key for conversion is eligible to live in
@@ -0,0 +1,177 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "request/conversion_stats.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace mozc {
+namespace {
+
+// The scalar counters, in the order of DebugString().
+struct Counter {
+  const char *name;
+  uint64 ConversionStats::*member;
+};
+
+const Counter kCounters[] = {
+  {"conversions", &ConversionStats::conversions},
+  {"nodes_allocated", &ConversionStats::nodes_allocated},
+  {"dictionary_lookups", &ConversionStats::dictionary_lookups},
+  {"tokens_decoded", &ConversionStats::tokens_decoded},
+  {"lookups_at_node_limit", &ConversionStats::lookups_at_node_limit},
+  {"connector_lookups", &ConversionStats::connector_lookups},
+  {"connector_cache_misses", &ConversionStats::connector_cache_misses},
+  {"viterbi_edges", &ConversionStats::viterbi_edges},
+  {"nbest_pops", &ConversionStats::nbest_pops},
+  {"candidates_filtered", &ConversionStats::candidates_filtered},
+};
+
+const char kMaxNodesPerPosition[] = "max_nodes_per_position";
+const char kPredictionResultsPrefix[] = "prediction_results/";
+
+uint32 GetMaxNodesPerPosition(const ConversionStats &stats) {
+  if (stats.nodes_per_position.empty()) {
+    return 0;
+  }
+  return *std::max_element(stats.nodes_per_position.begin(),
+                           stats.nodes_per_position.end());
+}
+
+}  // namespace
+
+ConversionStats::ConversionStats() {
+  Clear();
+}
+
+ConversionStats::~ConversionStats() {}
+
+void ConversionStats::Clear() {
+  for (size_t i = 0; i < arraysize(kCounters); ++i) {
+    this->*kCounters[i].member = 0;
+  }
+  nodes_per_position.clear();
+  prediction_results.clear();
+}
+
+string ConversionStats::DebugString() const {
+  std::ostringstream os;
+  for (size_t i = 0; i < arraysize(kCounters); ++i) {
+    os << kCounters[i].name << '=' << this->*kCounters[i].member << ' ';
+  }
+  os << kMaxNodesPerPosition << '=' << GetMaxNodesPerPosition(*this);
+  if (connector_lookups > 0) {
+    os << " connector_cache_hit_rate="
+       << 1.0 - static_cast<double>(connector_cache_misses) /
+                connector_lookups;
+  }
+  for (std::map<string, uint32>::const_iterator it =
+           prediction_results.begin();
+       it != prediction_results.end(); ++it) {
+    os << ' ' << kPredictionResultsPrefix << it->first << '=' << it->second;
+  }
+  return os.str();
+}
+
+ConversionStatsHistograms::ConversionStatsHistograms() : num_stats_(0) {}
+
+ConversionStatsHistograms::~ConversionStatsHistograms() {}
+
+void ConversionStatsHistograms::Add(const ConversionStats &stats) {
+  scoped_lock lock(&mutex_);
+  ++num_stats_;
+  for (size_t i = 0; i < arraysize(kCounters); ++i) {
+    AddValue(kCounters[i].name, stats.*kCounters[i].member);
+  }
+  AddValue(kMaxNodesPerPosition, GetMaxNodesPerPosition(stats));
+  for (std::map<string, uint32>::const_iterator it =
+           stats.prediction_results.begin();
+       it != stats.prediction_results.end(); ++it) {
+    AddValue(kPredictionResultsPrefix + it->first, it->second);
+  }
+}
+
+void ConversionStatsHistograms::Clear() {
+  scoped_lock lock(&mutex_);
+  num_stats_ = 0;
+  histograms_.clear();
+}
+
+uint64 ConversionStatsHistograms::num_stats() const {
+  scoped_lock lock(&mutex_);
+  return num_stats_;
+}
+
+string ConversionStatsHistograms::DebugString() const {
+  scoped_lock lock(&mutex_);
+  std::ostringstream os;
+  os << "stats: " << num_stats_ << std::endl;
+  for (HistogramMap::const_iterator it = histograms_.begin();
+       it != histograms_.end(); ++it) {
+    os << it->first << ':';
+    const std::vector<uint64> &buckets = it->second;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+      if (buckets[i] == 0) {
+        continue;
+      }
+      if (i == 0) {
+        os << " [0]=";
+      } else {
+        os << " [" << (static_cast<uint64>(1) << (i - 1)) << ','
+           << (static_cast<uint64>(1) << i) << ")=";
+      }
+      os << buckets[i];
+    }
+    os << std::endl;
+  }
+  return os.str();
+}
+
+// static
+size_t ConversionStatsHistograms::GetBucket(uint64 value) {
+  size_t bucket = 0;
+  while (value > 0) {
+    value >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+void ConversionStatsHistograms::AddValue(const string &name, uint64 value) {
+  std::vector<uint64> &buckets = histograms_[name];
+  const size_t bucket = GetBucket(value);
+  if (buckets.size() <= bucket) {
+    buckets.resize(bucket + 1, 0);
+  }
+  ++buckets[bucket];
+}
+
+}  // namespace mozc
@@ -0,0 +1,127 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef MOZC_REQUEST_CONVERSION_STATS_H_
+#define MOZC_REQUEST_CONVERSION_STATS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/mutex.h"
+#include "base/port.h"
+
+namespace mozc {
+
+// Counters of the work done for a conversion request, to see why one
+// conversion is slower than another.  A caller attaches an instance to
+// ConversionRequest::set_stats(), and ImmutableConverter and
+// DictionaryPredictor add to it.  The counters accumulate over all the
+// lattices built for the request, e.g., for realtime conversion inside a
+// prediction.
+struct ConversionStats {
+  ConversionStats();
+  ~ConversionStats();
+
+  void Clear();
+
+  // Returns a single line summary, e.g., "conversions=1 nodes=120 ...".
+  string DebugString() const;
+
+  // Number of lattices built and searched.
+  uint64 conversions;
+
+  // Nodes allocated for the lattices.  Nodes looked up for the previous key
+  // and kept in the lattice cache are not counted.
+  uint64 nodes_allocated;
+
+  // Number of nodes starting at each byte position of the largest lattice.
+  std::vector<uint32> nodes_per_position;
+
+  // Dictionary lookups issued while building the lattices, the tokens they
+  // returned, and the lookups truncated by the limit of nodes per lookup.
+  uint64 dictionary_lookups;
+  uint64 tokens_decoded;
+  uint64 lookups_at_node_limit;
+
+  // Calls of Connector::GetTransitionCost() and the calls that missed its
+  // cache, over the whole conversion.
+  uint64 connector_lookups;
+  uint64 connector_cache_misses;
+
+  // Pairs of nodes whose connection was evaluated by the Viterbi search.
+  uint64 viterbi_edges;
+
+  // Elements popped from the N-best agenda, and the candidates made by the
+  // N-best search and rejected by the candidate filter.
+  uint64 nbest_pops;
+  uint64 candidates_filtered;
+
+  // Number of DictionaryPredictor results per aggregation type, e.g.,
+  // "UNIGRAM".  A result is counted for each type it has.
+  std::map<string, uint32> prediction_results;
+};
+
+// Aggregates ConversionStats into histograms with power-of-two buckets.
+// Thread-safe.
+class ConversionStatsHistograms {
+ public:
+  ConversionStatsHistograms();
+  ~ConversionStatsHistograms();
+
+  void Add(const ConversionStats &stats);
+  void Clear();
+
+  // Number of the stats added.
+  uint64 num_stats() const;
+
+  // Returns the histograms, one line for each counter, e.g.,
+  // "viterbi_edges: [0]=2 [256,512)=10 [512,1024)=1".
+  string DebugString() const;
+
+  // Returns the index of the bucket of |value|.  The bucket 0 holds 0 and the
+  // bucket i > 0 holds [2^(i-1), 2^i).
+  static size_t GetBucket(uint64 value);
+
+ private:
+  typedef std::map<string, std::vector<uint64>> HistogramMap;
+
+  void AddValue(const string &name, uint64 value);
+
+  mutable Mutex mutex_;
+  uint64 num_stats_;
+  HistogramMap histograms_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConversionStatsHistograms);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_REQUEST_CONVERSION_STATS_H_
@@ -36,6 +36,7 @@
       'type': 'static_library',
       'sources': [
         'conversion_request.cc',
+        'conversion_stats.cc',
       ],
       'dependencies': [
         '../base/base.gyp:base',
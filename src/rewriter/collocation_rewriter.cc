@@ -459,6 +459,30 @@ inline bool IsKeyUnknown(const Segment &seg) {
   return Util::IsScriptType(seg.key(), Util::UNKNOWN_SCRIPT);
 }
 
+// Hash of a normalized collocation part generated from the candidate at
+// |index|.
+struct CandidatePart {
+  size_t index;
+  CollocationUtil::PartHash hash;
+};
+
+// Normalizes |parts| and appends their hashes to |output|.  Empty parts are
+// skipped since they never form a collocation.  |normalized| is a buffer
+// reused across calls.
+void AppendNormalizedParts(const std::vector<string> &parts,
+                           bool remove_number, size_t index,
+                           string *normalized,
+                           std::vector<CandidatePart> *output) {
+  for (size_t k = 0; k < parts.size(); ++k) {
+    CollocationUtil::GetNormalizedScript(parts[k], remove_number, normalized);
+    if (normalized->empty()) {
+      continue;
+    }
+    const CandidatePart part = {index, CollocationUtil::HashPart(*normalized)};
+    output->push_back(part);
+  }
+}
+
 }  // namespace
 
 bool CollocationRewriter::RewriteCollocation(Segments *segments) const {
@@ -541,15 +565,21 @@ class CollocationRewriter::CollocationFilter {
   ~CollocationFilter() {
   }
 
-  bool Exists(const string &left, const string &right) const {
-    if (left.empty() || right.empty()) {
-      return false;
+  // Tests all the |fingerprints| in one batch and returns the index of the
+  // first one found in the filter, or -1 if none is found.
+  int FindFirst(const std::vector<uint64> &fingerprints) const {
+    if (fingerprints.empty()) {
+      return -1;
     }
-    string key;
-    key.reserve(left.size() + right.size());
-    key.assign(left).append(right);
-    const uint64 id = Hash::Fingerprint(key);
-    return filter_->Exists(id);
+    std::unique_ptr<bool[]> results(new bool[fingerprints.size()]);
+    filter_->ExistsBatch(fingerprints.data(), fingerprints.size(),
+                         results.get());
+    for (size_t i = 0; i < fingerprints.size(); ++i) {
+      if (results[i]) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
   }
 
  private:
@@ -618,12 +648,18 @@ bool CollocationRewriter::RewriteFromPrevSegment(
     Segment *seg) const {
   string prev;
   CollocationUtil::GetNormalizedScript(prev_cand.value, true, &prev);
+  if (prev.empty()) {
+    return false;
+  }
+  const CollocationUtil::PartHash prev_hash = CollocationUtil::HashPart(prev);
 
   const size_t i_max = min(seg->candidates_size(), kCandidateSize);
 
-  // Reuse |curs| and |cur| in the loop as this method is performance critical.
+  // Reuse |curs| and |normalized| in the loop as this method is performance
+  // critical.
   std::vector<string> curs;
-  string cur;
+  string normalized;
+  std::vector<CandidatePart> cur_parts;
   for (size_t i = 0; i < i_max; ++i) {
     if (seg->candidate(i).cost > seg->candidate(0).cost + kMaxCostDiff) {
       continue;
@@ -638,22 +674,28 @@ bool CollocationRewriter::RewriteFromPrevSegment(
     if (!IsNaturalContent(seg->candidate(i), seg->candidate(0), RIGHT, &curs)) {
       continue;
     }
+    AppendNormalizedParts(curs, false, i, &normalized, &cur_parts);
+  }
 
-    for (int j = 0; j < curs.size(); ++j) {
-      cur.clear();
-      CollocationUtil::GetNormalizedScript(curs[j], false, &cur);
-      if (collocation_filter_->Exists(prev, cur)) {
-        VLOG_IF(3, i != 0) << prev << cur << " "
-                           << seg->candidate(0).value << "->"
-                           << seg->candidate(i).value;
-        seg->move_candidate(i, 0);
-        seg->mutable_candidate(0)->attributes
-            |= Segment::Candidate::CONTEXT_SENSITIVE;
-        return true;
-      }
-    }
+  std::vector<uint64> fingerprints;
+  fingerprints.reserve(cur_parts.size());
+  for (size_t k = 0; k < cur_parts.size(); ++k) {
+    fingerprints.push_back(
+        CollocationUtil::CombineHashes(prev_hash, cur_parts[k].hash));
   }
-  return false;
+  const int found = collocation_filter_->FindFirst(fingerprints);
+  if (found < 0) {
+    return false;
+  }
+
+  const size_t i = cur_parts[found].index;
+  VLOG_IF(3, i != 0) << prev << " "
+                     << seg->candidate(0).value << "->"
+                     << seg->candidate(i).value;
+  seg->move_candidate(i, 0);
+  seg->mutable_candidate(0)->attributes
+      |= Segment::Candidate::CONTEXT_SENSITIVE;
+  return true;
 }
 
 bool CollocationRewriter::RewriteUsingNextSegment(Segment *next_seg,
@@ -661,15 +703,18 @@ bool CollocationRewriter::RewriteUsingNextSegment(Segment *next_seg,
   const size_t i_max = min(seg->candidates_size(), kCandidateSize);
   const size_t j_max = min(next_seg->candidates_size(), kCandidateSize);
 
-  // Cache the results for the next segment
-  std::vector<int> next_seg_ok(j_max);  // Avoiding vector<bool>
-  std::vector<std::vector<string> > normalized_string(j_max);
+  // Reuse |nexts|, |curs| and |normalized| in the loops as this method is
+  // performance critical.
+  std::vector<string> nexts, curs;
+  string normalized;
 
-  // Reuse |nexts| in the loop as this method is performance critical.
-  std::vector<string> nexts;
+  // Hash the parts of the next segment only once.
+  std::vector<CandidatePart> next_parts;
   for (size_t j = 0; j < j_max; ++j) {
-    next_seg_ok[j] = 0;
-
+    if (next_seg->candidate(j).cost >
+        next_seg->candidate(0).cost + kMaxCostDiff) {
+      continue;
+    }
     if (IsName(next_seg->candidate(j))) {
       continue;
     }
@@ -681,19 +726,13 @@ bool CollocationRewriter::RewriteUsingNextSegment(Segment *next_seg,
                           next_seg->candidate(0), RIGHT, &nexts)) {
       continue;
     }
-
-    next_seg_ok[j] = 1;
-    for (std::vector<string>::const_iterator it = nexts.begin();
-         it != nexts.end(); ++it) {
-      normalized_string[j].push_back(string());
-      CollocationUtil::GetNormalizedScript(
-          *it, false, &normalized_string[j].back());
-    }
+    AppendNormalizedParts(nexts, false, j, &normalized, &next_parts);
+  }
+  if (next_parts.empty()) {
+    return false;
   }
 
-  // Reuse |curs| and |cur| in the loop as this method is performance critical.
-  std::vector<string> curs;
-  string cur;
+  std::vector<CandidatePart> cur_parts;
   for (size_t i = 0; i < i_max; ++i) {
     if (seg->candidate(i).cost > seg->candidate(0).cost + kMaxCostDiff) {
       continue;
@@ -708,38 +747,37 @@ bool CollocationRewriter::RewriteUsingNextSegment(Segment *next_seg,
     if (!IsNaturalContent(seg->candidate(i), seg->candidate(0), LEFT, &curs)) {
       continue;
     }
+    AppendNormalizedParts(curs, true, i, &normalized, &cur_parts);
+  }
 
-    for (int k = 0; k < curs.size(); ++k) {
-      cur.clear();
-      CollocationUtil::GetNormalizedScript(curs[k], true, &cur);
-      for (size_t j = 0; j < j_max; ++j) {
-        if (next_seg->candidate(j).cost >
-            next_seg->candidate(0).cost + kMaxCostDiff) {
-          continue;
-        }
-        if (!next_seg_ok[j]) {
-          continue;
-        }
-
-        for (int l = 0; l < normalized_string[j].size(); ++l) {
-          const string &next = normalized_string[j][l];
-          if (collocation_filter_->Exists(cur, next)) {
-            DCHECK(VerifyNaturalContent(
-                next_seg->candidate(j), next_seg->candidate(0), RIGHT))
-                << "IsNaturalContent() should not fail here.";
-            seg->move_candidate(i, 0);
-            seg->mutable_candidate(0)->attributes
-                |= Segment::Candidate::CONTEXT_SENSITIVE;
-            next_seg->move_candidate(j, 0);
-            next_seg->mutable_candidate(0)->attributes
-                |= Segment::Candidate::CONTEXT_SENSITIVE;
-            return true;
-          }
-        }
-      }
+  // The pairs are enumerated in the order of preference, i.e., the candidates
+  // of |seg| first and those of |next_seg| second, so the first hit in the
+  // batch is the pair to be promoted.
+  std::vector<uint64> fingerprints;
+  fingerprints.reserve(cur_parts.size() * next_parts.size());
+  for (size_t k = 0; k < cur_parts.size(); ++k) {
+    for (size_t l = 0; l < next_parts.size(); ++l) {
+      fingerprints.push_back(CollocationUtil::CombineHashes(
+          cur_parts[k].hash, next_parts[l].hash));
     }
   }
-  return false;
+  const int found = collocation_filter_->FindFirst(fingerprints);
+  if (found < 0) {
+    return false;
+  }
+
+  const size_t i = cur_parts[found / next_parts.size()].index;
+  const size_t j = next_parts[found % next_parts.size()].index;
+  DCHECK(VerifyNaturalContent(
+      next_seg->candidate(j), next_seg->candidate(0), RIGHT))
+      << "IsNaturalContent() should not fail here.";
+  seg->move_candidate(i, 0);
+  seg->mutable_candidate(0)->attributes
+      |= Segment::Candidate::CONTEXT_SENSITIVE;
+  next_seg->move_candidate(j, 0);
+  next_seg->mutable_candidate(0)->attributes
+      |= Segment::Candidate::CONTEXT_SENSITIVE;
+  return true;
 }
 
 }  // namespace mozc
@@ -35,6 +35,25 @@
 #include "base/util.h"
 
 namespace mozc {
+namespace {
+
+// Odd multiplier for the polynomial hash (64-bit FNV prime).
+const uint64 kPolynomialBase = GG_ULONGLONG(0x100000001b3);
+
+// Finalizer of MurmurHash3.  The polynomial hash is weak in its low bits,
+// which the existence filter uses as bit positions, so the bits are mixed
+// before returned as a fingerprint.
+inline uint64 MixBits(uint64 h) {
+  h ^= h >> 33;
+  h *= GG_ULONGLONG(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  h *= GG_ULONGLONG(0xc4ceb9fe1a85ec53);
+  h ^= h >> 33;
+  return h;
+}
+
+}  // namespace
+
 void CollocationUtil::GetNormalizedScript(
     const StringPiece str, bool remove_number, string *output) {
   output->clear();
@@ -76,6 +95,24 @@ bool CollocationUtil::IsNumber(char32 c) {
   return false;
 }
 
+CollocationUtil::PartHash CollocationUtil::HashPart(const StringPiece str) {
+  PartHash result = {0, 1};
+  for (size_t i = 0; i < str.size(); ++i) {
+    result.hash = result.hash * kPolynomialBase + static_cast<uint8>(str[i]);
+    result.scale *= kPolynomialBase;
+  }
+  return result;
+}
+
+uint64 CollocationUtil::CombineHashes(const PartHash &left,
+                                      const PartHash &right) {
+  return MixBits(left.hash * right.scale + right.hash);
+}
+
+uint64 CollocationUtil::Fingerprint(const StringPiece str) {
+  return MixBits(HashPart(str).hash);
+}
+
 void CollocationUtil::RemoveExtraCharacters(
     const StringPiece input, bool remove_number, string *output) {
   for (ConstChar32Iterator iter(input); !iter.Done(); iter.Next()) {
@@ -51,6 +51,25 @@ class CollocationUtil {
   // Returns true if given char is number including kanji.
   static bool IsNumber(char32 c);
 
+  // Hash of a part of a collocation entry. Collocation entries are
+  // concatenations of two normalized strings, and the hash of the
+  // concatenation can be computed from the hashes of the two parts by
+  // CombineHashes(). This lets the rewriter hash every candidate once and test
+  // all the candidate pairs without building joined strings.
+  struct PartHash {
+    uint64 hash;   // Polynomial hash of the part.
+    uint64 scale;  // (Polynomial base)^(length of the part).
+  };
+  static PartHash HashPart(const StringPiece str);
+
+  // Returns the fingerprint of |left| + |right| that is stored in the
+  // collocation existence filter.
+  static uint64 CombineHashes(const PartHash &left, const PartHash &right);
+
+  // Returns the fingerprint of the whole collocation entry |str|.  This is
+  // equal to CombineHashes() for any split of |str| into two parts.
+  static uint64 Fingerprint(const StringPiece str);
+
  private:
   // Removes characters for normalizing.
   static void RemoveExtraCharacters(
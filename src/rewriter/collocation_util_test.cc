@@ -105,4 +105,29 @@ TEST(CollocationUtilTest, GetNormalizedScript) {
   EXPECT_EQ("%%%", result);
 }
 
+TEST(CollocationUtilTest, CombineHashes) {
+  // "猫を飼いたい"
+  const string entry =
+      "\xe7\x8c\xab\xe3\x82\x92\xe9\xa3\xbc\xe3\x81\x84\xe3\x81\x9f"
+      "\xe3\x81\x84";
+  const uint64 expected = CollocationUtil::Fingerprint(entry);
+  for (size_t i = 0; i <= entry.size(); ++i) {
+    const string left = entry.substr(0, i);
+    const string right = entry.substr(i);
+    EXPECT_EQ(expected,
+              CollocationUtil::CombineHashes(CollocationUtil::HashPart(left),
+                                             CollocationUtil::HashPart(right)))
+        << left << " + " << right;
+  }
+
+  // The order of the parts matters.
+  // "猫", "を"
+  EXPECT_NE(CollocationUtil::CombineHashes(
+                CollocationUtil::HashPart("\xe7\x8c\xab"),
+                CollocationUtil::HashPart("\xe3\x82\x92")),
+            CollocationUtil::CombineHashes(
+                CollocationUtil::HashPart("\xe3\x82\x92"),
+                CollocationUtil::HashPart("\xe7\x8c\xab")));
+}
+
 }  // namespace mozc
@@ -44,6 +44,7 @@
 #include "base/flags.h"
 #include "base/init_mozc.h"
 #include "base/logging.h"
+#include "rewriter/collocation_util.h"
 #include "rewriter/gen_existence_data.h"
 
 DEFINE_string(collocation_data, "", "collocation data text");
@@ -57,12 +58,14 @@ namespace {
 void Convert() {
   InputFileStream ifs(FLAGS_collocation_data.c_str());
   string line;
-  std::vector<string> entries;
+  // CollocationRewriter looks up pairs by CollocationUtil::CombineHashes(),
+  // which agrees with CollocationUtil::Fingerprint() of the joined string.
+  std::vector<uint64> entries;
   while (!getline(ifs, line).fail()) {
     if (line.empty()) {
       continue;
     }
-    entries.push_back(line);
+    entries.push_back(CollocationUtil::Fingerprint(line));
   }
 
   std::ostream *ofs = &std::cout;
@@ -47,11 +47,11 @@ using mozc::storage::ExistenceFilter;
 namespace mozc {
 namespace {
 
-void GenExistenceData(const std::vector<string> &entries,
+void GenExistenceData(const std::vector<uint64> &fingerprints,
                       double error_rate,
                       char **existence_data,
                       size_t *existence_data_size) {
-  const int n = entries.size();
+  const int n = fingerprints.size();
   const int m =  ExistenceFilter::MinFilterSizeInBytesForErrorRate(
       error_rate, n);
   LOG(INFO) << "entry: " << n << " err: " << error_rate << " bytes: " << m;
@@ -59,21 +59,42 @@ void GenExistenceData(const std::vector<string> &entries,
   std::unique_ptr<ExistenceFilter> filter(ExistenceFilter::CreateOptimal(m, n));
   DCHECK(filter.get());
 
-  for (size_t i = 0; i < entries.size(); ++i) {
-    const uint64 id = Hash::Fingerprint(entries[i]);
-    filter->Insert(id);
+  for (size_t i = 0; i < fingerprints.size(); ++i) {
+    filter->Insert(fingerprints[i]);
   }
   filter->Write(existence_data, existence_data_size);
 }
 
+std::vector<uint64> FingerprintEntries(const std::vector<string> &entries) {
+  std::vector<uint64> fingerprints;
+  fingerprints.reserve(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    fingerprints.push_back(Hash::Fingerprint(entries[i]));
+  }
+  return fingerprints;
+}
+
 }  // namespace
 
 void OutputExistenceHeader(const std::vector<string> &entries,
                            const string &data_namespace, std::ostream *ofs,
                            double error_rate) {
+  OutputExistenceHeader(FingerprintEntries(entries), data_namespace, ofs,
+                        error_rate);
+}
+
+void OutputExistenceBinary(const std::vector<string> &entries,
+                           std::ostream *ofs, double error_rate) {
+  OutputExistenceBinary(FingerprintEntries(entries), ofs, error_rate);
+}
+
+void OutputExistenceHeader(const std::vector<uint64> &fingerprints,
+                           const string &data_namespace, std::ostream *ofs,
+                           double error_rate) {
   char *existence_data = NULL;
   size_t existence_data_size = 0;
-  GenExistenceData(entries, error_rate, &existence_data, &existence_data_size);
+  GenExistenceData(fingerprints, error_rate, &existence_data,
+                   &existence_data_size);
 
   *ofs << "// This header file is generated by "
        << "gen_existence_data." << std::endl;
@@ -88,11 +109,12 @@ void OutputExistenceHeader(const std::vector<string> &entries,
   *ofs << "}  // namespace " << data_namespace << std::endl;
 }
 
-void OutputExistenceBinary(const std::vector<string> &entries,
+void OutputExistenceBinary(const std::vector<uint64> &fingerprints,
                            std::ostream *ofs, double error_rate) {
   char *existence_data = NULL;
   size_t existence_data_size = 0;
-  GenExistenceData(entries, error_rate, &existence_data, &existence_data_size);
+  GenExistenceData(fingerprints, error_rate, &existence_data,
+                   &existence_data_size);
   ofs->write(existence_data, existence_data_size);
 }
 }  // namespace mozc
@@ -34,14 +34,27 @@
 #include <string>
 #include <vector>
 
+#include "base/port.h"
+
 namespace mozc {
 
+// Generates an existence filter of Hash::Fingerprint() of |entries|.
+
 void OutputExistenceHeader(const std::vector<string> &entries,
                            const string &data_namespace, std::ostream *ofs,
                            double error_rate);
 void OutputExistenceBinary(const std::vector<string> &entries,
                            std::ostream *ofs, double error_rate);
 
+// Same as above but the filter is generated from precomputed fingerprints.
+// Use these when the reader computes fingerprints by a function other than
+// Hash::Fingerprint().
+void OutputExistenceHeader(const std::vector<uint64> &fingerprints,
+                           const string &data_namespace, std::ostream *ofs,
+                           double error_rate);
+void OutputExistenceBinary(const std::vector<uint64> &fingerprints,
+                           std::ostream *ofs, double error_rate);
+
 }  // namespace mozc
 
 #endif  // MOZC_REWRITER_GEN_EXISTENCE_DATA_H_
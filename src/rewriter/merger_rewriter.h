@@ -121,6 +121,19 @@ class MergerRewriter : public RewriterInterface {
     return result;
   }
 
+  // Materializes the candidates deferred by the rewriters.
+  virtual bool ExpandCandidates(Segments *segments,
+                                size_t segment_index,
+                                size_t candidate_size) const {
+    bool result = false;
+    for (size_t i = 0; i < rewriters_.size(); ++i) {
+      result |= rewriters_[i]->ExpandCandidates(segments,
+                                                segment_index,
+                                                candidate_size);
+    }
+    return result;
+  }
+
   // Hook(s) for all mutable operations
   virtual void Finish(const ConversionRequest &request, Segments *segments) {
     for (size_t i = 0; i < rewriters_.size(); ++i) {
@@ -153,6 +166,12 @@ class MergerRewriter : public RewriterInterface {
     }
   }
 
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const {
+    for (size_t i = 0; i < rewriters_.size(); ++i) {
+      rewriters_[i]->CollectMemoryUsage(usage);
+    }
+  }
+
  private:
   std::vector<RewriterInterface *> rewriters_;
 
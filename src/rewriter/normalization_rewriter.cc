@@ -109,4 +109,21 @@ bool NormalizationRewriter::Rewrite(const ConversionRequest &request,
 
   return modified;
 }
+
+bool NormalizationRewriter::ExpandCandidates(Segments *segments,
+                                             size_t segment_index,
+                                             size_t candidate_size) const {
+  DCHECK(segments);
+  if (segment_index >= segments->segments_size()) {
+    return false;
+  }
+  // |candidate_size| is not used since the preceding rewriters may have
+  // inserted candidates after it.
+  Segment *segment = segments->mutable_segment(segment_index);
+  bool modified = false;
+  for (size_t i = 0; i < segment->candidates_size(); ++i) {
+    modified |= NormalizeCandidate(segment->mutable_candidate(i), CANDIDATE);
+  }
+  return modified;
+}
 }  // namespace mozc
@@ -46,6 +46,12 @@ class NormalizationRewriter : public RewriterInterface  {
 
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
+
+  // Normalizes the candidates inserted by the preceding rewriters when the
+  // segment is expanded.
+  virtual bool ExpandCandidates(Segments *segments,
+                                size_t segment_index,
+                                size_t candidate_size) const;
 };
 
 }  // namespace mozc
@@ -113,4 +113,31 @@ TEST_F(NormalizationRewriterTest, NormalizationTest) {
   //  EXPECT_EQ("〜", segments.segment(0).candidate(0).value);
   EXPECT_EQ("\xE3\x80\x9C", segments.segment(0).candidate(0).value);
 }
+
+TEST_F(NormalizationRewriterTest, ExpandCandidates) {
+  NormalizationRewriter normalization_rewriter;
+  Segments segments;
+  AddSegment("test", "test", &segments);
+  // A candidate inserted after Rewrite(), e.g., by VariantsRewriter.
+  // "〜"
+  Segment::Candidate *candidate =
+      segments.mutable_segment(0)->add_candidate();
+  candidate->Init();
+  candidate->value = "\xE3\x80\x9C";
+  candidate->content_value = "\xE3\x80\x9C";
+
+  EXPECT_FALSE(normalization_rewriter.ExpandCandidates(&segments, 1, 2));
+#ifdef OS_WIN
+  EXPECT_TRUE(normalization_rewriter.ExpandCandidates(&segments, 0, 1));
+  // U+FF5E
+  //  EXPECT_EQ("～", segments.segment(0).candidate(1).value);
+  EXPECT_EQ("\xEF\xBD\x9E", segments.segment(0).candidate(1).value);
+#else
+  EXPECT_FALSE(normalization_rewriter.ExpandCandidates(&segments, 0, 1));
+  // U+301C
+  //  EXPECT_EQ("〜", segments.segment(0).candidate(1).value);
+  EXPECT_EQ("\xE3\x80\x9C", segments.segment(0).candidate(1).value);
+#endif
+  EXPECT_EQ("test", segments.segment(0).candidate(0).value);
+}
 }  // namespace mozc
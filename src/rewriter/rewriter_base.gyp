@@ -105,9 +105,11 @@
       'type': 'executable',
       'toolsets': ['host'],
       'sources': [
+        'collocation_util.cc',
         'gen_collocation_data_main.cc',
       ],
       'dependencies': [
+        '../base/base.gyp:base',
         'gen_existence_data',
       ],
     },
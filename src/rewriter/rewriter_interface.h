@@ -37,6 +37,8 @@
 
 namespace mozc {
 
+class MemoryUsage;
+
 class RewriterInterface {
  public:
   virtual ~RewriterInterface() {}
@@ -70,6 +72,16 @@ class RewriterInterface {
     return true;
   }
 
+  // This method is called before the candidates of the segment are shown,
+  // e.g., when the candidate list is built. Rewriters that defer costly
+  // candidate generation in Rewrite() materialize the candidates within the
+  // first |candidate_size| ones here. Returns true if the segment is modified.
+  virtual bool ExpandCandidates(Segments *segments,
+                                size_t segment_index,
+                                size_t candidate_size) const {
+    return false;
+  }
+
   // Hook(s) for all mutable operations
   virtual void Finish(const ConversionRequest &request, Segments *segments) {}
 
@@ -82,6 +94,9 @@ class RewriterInterface {
   // clear internal data
   virtual void Clear() {}
 
+  // report the heap memory held by internal tables to |usage|.
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const {}
+
  protected:
   RewriterInterface() {}
 };
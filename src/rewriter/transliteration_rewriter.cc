@@ -217,11 +217,57 @@ void GetIds(const Segment &segment, T13nIds *ids) {
   }
 }
 
+bool IsGodan(const ConversionRequest &request) {
+  return request.request().special_romanji_table() ==
+      commands::Request::GODAN_TO_HIRAGANA;
+}
+
+// Gets the transliterations of the range of the composition.  The composer
+// builds only the types which differ in the source text or the character
+// width; the types which differ only in the letter case are derived here.
+void GetT13nsFromComposer(const ConversionRequest &request,
+                          size_t position, size_t size,
+                          std::vector<string> *t13ns) {
+  const composer::Composer &composer = request.composer();
+  t13ns->clear();
+  t13ns->resize(transliteration::NUM_T13N_TYPES);
+  composer.GetSubTransliteration(transliteration::HIRAGANA, position, size,
+                                 &(*t13ns)[transliteration::HIRAGANA]);
+  composer.GetSubTransliteration(transliteration::FULL_KATAKANA, position,
+                                 size,
+                                 &(*t13ns)[transliteration::FULL_KATAKANA]);
+  composer.GetSubTransliteration(transliteration::HALF_KATAKANA, position,
+                                 size,
+                                 &(*t13ns)[transliteration::HALF_KATAKANA]);
+  composer.GetSubTransliteration(transliteration::HALF_ASCII, position, size,
+                                 &(*t13ns)[transliteration::HALF_ASCII]);
+  // ModifyT13nsForGodan() rebuilds the other ASCII types from HALF_ASCII.
+  if (IsGodan(request)) {
+    return;
+  }
+
+  const string &half_ascii = (*t13ns)[transliteration::HALF_ASCII];
+  (*t13ns)[transliteration::HALF_ASCII_UPPER] = half_ascii;
+  (*t13ns)[transliteration::HALF_ASCII_LOWER] = half_ascii;
+  (*t13ns)[transliteration::HALF_ASCII_CAPITALIZED] = half_ascii;
+  Util::UpperString(&(*t13ns)[transliteration::HALF_ASCII_UPPER]);
+  Util::LowerString(&(*t13ns)[transliteration::HALF_ASCII_LOWER]);
+  Util::CapitalizeString(&(*t13ns)[transliteration::HALF_ASCII_CAPITALIZED]);
+
+  const string &full_ascii = (*t13ns)[transliteration::FULL_ASCII];
+  composer.GetSubTransliteration(transliteration::FULL_ASCII, position, size,
+                                 &(*t13ns)[transliteration::FULL_ASCII]);
+  (*t13ns)[transliteration::FULL_ASCII_UPPER] = full_ascii;
+  (*t13ns)[transliteration::FULL_ASCII_LOWER] = full_ascii;
+  (*t13ns)[transliteration::FULL_ASCII_CAPITALIZED] = full_ascii;
+  Util::UpperString(&(*t13ns)[transliteration::FULL_ASCII_UPPER]);
+  Util::LowerString(&(*t13ns)[transliteration::FULL_ASCII_LOWER]);
+  Util::CapitalizeString(&(*t13ns)[transliteration::FULL_ASCII_CAPITALIZED]);
+}
+
 void ModifyT13ns(const ConversionRequest &request,
                  const Segment &segment, std::vector<string> *t13ns) {
-  commands::Request::SpecialRomanjiTable special_romanji_table =
-      request.request().special_romanji_table();
-  if (special_romanji_table == commands::Request::GODAN_TO_HIRAGANA) {
+  if (IsGodan(request)) {
     ModifyT13nsForGodan(segment.key(), t13ns);
   }
 
@@ -240,7 +286,7 @@ bool TransliterationRewriter::FillT13nsFromComposer(
   if (segments->conversion_segments_size() == 1 &&
       request.composer().GetLength() == request.composer().GetCursor()) {
     std::vector<string> t13ns;
-    request.composer().GetTransliterations(&t13ns);
+    GetT13nsFromComposer(request, 0, request.composer().GetLength(), &t13ns);
     Segment *segment = segments->mutable_conversion_segment(0);
     CHECK(segment);
     ModifyT13ns(request, *segment, &t13ns);
@@ -260,9 +306,7 @@ bool TransliterationRewriter::FillT13nsFromComposer(
     }
     const size_t composition_len = Util::CharsLen(key);
     std::vector<string> t13ns;
-    request.composer().GetSubTransliterations(composition_pos,
-                                              composition_len,
-                                              &t13ns);
+    GetT13nsFromComposer(request, composition_pos, composition_len, &t13ns);
     composition_pos += composition_len;
 
     ModifyT13ns(request, *segment, &t13ns);
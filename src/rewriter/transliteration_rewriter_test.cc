@@ -221,6 +221,41 @@ TEST_F(TransliterationRewriterTest, T13nFromComposerTest) {
   }
 }
 
+TEST_F(TransliterationRewriterTest, T13nFromComposerBuildsOnlyBaseTypes) {
+  std::unique_ptr<TransliterationRewriter> t13n_rewriter(
+      CreateTransliterationRewriter());
+
+  composer::Table table;
+  table.InitializeWithRequestAndConfig(default_request(), default_config(),
+                                       mock_data_manager_);
+  composer::Composer composer(&table, &default_request(), &default_config());
+  SetAkann(&composer);
+
+  Segments segments;
+  Segment *segment = segments.add_segment();
+  // "あかん"
+  segment->set_key("\xe3\x81\x82\xe3\x81\x8b\xe3\x82\x93");
+  ConversionRequest request(&composer, &default_request(), &default_config());
+  EXPECT_TRUE(t13n_rewriter->Rewrite(request, &segments));
+  EXPECT_EQ("AKANN", segment->meta_candidate(
+      transliteration::HALF_ASCII_UPPER).value);
+
+  // The types differing only in the letter case are not built by the
+  // composer.
+  const size_t length = composer.GetLength();
+  EXPECT_TRUE(composer.IsSubTransliterationCachedForTest(
+      transliteration::HIRAGANA, 0, length));
+  EXPECT_TRUE(composer.IsSubTransliterationCachedForTest(
+      transliteration::HALF_ASCII, 0, length));
+  EXPECT_TRUE(composer.IsSubTransliterationCachedForTest(
+      transliteration::FULL_ASCII, 0, length));
+  EXPECT_FALSE(composer.IsSubTransliterationCachedForTest(
+      transliteration::HALF_ASCII_UPPER, 0, length));
+  EXPECT_FALSE(composer.IsSubTransliterationCachedForTest(
+      transliteration::HALF_ASCII_CAPITALIZED, 0, length));
+  EXPECT_FALSE(composer.IsSubTransliterationCachedForTest(
+      transliteration::FULL_ASCII_LOWER, 0, length));
+}
 
 TEST_F(TransliterationRewriterTest, KeyOfT13nFromComposerTest) {
   std::unique_ptr<TransliterationRewriter> t13n_rewriter(
@@ -941,6 +976,10 @@ TEST_F(TransliterationRewriterTest, MobileT13nTestWithGodan) {
     EXPECT_EQ("\xef\xbd\xb1\xef\xbe\x9d\xef\xbe\x9f\xef\xbe\x83\xef\xbe\x9e",
               seg.meta_candidate(transliteration::HALF_KATAKANA).value);
   }
+
+  // The other ASCII types are built from HALF_ASCII, not by the composer.
+  EXPECT_FALSE(composer.IsSubTransliterationCachedForTest(
+      transliteration::FULL_ASCII, 0, composer.GetLength()));
 }
 
 TEST_F(TransliterationRewriterTest, MobileT13nTest_ValidateGodanT13nTable) {
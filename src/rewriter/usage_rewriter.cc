@@ -34,6 +34,7 @@
 #include <string>
 
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/serialized_string_array.h"
 #include "base/util.h"
 #include "config/config_handler.h"
@@ -103,6 +104,17 @@ UsageRewriter::UsageRewriter(const DataManagerInterface *data_manager,
 UsageRewriter::~UsageRewriter() {
 }
 
+void UsageRewriter::CollectMemoryUsage(MemoryUsage *usage) const {
+  // Each node of std::map holds the value, three links and the color.
+  size_t bytes = key_value_usageitem_map_.size() *
+      (sizeof(std::map<StrPair, UsageDictItemIterator>::value_type) +
+       4 * sizeof(void *));
+  for (const auto &kv : key_value_usageitem_map_) {
+    bytes += kv.first.first.capacity() + kv.first.second.capacity();
+  }
+  usage->Add("usage", bytes);
+}
+
 // static
 // "合いました" => "合い"
 string UsageRewriter::GetKanjiPrefixAndOneHiragana(const string &word) {
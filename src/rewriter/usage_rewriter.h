@@ -61,6 +61,8 @@ class UsageRewriter : public RewriterInterface  {
     return CONVERSION | PREDICTION;
   }
 
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const;
+
  private:
   FRIEND_TEST(UsageRewriterTest, GetKanjiPrefixAndOneHiragana);
 
@@ -38,6 +38,7 @@
 #include "base/config_file_stream.h"
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/util.h"
 #include "config/config_handler.h"
 #include "converter/converter_interface.h"
@@ -331,4 +332,10 @@ void UserBoundaryHistoryRewriter::Clear() {
   }
 }
 
+void UserBoundaryHistoryRewriter::CollectMemoryUsage(MemoryUsage *usage) const {
+  if (storage_.get() != NULL) {
+    usage->Add("user_boundary_history", storage_->GetAllocatedBytes());
+  }
+}
+
 }  // namespace mozc
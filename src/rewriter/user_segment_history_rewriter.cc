@@ -39,6 +39,7 @@
 #include "base/config_file_stream.h"
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/number_util.h"
 #include "base/string_piece.h"
 #include "base/util.h"
@@ -1033,6 +1034,12 @@ void UserSegmentHistoryRewriter::Clear() {
   }
 }
 
+void UserSegmentHistoryRewriter::CollectMemoryUsage(MemoryUsage *usage) const {
+  if (storage_.get() != NULL) {
+    usage->Add("user_segment_history", storage_->GetAllocatedBytes());
+  }
+}
+
 bool UserSegmentHistoryRewriter::IsPunctuation(
     const Segment &seg,
     const Segment::Candidate &candidate) const {
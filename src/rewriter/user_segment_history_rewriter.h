@@ -65,6 +65,8 @@ class UserSegmentHistoryRewriter : public RewriterInterface {
 
   virtual void Clear();
 
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const;
+
  private:
   bool IsAvailable(const ConversionRequest &request,
                    const Segments &segments) const;
@@ -29,12 +29,14 @@
 
 #include "rewriter/variants_rewriter.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/logging.h"
 #include "base/number_util.h"
 #include "base/string_piece.h"
+#include "base/text_normalizer.h"
 #include "base/util.h"
 #include "config/character_form_manager.h"
 #include "converter/segments.h"
@@ -105,6 +107,23 @@ void AppendString(StringPiece src, string *dst) {
   }
 }
 
+// Return false if |value| consists only of Kanji and Hiragana, which have no
+// full/half width forms.  When true is returned, |value| may have an
+// alternative form.
+bool MayHaveAlternativeForm(StringPiece value) {
+  const char *begin = value.data();
+  const char *end = value.data() + value.size();
+  while (begin < end) {
+    size_t mblen = 0;
+    const Util::ScriptType type = Util::GetScriptType(begin, end, &mblen);
+    if (type != Util::KANJI && type != Util::HIRAGANA) {
+      return true;
+    }
+    begin += mblen;
+  }
+  return false;
+}
+
 // Return true if all charcters in |value| are UNKNOWN_SCRIPT
 // and FormType of |value| are consistent, e.g. all fullwith or
 // all halfwidth.
@@ -349,6 +368,30 @@ bool VariantsRewriter::RewriteSegment(RewriteType type, Segment *seg) const {
       continue;
     }
 
+    if (type == EXPAND_VARIANT) {
+      // Rewrite original to default and defer the generation of the
+      // alternative until ExpandCandidates() is called for this segment.
+      // The description is also set at that time, since it depends on
+      // whether the alternative is shown next to the default.
+      if (!MayHaveAlternativeForm(original_candidate->value)) {
+        SetDescriptionForCandidate(pos_matcher_, original_candidate);
+        continue;
+      }
+      if (GenerateDefault(*original_candidate,
+                          &default_value,
+                          &default_content_value,
+                          &default_inner_segment_boundary)) {
+        original_candidate->value = default_value;
+        original_candidate->content_value = default_content_value;
+        original_candidate->inner_segment_boundary.swap(
+            default_inner_segment_boundary);
+      }
+      original_candidate->attributes |= Segment::Candidate::VARIANTS_DEFERRED;
+      modified = true;
+      continue;
+    }
+
+    DCHECK_EQ(SELECT_VARIANT, type);
     if (!GenerateAlternatives(*original_candidate,
                               &default_value,
                               &alternative_value,
@@ -360,72 +403,149 @@ bool VariantsRewriter::RewriteSegment(RewriteType type, Segment *seg) const {
       continue;
     }
 
-    CharacterFormManager::FormType default_form
-        = CharacterFormManager::UNKNOWN_FORM;
-    CharacterFormManager::FormType alternative_form
-        = CharacterFormManager::UNKNOWN_FORM;
-
-    int default_description_type =
-        (CHARACTER_FORM | PLATFORM_DEPENDENT_CHARACTER |
-         ZIPCODE | SPELLING_CORRECTION);
-
-    int alternative_description_type =
-        (CHARACTER_FORM | PLATFORM_DEPENDENT_CHARACTER |
-         ZIPCODE | SPELLING_CORRECTION);
-
-    if (CharacterFormManager::GetFormTypesFromStringPair(
-            default_value,
-            &default_form,
-            alternative_value,
-            &alternative_form)) {
-      if (default_form == CharacterFormManager::HALF_WIDTH) {
-        default_description_type |= HALF_WIDTH;
-      } else if (default_form == CharacterFormManager::FULL_WIDTH) {
-        default_description_type |= FULL_WIDTH;
-      }
-      if (alternative_form == CharacterFormManager::HALF_WIDTH) {
-        alternative_description_type |= HALF_WIDTH;
-      } else if (alternative_form == CharacterFormManager::FULL_WIDTH) {
-        alternative_description_type |= FULL_WIDTH;
-      }
-    } else {
-      default_description_type     |= FULL_HALF_WIDTH;
-      alternative_description_type |= FULL_HALF_WIDTH;
+    int default_description_type = 0;
+    int alternative_description_type = 0;
+    GetDescriptionTypes(default_value, alternative_value,
+                        &default_description_type,
+                        &alternative_description_type);
+
+    // Rewrite original to default
+    original_candidate->value = default_value;
+    original_candidate->content_value = default_content_value;
+    original_candidate->inner_segment_boundary.swap(
+        default_inner_segment_boundary);
+    SetDescription(pos_matcher_,
+                   default_description_type, original_candidate);
+    modified = true;
+  }
+  return modified;
+}
+
+// static
+void VariantsRewriter::GetDescriptionTypes(const string &default_value,
+                                           const string &alternative_value,
+                                           int *default_description_type,
+                                           int *alternative_description_type) {
+  CharacterFormManager::FormType default_form
+      = CharacterFormManager::UNKNOWN_FORM;
+  CharacterFormManager::FormType alternative_form
+      = CharacterFormManager::UNKNOWN_FORM;
+
+  *default_description_type =
+      (CHARACTER_FORM | PLATFORM_DEPENDENT_CHARACTER |
+       ZIPCODE | SPELLING_CORRECTION);
+
+  *alternative_description_type =
+      (CHARACTER_FORM | PLATFORM_DEPENDENT_CHARACTER |
+       ZIPCODE | SPELLING_CORRECTION);
+
+  if (CharacterFormManager::GetFormTypesFromStringPair(
+          default_value,
+          &default_form,
+          alternative_value,
+          &alternative_form)) {
+    if (default_form == CharacterFormManager::HALF_WIDTH) {
+      *default_description_type |= HALF_WIDTH;
+    } else if (default_form == CharacterFormManager::FULL_WIDTH) {
+      *default_description_type |= FULL_WIDTH;
+    }
+    if (alternative_form == CharacterFormManager::HALF_WIDTH) {
+      *alternative_description_type |= HALF_WIDTH;
+    } else if (alternative_form == CharacterFormManager::FULL_WIDTH) {
+      *alternative_description_type |= FULL_WIDTH;
     }
+  } else {
+    *default_description_type     |= FULL_HALF_WIDTH;
+    *alternative_description_type |= FULL_HALF_WIDTH;
+  }
+}
 
-    if (type == EXPAND_VARIANT) {
-      // Insert default candidate to position |i| and
-      // rewrite original(|i+1|) to altenative
-      Segment::Candidate *new_candidate = seg->insert_candidate(i);
-      DCHECK(new_candidate);
-
-      new_candidate->Init();
-      new_candidate->key = original_candidate->key;
-      new_candidate->value = default_value;
-      new_candidate->content_key = original_candidate->content_key;
-      new_candidate->content_value = default_content_value;
-      new_candidate->cost = original_candidate->cost;
-      new_candidate->structure_cost = original_candidate->structure_cost;
-      new_candidate->lid = original_candidate->lid;
-      new_candidate->rid = original_candidate->rid;
-      new_candidate->description = original_candidate->description;
-      SetDescription(pos_matcher_, default_description_type, new_candidate);
-
-      original_candidate->value = alternative_value;
-      original_candidate->content_value = alternative_content_value;
-      SetDescription(pos_matcher_,
-                     alternative_description_type, original_candidate);
-      ++i;  // skip inserted candidate
-    } else if (type == SELECT_VARIANT) {
-      // Rewrite original to default
-      original_candidate->value = default_value;
-      original_candidate->content_value = default_content_value;
-      original_candidate->inner_segment_boundary.swap(
-          default_inner_segment_boundary);
-      SetDescription(pos_matcher_,
-                     default_description_type, original_candidate);
+bool VariantsRewriter::ExpandCandidates(Segments *segments,
+                                        size_t segment_index,
+                                        size_t candidate_size) const {
+  CHECK(segments);
+  if (segment_index >= segments->segments_size()) {
+    return false;
+  }
+  Segment *seg = segments->mutable_segment(segment_index);
+  DCHECK(seg);
+
+  // An alternative equal to a value already in the segment is not inserted.
+  // NormalizationRewriter::ExpandCandidates() normalizes the inserted values
+  // afterwards, so they are compared in the normalized form.
+  std::set<string> values;
+  for (size_t i = 0; i < seg->candidates_size(); ++i) {
+    values.insert(seg->candidate(i).value);
+  }
+
+  bool modified = false;
+  string default_value, alternative_value, normalized_alternative_value;
+  string default_content_value, alternative_content_value;
+  std::vector<uint32> default_inner_segment_boundary;
+  std::vector<uint32> alternative_inner_segment_boundary;
+  for (size_t i = 0; i < seg->candidates_size() && i < candidate_size; ++i) {
+    Segment::Candidate *candidate = seg->mutable_candidate(i);
+    DCHECK(candidate);
+    if (!(candidate->attributes & Segment::Candidate::VARIANTS_DEFERRED)) {
+      continue;
     }
+    candidate->attributes &= ~Segment::Candidate::VARIANTS_DEFERRED;
     modified = true;
+
+    // The candidate already holds the default form, so the alternative is
+    // generated from it.  Only the candidates which may have an alternative
+    // are deferred; the others get their descriptions here.
+    bool has_alternative = GenerateAlternatives(
+        *candidate,
+        &default_value,
+        &alternative_value,
+        &default_content_value,
+        &alternative_content_value,
+        &default_inner_segment_boundary,
+        &alternative_inner_segment_boundary);
+    if (has_alternative) {
+      normalized_alternative_value.clear();
+      TextNormalizer::NormalizeText(alternative_value,
+                                    &normalized_alternative_value);
+      has_alternative =
+          values.insert(normalized_alternative_value).second;
+    }
+    if (!has_alternative) {
+      if (!(candidate->attributes &
+            Segment::Candidate::NO_EXTRA_DESCRIPTION)) {
+        SetDescriptionForCandidate(pos_matcher_, candidate);
+      }
+      continue;
+    }
+
+    int default_description_type = 0;
+    int alternative_description_type = 0;
+    GetDescriptionTypes(default_value, alternative_value,
+                        &default_description_type,
+                        &alternative_description_type);
+
+    // Insert alternative candidate to position |i + 1|.
+    Segment::Candidate *new_candidate = seg->insert_candidate(i + 1);
+    DCHECK(new_candidate);
+    // |candidate| may be invalidated by the insertion.
+    candidate = seg->mutable_candidate(i);
+    new_candidate->CopyFrom(*candidate);
+    new_candidate->value = alternative_value;
+    new_candidate->content_value = alternative_content_value;
+    new_candidate->inner_segment_boundary.swap(
+        alternative_inner_segment_boundary);
+    if (new_candidate->attributes &
+        Segment::Candidate::NO_EXTRA_DESCRIPTION) {
+      // Another rewriter has already annotated the default form.
+      new_candidate->description.clear();
+      new_candidate->prefix.clear();
+    } else {
+      SetDescription(pos_matcher_, default_description_type, candidate);
+    }
+    SetDescription(pos_matcher_,
+                   alternative_description_type, new_candidate);
+    ++i;  // skip inserted candidate
+    ++candidate_size;
   }
   return modified;
 }
@@ -523,6 +643,62 @@ bool VariantsRewriter::GenerateAlternatives(
   return at_least_one_modified;
 }
 
+// Try generating the default character form only.  Inner segment boundary is
+// taken into account.  When the default form is the same as |original|,
+// false is returned.
+bool VariantsRewriter::GenerateDefault(
+    const Segment::Candidate &original,
+    string *default_value,
+    string *default_content_value,
+    std::vector<uint32> *default_inner_segment_boundary) const {
+  default_value->clear();
+  default_content_value->clear();
+  default_inner_segment_boundary->clear();
+
+  const config::CharacterFormManager *manager =
+      CharacterFormManager::GetCharacterFormManager();
+
+  // See GenerateAlternatives() for the validity check.
+  if (original.inner_segment_boundary.empty() || !original.IsValid()) {
+    manager->ConvertConversionString(original.value, default_value);
+    if (original.value != original.content_value) {
+      manager->ConvertConversionString(original.content_value,
+                                       default_content_value);
+    } else {
+      default_content_value->assign(*default_value);
+    }
+    return *default_value != original.value ||
+        *default_content_value != original.content_value;
+  }
+
+  bool at_least_one_modified = false;
+  string tmp, inner_default_value, inner_default_content_value;
+  for (Segment::Candidate::InnerSegmentIterator iter(&original);
+       !iter.Done(); iter.Next()) {
+    iter.GetValue().CopyToString(&tmp);
+    manager->ConvertConversionString(tmp, &inner_default_value);
+    if (iter.GetValue() != iter.GetContentValue()) {
+      iter.GetContentValue().CopyToString(&tmp);
+      manager->ConvertConversionString(tmp, &inner_default_content_value);
+    } else {
+      inner_default_content_value = inner_default_value;
+    }
+    if (iter.GetValue() != inner_default_value ||
+        iter.GetContentValue() != inner_default_content_value) {
+      at_least_one_modified = true;
+    }
+    default_value->append(inner_default_value);
+    default_content_value->append(inner_default_content_value);
+    default_inner_segment_boundary->push_back(
+        Segment::Candidate::EncodeLengths(
+            iter.GetKey().size(),
+            inner_default_value.size(),
+            iter.GetContentKey().size(),
+            inner_default_content_value.size()));
+  }
+  return at_least_one_modified;
+}
+
 void VariantsRewriter::Finish(const ConversionRequest &request,
                               Segments *segments) {
   if (segments->request_type() != Segments::CONVERSION) {
@@ -59,6 +59,11 @@ class VariantsRewriter : public RewriterInterface {
   virtual int capability(const ConversionRequest &request) const;
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
+  // Inserts the alternative forms deferred by Rewrite() next to the
+  // candidates within the first |candidate_size| ones of the segment.
+  virtual bool ExpandCandidates(Segments *segments,
+                                size_t segment_index,
+                                size_t candidate_size) const;
   virtual void Finish(const ConversionRequest &request, Segments *segments);
   virtual void Clear();
 
@@ -102,6 +107,10 @@ class VariantsRewriter : public RewriterInterface {
   static void SetDescription(const dictionary::POSMatcher &pos_matcher,
                              int description_type,
                              Segment::Candidate *candidate);
+  static void GetDescriptionTypes(const string &default_value,
+                                  const string &alternative_value,
+                                  int *default_description_type,
+                                  int *alternative_description_type);
   bool RewriteSegment(RewriteType type, Segment *seg) const;
   bool GenerateAlternatives(
       const Segment::Candidate &original,
@@ -111,6 +120,11 @@ class VariantsRewriter : public RewriterInterface {
       string *alternative_content_value,
       std::vector<uint32> *default_inner_segment_boundary,
       std::vector<uint32> *alternative_inner_segment_boundary) const;
+  bool GenerateDefault(
+      const Segment::Candidate &original,
+      string *default_value,
+      string *default_content_value,
+      std::vector<uint32> *default_inner_segment_boundary) const;
 
   const dictionary::POSMatcher pos_matcher_;
 };
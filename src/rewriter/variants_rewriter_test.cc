@@ -30,6 +30,7 @@
 #include "rewriter/variants_rewriter.h"
 
 #include <memory>
+#include <set>
 #include <string>
 
 #include "base/logging.h"
@@ -132,6 +133,8 @@ TEST_F(VariantsRewriterTest, RewriteTest) {
       SetCharacterForm("012", Config::FULL_WIDTH);
 
     EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                            seg->candidates_size()));
     EXPECT_EQ(2, seg->candidates_size());
     // "０１２"
     EXPECT_EQ("\xef\xbc\x90\xef\xbc\x91\xef\xbc\x92", seg->candidate(0).value);
@@ -166,6 +169,8 @@ TEST_F(VariantsRewriterTest, RewriteTest) {
       SetCharacterForm("abc", Config::FULL_WIDTH);
 
     EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                            seg->candidates_size()));
     EXPECT_EQ(2, seg->candidates_size());
     // "Ｇｏｏｇｌｅ"
     EXPECT_EQ("\xef\xbc\xa7\xef\xbd\x8f\xef\xbd\x8f\xef\xbd\x87\xef\xbd\x8c\xef"
@@ -187,6 +192,8 @@ TEST_F(VariantsRewriterTest, RewriteTest) {
       SetCharacterForm("@", Config::FULL_WIDTH);
 
     EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                            seg->candidates_size()));
     EXPECT_EQ(2, seg->candidates_size());
     // "＠"
     EXPECT_EQ("\xef\xbc\xa0", seg->candidate(0).value);
@@ -210,7 +217,17 @@ TEST_F(VariantsRewriterTest, RewriteTest) {
       SetCharacterForm("\xe3\x82\xa2\xe3\x82\xa4\xe3\x82\xa6",
                        Config::FULL_WIDTH);
 
-    EXPECT_FALSE(rewriter->Rewrite(request, &segments));
+    // Only the default form is generated by Rewrite(), so whether the
+    // candidate has an alternative is known when it is expanded.
+    EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                            seg->candidates_size()));
+    EXPECT_EQ(1, seg->candidates_size());
+    // "グーグル"
+    EXPECT_EQ("\xe3\x82\xb0\xe3\x83\xbc\xe3\x82\xb0\xe3\x83\xab",
+              seg->candidate(0).value);
+    EXPECT_FALSE(seg->candidate(0).attributes &
+                 Segment::Candidate::VARIANTS_DEFERRED);
     seg->clear_candidates();
   }
 
@@ -228,6 +245,8 @@ TEST_F(VariantsRewriterTest, RewriteTest) {
                            Config::HALF_WIDTH);
 
      EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+     EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                             seg->candidates_size()));
      EXPECT_EQ(2, seg->candidates_size());
      // "ｸﾞｰｸﾞﾙ"
      EXPECT_EQ("\xef\xbd\xb8\xef\xbe\x9e\xef\xbd\xb0\xef\xbd\xb8\xef\xbe\x9e"
@@ -271,6 +290,8 @@ TEST_F(VariantsRewriterTest, RewriteTestManyCandidates) {
     }
 
     EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                            seg->candidates_size()));
     EXPECT_EQ(30, seg->candidates_size());
 
     for (int i = 0; i < 10; ++i) {
@@ -311,6 +332,8 @@ TEST_F(VariantsRewriterTest, RewriteTestManyCandidates) {
     }
 
     EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                            seg->candidates_size()));
     EXPECT_EQ(30, seg->candidates_size());
 
     for (int i = 0; i < 10; ++i) {
@@ -664,6 +687,8 @@ TEST_F(VariantsRewriterTest, RewriteForConversion) {
     }
     EXPECT_TRUE(rewriter->Rewrite(request, &segments));
     EXPECT_EQ(1, segments.segments_size());
+    EXPECT_EQ(1, segments.segment(0).candidates_size());
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0, 1));
     EXPECT_EQ(2, segments.segment(0).candidates_size());
 
     EXPECT_EQ(Config::FULL_WIDTH,
@@ -690,6 +715,8 @@ TEST_F(VariantsRewriterTest, RewriteForConversion) {
     }
     EXPECT_TRUE(rewriter->Rewrite(request, &segments));
     EXPECT_EQ(1, segments.segments_size());
+    EXPECT_EQ(1, segments.segment(0).candidates_size());
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0, 1));
     EXPECT_EQ(2, segments.segment(0).candidates_size());
 
     EXPECT_EQ(Config::HALF_WIDTH,
@@ -713,6 +740,8 @@ TEST_F(VariantsRewriterTest, RewriteForPrediction) {
     InitSegmentsForAlphabetRewrite("abc", &segments);
     EXPECT_TRUE(rewriter->Rewrite(request, &segments));
     EXPECT_EQ(1, segments.segments_size());
+    EXPECT_EQ(1, segments.segment(0).candidates_size());
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0, 1));
     EXPECT_EQ(2, segments.segment(0).candidates_size());
 
     EXPECT_EQ(Config::FULL_WIDTH,
@@ -730,6 +759,8 @@ TEST_F(VariantsRewriterTest, RewriteForPrediction) {
     InitSegmentsForAlphabetRewrite("abc", &segments);
     EXPECT_TRUE(rewriter->Rewrite(request, &segments));
     EXPECT_EQ(1, segments.segments_size());
+    EXPECT_EQ(1, segments.segment(0).candidates_size());
+    EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0, 1));
     EXPECT_EQ(2, segments.segment(0).candidates_size());
 
     EXPECT_EQ(Config::HALF_WIDTH,
@@ -819,6 +850,161 @@ TEST_F(VariantsRewriterTest, RewriteForSuggestion) {
   }
 }
 
+TEST_F(VariantsRewriterTest, ExpandCandidates) {
+  std::unique_ptr<VariantsRewriter> rewriter(CreateVariantsRewriter());
+  const ConversionRequest request;
+  CharacterFormManager::GetCharacterFormManager()->
+      SetCharacterForm("abc", Config::FULL_WIDTH);
+
+  Segments segments;
+  segments.set_request_type(Segments::CONVERSION);
+  Segment *segment = segments.push_back_segment();
+  segment->set_key("abc");
+  const char *kValues[] = {"abc", "xyz"};
+  for (size_t i = 0; i < arraysize(kValues); ++i) {
+    Segment::Candidate *candidate = segment->add_candidate();
+    candidate->Init();
+    candidate->key = "abc";
+    candidate->content_key = "abc";
+    candidate->value = kValues[i];
+    candidate->content_value = kValues[i];
+  }
+
+  // Alternatives are deferred and only the default forms are kept.
+  EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+  ASSERT_EQ(2, segment->candidates_size());
+  // "ａｂｃ"
+  EXPECT_EQ("\xef\xbd\x81\xef\xbd\x82\xef\xbd\x83",
+            segment->candidate(0).value);
+  // "ｘｙｚ"
+  EXPECT_EQ("\xef\xbd\x98\xef\xbd\x99\xef\xbd\x9a",
+            segment->candidate(1).value);
+  EXPECT_TRUE(segment->candidate(0).attributes &
+              Segment::Candidate::VARIANTS_DEFERRED);
+  EXPECT_TRUE(segment->candidate(1).attributes &
+              Segment::Candidate::VARIANTS_DEFERRED);
+
+  EXPECT_FALSE(rewriter->ExpandCandidates(&segments, 0, 0));
+  EXPECT_EQ(2, segment->candidates_size());
+  EXPECT_FALSE(rewriter->ExpandCandidates(&segments, 1, 2));
+
+  // Only the first candidate is expanded.
+  EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0, 1));
+  ASSERT_EQ(3, segment->candidates_size());
+  EXPECT_EQ("\xef\xbd\x81\xef\xbd\x82\xef\xbd\x83",
+            segment->candidate(0).value);
+  EXPECT_EQ("abc", segment->candidate(1).value);
+  EXPECT_EQ("abc", segment->candidate(1).content_value);
+  EXPECT_EQ("\xef\xbd\x98\xef\xbd\x99\xef\xbd\x9a",
+            segment->candidate(2).value);
+  EXPECT_FALSE(segment->candidate(0).attributes &
+               Segment::Candidate::VARIANTS_DEFERRED);
+  EXPECT_FALSE(segment->candidate(1).attributes &
+               Segment::Candidate::VARIANTS_DEFERRED);
+  EXPECT_TRUE(segment->candidate(2).attributes &
+              Segment::Candidate::VARIANTS_DEFERRED);
+  EXPECT_EQ(string(VariantsRewriter::kFullWidth) + " " +
+            VariantsRewriter::kAlphabet,
+            segment->candidate(0).description);
+  EXPECT_EQ(string(VariantsRewriter::kHalfWidth) + " " +
+            VariantsRewriter::kAlphabet,
+            segment->candidate(1).description);
+
+  // Already expanded candidates are kept as they are.
+  EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                         segment->candidates_size()));
+  ASSERT_EQ(4, segment->candidates_size());
+  EXPECT_EQ("\xef\xbd\x81\xef\xbd\x82\xef\xbd\x83",
+            segment->candidate(0).value);
+  EXPECT_EQ("abc", segment->candidate(1).value);
+  EXPECT_EQ("\xef\xbd\x98\xef\xbd\x99\xef\xbd\x9a",
+            segment->candidate(2).value);
+  EXPECT_EQ("xyz", segment->candidate(3).value);
+
+  EXPECT_FALSE(rewriter->ExpandCandidates(&segments, 0,
+                                          segment->candidates_size()));
+  EXPECT_EQ(4, segment->candidates_size());
+}
+
+TEST_F(VariantsRewriterTest, ExpandCandidatesWithoutDuplicates) {
+  std::unique_ptr<VariantsRewriter> rewriter(CreateVariantsRewriter());
+  const ConversionRequest request;
+  CharacterFormManager::GetCharacterFormManager()->
+      SetCharacterForm("abc", Config::FULL_WIDTH);
+
+  Segments segments;
+  segments.set_request_type(Segments::CONVERSION);
+  Segment *segment = segments.push_back_segment();
+  segment->set_key("abc");
+  for (size_t i = 0; i < 2; ++i) {
+    Segment::Candidate *candidate = segment->add_candidate();
+    candidate->Init();
+    candidate->key = "abc";
+    candidate->content_key = "abc";
+    candidate->value = "abc";
+    candidate->content_value = "abc";
+  }
+  // The second candidate keeps its form, which is the alternative form of
+  // the first one.
+  segment->mutable_candidate(1)->attributes |=
+      Segment::Candidate::NO_VARIANTS_EXPANSION;
+
+  EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+  ASSERT_EQ(2, segment->candidates_size());
+  // "ａｂｃ"
+  EXPECT_EQ("\xef\xbd\x81\xef\xbd\x82\xef\xbd\x83",
+            segment->candidate(0).value);
+  EXPECT_EQ("abc", segment->candidate(1).value);
+
+  EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                         segment->candidates_size()));
+  ASSERT_EQ(2, segment->candidates_size());
+  std::set<string> values;
+  for (size_t i = 0; i < segment->candidates_size(); ++i) {
+    EXPECT_TRUE(values.insert(segment->candidate(i).value).second)
+        << segment->candidate(i).value;
+    EXPECT_FALSE(segment->candidate(i).attributes &
+                 Segment::Candidate::VARIANTS_DEFERRED);
+  }
+}
+
+TEST_F(VariantsRewriterTest, ExpandCandidatesOfDefaultForm) {
+  std::unique_ptr<VariantsRewriter> rewriter(CreateVariantsRewriter());
+  const ConversionRequest request;
+  CharacterFormManager::GetCharacterFormManager()->
+      SetCharacterForm("012", Config::HALF_WIDTH);
+
+  Segments segments;
+  segments.set_request_type(Segments::CONVERSION);
+  Segment *segment = segments.push_back_segment();
+  segment->set_key("012");
+  Segment::Candidate *candidate = segment->add_candidate();
+  candidate->Init();
+  candidate->key = "012";
+  candidate->content_key = "012";
+  candidate->value = "012";
+  candidate->content_value = "012";
+
+  // The candidate is already in the default form but is still deferred,
+  // since it has the alternative form.
+  EXPECT_TRUE(rewriter->Rewrite(request, &segments));
+  ASSERT_EQ(1, segment->candidates_size());
+  EXPECT_EQ("012", segment->candidate(0).value);
+  EXPECT_TRUE(segment->candidate(0).attributes &
+              Segment::Candidate::VARIANTS_DEFERRED);
+  EXPECT_TRUE(segment->candidate(0).description.empty());
+
+  EXPECT_TRUE(rewriter->ExpandCandidates(&segments, 0,
+                                         segment->candidates_size()));
+  ASSERT_EQ(2, segment->candidates_size());
+  EXPECT_EQ("012", segment->candidate(0).value);
+  // "０１２"
+  EXPECT_EQ("\xef\xbc\x90\xef\xbc\x91\xef\xbc\x92",
+            segment->candidate(1).value);
+  EXPECT_EQ("\xef\xbc\x90\xef\xbc\x91\xef\xbc\x92",
+            segment->candidate(1).content_value);
+}
+
 TEST_F(VariantsRewriterTest, Capability) {
   std::unique_ptr<VariantsRewriter> rewriter(CreateVariantsRewriter());
   const ConversionRequest request;
@@ -0,0 +1,464 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "session/latency_cliff_search.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/stopwatch.h"
+#include "base/util.h"
+#include "engine/engine_interface.h"
+#include "protocol/config.pb.h"
+#include "session/random_keyevents_generator.h"
+#include "session/session_handler.h"
+
+namespace mozc {
+namespace session {
+namespace {
+
+using commands::KeyEvent;
+
+const size_t kMinLength = 8;
+
+// Upper bound of the runs spent by Minimize() on a case.
+const int kMaxMinimizeRuns = 500;
+
+const char *kSyllables[] = {
+  "a", "i", "u", "e", "o", "ka", "ki", "ku", "ke", "ko", "sa", "shi", "su",
+  "se", "so", "ta", "chi", "tsu", "te", "to", "na", "ni", "nu", "ne", "no",
+  "ha", "hi", "fu", "he", "ho", "ma", "mi", "mu", "me", "mo", "ya", "yu",
+  "yo", "ra", "ri", "ru", "re", "ro", "wa", "nn", "ga", "gi", "gu", "ge",
+  "go", "za", "ji", "zu", "ze", "zo", "da", "de", "do", "ba", "bi", "bu",
+  "be", "bo", "pa", "pi", "pu", "pe", "po", "kya", "sho", "chu", "xtu",
+};
+
+const char kDigitSeparators[] = "-,.:/";
+const char kSymbols[] = "-!?,./@#&()";
+
+void AppendAsciiKeys(const string &str, std::vector<KeyEvent> *keys) {
+  for (size_t i = 0; i < str.size(); ++i) {
+    KeyEvent key;
+    key.set_key_code(static_cast<uint8>(str[i]));
+    keys->push_back(key);
+  }
+}
+
+void AppendSpecialKey(KeyEvent::SpecialKey special_key,
+                      std::vector<KeyEvent> *keys) {
+  KeyEvent key;
+  key.set_special_key(special_key);
+  keys->push_back(key);
+}
+
+const char *GetRandomSyllable() {
+  return kSyllables[Util::Random(arraysize(kSyllables))];
+}
+
+// Returns the name used by KeyParser, e.g. "pageup" for PAGE_UP.
+string GetKeyParserName(const string &enum_name) {
+  string name;
+  for (size_t i = 0; i < enum_name.size(); ++i) {
+    if (enum_name[i] != '_') {
+      name += enum_name[i];
+    }
+  }
+  Util::LowerString(&name);
+  return name;
+}
+
+bool IsPlainAsciiKey(const KeyEvent &key) {
+  return key.has_key_code() && !key.has_special_key() &&
+         key.modifier_keys_size() == 0 && !key.has_modifiers() &&
+         key.key_code() >= 0x20 && key.key_code() < 0x7F;
+}
+
+string ToKeyParserString(const KeyEvent &key) {
+  string result;
+  for (size_t i = 0; i < key.modifier_keys_size(); ++i) {
+    result += GetKeyParserName(
+        KeyEvent::ModifierKey_Name(key.modifier_keys(i)));
+    result += ' ';
+  }
+  if (key.has_special_key()) {
+    result += GetKeyParserName(KeyEvent::SpecialKey_Name(key.special_key()));
+  } else if (key.key_code() == ' ') {
+    // KeyParser splits the keys on spaces.
+    result += "space";
+  } else {
+    result += static_cast<char>(key.key_code());
+  }
+  return result;
+}
+
+bool IsSlower(const LatencyCliffSearch::Case &lhs,
+              const LatencyCliffSearch::Case &rhs) {
+  return lhs.measurement.max_latency_usec > rhs.measurement.max_latency_usec;
+}
+
+}  // namespace
+
+LatencyCliffSearch::SessionHandlerRunner::SessionHandlerRunner(
+    std::unique_ptr<EngineInterface> engine)
+    : handler_(new SessionHandler(std::move(engine))) {
+  // Keeps the runs independent of each other.
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::SET_IMPOSED_CONFIG);
+  command.mutable_input()->mutable_config()->set_incognito_mode(true);
+  handler_->EvalCommand(&command);
+}
+
+LatencyCliffSearch::SessionHandlerRunner::~SessionHandlerRunner() {}
+
+bool LatencyCliffSearch::SessionHandlerRunner::Run(
+    const std::vector<KeyEvent> &keys, Measurement *measurement) {
+  DCHECK(measurement);
+  *measurement = Measurement();
+
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::CREATE_SESSION);
+  if (!handler_->EvalCommand(&command) ||
+      command.output().error_code() != commands::Output::SESSION_SUCCESS) {
+    LOG(ERROR) << "Failed to create a session";
+    return false;
+  }
+  const uint64 id = command.output().id();
+
+  command.Clear();
+  command.mutable_input()->set_id(id);
+  command.mutable_input()->set_type(commands::Input::SEND_KEY);
+  command.mutable_input()->mutable_key()->set_special_key(KeyEvent::ON);
+  handler_->EvalCommand(&command);
+
+  bool result = true;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    command.Clear();
+    command.mutable_input()->set_id(id);
+    command.mutable_input()->set_type(commands::Input::SEND_KEY);
+    *command.mutable_input()->mutable_key() = keys[i];
+
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    const bool succeeded = handler_->EvalCommand(&command);
+    stopwatch.Stop();
+    if (!succeeded) {
+      LOG(ERROR) << "SEND_KEY failed at " << i << ": "
+                 << keys[i].DebugString();
+      result = false;
+      break;
+    }
+
+    const uint64 latency =
+        static_cast<uint64>(stopwatch.GetElapsedMicroseconds());
+    measurement->total_latency_usec += latency;
+    if (latency > measurement->max_latency_usec) {
+      measurement->max_latency_usec = latency;
+      measurement->slowest_key_index = i;
+    }
+
+    const commands::Output &output = command.output();
+    size_t preedit_chars = 0;
+    for (size_t j = 0; j < output.preedit().segment_size(); ++j) {
+      preedit_chars += Util::CharsLen(output.preedit().segment(j).value());
+    }
+    measurement->max_preedit_chars =
+        std::max(measurement->max_preedit_chars, preedit_chars);
+    measurement->max_candidates =
+        std::max(measurement->max_candidates,
+                 static_cast<size_t>(
+                     output.all_candidate_words().candidates_size()));
+  }
+
+  command.Clear();
+  command.mutable_input()->set_id(id);
+  command.mutable_input()->set_type(commands::Input::DELETE_SESSION);
+  handler_->EvalCommand(&command);
+  return result;
+}
+
+LatencyCliffSearch::LatencyCliffSearch(RunnerInterface *runner)
+    : runner_(runner), num_trials_(3), max_worst_cases_(10) {
+  DCHECK(runner_);
+}
+
+LatencyCliffSearch::~LatencyCliffSearch() {}
+
+bool LatencyCliffSearch::Search(size_t max_length, int num_mutations) {
+  for (int type = 0; type < NUM_INPUT_TYPES; ++type) {
+    for (size_t length = kMinLength; length <= max_length; length *= 2) {
+      Case c;
+      c.type = static_cast<InputType>(type);
+      GenerateInput(c.type, length, &c.keys);
+      if (!Measure(&c)) {
+        return false;
+      }
+      LOG(INFO) << GetInputTypeName(c.type) << " length: " << length
+                << " max latency: " << c.measurement.max_latency_usec
+                << "us preedit: " << c.measurement.max_preedit_chars
+                << " candidates: " << c.measurement.max_candidates;
+      AddWorstCase(c);
+    }
+  }
+
+  for (int i = 0; i < num_mutations && !worst_cases_.empty(); ++i) {
+    Case c = worst_cases_[Util::Random(worst_cases_.size())];
+    Mutate(&c.keys);
+    if (!Measure(&c)) {
+      return false;
+    }
+    AddWorstCase(c);
+  }
+  return true;
+}
+
+bool LatencyCliffSearch::Measure(Case *c) {
+  DCHECK(c);
+  Measurement best;
+  for (int i = 0; i < std::max(num_trials_, 1); ++i) {
+    Measurement measurement;
+    if (!runner_->Run(c->keys, &measurement)) {
+      return false;
+    }
+    if (i == 0 || measurement.max_latency_usec < best.max_latency_usec) {
+      best = measurement;
+    }
+  }
+  c->measurement = best;
+  return true;
+}
+
+bool LatencyCliffSearch::Minimize(double ratio, Case *c) {
+  DCHECK(c);
+  if (c->measurement.max_latency_usec == 0 && !Measure(c)) {
+    return false;
+  }
+  const double threshold = c->measurement.max_latency_usec * ratio;
+
+  // Delta debugging: removes one of |granularity| chunks at a time and refines
+  // the chunks when none of them can be removed.
+  size_t granularity = 2;
+  int runs = 0;
+  while (c->keys.size() >= 2 && runs < kMaxMinimizeRuns) {
+    const size_t size = c->keys.size();
+    granularity = std::min(granularity, size);
+    const size_t chunk = (size + granularity - 1) / granularity;
+    bool removed = false;
+    for (size_t begin = 0; begin < size && runs < kMaxMinimizeRuns;
+         begin += chunk) {
+      Case candidate;
+      candidate.type = c->type;
+      candidate.keys.assign(c->keys.begin(), c->keys.begin() + begin);
+      candidate.keys.insert(candidate.keys.end(),
+                            c->keys.begin() + std::min(begin + chunk, size),
+                            c->keys.end());
+      if (candidate.keys.empty()) {
+        continue;
+      }
+      if (!Measure(&candidate)) {
+        return false;
+      }
+      ++runs;
+      if (candidate.measurement.max_latency_usec >= threshold) {
+        *c = candidate;
+        granularity = std::max<size_t>(granularity - 1, 2);
+        removed = true;
+        break;
+      }
+    }
+    if (!removed) {
+      if (granularity >= size) {
+        break;
+      }
+      granularity = std::min(granularity * 2, size);
+    }
+  }
+  return true;
+}
+
+void LatencyCliffSearch::AddWorstCase(const Case &c) {
+  worst_cases_.insert(std::upper_bound(worst_cases_.begin(),
+                                       worst_cases_.end(), c, IsSlower),
+                      c);
+  if (worst_cases_.size() > max_worst_cases_) {
+    worst_cases_.resize(max_worst_cases_);
+  }
+}
+
+// static
+void LatencyCliffSearch::GenerateInput(InputType type, size_t length,
+                                       std::vector<KeyEvent> *keys) {
+  DCHECK(keys);
+  keys->clear();
+  switch (type) {
+    case HIRAGANA_RUN:
+      while (keys->size() < length) {
+        AppendAsciiKeys(GetRandomSyllable(), keys);
+      }
+      break;
+    case DIGITS:
+      while (keys->size() < length) {
+        string str(1, '0' + Util::Random(10));
+        if (Util::Random(8) == 0) {
+          str += kDigitSeparators[Util::Random(arraysize(kDigitSeparators) -
+                                               1)];
+        }
+        AppendAsciiKeys(str, keys);
+      }
+      break;
+    case MIXED_SCRIPTS:
+      while (keys->size() < length) {
+        string str;
+        switch (Util::Random(4)) {
+          case 0:
+            str = GetRandomSyllable();
+            str[0] = 'A' + (str[0] - 'a');
+            break;
+          case 1:
+            str.assign(1, '0' + Util::Random(10));
+            break;
+          case 2:
+            str.assign(1, kSymbols[Util::Random(arraysize(kSymbols) - 1)]);
+            break;
+          default:
+            str = GetRandomSyllable();
+            break;
+        }
+        AppendAsciiKeys(str, keys);
+      }
+      break;
+    case REPEATED: {
+      const string syllable = GetRandomSyllable();
+      while (keys->size() < length) {
+        AppendAsciiKeys(syllable, keys);
+      }
+      break;
+    }
+    case RANDOM_KEYS: {
+      std::vector<KeyEvent> sequence;
+      while (keys->size() < length) {
+        RandomKeyEventsGenerator::GenerateSequence(&sequence);
+        keys->insert(keys->end(), sequence.begin(), sequence.end());
+      }
+      break;
+    }
+    default:
+      LOG(DFATAL) << "Unknown input type: " << type;
+      return;
+  }
+  if (keys->size() > length) {
+    keys->resize(length);
+  }
+  AppendSpecialKey(KeyEvent::SPACE, keys);
+}
+
+// static
+void LatencyCliffSearch::Mutate(std::vector<KeyEvent> *keys) {
+  DCHECK(keys);
+  if (keys->empty()) {
+    return;
+  }
+  const size_t begin = Util::Random(keys->size());
+  const size_t end =
+      begin + 1 + Util::Random(std::min<size_t>(keys->size() - begin, 16));
+  const std::vector<KeyEvent> chunk(keys->begin() + begin,
+                                    keys->begin() + end);
+  switch (Util::Random(3)) {
+    case 0:
+      // Duplicates the chunk at a random position.
+      keys->insert(keys->begin() + Util::Random(keys->size() + 1),
+                   chunk.begin(), chunk.end());
+      break;
+    case 1:
+      if (keys->size() > chunk.size()) {
+        keys->erase(keys->begin() + begin, keys->begin() + end);
+      }
+      break;
+    default: {
+      // Repeats the chunk in place.
+      const int count = 1 + Util::Random(4);
+      for (int i = 0; i < count; ++i) {
+        keys->insert(keys->begin() + end, chunk.begin(), chunk.end());
+      }
+      break;
+    }
+  }
+}
+
+// static
+string LatencyCliffSearch::ToScenario(const Case &c) {
+  std::ostringstream os;
+  os << "# Generated by latency_cliff_search." << std::endl
+     << "# Input type: " << GetInputTypeName(c.type) << std::endl
+     << "# Max latency: " << c.measurement.max_latency_usec << "us at key "
+     << c.measurement.slowest_key_index << std::endl
+     << "# Max preedit chars: " << c.measurement.max_preedit_chars
+     << ", max candidates: " << c.measurement.max_candidates << std::endl
+     << "SEND_KEY\tON" << std::endl;
+
+  string ascii_keys;
+  for (size_t i = 0; i < c.keys.size(); ++i) {
+    const KeyEvent &key = c.keys[i];
+    if (IsPlainAsciiKey(key)) {
+      ascii_keys += static_cast<char>(key.key_code());
+      continue;
+    }
+    if (!ascii_keys.empty()) {
+      os << "SEND_KEYS\t" << ascii_keys << std::endl;
+      ascii_keys.clear();
+    }
+    os << "SEND_KEY\t" << ToKeyParserString(key) << std::endl;
+  }
+  if (!ascii_keys.empty()) {
+    os << "SEND_KEYS\t" << ascii_keys << std::endl;
+  }
+  return os.str();
+}
+
+// static
+const char *LatencyCliffSearch::GetInputTypeName(InputType type) {
+  switch (type) {
+    case HIRAGANA_RUN:
+      return "HIRAGANA_RUN";
+    case DIGITS:
+      return "DIGITS";
+    case MIXED_SCRIPTS:
+      return "MIXED_SCRIPTS";
+    case REPEATED:
+      return "REPEATED";
+    case RANDOM_KEYS:
+      return "RANDOM_KEYS";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+}  // namespace session
+}  // namespace mozc
@@ -0,0 +1,175 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Searches for key sequences on which the session handler gets
+// disproportionately slow ("latency cliffs").  Input sequences of several
+// shapes are generated with growing lengths, the slowest ones are mutated to
+// look for even slower neighbours, and the worst cases are finally reduced to
+// short sequences which can be checked in as session scenario files.
+//
+// Example:
+//   LatencyCliffSearch::SessionHandlerRunner runner(
+//       std::unique_ptr<EngineInterface>(EngineFactory::Create()));
+//   LatencyCliffSearch search(&runner);
+//   search.Search(256, 100);
+//   for (size_t i = 0; i < search.worst_cases().size(); ++i) {
+//     LatencyCliffSearch::Case c = search.worst_cases()[i];
+//     search.Minimize(0.8, &c);
+//     LOG(INFO) << LatencyCliffSearch::ToScenario(c);
+//   }
+
+#ifndef MOZC_SESSION_LATENCY_CLIFF_SEARCH_H_
+#define MOZC_SESSION_LATENCY_CLIFF_SEARCH_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/port.h"
+#include "protocol/commands.pb.h"
+
+namespace mozc {
+
+class EngineInterface;
+class SessionHandler;
+
+namespace session {
+
+class LatencyCliffSearch {
+ public:
+  enum InputType {
+    HIRAGANA_RUN,   // Romaji of a long run of hiragana without a break.
+    DIGITS,         // Digits mixed with a few separators.
+    MIXED_SCRIPTS,  // Romaji mixed with upper-case letters, digits and symbols.
+    REPEATED,       // A single syllable repeated.
+    RANDOM_KEYS,    // Sequences from RandomKeyEventsGenerator.
+    NUM_INPUT_TYPES,
+  };
+
+  struct Measurement {
+    Measurement()
+        : max_latency_usec(0), slowest_key_index(0), total_latency_usec(0),
+          max_preedit_chars(0), max_candidates(0) {}
+
+    // The latency of the slowest SEND_KEY command and its index.
+    uint64 max_latency_usec;
+    size_t slowest_key_index;
+    uint64 total_latency_usec;
+    // The largest preedit and candidate list seen during the run.  They stand
+    // for the size of the lattice behind the slow commands.
+    size_t max_preedit_chars;
+    size_t max_candidates;
+  };
+
+  // Runs a key sequence on a fresh session and measures it.
+  class RunnerInterface {
+   public:
+    virtual ~RunnerInterface() {}
+    virtual bool Run(const std::vector<commands::KeyEvent> &keys,
+                     Measurement *measurement) = 0;
+  };
+
+  // Runs key sequences through SessionHandler::EvalCommand.  History learning
+  // is disabled so that each run starts from the same state.
+  class SessionHandlerRunner : public RunnerInterface {
+   public:
+    explicit SessionHandlerRunner(std::unique_ptr<EngineInterface> engine);
+    ~SessionHandlerRunner() override;
+
+    bool Run(const std::vector<commands::KeyEvent> &keys,
+             Measurement *measurement) override;
+
+   private:
+    std::unique_ptr<SessionHandler> handler_;
+
+    DISALLOW_COPY_AND_ASSIGN(SessionHandlerRunner);
+  };
+
+  struct Case {
+    Case() : type(RANDOM_KEYS) {}
+
+    std::vector<commands::KeyEvent> keys;
+    InputType type;
+    Measurement measurement;
+  };
+
+  // Does not take the ownership of |runner|.
+  explicit LatencyCliffSearch(RunnerInterface *runner);
+  ~LatencyCliffSearch();
+
+  // Each sequence is run |num_trials| times and the fastest run counts, which
+  // filters out the noise of the machine.  The default is 3.
+  void set_num_trials(int num_trials) { num_trials_ = num_trials; }
+  // The number of the worst cases to keep.  The default is 10.
+  void set_max_worst_cases(size_t size) { max_worst_cases_ = size; }
+
+  // Measures sequences of every input type with lengths 8, 16, ... up to
+  // |max_length| keys, then applies |num_mutations| random mutations to the
+  // worst cases found so far.  Returns false if the runner failed.
+  bool Search(size_t max_length, int num_mutations);
+
+  // Measures |c->keys| and updates |c->measurement|.
+  bool Measure(Case *c);
+
+  // Removes keys from |c| as long as the maximum latency stays at |ratio|
+  // times the original one or above.  Returns false if the runner failed.
+  bool Minimize(double ratio, Case *c);
+
+  // The worst cases, the slowest first.
+  const std::vector<Case> &worst_cases() const { return worst_cases_; }
+
+  // Generates |length| keys of |type| followed by SPACE to convert.  Uses
+  // Util::Random.
+  static void GenerateInput(InputType type, size_t length,
+                            std::vector<commands::KeyEvent> *keys);
+
+  // Duplicates, removes or repeats a random chunk of |keys|.
+  static void Mutate(std::vector<commands::KeyEvent> *keys);
+
+  // Formats |c| in the format of data/test/session/scenario.
+  static string ToScenario(const Case &c);
+
+  static const char *GetInputTypeName(InputType type);
+
+ private:
+  void AddWorstCase(const Case &c);
+
+  RunnerInterface *runner_;
+  int num_trials_;
+  size_t max_worst_cases_;
+  std::vector<Case> worst_cases_;
+
+  DISALLOW_COPY_AND_ASSIGN(LatencyCliffSearch);
+};
+
+}  // namespace session
+}  // namespace mozc
+
+#endif  // MOZC_SESSION_LATENCY_CLIFF_SEARCH_H_
@@ -0,0 +1,121 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Searches for key sequences on which the session handler gets slow and
+// writes the minimized worst cases as session scenario files.
+//
+// Usage:
+//   latency_cliff_search_main --max_length=256 --num_mutations=200 \
+//       --output_dir=/tmp/latency_cliffs
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "base/file_stream.h"
+#include "base/file_util.h"
+#include "base/flags.h"
+#include "base/init_mozc.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/system_util.h"
+#include "base/util.h"
+#include "engine/engine_factory.h"
+#include "engine/engine_interface.h"
+#include "session/latency_cliff_search.h"
+#include "session/random_keyevents_generator.h"
+
+DEFINE_int32(max_length, 256, "Maximum length of the generated sequences");
+DEFINE_int32(num_mutations, 100, "Number of mutations of the worst cases");
+DEFINE_int32(num_trials, 3, "Number of runs per sequence");
+DEFINE_int32(num_worst_cases, 10, "Number of the worst cases to report");
+DEFINE_double(minimize_ratio, 0.8,
+              "Minimized cases keep this ratio of the original latency");
+// There is no DEFINE_uint32.
+DEFINE_uint64(random_seed, 0,
+              "Random seed value. This value will be interpreted as uint32.");
+DEFINE_string(output_dir, "",
+              "Directory to write the scenario files. "
+              "The scenarios are printed to stdout if empty.");
+DEFINE_string(profile_dir, "", "Profile dir");
+
+int main(int argc, char **argv) {
+  mozc::InitMozc(argv[0], &argc, &argv, false);
+
+  if (!FLAGS_profile_dir.empty()) {
+    mozc::FileUtil::CreateDirectory(FLAGS_profile_dir);
+    mozc::SystemUtil::SetUserProfileDirectory(FLAGS_profile_dir);
+  }
+  if (!FLAGS_output_dir.empty()) {
+    mozc::FileUtil::CreateDirectory(FLAGS_output_dir);
+  }
+
+  mozc::session::RandomKeyEventsGenerator::InitSeed(
+      static_cast<uint32>(FLAGS_random_seed));
+
+  mozc::session::LatencyCliffSearch::SessionHandlerRunner runner(
+      std::unique_ptr<mozc::EngineInterface>(mozc::EngineFactory::Create()));
+  mozc::session::LatencyCliffSearch search(&runner);
+  search.set_num_trials(FLAGS_num_trials);
+  search.set_max_worst_cases(FLAGS_num_worst_cases);
+  if (!search.Search(FLAGS_max_length, FLAGS_num_mutations)) {
+    LOG(ERROR) << "Search failed";
+    return 1;
+  }
+
+  for (size_t i = 0; i < search.worst_cases().size(); ++i) {
+    mozc::session::LatencyCliffSearch::Case c = search.worst_cases()[i];
+    const size_t original_size = c.keys.size();
+    if (!search.Minimize(FLAGS_minimize_ratio, &c)) {
+      LOG(ERROR) << "Minimize failed";
+      return 1;
+    }
+    LOG(INFO) << "Case " << i << ": " << original_size << " -> "
+              << c.keys.size() << " keys, "
+              << c.measurement.max_latency_usec << "us";
+
+    const string scenario = mozc::session::LatencyCliffSearch::ToScenario(c);
+    if (FLAGS_output_dir.empty()) {
+      std::cout << scenario << std::endl;
+      continue;
+    }
+    const string path = mozc::FileUtil::JoinPath(
+        FLAGS_output_dir,
+        mozc::Util::StringPrintf("latency_cliff_%02d.txt",
+                                 static_cast<int>(i)));
+    mozc::OutputFileStream output(path.c_str());
+    if (output.fail()) {
+      LOG(ERROR) << "File not opend: " << path;
+      return 1;
+    }
+    output << scenario;
+  }
+  return 0;
+}
@@ -0,0 +1,179 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "session/latency_cliff_search.h"
+
+#include <vector>
+
+#include "base/util.h"
+#include "protocol/commands.pb.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace session {
+namespace {
+
+using commands::KeyEvent;
+
+// Pretends that the latency is the square of the number of 'q' keys, and is
+// much larger when the sequence contains both 'q' and 'z'.
+class FakeRunner : public LatencyCliffSearch::RunnerInterface {
+ public:
+  FakeRunner() : num_runs_(0) {}
+
+  bool Run(const std::vector<KeyEvent> &keys,
+           LatencyCliffSearch::Measurement *measurement) override {
+    ++num_runs_;
+    *measurement = LatencyCliffSearch::Measurement();
+    size_t num_q = 0;
+    bool has_z = false;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i].key_code() == 'q') {
+        ++num_q;
+      } else if (keys[i].key_code() == 'z') {
+        has_z = true;
+      }
+      uint64 latency = num_q * num_q;
+      if (num_q > 0 && has_z) {
+        latency += 1000;
+      }
+      measurement->total_latency_usec += latency;
+      if (latency > measurement->max_latency_usec) {
+        measurement->max_latency_usec = latency;
+        measurement->slowest_key_index = i;
+      }
+    }
+    measurement->max_preedit_chars = keys.size();
+    return true;
+  }
+
+  int num_runs() const { return num_runs_; }
+
+ private:
+  int num_runs_;
+};
+
+void AppendKeys(const char *str, std::vector<KeyEvent> *keys) {
+  for (const char *p = str; *p != '\0'; ++p) {
+    KeyEvent key;
+    key.set_key_code(*p);
+    keys->push_back(key);
+  }
+}
+
+TEST(LatencyCliffSearchTest, GenerateInput) {
+  Util::SetRandomSeed(1);
+  for (int type = 0; type < LatencyCliffSearch::NUM_INPUT_TYPES; ++type) {
+    std::vector<KeyEvent> keys;
+    LatencyCliffSearch::GenerateInput(
+        static_cast<LatencyCliffSearch::InputType>(type), 32, &keys);
+    SCOPED_TRACE(LatencyCliffSearch::GetInputTypeName(
+        static_cast<LatencyCliffSearch::InputType>(type)));
+    ASSERT_EQ(33, keys.size());
+    EXPECT_EQ(KeyEvent::SPACE, keys.back().special_key());
+  }
+}
+
+TEST(LatencyCliffSearchTest, Search) {
+  Util::SetRandomSeed(1);
+  FakeRunner runner;
+  LatencyCliffSearch search(&runner);
+  search.set_num_trials(2);
+  search.set_max_worst_cases(3);
+  ASSERT_TRUE(search.Search(64, 20));
+
+  const std::vector<LatencyCliffSearch::Case> &cases = search.worst_cases();
+  ASSERT_EQ(3, cases.size());
+  for (size_t i = 1; i < cases.size(); ++i) {
+    EXPECT_GE(cases[i - 1].measurement.max_latency_usec,
+              cases[i].measurement.max_latency_usec);
+  }
+  // 4 lengths for each input type, then the mutations.
+  EXPECT_EQ((4 * LatencyCliffSearch::NUM_INPUT_TYPES + 20) * 2,
+            runner.num_runs());
+}
+
+TEST(LatencyCliffSearchTest, Minimize) {
+  FakeRunner runner;
+  LatencyCliffSearch search(&runner);
+  search.set_num_trials(1);
+
+  LatencyCliffSearch::Case c;
+  AppendKeys("abcdefghijklmnopqrstuvwxyzabcdefghijklmnop", &c.keys);
+  ASSERT_TRUE(search.Measure(&c));
+  EXPECT_EQ(1001, c.measurement.max_latency_usec);
+
+  ASSERT_TRUE(search.Minimize(1.0, &c));
+  ASSERT_EQ(2, c.keys.size());
+  EXPECT_EQ('q', c.keys[0].key_code());
+  EXPECT_EQ('z', c.keys[1].key_code());
+  EXPECT_EQ(1001, c.measurement.max_latency_usec);
+
+  // Only the keys needed to keep a half of the latency remain.
+  c.keys.clear();
+  AppendKeys("aqqbqqcqqdqqe", &c.keys);
+  ASSERT_TRUE(search.Measure(&c));
+  EXPECT_EQ(64, c.measurement.max_latency_usec);
+  ASSERT_TRUE(search.Minimize(0.5, &c));
+  EXPECT_EQ(6, c.keys.size());
+  EXPECT_LE(32, c.measurement.max_latency_usec);
+}
+
+TEST(LatencyCliffSearchTest, ToScenario) {
+  LatencyCliffSearch::Case c;
+  c.type = LatencyCliffSearch::MIXED_SCRIPTS;
+  AppendKeys("ka ", &c.keys);
+  KeyEvent key;
+  key.set_special_key(KeyEvent::PAGE_UP);
+  key.add_modifier_keys(KeyEvent::SHIFT);
+  c.keys.push_back(key);
+  key.Clear();
+  key.set_key_code(' ');
+  key.add_modifier_keys(KeyEvent::CTRL);
+  c.keys.push_back(key);
+  AppendKeys("1", &c.keys);
+  key.Clear();
+  key.set_special_key(KeyEvent::SPACE);
+  c.keys.push_back(key);
+
+  const string scenario = LatencyCliffSearch::ToScenario(c);
+  EXPECT_NE(string::npos, scenario.find("# Input type: MIXED_SCRIPTS\n"));
+  EXPECT_NE(string::npos,
+            scenario.find("SEND_KEY\tON\n"
+                          "SEND_KEYS\tka \n"
+                          "SEND_KEY\tshift pageup\n"
+                          "SEND_KEY\tctrl space\n"
+                          "SEND_KEYS\t1\n"
+                          "SEND_KEY\tspace\n"));
+}
+
+}  // namespace
+}  // namespace session
+}  // namespace mozc
@@ -37,6 +37,7 @@
 
 #include "base/clock.h"
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/port.h"
 #include "base/singleton.h"
 #include "base/url.h"
@@ -50,6 +51,7 @@
 #include "engine/user_data_manager_interface.h"
 #include "protocol/commands.pb.h"
 #include "protocol/config.pb.h"
+#include "protocol/state.pb.h"
 #include "session/internal/ime_context.h"
 #include "session/internal/key_event_transformer.h"
 #include "session/internal/keymap.h"
@@ -184,6 +186,26 @@ commands::CompositionMode ToCompositionMode(
     return mode;
 }
 
+transliteration::TransliterationType ToTransliterationType(
+    commands::CompositionMode mode) {
+  switch (mode) {
+    case commands::HIRAGANA:
+      return transliteration::HIRAGANA;
+    case commands::FULL_KATAKANA:
+      return transliteration::FULL_KATAKANA;
+    case commands::HALF_KATAKANA:
+      return transliteration::HALF_KATAKANA;
+    case commands::FULL_ASCII:
+      return transliteration::FULL_ASCII;
+    case commands::HALF_ASCII:
+      return transliteration::HALF_ASCII;
+    default:
+      LOG(ERROR) << "Unknown composition mode: " << mode;
+      // use HIRAGANA as a default.
+      return transliteration::HIRAGANA;
+  }
+}
+
 ImeContext::State GetEffectiveStateForTestSendKey(
     const commands::KeyEvent &key,
     ImeContext::State state) {
@@ -1399,6 +1421,59 @@ uint64 Session::last_command_time() const {
   return context_->last_command_time();
 }
 
+bool Session::Hibernate(protocol::HibernatedSession *state) const {
+  DCHECK(state);
+  if (context_->state() != ImeContext::DIRECT &&
+      context_->state() != ImeContext::PRECOMPOSITION) {
+    return false;
+  }
+  // Zero query suggestion may be shown in the precomposition state.
+  if (context_->converter().IsActive()) {
+    return false;
+  }
+
+  const composer::Composer &composer = context_->composer();
+  state->Clear();
+  state->set_create_time(context_->create_time());
+  state->set_last_command_time(context_->last_command_time());
+  state->set_activated(context_->state() != ImeContext::DIRECT);
+  state->set_mode(ToCompositionMode(composer.GetInputMode()));
+  state->set_comeback_mode(ToCompositionMode(composer.GetComebackInputMode()));
+  state->set_input_field_type(composer.GetInputFieldType());
+  state->mutable_capability()->CopyFrom(context_->client_capability());
+  state->mutable_application_info()->CopyFrom(context_->application_info());
+  state->mutable_client_context()->CopyFrom(context_->client_context());
+  return true;
+}
+
+bool Session::Restore(const protocol::HibernatedSession &state) {
+  ClearUndoContext();
+  context_->set_create_time(state.create_time());
+  context_->set_last_command_time(state.last_command_time());
+  SetSessionState(state.activated() ? ImeContext::PRECOMPOSITION
+                                    : ImeContext::DIRECT,
+                  context_.get());
+
+  composer::Composer *composer = context_->mutable_composer();
+  composer->SetInputMode(ToTransliterationType(state.comeback_mode()));
+  if (state.mode() != state.comeback_mode()) {
+    composer->SetTemporaryInputMode(ToTransliterationType(state.mode()));
+  }
+  composer->SetInputFieldType(state.input_field_type());
+
+  context_->mutable_client_capability()->CopyFrom(state.capability());
+  context_->mutable_application_info()->CopyFrom(state.application_info());
+  context_->mutable_client_context()->CopyFrom(state.client_context());
+  return true;
+}
+
+void Session::CollectMemoryUsage(MemoryUsage *usage) const {
+  usage->Add("segments", context_->converter().GetAllocatedBytes());
+  if (prev_context_ != nullptr) {
+    usage->Add("undo_segments", prev_context_->converter().GetAllocatedBytes());
+  }
+}
+
 bool Session::InsertCharacter(commands::Command *command) {
   if (!command->input().has_key()) {
     LOG(ERROR) << "No key event: " << command->input().DebugString();
@@ -47,6 +47,7 @@
         '../converter/converter_base.gyp:converter_util',
         '../protocol/protocol.gyp:commands_proto',
         '../protocol/protocol.gyp:config_proto',
+        '../protocol/protocol.gyp:state_proto',
         '../request/request.gyp:conversion_request',
         '../transliteration/transliteration.gyp:transliteration',
         '../usage_stats/usage_stats_base.gyp:usage_stats',
@@ -99,9 +100,12 @@
         '../config/config.gyp:config_handler',
         '../dictionary/dictionary_base.gyp:user_dictionary',
         '../engine/engine.gyp:engine_factory',
+        '../engine/engine.gyp:engine_loader',
         '../protocol/protocol.gyp:commands_proto',
         '../protocol/protocol.gyp:config_proto',
         '../protocol/protocol.gyp:engine_builder_proto',
+        '../protocol/protocol.gyp:output_delta_util',
+        '../protocol/protocol.gyp:state_proto',
         '../protocol/protocol.gyp:user_dictionary_storage_proto',
         '../usage_stats/usage_stats_base.gyp:usage_stats',
         'session_base.gyp:generic_storage_manager',
@@ -161,6 +165,31 @@
         'session',
       ],
     },
+    {
+      'target_name': 'latency_cliff_search',
+      'type': 'static_library',
+      'sources': [
+        'latency_cliff_search.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../protocol/protocol.gyp:commands_proto',
+        '../protocol/protocol.gyp:config_proto',
+        'random_keyevents_generator',
+        'session_handler',
+      ],
+    },
+    {
+      'target_name': 'latency_cliff_search_main',
+      'type': 'executable',
+      'sources': [
+        'latency_cliff_search_main.cc',
+      ],
+      'dependencies': [
+        '../engine/engine.gyp:engine_factory',
+        'latency_cliff_search',
+      ],
+    },
     {
       'target_name': 'session_server_main',
       'type': 'executable',
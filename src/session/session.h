@@ -260,6 +260,18 @@ class Session : public SessionInterface {
   // return 0 (default value) if no command is executed in this session.
   virtual uint64 last_command_time() const;
 
+  // Saves the modes, the client information and the times of the session.
+  // Only a session without composition or conversion can be hibernated.
+  // The undo context and the conversion history are not saved.
+  virtual bool Hibernate(protocol::HibernatedSession *state) const;
+
+  // Restores the state saved by Hibernate().  Config, request and table
+  // should be set beforehand.
+  virtual bool Restore(const protocol::HibernatedSession &state);
+
+  // Reports the segments of the current and the undo contexts.
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const;
+
   // TODO(komatsu): delete this funciton.
   // For unittest only
   mozc::composer::Composer *get_internal_composer_only_for_unittest();
@@ -1360,6 +1360,13 @@ void SessionConverter::AppendCandidateList() {
   // cannot be decided).
   const bool add_meta_candidates = (candidate_list_->size() == 0);
 
+  // Materialize the candidates deferred by the rewriters before listing
+  // them. The candidates already in |candidate_list_| have been expanded,
+  // so their positions are kept.
+  converter_->GetCandidates(
+      segments_.get(), segment_index_,
+      segments_->conversion_segment(segment_index_).candidates_size());
+
   const Segment &segment = segments_->conversion_segment(segment_index_);
   for (size_t i = candidate_list_->next_available_id();
        i < segment.candidates_size();
@@ -270,6 +270,11 @@ class SessionConverter : public SessionConverterInterface {
     use_cascading_window_ = use_cascading_window;
   }
 
+  virtual size_t GetAllocatedBytes() const {
+    return segments_->GetAllocatedBytes() +
+        previous_suggestions_.GetAllocatedBytes();
+  }
+
   // Meaning that all the composition characters are consumed.
   // c.f. CommitSuggestionInternal
   static const size_t kConsumedAllCharacters;
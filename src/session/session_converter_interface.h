@@ -257,6 +257,10 @@ class SessionConverterInterface {
 
   virtual void set_use_cascading_window(bool use_cascading_window) = 0;
 
+  // Returns an estimate of the heap memory held by the conversion state,
+  // e.g., segments and the cached lattice.
+  virtual size_t GetAllocatedBytes() const { return 0; }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(SessionConverterInterface);
 };
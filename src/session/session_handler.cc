@@ -33,6 +33,7 @@
 #include "session/session_handler.h"
 
 #include <algorithm>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -40,12 +41,14 @@
 #include "base/clock.h"
 #include "base/flags.h"
 #include "base/logging.h"
+#include "base/memory_usage.h"
 #include "base/port.h"
 #ifndef MOZC_DISABLE_SESSION_WATCHDOG
 #include "base/process.h"
 #endif  // MOZC_DISABLE_SESSION_WATCHDOG
 #include "base/singleton.h"
 #include "base/stopwatch.h"
+#include "base/thread.h"
 #include "base/util.h"
 #include "composer/table.h"
 #include "config/character_form_manager.h"
@@ -55,6 +58,8 @@
 #include "engine/user_data_manager_interface.h"
 #include "protocol/commands.pb.h"
 #include "protocol/config.pb.h"
+#include "protocol/output_delta_util.h"
+#include "protocol/state.pb.h"
 #include "protocol/user_dictionary_storage.pb.h"
 #include "session/generic_storage_manager.h"
 #include "session/session.h"
@@ -95,15 +100,22 @@ DEFINE_int32(last_create_session_timeout, 300,
              "\"last_create_session_timeout\" sec "
              "after create session command");
 
+DEFINE_int32(session_hibernation_timeout, 0,
+             "replace a session with its compact form if it is not accessed "
+             "for \"session_hibernation_timeout\" sec. 0 disables it");
+
+DEFINE_int32(memory_usage_log_interval, 0,
+             "log the memory usage of the engine and the sessions every "
+             "\"memory_usage_log_interval\" sec on cleanup. 0 disables it");
+
 DEFINE_bool(restricted, false,
             "Launch server with restricted setting");
 
 namespace mozc {
 
 namespace {
-bool IsApplicationAlive(const session::SessionInterface *session) {
+bool IsApplicationAlive(const commands::ApplicationInfo &info) {
 #ifndef MOZC_DISABLE_SESSION_WATCHDOG
-  const commands::ApplicationInfo &info = session->application_info();
   // When the thread/process's current status is unknown, i.e.,
   // if IsThreadAlive/IsProcessAlive functions failed to know the
   // status of the thread/process, return true just in case.
@@ -141,6 +153,62 @@ bool IsCarrierEmoji(const string &utf8_str) {
   const uint32 kMaxEmojiPuaCodePoint = 0xFEEA0;
   return kMinEmojiPuaCodePoint <= ucs4_val && ucs4_val <= kMaxEmojiPuaCodePoint;
 }
+
+// Returns true if the client cannot skip |output| of a key, e.g. because it
+// has a result to be committed or the key should be sent to the application.
+bool NeedsClientHandling(const commands::Output &output) {
+  return !output.consumed() ||
+      output.has_result() ||
+      output.has_deletion_range() ||
+      output.has_callback() ||
+      output.has_url() ||
+      output.launch_tool_mode() != commands::Output::NO_TOOL;
+}
+
+// Clears the user data of |manager| for the command |type|.  Returns false if
+// |manager| keeps no such data.
+bool ClearUserDataOf(UserDataManagerInterface *manager,
+                     commands::Input::CommandType type) {
+  switch (type) {
+    case commands::Input::CLEAR_USER_HISTORY:
+      return manager->ClearUserHistory();
+    case commands::Input::CLEAR_USER_PREDICTION:
+      return manager->ClearUserPrediction();
+    case commands::Input::CLEAR_UNUSED_USER_PREDICTION:
+      return manager->ClearUnusedUserPrediction();
+    default:
+      LOG(DFATAL) << "Not a clear command: " << type;
+      return false;
+  }
+}
+
+// Deletes a retired engine out of the request path.  The user data of the
+// engine is saved before the deletion, and the current engine merges it with
+// UserDataManagerInterface::Reload() once the deleter has finished.
+class EngineDeleter : public Thread {
+ public:
+  EngineDeleter(std::unique_ptr<EngineInterface> engine,
+                std::unique_ptr<composer::TableManager> table_manager)
+      : engine_(std::move(engine)), table_manager_(std::move(table_manager)) {}
+  ~EngineDeleter() override {
+    Join();
+  }
+
+  void Run() override {
+    // The tables refer to the data of the engine.
+    table_manager_.reset();
+    if (engine_->GetUserDataManager()) {
+      engine_->GetUserDataManager()->Retire();
+    }
+    engine_.reset();
+  }
+
+ private:
+  std::unique_ptr<EngineInterface> engine_;
+  std::unique_ptr<composer::TableManager> table_manager_;
+
+  DISALLOW_COPY_AND_ASSIGN(EngineDeleter);
+};
 }  // namespace
 
 SessionHandler::SessionHandler(std::unique_ptr<EngineInterface> engine) {
@@ -215,6 +283,22 @@ SessionHandler::~SessionHandler() {
     element->value = nullptr;
   }
   session_map_->Clear();
+  // The learning of the retired engines is handed over to the current engine
+  // before it saves the user data for the last time.
+  const bool has_retired_engines =
+      !engine_deleters_.empty() || !retired_engines_.empty();
+  engine_deleters_.clear();
+  for (const auto &generation : retired_engines_) {
+    generation->table_manager.reset();
+    if (generation->engine->GetUserDataManager()) {
+      generation->engine->GetUserDataManager()->Retire();
+    }
+  }
+  retired_engine_sessions_.clear();
+  retired_engines_.clear();
+  if (has_retired_engines && engine_ && engine_->GetUserDataManager()) {
+    engine_->GetUserDataManager()->Reload();
+  }
 #ifndef MOZC_DISABLE_SESSION_WATCHDOG
   if (session_watch_dog_->IsRunning()) {
     session_watch_dog_->Terminate();
@@ -246,15 +330,13 @@ bool SessionHandler::StartWatchDog() {
 
 void SessionHandler::SetConfig(const config::Config &config) {
   *config_ = config;
-  const composer::Table *table = table_manager_->GetTable(
-      *request_, *config_, *engine_->GetDataManager());
   for (SessionElement *element =
            const_cast<SessionElement *>(session_map_->Head());
        element != NULL; element = element->next) {
     if (element->value != NULL) {
       element->value->SetConfig(config_.get());
       element->value->SetRequest(request_.get());
-      element->value->SetTable(table);
+      element->value->SetTable(GetTable(element->key));
     }
   }
   config::CharacterFormManager::GetCharacterFormManager()->ReloadConfig(config);
@@ -287,25 +369,37 @@ bool SessionHandler::Reload(commands::Command *command) {
 
 bool SessionHandler::ClearUserHistory(commands::Command *command) {
   VLOG(1) << "Clearing user history";
-  engine_->GetUserDataManager()->ClearUserHistory();
+  ClearUserData(commands::Input::CLEAR_USER_HISTORY);
   UsageStats::IncrementCount("ClearUserHistory");
   return true;
 }
 
 bool SessionHandler::ClearUserPrediction(commands::Command *command) {
   VLOG(1) << "Clearing user prediction";
-  engine_->GetUserDataManager()->ClearUserPrediction();
+  ClearUserData(commands::Input::CLEAR_USER_PREDICTION);
   UsageStats::IncrementCount("ClearUserPrediction");
   return true;
 }
 
 bool SessionHandler::ClearUnusedUserPrediction(commands::Command *command) {
   VLOG(1) << "Clearing unused user prediction";
-  engine_->GetUserDataManager()->ClearUnusedUserPrediction();
+  ClearUserData(commands::Input::CLEAR_UNUSED_USER_PREDICTION);
   UsageStats::IncrementCount("ClearUnusedUserPrediction");
   return true;
 }
 
+void SessionHandler::ClearUserData(commands::Input::CommandType type) {
+  if (!ClearUserDataOf(engine_->GetUserDataManager(), type) &&
+      engine_loader_ &&
+      std::find(pending_user_data_clears_.begin(),
+                pending_user_data_clears_.end(),
+                type) == pending_user_data_clears_.end()) {
+    // The current engine, e.g., MinimalEngine, keeps no user data.  The
+    // request is replayed on the engine being loaded.
+    pending_user_data_clears_.push_back(type);
+  }
+}
+
 bool SessionHandler::GetStoredConfig(commands::Command *command) {
   VLOG(1) << "Getting stored config";
   // Use GetStoredConfig instead of GetConfig because GET_CONFIG
@@ -467,6 +561,8 @@ bool SessionHandler::EvalCommand(commands::Command *command) {
     return false;
   }
 
+  MaybeSwitchEngine();
+
   bool eval_succeeded = false;
   stopwatch_->Reset();
   stopwatch_->Start();
@@ -481,6 +577,9 @@ bool SessionHandler::EvalCommand(commands::Command *command) {
     case commands::Input::SEND_KEY:
       eval_succeeded = SendKey(command);
       break;
+    case commands::Input::SEND_KEYS:
+      eval_succeeded = SendKeys(command);
+      break;
     case commands::Input::TEST_SEND_KEY:
       eval_succeeded = TestSendKey(command);
       break;
@@ -538,6 +637,9 @@ bool SessionHandler::EvalCommand(commands::Command *command) {
     case commands::Input::NO_OPERATION:
       eval_succeeded = NoOperation(command);
       break;
+    case commands::Input::GET_MEMORY_USAGE:
+      eval_succeeded = GetMemoryUsage(command);
+      break;
     default:
       eval_succeeded = false;
   }
@@ -557,7 +659,11 @@ bool SessionHandler::EvalCommand(commands::Command *command) {
 
   if (eval_succeeded) {
     // TODO(komatsu): Make sre if checking eval_succeeded is necessary or not.
-    observer_handler_->EvalCommandHandler(*command);
+    // The keys of SEND_KEYS are observed one by one in SendKeys().
+    if (command->input().type() != commands::Input::SEND_KEYS) {
+      observer_handler_->EvalCommandHandler(*command);
+    }
+    MaybeEncodeOutputDelta(command);
   }
 
   stopwatch_->Stop();
@@ -588,36 +694,102 @@ void SessionHandler::MaybeUpdateStoredConfig(commands::Command *command) {
 
 bool SessionHandler::SendKey(commands::Command *command) {
   const SessionID id = command->input().id();
-  session::SessionInterface **session = session_map_->MutableLookup(id);
-  if (session == NULL || *session == NULL) {
+  session::SessionInterface *session = GetSession(id);
+  if (session == NULL) {
     LOG(WARNING) << "SessionID " << id << " is not available";
     return false;
   }
-  (*session)->SendKey(command);
+  session->SendKey(command);
   MaybeUpdateStoredConfig(command);
   return true;
 }
 
+bool SessionHandler::SendKeys(commands::Command *command) {
+  const SessionID id = command->input().id();
+  if (command->input().keys_size() == 0) {
+    LOG(WARNING) << "No key is given";
+    return false;
+  }
+
+  // Each key is evaluated as a SEND_KEY command.  Only the fields a key event
+  // reads are copied; the session rewrites nothing but the key itself, so the
+  // input is built once and only the key is replaced for each key.  The
+  // output is cleared in place so that its allocated submessages, e.g.
+  // candidates, are reused.
+  const commands::Input &input = command->input();
+  commands::Command key_command;
+  commands::Input *key_input = key_command.mutable_input();
+  key_input->set_type(commands::Input::SEND_KEY);
+  key_input->set_id(id);
+  if (input.has_capability()) {
+    key_input->mutable_capability()->CopyFrom(input.capability());
+  }
+  if (input.has_application_info()) {
+    key_input->mutable_application_info()->CopyFrom(input.application_info());
+  }
+  if (input.has_context()) {
+    key_input->mutable_context()->CopyFrom(input.context());
+  }
+  if (input.has_config()) {
+    key_input->mutable_config()->CopyFrom(input.config());
+  }
+  if (input.has_request()) {
+    key_input->mutable_request()->CopyFrom(input.request());
+  }
+  if (input.has_request_suggestion()) {
+    key_input->set_request_suggestion(input.request_suggestion());
+  }
+  const std::set<uint32> output_key_indices(
+      input.output_key_indices().begin(), input.output_key_indices().end());
+
+  const int last_index = input.keys_size() - 1;
+  for (int i = 0; i <= last_index; ++i) {
+    session::SessionInterface *session = GetSession(id);
+    if (session == NULL) {
+      LOG(WARNING) << "SessionID " << id << " is not available";
+      return false;
+    }
+    key_command.clear_output();
+    key_input->mutable_key()->CopyFrom(input.keys(i));
+    session->SendKey(&key_command);
+    MaybeUpdateStoredConfig(&key_command);
+    key_command.mutable_output()->set_id(id);
+    // Observers see every key as a SEND_KEY command.  EvalCommand() doesn't
+    // observe the SEND_KEYS command itself.
+    observer_handler_->EvalCommandHandler(key_command);
+
+    if (i == last_index) {
+      command->mutable_output()->MergeFrom(key_command.output());
+    } else if (output_key_indices.count(i) > 0 ||
+               NeedsClientHandling(key_command.output())) {
+      commands::Output::KeyOutput *key_output =
+          command->mutable_output()->add_key_outputs();
+      key_output->set_index(i);
+      key_output->mutable_output()->Swap(key_command.mutable_output());
+    }
+  }
+  return true;
+}
+
 bool SessionHandler::TestSendKey(commands::Command *command) {
   const SessionID id = command->input().id();
-  session::SessionInterface **session = session_map_->MutableLookup(id);
-  if (session == NULL || *session == NULL) {
+  session::SessionInterface *session = GetSession(id);
+  if (session == NULL) {
     LOG(WARNING) << "SessionID " << id << " is not available";
     return false;
   }
-  (*session)->TestSendKey(command);
+  session->TestSendKey(command);
   return true;
 }
 
 bool SessionHandler::SendCommand(commands::Command *command) {
   const SessionID id = command->input().id();
-  session::SessionInterface **session =
-    const_cast<session::SessionInterface **>(session_map_->Lookup(id));
-  if (session == NULL || *session == NULL) {
+  session::SessionInterface *session = GetSession(id);
+  if (session == NULL) {
     LOG(WARNING) << "SessionID " << id << " is not available";
     return false;
   }
-  (*session)->SendCommand(command);
+  session->SendCommand(command);
   MaybeUpdateStoredConfig(command);
   return true;
 }
@@ -647,25 +819,25 @@ bool SessionHandler::CreateSession(commands::Command *command) {
     }
     delete oldest_element->value;
     oldest_element->value = NULL;
+    hibernated_sessions_.erase(oldest_element->key);
+    delta_output_bases_.erase(oldest_element->key);
+    ReleaseRetiredEngine(oldest_element->key);
     session_map_->Erase(oldest_element->key);
     VLOG(1) << "Session is FULL, oldest SessionID "
             << oldest_element->key << " is removed";
   }
 
-  if (engine_builder_ &&
-      session_map_->Size() == 0 &&
-      engine_builder_->HasResponse()) {
+  // The existing sessions keep the current engine until they get idle, so
+  // the prepared engine can be installed at any time.
+  if (engine_builder_ && engine_builder_->HasResponse()) {
     auto *response =
         command->mutable_output()->mutable_engine_reload_response();
     engine_builder_->GetResponse(response);
     if (response->status() == EngineReloadResponse::RELOAD_READY) {
-      if (engine_->GetUserDataManager()) {
-        engine_->GetUserDataManager()->Wait();
-      }
-      engine_.reset();
-      engine_ = engine_builder_->BuildFromPreparedData();
-      LOG_IF(FATAL, !engine_) << "Critical failure in engine replace";
-      table_manager_->ClearCaches();
+      std::unique_ptr<EngineInterface> engine =
+          engine_builder_->BuildFromPreparedData();
+      LOG_IF(FATAL, !engine) << "Critical failure in engine replace";
+      InstallEngine(std::move(engine));
       response->set_status(EngineReloadResponse::RELOADED);
     }
     engine_builder_->Clear();
@@ -687,6 +859,9 @@ bool SessionHandler::CreateSession(commands::Command *command) {
 
   if (command->input().has_capability()) {
     session->set_client_capability(command->input().capability());
+    if (command->input().capability().delta_output()) {
+      delta_output_bases_[new_id].output.reset(new commands::Output);
+    }
   }
 
   if (command->input().has_application_info()) {
@@ -765,19 +940,41 @@ bool SessionHandler::Cleanup(commands::Command *command) {
   for (SessionElement *element =
            const_cast<SessionElement *>(session_map_->Head());
        element != NULL; element = element->next) {
-    session::SessionInterface *session = element->value;
-    if (!IsApplicationAlive(session)) {
+    // A hibernated session is checked with its saved state.
+    protocol::HibernatedSession hibernated;
+    const session::SessionInterface *session = element->value;
+    if (session == NULL) {
+      std::map<SessionID, string>::const_iterator it =
+          hibernated_sessions_.find(element->key);
+      if (it == hibernated_sessions_.end()) {
+        LOG(ERROR) << "No state of hibernated session: " << element->key;
+        remove_ids.push_back(element->key);
+        continue;
+      }
+      if (!hibernated.ParseFromString(it->second)) {
+        LOG(ERROR) << "Broken hibernated session: " << element->key;
+        remove_ids.push_back(element->key);
+        continue;
+      }
+    }
+    const commands::ApplicationInfo &application_info =
+        session ? session->application_info() : hibernated.application_info();
+    const uint64 create_session_time =
+        session ? session->create_session_time() : hibernated.create_time();
+    const uint64 last_command_time =
+        session ? session->last_command_time() :
+        hibernated.last_command_time();
+
+    if (!IsApplicationAlive(application_info)) {
       VLOG(2) << "Application is not alive. Removing: " << element->key;
       remove_ids.push_back(element->key);
-    } else if (session->last_command_time() == 0) {
+    } else if (last_command_time == 0) {
       // no command is exectuted
-      if ((current_time - session->create_session_time()) >=
-          create_session_timeout) {
+      if ((current_time - create_session_time) >= create_session_timeout) {
         remove_ids.push_back(element->key);
       }
     } else {  // some commands are executed already
-      if ((current_time - session->last_command_time()) >=
-          last_command_timeout) {
+      if ((current_time - last_command_time) >= last_command_timeout) {
         remove_ids.push_back(element->key);
       }
     }
@@ -788,9 +985,25 @@ bool SessionHandler::Cleanup(commands::Command *command) {
     VLOG(1) << "Session ID " << remove_ids[i] << " is removed by server";
   }
 
+  if (FLAGS_session_hibernation_timeout > 0) {
+    // allow [10..] sec.
+    HibernateIdleSessions(
+        current_time,
+        suspend_time + max(10, FLAGS_session_hibernation_timeout));
+  }
+
   // Sync all data. This is a regression bug fix http://b/3033708
   engine_->GetUserDataManager()->Sync();
 
+  if (FLAGS_memory_usage_log_interval > 0 &&
+      current_time - last_memory_usage_log_time_ >=
+      FLAGS_memory_usage_log_interval) {
+    MemoryUsage usage;
+    CollectMemoryUsage(&usage);
+    LOG(INFO) << "Memory usage: " << usage.DebugString();
+    last_memory_usage_log_time_ = current_time;
+  }
+
   // timeout is enabled.
   if (FLAGS_timeout > 0 &&
       last_session_empty_time_ != 0 &&
@@ -832,6 +1045,54 @@ bool SessionHandler::NoOperation(commands::Command *command) {
   return true;
 }
 
+bool SessionHandler::GetMemoryUsage(commands::Command *command) {
+  MemoryUsage usage;
+  CollectMemoryUsage(&usage);
+  commands::MemoryUsage *output =
+      command->mutable_output()->mutable_memory_usage();
+  for (const auto &entry : usage.entries()) {
+    commands::MemoryUsage::Entry *output_entry = output->add_entries();
+    output_entry->set_name(entry.first);
+    output_entry->set_bytes(entry.second);
+  }
+  output->set_total_bytes(usage.GetTotalBytes());
+  return true;
+}
+
+void SessionHandler::CollectMemoryUsage(MemoryUsage *usage) const {
+  {
+    MemoryUsage::Scope scope(usage, "engine");
+    engine_->CollectMemoryUsage(usage);
+  }
+  for (const auto &generation : retired_engines_) {
+    MemoryUsage::Scope scope(usage, "retired_engine");
+    generation->engine->CollectMemoryUsage(usage);
+  }
+
+  MemoryUsage::Scope scope(usage, "sessions");
+  for (const SessionElement *element = session_map_->Head();
+       element != NULL; element = element->next) {
+    if (element->value != NULL) {
+      element->value->CollectMemoryUsage(usage);
+    }
+  }
+  size_t hibernated_bytes = 0;
+  for (const auto &hibernated : hibernated_sessions_) {
+    hibernated_bytes += hibernated.second.capacity();
+  }
+  usage->Add("hibernated", hibernated_bytes);
+  size_t delta_output_bytes = 0;
+  for (const auto &base : delta_output_bases_) {
+    if (base.second.output) {
+      delta_output_bytes += base.second.output->SpaceUsed();
+    }
+  }
+  if (delta_output_scratch_) {
+    delta_output_bytes += delta_output_scratch_->SpaceUsed();
+  }
+  usage->Add("delta_output_bases", delta_output_bytes);
+}
+
 // Create Random Session ID in order to make the session id unpredicable
 SessionID SessionHandler::CreateNewSessionID() {
   SessionID id = 0;
@@ -851,11 +1112,15 @@ SessionID SessionHandler::CreateNewSessionID() {
 
 bool SessionHandler::DeleteSessionID(SessionID id) {
   session::SessionInterface **session = session_map_->MutableLookup(id);
-  if (session == NULL || *session == NULL) {
+  if (session == NULL) {
     LOG_IF(WARNING, id != 0) << "cannot find SessionID " << id;
     return false;
   }
+  // |*session| is NULL if the session is hibernated.
   delete *session;
+  hibernated_sessions_.erase(id);
+  delta_output_bases_.erase(id);
+  ReleaseRetiredEngine(id);
 
   session_map_->Erase(id);   // remove from LRU
 
@@ -867,4 +1132,238 @@ bool SessionHandler::DeleteSessionID(SessionID id) {
 
   return true;
 }
+
+session::SessionInterface *SessionHandler::GetSession(SessionID id) {
+  session::SessionInterface **session = session_map_->MutableLookup(id);
+  if (session == NULL) {
+    return NULL;
+  }
+  if (*session == NULL) {
+    *session = RestoreSession(id);
+    if (*session == NULL) {
+      session_map_->Erase(id);
+      delta_output_bases_.erase(id);
+      return NULL;
+    }
+  }
+  return *session;
+}
+
+void SessionHandler::HibernateIdleSessions(uint64 current_time,
+                                           uint64 timeout) {
+  for (SessionElement *element = session_map_->MutableHead();
+       element != NULL; element = element->next) {
+    session::SessionInterface *session = element->value;
+    if (session == NULL) {
+      continue;
+    }
+    const uint64 last_access_time = (session->last_command_time() == 0) ?
+        session->create_session_time() : session->last_command_time();
+    if ((current_time - last_access_time) < timeout) {
+      continue;
+    }
+    HibernateSession(element->key, &element->value);
+  }
+}
+
+bool SessionHandler::HibernateSession(SessionID id,
+                                      session::SessionInterface **session) {
+  DCHECK(*session);
+  protocol::HibernatedSession state;
+  if (!(*session)->Hibernate(&state)) {
+    return false;
+  }
+  state.SerializeToString(&hibernated_sessions_[id]);
+  delete *session;
+  *session = NULL;
+  // The session is restored with the current engine.
+  ReleaseRetiredEngine(id);
+  // The next output is sent in full.
+  std::map<SessionID, DeltaOutputBase>::iterator base =
+      delta_output_bases_.find(id);
+  if (base != delta_output_bases_.end()) {
+    base->second.output->Clear();
+  }
+  VLOG(1) << "Session ID " << id << " is hibernated";
+  return true;
+}
+
+void SessionHandler::MaybeEncodeOutputDelta(commands::Command *command) {
+  switch (command->input().type()) {
+    case commands::Input::SEND_KEY:
+    case commands::Input::SEND_KEYS:
+    case commands::Input::TEST_SEND_KEY:
+    case commands::Input::SEND_COMMAND:
+      break;
+    default:
+      return;
+  }
+  std::map<SessionID, DeltaOutputBase>::iterator it =
+      delta_output_bases_.find(command->input().id());
+  if (it == delta_output_bases_.end()) {
+    return;
+  }
+  DeltaOutputBase *base = &it->second;
+  commands::Output *output = command->mutable_output();
+  // The scratch output holds the base output swapped out by the previous
+  // call, so that copying into it reuses the allocated submessages.
+  if (!delta_output_scratch_) {
+    delta_output_scratch_.reset(new commands::Output);
+  }
+  delta_output_scratch_->CopyFrom(*output);
+  // The client may have missed the base output, e.g. because of a timeout.
+  if (base->sequence != 0 &&
+      command->input().output_base_sequence() == base->sequence &&
+      base->output->ByteSize() > 0) {
+    OutputDeltaUtil::EncodeDelta(*base->output, output);
+    output->mutable_delta()->set_base_sequence(base->sequence);
+  }
+  ++base->sequence;
+  output->mutable_delta()->set_sequence(base->sequence);
+  base->output->Swap(delta_output_scratch_.get());
+}
+
+void SessionHandler::SetEngineLoader(
+    std::unique_ptr<EngineLoader> engine_loader) {
+  engine_loader_ = std::move(engine_loader);
+}
+
+void SessionHandler::InstallEngine(std::unique_ptr<EngineInterface> engine) {
+  DCHECK(engine);
+  std::unique_ptr<EngineGeneration> generation(new EngineGeneration);
+  for (const SessionElement *element = session_map_->Head();
+       element != NULL; element = element->next) {
+    // The hibernated sessions are restored with the new engine, and the
+    // sessions of the older generations keep their engines.
+    if (element->value != NULL &&
+        retired_engine_sessions_.count(element->key) == 0) {
+      retired_engine_sessions_[element->key] = generation.get();
+      ++generation->num_sessions;
+    }
+  }
+  generation->engine = std::move(engine_);
+  engine_ = std::move(engine);
+  // The retired engine keeps learning from its sessions.  Its user data is
+  // handed over to the new engine when it is released.  See EngineDeleter.
+  // The tables cached so far are kept with the retired engine, as its
+  // sessions still refer to them.
+  generation->table_manager = std::move(table_manager_);
+  table_manager_.reset(new composer::TableManager);
+  VLOG(1) << "Installed a new engine.  " << generation->num_sessions
+          << " sessions keep the previous one";
+  retired_engines_.push_back(std::move(generation));
+}
+
+void SessionHandler::MaybeSwitchEngine() {
+  if (engine_loader_ && engine_loader_->IsReady()) {
+    std::unique_ptr<EngineInterface> engine = engine_loader_->Release();
+    engine_loader_.reset();
+    if (engine) {
+      InstallEngine(std::move(engine));
+      for (const commands::Input::CommandType type :
+               pending_user_data_clears_) {
+        ClearUserDataOf(engine_->GetUserDataManager(), type);
+      }
+    }
+    pending_user_data_clears_.clear();
+  }
+
+  // Finished deleters are joined immediately, and the user data they have
+  // saved is merged into the current engine.
+  bool user_data_saved = false;
+  for (auto it = engine_deleters_.begin(); it != engine_deleters_.end();) {
+    if ((*it)->IsRunning()) {
+      ++it;
+    } else {
+      it = engine_deleters_.erase(it);
+      user_data_saved = true;
+    }
+  }
+  if (user_data_saved && engine_->GetUserDataManager()) {
+    engine_->GetUserDataManager()->Reload();
+  }
+
+  if (retired_engines_.empty()) {
+    return;
+  }
+
+  // Sessions in composition or conversion keep their engine until they get
+  // idle.
+  for (auto it = retired_engine_sessions_.begin();
+       it != retired_engine_sessions_.end();) {
+    const SessionID id = it->first;
+    // HibernateSession() erases |it|.
+    ++it;
+    session::SessionInterface **session =
+        session_map_->MutableLookupWithoutInsert(id);
+    if (session != NULL && *session != NULL) {
+      HibernateSession(id, session);
+    }
+  }
+
+  for (auto it = retired_engines_.begin(); it != retired_engines_.end();) {
+    if ((*it)->num_sessions > 0) {
+      ++it;
+      continue;
+    }
+    std::unique_ptr<Thread> deleter(
+        new EngineDeleter(std::move((*it)->engine),
+                          std::move((*it)->table_manager)));
+    deleter->SetJoinable(true);
+    deleter->Start("EngineDeleter");
+    engine_deleters_.push_back(std::move(deleter));
+    it = retired_engines_.erase(it);
+  }
+}
+
+const composer::Table *SessionHandler::GetTable(SessionID id) {
+  // A session of a retired engine uses the tables of its generation, which
+  // are released together with the session's engine.
+  std::map<SessionID, EngineGeneration *>::const_iterator it =
+      retired_engine_sessions_.find(id);
+  if (it != retired_engine_sessions_.end()) {
+    EngineGeneration *generation = it->second;
+    return generation->table_manager->GetTable(
+        *request_, *config_, *generation->engine->GetDataManager());
+  }
+  return table_manager_->GetTable(
+      *request_, *config_, *engine_->GetDataManager());
+}
+
+void SessionHandler::ReleaseRetiredEngine(SessionID id) {
+  std::map<SessionID, EngineGeneration *>::iterator it =
+      retired_engine_sessions_.find(id);
+  if (it == retired_engine_sessions_.end()) {
+    return;
+  }
+  DCHECK_GT(it->second->num_sessions, 0);
+  --it->second->num_sessions;
+  retired_engine_sessions_.erase(it);
+}
+
+session::SessionInterface *SessionHandler::RestoreSession(SessionID id) {
+  std::map<SessionID, string>::iterator it = hibernated_sessions_.find(id);
+  if (it == hibernated_sessions_.end()) {
+    return NULL;
+  }
+  protocol::HibernatedSession state;
+  const bool parsed = state.ParseFromString(it->second);
+  hibernated_sessions_.erase(it);
+  if (!parsed) {
+    LOG(ERROR) << "Broken hibernated session: " << id;
+    return NULL;
+  }
+
+  std::unique_ptr<session::SessionInterface> session(NewSession());
+  session->SetConfig(config_.get());
+  session->SetRequest(request_.get());
+  session->SetTable(GetTable(id));
+  if (!session->Restore(state)) {
+    LOG(ERROR) << "Cannot restore session: " << id;
+    return NULL;
+  }
+  VLOG(1) << "Session ID " << id << " is restored";
+  return session.release();
+}
+
 }  // namespace mozc
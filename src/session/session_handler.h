@@ -34,12 +34,16 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "base/port.h"
 #include "composer/table.h"
 #include "engine/engine_builder_interface.h"
 #include "engine/engine_interface.h"
+#include "engine/engine_loader.h"
+#include "protocol/commands.pb.h"
 #include "session/common.h"
 #include "session/session_handler_interface.h"
 #include "storage/lru_cache.h"
@@ -54,6 +58,8 @@
 
 namespace mozc {
 
+class Thread;
+
 #ifndef MOZC_DISABLE_SESSION_WATCHDOG
 class SessionWatchDog;
 #else  // MOZC_DISABLE_SESSION_WATCHDOG
@@ -61,10 +67,12 @@ class SessionWatchDog;
 // TODO(kkojima): Remove this guard after
 // enabling session watch dog for android.
 #endif  // MOZC_DISABLE_SESSION_WATCHDOG
+class MemoryUsage;
 class Stopwatch;
 
 namespace commands {
 class Command;
+class Output;
 class Request;
 }  // namespace commands
 
@@ -104,8 +112,22 @@ class SessionHandler : public SessionHandlerInterface {
 
   const EngineInterface &engine() const { return *engine_; }
 
+  // Switches to the engine built by |engine_loader| once it is ready.  Until
+  // then the current engine, e.g., MinimalEngine, serves the sessions.  The
+  // sessions created before the switch are moved to the new engine when they
+  // get idle.  See InstallEngine().
+  void SetEngineLoader(std::unique_ptr<EngineLoader> engine_loader);
+
  private:
   FRIEND_TEST(SessionHandlerTest, StorageTest);
+  FRIEND_TEST(SessionHandlerTest, HibernateIdleSession);
+  FRIEND_TEST(SessionHandlerTest, DeltaOutput);
+  FRIEND_TEST(SessionHandlerTest, SwitchEngine);
+  FRIEND_TEST(SessionHandlerTest, SwitchEngineKeepsTableOfComposition);
+  FRIEND_TEST(SessionHandlerTest, ClearUserDataWhileLoading);
+  FRIEND_TEST(SessionHandlerTest, EngineGenerations);
+  FRIEND_TEST(SessionHandlerTest, EngineReload_SessionExists);
+  FRIEND_TEST(SessionHandlerTest, InstallEngineHandsOverUserData);
 
   using SessionMap =
       mozc::storage::LRUCache<SessionID, session::SessionInterface *>;
@@ -124,11 +146,15 @@ class SessionHandler : public SessionHandlerInterface {
   bool DeleteSession(commands::Command *command);
   bool TestSendKey(commands::Command *command);
   bool SendKey(commands::Command *command);
+  bool SendKeys(commands::Command *command);
   bool SendCommand(commands::Command *command);
   bool SyncData(commands::Command *command);
   bool ClearUserHistory(commands::Command *command);
   bool ClearUserPrediction(commands::Command *command);
   bool ClearUnusedUserPrediction(commands::Command *command);
+  // Clears the user data for the command |type|, or queues the request until
+  // |engine_loader_| gets ready if the current engine keeps no user data.
+  void ClearUserData(commands::Input::CommandType type);
   bool Shutdown(commands::Command *command);
   bool Reload(commands::Command *command);
   bool GetStoredConfig(commands::Command *command);
@@ -143,11 +169,56 @@ class SessionHandler : public SessionHandlerInterface {
   bool SendUserDictionaryCommand(commands::Command *command);
   bool SendEngineReloadRequest(commands::Command *command);
   bool NoOperation(commands::Command *command);
+  bool GetMemoryUsage(commands::Command *command);
 
   SessionID CreateNewSessionID();
   bool DeleteSessionID(SessionID id);
 
+  // Returns the session for |id|, restoring it first if it is hibernated.
+  // Returns NULL if the session is not available.
+  session::SessionInterface *GetSession(SessionID id);
+  // Replaces the sessions idle for |timeout| sec with their compact form.
+  void HibernateIdleSessions(uint64 current_time, uint64 timeout);
+  // Replaces |*session| of |id| with its compact form.  Returns false
+  // if the session is not idle.
+  bool HibernateSession(SessionID id, session::SessionInterface **session);
+  session::SessionInterface *RestoreSession(SessionID id);
+
+  // Encodes the output of |command| relative to the last output sent to the
+  // session if the client supports Capability::delta_output.
+  void MaybeEncodeOutputDelta(commands::Command *command);
+
+  // Makes |engine| the engine of the new sessions.  The current engine is
+  // retired as a new generation of |retired_engines_| together with the live
+  // sessions, which keep using it until they end or get idle.
+  void InstallEngine(std::unique_ptr<EngineInterface> engine);
+  // Switches to the engine built by |engine_loader_| if it is ready, moves
+  // the idle sessions of the retired engines to the current one by
+  // hibernating them, and releases the retired engines no longer used.
+  void MaybeSwitchEngine();
+  // Returns the table for the session |id| from the tables of its engine.
+  const composer::Table *GetTable(SessionID id);
+  // Drops the reference from the session |id| to its retired engine, if any.
+  void ReleaseRetiredEngine(SessionID id);
+
+  // Reports the heap memory held by the engines and the sessions.
+  void CollectMemoryUsage(MemoryUsage *usage) const;
+
   std::unique_ptr<SessionMap> session_map_;
+  // Serialized protocol::HibernatedSession of the sessions whose value in
+  // |session_map_| is NULL.  The sessions stay in |session_map_| to keep
+  // their LRU order and to count towards |max_session_size_|.
+  std::map<SessionID, string> hibernated_sessions_;
+  // The last complete output sent to each session with
+  // Capability::delta_output, and its OutputDelta::sequence.  The sequence is
+  // 0 until the first output.
+  struct DeltaOutputBase {
+    uint64 sequence = 0;
+    std::unique_ptr<commands::Output> output;
+  };
+  std::map<SessionID, DeltaOutputBase> delta_output_bases_;
+  // Reused by MaybeEncodeOutputDelta() to keep a copy of the complete output.
+  std::unique_ptr<commands::Output> delta_output_scratch_;
 #ifndef MOZC_DISABLE_SESSION_WATCHDOG
   std::unique_ptr<SessionWatchDog> session_watch_dog_;
 #else  // MOZC_DISABLE_SESSION_WATCHDOG
@@ -159,10 +230,31 @@ class SessionHandler : public SessionHandlerInterface {
   uint32 max_session_size_ = 0;
   uint64 last_session_empty_time_ = 0;
   uint64 last_cleanup_time_ = 0;
+  uint64 last_memory_usage_log_time_ = 0;
   uint64 last_create_session_time_ = 0;
 
   std::unique_ptr<EngineInterface> engine_;
   std::unique_ptr<EngineBuilderInterface> engine_builder_;
+  std::unique_ptr<EngineLoader> engine_loader_;
+  // Clear commands to be replayed on the engine built by |engine_loader_|.
+  std::vector<commands::Input::CommandType> pending_user_data_clears_;
+  // An engine replaced by a newer one, and the number of the sessions still
+  // using it.  The engine is released when |num_sessions| gets 0.
+  struct EngineGeneration {
+    std::unique_ptr<EngineInterface> engine;
+    // The tables built for the engine.  The sessions of this generation keep
+    // pointers to them, so they are released after the sessions, and before
+    // the engine whose data they refer to.
+    std::unique_ptr<composer::TableManager> table_manager;
+    size_t num_sessions = 0;
+  };
+  // Ordered from the oldest generation.
+  std::vector<std::unique_ptr<EngineGeneration>> retired_engines_;
+  // The sessions using a retired engine, and the generation of the engine.
+  std::map<SessionID, EngineGeneration *> retired_engine_sessions_;
+  // Threads deleting the released engines, as deleting an engine waits for
+  // its user data to be saved.
+  std::vector<std::unique_ptr<Thread>> engine_deleters_;
   std::unique_ptr<session::SessionObserverHandler> observer_handler_;
   std::unique_ptr<Stopwatch> stopwatch_;
   std::unique_ptr<user_dictionary::UserDictionarySessionHandler>
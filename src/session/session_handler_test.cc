@@ -31,7 +31,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/clock_mock.h"
@@ -39,15 +41,19 @@
 #include "base/util.h"
 #include "config/config_handler.h"
 #include "converter/converter_mock.h"
+#include "data_manager/testing/mock_data_manager.h"
 #include "engine/engine_builder_interface.h"
+#include "engine/engine_loader.h"
 #include "engine/engine_stub.h"
 #include "engine/mock_converter_engine.h"
+#include "engine/minimal_engine.h"
 #include "engine/mock_data_engine_factory.h"
 #include "engine/user_data_manager_mock.h"
 #include "protocol/commands.pb.h"
 #include "protocol/config.pb.h"
 #include "session/generic_storage_manager.h"
 #include "session/session_handler_test_util.h"
+#include "session/session_observer_interface.h"
 #include "testing/base/public/googletest.h"
 #include "testing/base/public/gunit.h"
 #include "usage_stats/usage_stats.h"
@@ -57,6 +63,7 @@ DECLARE_int32(max_session_size);
 DECLARE_int32(create_session_min_interval);
 DECLARE_int32(last_command_timeout);
 DECLARE_int32(last_create_session_timeout);
+DECLARE_int32(session_hibernation_timeout);
 
 namespace mozc {
 
@@ -141,6 +148,70 @@ EngineReloadResponse::Status SendDummyEngineCommand(SessionHandler *handler) {
   return command.output().engine_reload_response().status();
 }
 
+EngineInterface *CreateMockDataEngineForLoader() {
+  return MockDataEngineFactory::Create();
+}
+
+// The user data manager of the last engine created by
+// CreateUserDataMockEngineForLoader().
+UserDataManagerMock *g_loaded_user_data_manager = nullptr;
+
+EngineInterface *CreateUserDataMockEngineForLoader() {
+  MockConverterEngine *engine = new MockConverterEngine();
+  g_loaded_user_data_manager = new UserDataManagerMock();
+  engine->SetUserDataManager(g_loaded_user_data_manager);
+  return engine;
+}
+
+bool SendKey(SessionHandler *handler, uint64 id,
+             const commands::KeyEvent &key, commands::Output *output) {
+  commands::Command command;
+  command.mutable_input()->set_id(id);
+  command.mutable_input()->set_type(commands::Input::SEND_KEY);
+  *command.mutable_input()->mutable_key() = key;
+  if (!handler->EvalCommand(&command)) {
+    return false;
+  }
+  output->Swap(command.mutable_output());
+  return true;
+}
+
+// Records the commands given to the observer.
+class RecordingObserver : public session::SessionObserverInterface {
+ public:
+  RecordingObserver() {}
+  ~RecordingObserver() override {}
+
+  void EvalCommandHandler(const commands::Command &command) override {
+    commands_.push_back(command);
+  }
+
+  const std::vector<commands::Command> &commands() const { return commands_; }
+
+ private:
+  std::vector<commands::Command> commands_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingObserver);
+};
+
+// Counts Retire() outside of the manager, which is deleted with its engine.
+class RetireCountingUserDataManager : public UserDataManagerMock {
+ public:
+  explicit RetireCountingUserDataManager(int *retire_count)
+      : retire_count_(retire_count) {}
+  ~RetireCountingUserDataManager() override {}
+
+  bool Retire() override {
+    ++*retire_count_;
+    return UserDataManagerMock::Retire();
+  }
+
+ private:
+  int *retire_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(RetireCountingUserDataManager);
+};
+
 }  // namespace
 
 class SessionHandlerTest : public SessionHandlerTestBase {
@@ -279,6 +350,340 @@ TEST_F(SessionHandlerTest, LastCommandTimeout) {
   EXPECT_FALSE(IsGoodSession(&handler, id));
 }
 
+TEST_F(SessionHandlerTest, HibernateIdleSession) {
+  const int32 timeout = FLAGS_session_hibernation_timeout = 60;  // 60 sec
+  ClockMock clock(1000, 0);
+  Clock::SetClockForUnitTest(&clock);
+
+  SessionHandler handler(CreateMockDataEngine());
+
+  uint64 id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &id));
+  EXPECT_TRUE(IsGoodSession(&handler, id));
+
+  clock.PutClockForward(timeout - 1, 0);
+  EXPECT_TRUE(CleanUp(&handler, id));
+  EXPECT_TRUE(handler.hibernated_sessions_.empty());
+
+  clock.PutClockForward(1, 0);
+  EXPECT_TRUE(CleanUp(&handler, id));
+  EXPECT_EQ(1, handler.hibernated_sessions_.size());
+
+  // The session is restored by the next command.
+  EXPECT_TRUE(IsGoodSession(&handler, id));
+  EXPECT_TRUE(handler.hibernated_sessions_.empty());
+
+  // A hibernated session can be deleted.
+  clock.PutClockForward(timeout, 0);
+  EXPECT_TRUE(CleanUp(&handler, id));
+  EXPECT_EQ(1, handler.hibernated_sessions_.size());
+  EXPECT_TRUE(DeleteSession(&handler, id));
+  EXPECT_TRUE(handler.hibernated_sessions_.empty());
+  EXPECT_FALSE(IsGoodSession(&handler, id));
+
+  // A hibernated session whose state is lost is removed without adding an
+  // empty state.
+  EXPECT_TRUE(CreateSession(&handler, &id));
+  clock.PutClockForward(timeout, 0);
+  EXPECT_TRUE(CleanUp(&handler, id));
+  ASSERT_EQ(1, handler.hibernated_sessions_.size());
+  handler.hibernated_sessions_.clear();
+  EXPECT_TRUE(CleanUp(&handler, id));
+  EXPECT_TRUE(handler.hibernated_sessions_.empty());
+  EXPECT_FALSE(IsGoodSession(&handler, id));
+}
+
+TEST_F(SessionHandlerTest, SwitchEngine) {
+  SessionHandler handler(std::unique_ptr<EngineInterface>(new MinimalEngine(
+      std::unique_ptr<const DataManagerInterface>(
+          new testing::MockDataManager))));
+  const EngineInterface *minimal_engine = &handler.engine();
+  std::unique_ptr<EngineLoader> engine_loader(
+      new EngineLoader(&CreateMockDataEngineForLoader));
+  EngineLoader *loader = engine_loader.get();
+  handler.SetEngineLoader(std::move(engine_loader));
+
+  // The minimal engine serves the composition.
+  uint64 composing_id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &composing_id));
+  commands::KeyEvent key;
+  commands::Output output;
+  key.set_special_key(commands::KeyEvent::ON);
+  EXPECT_TRUE(SendKey(&handler, composing_id, key, &output));
+  key.Clear();
+  key.set_key_code('a');
+  EXPECT_TRUE(SendKey(&handler, composing_id, key, &output));
+  EXPECT_TRUE(output.has_preedit());
+
+  loader->StartLoading();
+  while (!loader->IsReady()) {
+    Util::Sleep(10);
+  }
+
+  // The session in composition keeps the minimal engine.
+  key.set_key_code('i');
+  EXPECT_TRUE(SendKey(&handler, composing_id, key, &output));
+  EXPECT_TRUE(output.has_preedit());
+  EXPECT_NE(minimal_engine, &handler.engine());
+  ASSERT_EQ(1, handler.retired_engines_.size());
+  EXPECT_EQ(minimal_engine, handler.retired_engines_[0]->engine.get());
+  EXPECT_EQ(1, handler.retired_engines_[0]->num_sessions);
+  EXPECT_EQ(1, handler.retired_engine_sessions_.count(composing_id));
+
+  // A new session uses the loaded engine.
+  uint64 new_id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &new_id));
+  EXPECT_EQ(0, handler.retired_engine_sessions_.count(new_id));
+
+  key.Clear();
+  key.set_special_key(commands::KeyEvent::ENTER);
+  EXPECT_TRUE(SendKey(&handler, composing_id, key, &output));
+  EXPECT_TRUE(output.has_result());
+
+  // The idle session is moved to the loaded engine by the next command.
+  EXPECT_TRUE(IsGoodSession(&handler, new_id));
+  EXPECT_TRUE(handler.retired_engines_.empty());
+  EXPECT_EQ(1, handler.hibernated_sessions_.count(composing_id));
+  EXPECT_TRUE(IsGoodSession(&handler, composing_id));
+  EXPECT_TRUE(handler.hibernated_sessions_.empty());
+}
+
+// Tests that the table of a composing session outlives the engine switch.
+// The composer keeps a raw pointer to it until the session ends.
+TEST_F(SessionHandlerTest, SwitchEngineKeepsTableOfComposition) {
+  SessionHandler handler(std::unique_ptr<EngineInterface>(new MinimalEngine(
+      std::unique_ptr<const DataManagerInterface>(
+          new testing::MockDataManager))));
+  const DataManagerInterface &minimal_data = *handler.engine().GetDataManager();
+  std::unique_ptr<EngineLoader> engine_loader(
+      new EngineLoader(&CreateMockDataEngineForLoader));
+  EngineLoader *loader = engine_loader.get();
+  handler.SetEngineLoader(std::move(engine_loader));
+
+  uint64 id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &id));
+  commands::KeyEvent key;
+  commands::Output output;
+  key.set_special_key(commands::KeyEvent::ON);
+  EXPECT_TRUE(SendKey(&handler, id, key, &output));
+  key.Clear();
+  key.set_key_code('k');
+  EXPECT_TRUE(SendKey(&handler, id, key, &output));
+  EXPECT_TRUE(output.has_preedit());
+  const composer::Table *table = handler.table_manager_->GetTable(
+      *handler.request_, *handler.config_, minimal_data);
+
+  loader->StartLoading();
+  while (!loader->IsReady()) {
+    Util::Sleep(10);
+  }
+
+  // The pending "k" is completed with the table of the minimal engine.
+  key.set_key_code('a');
+  EXPECT_TRUE(SendKey(&handler, id, key, &output));
+  EXPECT_TRUE(output.has_preedit());
+  ASSERT_EQ(1, handler.retired_engines_.size());
+  ASSERT_TRUE(handler.retired_engines_[0]->table_manager);
+  EXPECT_EQ(table, handler.retired_engines_[0]->table_manager->GetTable(
+      *handler.request_, *handler.config_, minimal_data));
+
+  key.Clear();
+  key.set_special_key(commands::KeyEvent::ENTER);
+  EXPECT_TRUE(SendKey(&handler, id, key, &output));
+  ASSERT_TRUE(output.has_result());
+  // "か"
+  EXPECT_EQ("\xE3\x81\x8B", output.result().value());
+
+  // The session is moved to the loaded engine once it is idle.
+  EXPECT_TRUE(IsGoodSession(&handler, id));
+  EXPECT_TRUE(handler.retired_engines_.empty());
+  key.Clear();
+  key.set_key_code('a');
+  EXPECT_TRUE(SendKey(&handler, id, key, &output));
+  EXPECT_TRUE(output.has_preedit());
+}
+
+// Tests that the clear requests served by the minimal engine are replayed on
+// the loaded engine.
+TEST_F(SessionHandlerTest, ClearUserDataWhileLoading) {
+  SessionHandler handler(std::unique_ptr<EngineInterface>(new MinimalEngine(
+      std::unique_ptr<const DataManagerInterface>(
+          new testing::MockDataManager))));
+  std::unique_ptr<EngineLoader> engine_loader(
+      new EngineLoader(&CreateUserDataMockEngineForLoader));
+  EngineLoader *loader = engine_loader.get();
+  handler.SetEngineLoader(std::move(engine_loader));
+
+  const commands::Input::CommandType kClearCommands[] = {
+    commands::Input::CLEAR_USER_HISTORY,
+    commands::Input::CLEAR_USER_PREDICTION,
+    commands::Input::CLEAR_USER_HISTORY,
+  };
+  for (const commands::Input::CommandType type : kClearCommands) {
+    commands::Command command;
+    command.mutable_input()->set_type(type);
+    EXPECT_TRUE(handler.EvalCommand(&command));
+  }
+  EXPECT_EQ(2, handler.pending_user_data_clears_.size());
+
+  loader->StartLoading();
+  while (!loader->IsReady()) {
+    Util::Sleep(10);
+  }
+  uint64 id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &id));
+  EXPECT_TRUE(handler.pending_user_data_clears_.empty());
+  ASSERT_NE(nullptr, g_loaded_user_data_manager);
+  EXPECT_EQ(1, g_loaded_user_data_manager->GetFunctionCallCount(
+      "ClearUserHistory"));
+  EXPECT_EQ(1, g_loaded_user_data_manager->GetFunctionCallCount(
+      "ClearUserPrediction"));
+  EXPECT_EQ(0, g_loaded_user_data_manager->GetFunctionCallCount(
+      "ClearUnusedUserPrediction"));
+}
+
+TEST_F(SessionHandlerTest, SendKeys) {
+  SessionHandler handler(CreateMockDataEngine());
+
+  uint64 id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &id));
+
+  commands::Command command;
+  commands::Input *input = command.mutable_input();
+  input->set_id(id);
+  input->set_type(commands::Input::SEND_KEYS);
+  input->add_keys()->set_special_key(commands::KeyEvent::ON);
+  input->add_keys()->set_key_code('a');
+  input->add_keys()->set_special_key(commands::KeyEvent::ENTER);
+  input->add_keys()->set_key_code('k');
+  input->add_output_key_indices(1);
+  input->add_touch_events()->set_source_id(1);
+  RecordingObserver observer;
+  handler.AddObserver(&observer);
+  ASSERT_TRUE(handler.EvalCommand(&command));
+
+  // Every key is observed once as a SEND_KEY command, with only the fields a
+  // key needs.
+  ASSERT_EQ(4, observer.commands().size());
+  for (int i = 0; i < 4; ++i) {
+    const commands::Input &key_input = observer.commands()[i].input();
+    EXPECT_EQ(commands::Input::SEND_KEY, key_input.type());
+    EXPECT_EQ(id, key_input.id());
+    EXPECT_EQ(0, key_input.keys_size());
+    EXPECT_EQ(0, key_input.output_key_indices_size());
+    EXPECT_EQ(0, key_input.touch_events_size());
+  }
+  EXPECT_EQ('k', observer.commands()[3].input().key().key_code());
+
+  // The output of the last key.
+  const commands::Output &output = command.output();
+  EXPECT_EQ(id, output.id());
+  EXPECT_TRUE(output.consumed());
+  EXPECT_FALSE(output.has_result());
+  EXPECT_TRUE(output.has_preedit());
+
+  // The requested output and the one with the result.
+  ASSERT_EQ(2, output.key_outputs_size());
+  EXPECT_EQ(1, output.key_outputs(0).index());
+  EXPECT_TRUE(output.key_outputs(0).output().has_preedit());
+  EXPECT_EQ(2, output.key_outputs(1).index());
+  EXPECT_TRUE(output.key_outputs(1).output().has_result());
+
+  // An empty sequence is an error.
+  command.Clear();
+  command.mutable_input()->set_id(id);
+  command.mutable_input()->set_type(commands::Input::SEND_KEYS);
+  EXPECT_FALSE(handler.EvalCommand(&command));
+}
+
+TEST_F(SessionHandlerTest, GetMemoryUsage) {
+  SessionHandler handler(CreateMockDataEngine());
+
+  uint64 id = 0;
+  ASSERT_TRUE(CreateSession(&handler, &id));
+  commands::KeyEvent key;
+  commands::Output output;
+  key.set_special_key(commands::KeyEvent::ON);
+  ASSERT_TRUE(SendKey(&handler, id, key, &output));
+  key.Clear();
+  key.set_key_code('a');
+  ASSERT_TRUE(SendKey(&handler, id, key, &output));
+
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::GET_MEMORY_USAGE);
+  ASSERT_TRUE(handler.EvalCommand(&command));
+  ASSERT_TRUE(command.output().has_memory_usage());
+  const commands::MemoryUsage &usage = command.output().memory_usage();
+
+  uint64 total_bytes = 0;
+  uint64 connector_bytes = 0;
+  uint64 segments_bytes = 0;
+  for (const commands::MemoryUsage::Entry &entry : usage.entries()) {
+    total_bytes += entry.bytes();
+    if (entry.name() == "engine/connector") {
+      connector_bytes = entry.bytes();
+    } else if (entry.name() == "sessions/segments") {
+      segments_bytes = entry.bytes();
+    }
+  }
+  EXPECT_EQ(total_bytes, usage.total_bytes());
+  EXPECT_LT(0, connector_bytes);
+  // The suggestion for "a" fills the segments.
+  EXPECT_LT(0, segments_bytes);
+}
+
+TEST_F(SessionHandlerTest, DeltaOutput) {
+  SessionHandler handler(CreateMockDataEngine());
+
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::CREATE_SESSION);
+  command.mutable_input()->mutable_capability()->set_delta_output(true);
+  ASSERT_TRUE(handler.EvalCommand(&command));
+  const uint64 id = command.output().id();
+  EXPECT_EQ(1, handler.delta_output_bases_.count(id));
+
+  // The first output is complete.
+  command.Clear();
+  command.mutable_input()->set_id(id);
+  command.mutable_input()->set_type(commands::Input::SEND_COMMAND);
+  command.mutable_input()->mutable_command()->set_type(
+      commands::SessionCommand::GET_STATUS);
+  ASSERT_TRUE(handler.EvalCommand(&command));
+  EXPECT_TRUE(command.output().has_status());
+  EXPECT_EQ(1, command.output().delta().sequence());
+  EXPECT_FALSE(command.output().delta().has_base_sequence());
+
+  // The unchanged status is omitted.
+  command.clear_output();
+  command.mutable_input()->set_output_base_sequence(1);
+  ASSERT_TRUE(handler.EvalCommand(&command));
+  EXPECT_FALSE(command.output().has_status());
+  EXPECT_TRUE(command.output().delta().same_status());
+  EXPECT_EQ(2, command.output().delta().sequence());
+  EXPECT_EQ(1, command.output().delta().base_sequence());
+
+  // The client missed the last output.
+  command.clear_output();
+  ASSERT_TRUE(handler.EvalCommand(&command));
+  EXPECT_TRUE(command.output().has_status());
+  EXPECT_EQ(3, command.output().delta().sequence());
+  EXPECT_FALSE(command.output().delta().has_base_sequence());
+
+  EXPECT_TRUE(DeleteSession(&handler, id));
+  EXPECT_TRUE(handler.delta_output_bases_.empty());
+
+  // The outputs are not encoded without the capability.
+  uint64 legacy_id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &legacy_id));
+  command.Clear();
+  command.mutable_input()->set_id(legacy_id);
+  command.mutable_input()->set_type(commands::Input::SEND_COMMAND);
+  command.mutable_input()->mutable_command()->set_type(
+      commands::SessionCommand::GET_STATUS);
+  ASSERT_TRUE(handler.EvalCommand(&command));
+  EXPECT_FALSE(command.output().has_delta());
+}
+
 TEST_F(SessionHandlerTest, ShutdownTest) {
   SessionHandler handler(CreateMockDataEngine());
 
@@ -658,23 +1063,118 @@ TEST_F(SessionHandlerTest, EngineReload_SessionExists) {
   // Emulate the state where async data load is complete.
   engine_builder->set_state(MockEngineBuilder::State::RELOAD_READY);
 
-  // Another session is created.  Since the handler already holds one session
-  // (id1), engine reload should not happen.
+  // Another session is created.  The engine is reloaded even though the
+  // handler already holds one session (id1), which keeps the old engine.
+  const EngineInterface *old_engine = &handler.engine();
   uint64 id2 = 0;
   ASSERT_TRUE(CreateSession(&handler, &id2));
-  EXPECT_EQ(0, engine_builder->num_build_from_prepared_data_called());
-  EXPECT_EQ(0, engine_builder->num_clear_called());
-
-  // All the sessions were deleted.
+  EXPECT_EQ(1, engine_builder->num_build_from_prepared_data_called());
+  EXPECT_EQ(1, engine_builder->num_clear_called());
+  EXPECT_NE(old_engine, &handler.engine());
+  ASSERT_EQ(1, handler.retired_engines_.size());
+  EXPECT_EQ(old_engine, handler.retired_engines_[0]->engine.get());
+  EXPECT_EQ(1, handler.retired_engines_[0]->num_sessions);
+  EXPECT_EQ(1, handler.retired_engine_sessions_.count(id1));
+  EXPECT_EQ(0, handler.retired_engine_sessions_.count(id2));
+
+  // The old engine is released when its last session is deleted.
   ASSERT_TRUE(DeleteSession(&handler, id1));
-  ASSERT_TRUE(DeleteSession(&handler, id2));
+  EXPECT_TRUE(IsGoodSession(&handler, id2));
+  EXPECT_TRUE(handler.retired_engines_.empty());
+}
 
-  // A new session is created.  Since the handler holds no session, engine is
-  // reloaded at this timing.
+// Tests that each engine generation is kept while its sessions use it.
+TEST_F(SessionHandlerTest, EngineGenerations) {
+  SessionHandler handler(CreateMockDataEngine());
+  const EngineInterface *engine1 = &handler.engine();
+
+  // Starts composition so that the session keeps its engine.
+  auto start_composition = [&handler](uint64 id) {
+    commands::KeyEvent key;
+    commands::Output output;
+    key.set_special_key(commands::KeyEvent::ON);
+    EXPECT_TRUE(SendKey(&handler, id, key, &output));
+    key.Clear();
+    key.set_key_code('a');
+    EXPECT_TRUE(SendKey(&handler, id, key, &output));
+    EXPECT_TRUE(output.has_preedit());
+  };
+
+  uint64 id1 = 0;
+  ASSERT_TRUE(CreateSession(&handler, &id1));
+  start_composition(id1);
+
+  handler.InstallEngine(CreateMockDataEngine());
+  const EngineInterface *engine2 = &handler.engine();
+  uint64 id2 = 0;
+  ASSERT_TRUE(CreateSession(&handler, &id2));
+  start_composition(id2);
+
+  handler.InstallEngine(CreateMockDataEngine());
   uint64 id3 = 0;
   ASSERT_TRUE(CreateSession(&handler, &id3));
-  EXPECT_EQ(1, engine_builder->num_build_from_prepared_data_called());
-  EXPECT_EQ(1, engine_builder->num_clear_called());
+
+  // Each session in composition keeps the engine it was created with.
+  ASSERT_EQ(2, handler.retired_engines_.size());
+  EXPECT_EQ(engine1, handler.retired_engines_[0]->engine.get());
+  EXPECT_EQ(1, handler.retired_engines_[0]->num_sessions);
+  EXPECT_EQ(engine2, handler.retired_engines_[1]->engine.get());
+  EXPECT_EQ(1, handler.retired_engines_[1]->num_sessions);
+  ASSERT_EQ(2, handler.retired_engine_sessions_.size());
+  EXPECT_EQ(handler.retired_engines_[0].get(),
+            handler.retired_engine_sessions_[id1]);
+  EXPECT_EQ(handler.retired_engines_[1].get(),
+            handler.retired_engine_sessions_[id2]);
+
+  // The newer generation is released first when its session gets idle.
+  commands::KeyEvent key;
+  commands::Output output;
+  key.set_special_key(commands::KeyEvent::ENTER);
+  EXPECT_TRUE(SendKey(&handler, id2, key, &output));
+  EXPECT_TRUE(output.has_result());
+  EXPECT_TRUE(IsGoodSession(&handler, id3));
+  ASSERT_EQ(1, handler.retired_engines_.size());
+  EXPECT_EQ(engine1, handler.retired_engines_[0]->engine.get());
+
+  // The oldest generation is released when its session ends.
+  ASSERT_TRUE(DeleteSession(&handler, id1));
+  EXPECT_TRUE(IsGoodSession(&handler, id3));
+  EXPECT_TRUE(handler.retired_engines_.empty());
+  EXPECT_TRUE(handler.retired_engine_sessions_.empty());
+}
+
+// Tests that the retired engine saves its user data off the request path
+// when it is released, and the new engine reloads the data afterwards.
+TEST_F(SessionHandlerTest, InstallEngineHandsOverUserData) {
+  int old_retire_count = 0;
+  std::unique_ptr<MockConverterEngine> old_engine(new MockConverterEngine());
+  old_engine->SetUserDataManager(
+      new RetireCountingUserDataManager(&old_retire_count));
+  SessionHandler handler(std::move(old_engine));
+  uint64 id = 0;
+  ASSERT_TRUE(CreateSession(&handler, &id));
+
+  std::unique_ptr<MockConverterEngine> new_engine(new MockConverterEngine());
+  UserDataManagerMock *new_user_data = new UserDataManagerMock();
+  new_engine->SetUserDataManager(new_user_data);
+  handler.InstallEngine(std::move(new_engine));
+
+  // Nothing is handed over while the session can still learn.
+  handler.MaybeSwitchEngine();
+  EXPECT_EQ(0, old_retire_count);
+  EXPECT_EQ(0, new_user_data->GetFunctionCallCount("Reload"));
+
+  ASSERT_TRUE(DeleteSession(&handler, id));
+  for (int i = 0; i < 500 && (!handler.retired_engines_.empty() ||
+                              !handler.engine_deleters_.empty()); ++i) {
+    handler.MaybeSwitchEngine();
+    Util::Sleep(10);
+  }
+  ASSERT_TRUE(handler.retired_engines_.empty());
+  ASSERT_TRUE(handler.engine_deleters_.empty());
+  EXPECT_EQ(1, old_retire_count);
+  EXPECT_EQ(0, new_user_data->GetFunctionCallCount("Retire"));
+  EXPECT_EQ(1, new_user_data->GetFunctionCallCount("Reload"));
 }
 
 }  // namespace mozc
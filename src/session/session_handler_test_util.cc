@@ -54,6 +54,7 @@ DECLARE_int32(create_session_min_interval);
 DECLARE_int32(watch_dog_interval);
 DECLARE_int32(last_command_timeout);
 DECLARE_int32(last_create_session_timeout);
+DECLARE_int32(session_hibernation_timeout);
 DECLARE_bool(restricted);
 
 namespace mozc {
@@ -118,6 +119,7 @@ void SessionHandlerTestBase::SetUp() {
   flags_watch_dog_interval_backup_ = FLAGS_watch_dog_interval;
   flags_last_command_timeout_backup_ = FLAGS_last_command_timeout;
   flags_last_create_session_timeout_backup_ = FLAGS_last_create_session_timeout;
+  flags_session_hibernation_timeout_backup_ = FLAGS_session_hibernation_timeout;
   flags_restricted_backup_ = FLAGS_restricted;
 
   user_profile_directory_backup_ = SystemUtil::GetUserProfileDirectory();
@@ -136,6 +138,7 @@ void SessionHandlerTestBase::TearDown() {
   FLAGS_watch_dog_interval = flags_watch_dog_interval_backup_;
   FLAGS_last_command_timeout = flags_last_command_timeout_backup_;
   FLAGS_last_create_session_timeout = flags_last_create_session_timeout_backup_;
+  FLAGS_session_hibernation_timeout = flags_session_hibernation_timeout_backup_;
   FLAGS_restricted = flags_restricted_backup_;
 }
 
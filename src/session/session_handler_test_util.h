@@ -92,6 +92,7 @@ class SessionHandlerTestBase : public ::testing::Test {
   int32 flags_watch_dog_interval_backup_;
   int32 flags_last_command_timeout_backup_;
   int32 flags_last_create_session_timeout_backup_;
+  int32 flags_session_hibernation_timeout_backup_;
   bool flags_restricted_backup_;
   usage_stats::scoped_usage_stats_enabler usage_stats_enabler_;
 
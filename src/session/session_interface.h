@@ -36,6 +36,8 @@
 
 namespace mozc {
 
+class MemoryUsage;
+
 namespace commands {
 class ApplicationInfo;
 class Capability;
@@ -47,6 +49,10 @@ namespace composer {
 class Table;
 }  // namespace composer
 
+namespace protocol {
+class HibernatedSession;
+}  // namespace protocol
+
 namespace session {
 class SessionInterface {
  public:
@@ -84,6 +90,21 @@ class SessionInterface {
 
   // return 0 (default value) if no command is executed in this session.
   virtual uint64 last_command_time() const = 0;
+
+  // Save the state of an idle session to |state|.  Return false if the
+  // session has something in progress and cannot be hibernated.
+  // Currently, this is especial for session::Session.
+  virtual bool Hibernate(protocol::HibernatedSession *state) const {
+    return false;
+  }
+
+  // Restore the state saved by Hibernate().
+  virtual bool Restore(const protocol::HibernatedSession &state) {
+    return false;
+  }
+
+  // Report the heap memory held by the conversion state to |usage|.
+  virtual void CollectMemoryUsage(MemoryUsage *usage) const {}
 };
 
 }  // namespace session
@@ -33,11 +33,14 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
+#include "base/flags.h"
 #include "base/logging.h"
 #include "base/port.h"
 #include "base/scheduler.h"
 #include "engine/engine_factory.h"
+#include "engine/engine_loader.h"
 #include "ipc/ipc.h"
 #include "ipc/named_event.h"
 #include "protocol/commands.pb.h"
@@ -45,6 +48,10 @@
 #include "session/session_usage_observer.h"
 #include "usage_stats/usage_stats_uploader.h"
 
+DEFINE_bool(load_engine_in_background, true,
+            "Serve the sessions with a minimal engine while the engine is "
+            "loaded in background");
+
 namespace {
 
 #ifdef OS_WIN
@@ -60,15 +67,37 @@ const int kTimeOut = 5000;  // 5000msec
 const char kSessionName[] = "session";
 const char kEventName[] = "session";
 
+mozc::EngineInterface *CreateEngine() {
+  return mozc::EngineFactory::Create();
+}
+
+// Creates the handler.  If --load_engine_in_background is set, the handler
+// starts with MinimalEngine so that the server can accept the first key
+// events before the dictionaries are loaded.
+mozc::SessionHandler *CreateSessionHandler() {
+  if (!FLAGS_load_engine_in_background) {
+    return new mozc::SessionHandler(
+        std::unique_ptr<mozc::EngineInterface>(CreateEngine()));
+  }
+  std::unique_ptr<mozc::EngineLoader> engine_loader(
+      new mozc::EngineLoader(&CreateEngine));
+  engine_loader->StartLoading();
+  mozc::SessionHandler *handler = new mozc::SessionHandler(
+      std::unique_ptr<mozc::EngineInterface>(
+          mozc::EngineFactory::CreateMinimal()));
+  handler->SetEngineLoader(std::move(engine_loader));
+  return handler;
+}
+
 }  // namespace
 
 namespace mozc {
 
 SessionServer::SessionServer()
     : IPCServer(kSessionName, kNumConnections, kTimeOut),
+      command_(new commands::Command),
       usage_observer_(new session::SessionUsageObserver()),
-      session_handler_(new SessionHandler(
-      std::unique_ptr<Engine>(EngineFactory::Create()))) {
+      session_handler_(CreateSessionHandler()) {
   using usage_stats::UsageStatsUploader;
   // start session watch dog timer
   session_handler_->StartWatchDog();
@@ -104,44 +133,47 @@ bool SessionServer::Process(const char *request,
                             size_t request_size,
                             char *response,
                             size_t *response_size) {
+  string output;
+  const bool result = ProcessRequest(request, request_size, &output);
+  if (*response_size < output.size()) {
+    LOG(WARNING) << "response size < output.size";
+    *response_size = 0;
+    return result;
+  }
+  ::memcpy(response, output.data(), output.size());
+  *response_size = output.size();
+  return result;
+}
+
+bool SessionServer::ProcessRequest(const char *request,
+                                   size_t request_size,
+                                   string *response) {
+  response->clear();
   if (!session_handler_) {
     LOG(WARNING) << "handler is not available";
     return false;   // shutdown the server if handler doesn't exist
   }
 
-  commands::Command command;   // can define as a private member?
-  if (!command.mutable_input()->ParseFromArray(request, request_size)) {
+  command_->Clear();
+  if (!command_->mutable_input()->ParseFromArray(request, request_size)) {
     LOG(WARNING) << "Invalid request";
-    *response_size = 0;
     return true;
   }
 
-  if (!session_handler_->EvalCommand(&command)) {
+  if (!session_handler_->EvalCommand(command_.get())) {
     LOG(WARNING) << "EvalCommand() returned false. Exiting the loop.";
-    *response_size = 0;
     return false;
   }
 
-  string output;
-  if (!command.output().SerializeToString(&output)) {
+  // Serializes the output directly into the reused buffer.
+  if (!command_->output().SerializeToString(response)) {
     LOG(WARNING) << "SerializeToString() failed";
-    *response_size = 0;
-    return true;
-  }
-
-  // TODO(taku) automatically increase the buffer.
-  // Needs to fix IPCServer as well
-  if (*response_size < output.size()) {
-    LOG(WARNING) << "response size < output.size";
-    *response_size = 0;
+    response->clear();
     return true;
   }
 
-  ::memcpy(response, output.data(), output.size());
-  *response_size = output.size();
-
   // debug message
-  VLOG(2) << command.DebugString();
+  VLOG(2) << command_->DebugString();
 
   return true;
 }
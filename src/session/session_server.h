@@ -41,6 +41,10 @@ namespace mozc {
 class EngineInterface;
 class SessionHandlerInterface;
 
+namespace commands {
+class Command;
+}  // namespace commands
+
 namespace session {
 class SessionUsageObserver;
 }  // namespace session
@@ -67,7 +71,13 @@ class SessionServer: public IPCServer {
                char *response,
                size_t *response_size) override;
 
+  bool ProcessRequest(const char *request,
+                      size_t request_size,
+                      string *response) override;
+
  private:
+  // Reused across requests to keep the allocated messages.
+  std::unique_ptr<commands::Command> command_;
   std::unique_ptr<session::SessionUsageObserver> usage_observer_;
   std::unique_ptr<SessionHandlerInterface> session_handler_;
 
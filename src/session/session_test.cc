@@ -48,6 +48,7 @@
 #include "protocol/candidates.pb.h"
 #include "protocol/commands.pb.h"
 #include "protocol/config.pb.h"
+#include "protocol/state.pb.h"
 #include "request/conversion_request.h"
 #include "rewriter/transliteration_rewriter.h"
 #include "session/internal/ime_context.h"
@@ -6517,6 +6518,36 @@ TEST_F(SessionTest, InputModeConsumed) {
   EXPECT_EQ(mozc::commands::HALF_ASCII, command.output().mode());
 }
 
+TEST_F(SessionTest, HibernateAndRestore) {
+  std::unique_ptr<Session> session(new Session(engine_.get()));
+  InitSessionToPrecomposition(session.get());
+  commands::Command command;
+  EXPECT_TRUE(session->InputModeFullKatakana(&command));
+  commands::ApplicationInfo application_info;
+  application_info.set_process_id(1234);
+  session->set_application_info(application_info);
+
+  protocol::HibernatedSession state;
+  EXPECT_TRUE(session->Hibernate(&state));
+  EXPECT_TRUE(state.activated());
+  EXPECT_EQ(commands::FULL_KATAKANA, state.mode());
+
+  std::unique_ptr<Session> restored(new Session(engine_.get()));
+  EXPECT_TRUE(restored->Restore(state));
+  EXPECT_EQ(session->create_session_time(), restored->create_session_time());
+  EXPECT_EQ(1234, restored->application_info().process_id());
+
+  command.Clear();
+  EXPECT_TRUE(restored->GetStatus(&command));
+  EXPECT_TRUE(command.output().status().activated());
+  EXPECT_EQ(commands::FULL_KATAKANA, command.output().status().mode());
+
+  // A session in composition cannot be hibernated.
+  command.Clear();
+  SendKey("a", restored.get(), &command);
+  EXPECT_FALSE(restored->Hibernate(&state));
+}
+
 TEST_F(SessionTest, InputModeConsumedForTestSendKey) {
   // This test is only for Windows, because InputModeHiragana bound
   // with Hiragana key is only supported on Windows yet.
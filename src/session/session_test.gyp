@@ -116,6 +116,8 @@
       'dependencies': [
         '../base/base_test.gyp:clock_mock',
         '../converter/converter_base.gyp:converter_mock',
+        '../engine/engine.gyp:engine_loader',
+        '../engine/engine.gyp:minimal_engine',
         '../engine/engine.gyp:mock_converter_engine',
         '../testing/testing.gyp:gtest_main',
         '../usage_stats/usage_stats_test.gyp:usage_stats_testing_util',
@@ -259,6 +261,20 @@
         'test_size': 'large',
       },
     },
+    {
+      'target_name': 'latency_cliff_search_test',
+      'type': 'executable',
+      'sources': [
+        'latency_cliff_search_test.cc',
+      ],
+      'dependencies': [
+        '../testing/testing.gyp:gtest_main',
+        'session.gyp:latency_cliff_search',
+      ],
+      'variables': {
+        'test_size': 'small',
+      },
+    },
     {
       'target_name': 'random_keyevents_generator_test',
       'type': 'executable',
@@ -349,6 +365,7 @@
       'type': 'none',
       'dependencies': [
         'generic_storage_manager_test',
+        'latency_cliff_search_test',
         'random_keyevents_generator_test',
         'request_test_util_test',
         'session_converter_stress_test',
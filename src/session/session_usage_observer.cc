@@ -103,6 +103,7 @@ bool IsSessionIndependentCommand(commands::Input::CommandType type) {
     case commands::Input::READ_ALL_FROM_STORAGE:
     case commands::Input::RELOAD:
     case commands::Input::SEND_USER_DICTIONARY_COMMAND:
+    case commands::Input::GET_MEMORY_USAGE:
       return true;
     default:
       return false;
@@ -46,6 +46,16 @@ inline uint64 RotateLeft64(uint64 original, int num_bits) {
   return (original << (64 - num_bits)) | (original >> num_bits);
 }
 
+inline void PrefetchForRead(const void *addr) {
+#if defined(__GNUC__)
+  __builtin_prefetch(addr, 0 /* read */, 1 /* low temporal locality */);
+#endif  // __GNUC__
+}
+
+// The number of hashes whose bitmap words are prefetched ahead in
+// ExistsBatch().
+const size_t kPrefetchDistance = 8;
+
 inline uint32 BitsToWords(uint32 bits) {
   uint32 words = (bits + 31) >> 5;
   if (bits > 0 && words == 0) {
@@ -63,6 +73,7 @@ class ExistenceFilter::BlockBitmap {
   void Clear();
   bool Get(uint32 index) const;
   void Set(uint32 index);
+  void Prefetch(uint32 index) const;
 
   // REQUIRES: "iter" is zero, or was set by a preceding call
   // to GetMutableFragment().
@@ -214,6 +225,12 @@ inline bool ExistenceFilter::BlockBitmap::Get(uint32 index) const {
   return (block_[bindex][windex] >> bitpos) & 1;
 }
 
+inline void ExistenceFilter::BlockBitmap::Prefetch(uint32 index) const {
+  const uint32 bindex = index >> kBlockShift;
+  const uint32 windex = (index & kBlockMask) >> 5;
+  PrefetchForRead(&block_[bindex][windex]);
+}
+
 inline void ExistenceFilter::BlockBitmap::Set(uint32 index) {
   const uint32 bindex = index >> kBlockShift;
   const uint32 windex = (index & kBlockMask) >> 5;
@@ -247,6 +264,25 @@ bool ExistenceFilter::Exists(uint64 hash) const {
   return true;
 }
 
+void ExistenceFilter::ExistsBatch(const uint64 *hashes, size_t size,
+                                  bool *results) const {
+  // Prefetches the words for all the hash functions of the hashes
+  // |kPrefetchDistance| ahead of the one being tested.
+  for (size_t i = 0; i < size + kPrefetchDistance; ++i) {
+    if (i < size) {
+      uint64 hash = hashes[i];
+      for (size_t j = 0; j < num_hashes_; ++j) {
+        hash = RotateLeft64(hash, 8);
+        rep_->Prefetch(hash % vec_size_);
+      }
+    }
+    if (i >= kPrefetchDistance) {
+      const size_t target = i - kPrefetchDistance;
+      results[target] = Exists(hashes[target]);
+    }
+  }
+}
+
 void ExistenceFilter::Insert(uint64 hash) {
   for (size_t i = 0; i < num_hashes_; ++i) {
     hash = RotateLeft64(hash, 8);
@@ -66,6 +66,11 @@ class ExistenceFilter {
   // It may return some false positives
   bool Exists(uint64 hash) const;
 
+  // Checks |size| hashes at once and stores Exists(hashes[i]) to results[i].
+  // The bitmap words for the hashes are prefetched before they are tested, so
+  // that the cache misses of independent lookups overlap.
+  void ExistsBatch(const uint64 *hashes, size_t size, bool *results) const;
+
   // Returns the size (in bytes) of the bloom filter
   size_t Size() const;
 
@@ -164,5 +164,33 @@ TEST(ExistenceFilterTest, InsertAndExistsTest) {
   }
 }
 
+TEST(ExistenceFilterTest, ExistsBatchTest) {
+  const int kNumWords = 100;
+  static const float kErrorRate = 0.0001;
+  int num_bytes =
+      ExistenceFilter::MinFilterSizeInBytesForErrorRate(kErrorRate, kNumWords);
+
+  std::unique_ptr<ExistenceFilter> filter(
+      ExistenceFilter::CreateOptimal(num_bytes, kNumWords));
+  for (int i = 0; i < kNumWords; ++i) {
+    filter->Insert(Hash::Fingerprint(i * 2));
+  }
+
+  // Batches shorter and longer than the prefetch distance.
+  for (size_t size = 0; size <= 2 * kNumWords; size += 3) {
+    std::vector<uint64> hashes;
+    for (size_t i = 0; i < size; ++i) {
+      hashes.push_back(Hash::Fingerprint(static_cast<int>(i)));
+    }
+    std::unique_ptr<bool[]> results(new bool[size + 1]);
+    results[size] = false;
+    filter->ExistsBatch(hashes.data(), size, results.get());
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(filter->Exists(hashes[i]), results[i]) << i;
+    }
+    EXPECT_FALSE(results[size]);
+  }
+}
+
 }  // namespace storage
 }  // namespace mozc
@@ -51,6 +51,9 @@ class BitVectorBasedArray {
   // Note: the result may contain '\0' chars, or may NOT be '\0'-terminated.
   const char *Get(size_t index, size_t *length) const;
 
+  // Returns the bytes allocated for the index.
+  size_t GetAllocatedBytes() const { return index_.GetAllocatedBytes(); }
+
  private:
   SimpleSuccinctBitVectorIndex index_;
   size_t base_length_;
@@ -169,6 +169,14 @@ class Louds {
     return index_.Get(node.edge_index_) != 0;
   }
 
+  // Returns the bytes allocated for the index and the select caches.
+  size_t GetAllocatedBytes() const {
+    return index_.GetAllocatedBytes() +
+           (select_cache_ ? (select0_cache_size_ + select1_cache_size_) *
+                                sizeof(int)
+                          : 0);
+  }
+
  private:
   SimpleSuccinctBitVectorIndex index_;
   size_t select0_cache_size_;
@@ -29,6 +29,8 @@
 
 #include "storage/louds/louds_trie.h"
 
+#include <cstring>
+
 #include "base/logging.h"
 #include "base/port.h"
 #include "storage/louds/louds.h"
@@ -43,8 +45,23 @@ inline int32 ReadInt32(const uint8 *data) {
   // TODO(noriyukit): static assertion for the endian.
   return *reinterpret_cast<const int32*>(data);
 }
+
+// The flag in the field of the num bits for each character, indicating that
+// the image has the tail section.
+const int kTailFlag = 1 << 8;
+
+inline size_t Align32(size_t size) {
+  return (size + 3) & ~static_cast<size_t>(3);
+}
 }  // namespace
 
+LoudsTrie::LoudsTrie()
+    : edge_character_(nullptr), tail_id_array_(nullptr), tail_id_bits_(0) {
+}
+
+LoudsTrie::~LoudsTrie() {
+}
+
 bool LoudsTrie::Open(const uint8 *image,
                      size_t louds_lb0_cache_size,
                      size_t louds_lb1_cache_size,
@@ -56,12 +73,24 @@ bool LoudsTrie::Open(const uint8 *image,
   // [trie size: little endian 4byte int]
   // [terminal size: little endian 4byte int]
   // [num bits for each character annotated to an edge:
-  //  little endian 4 byte int. Currently, this class supports only 8-bits]
+  //  little endian 4 byte int. Currently, this class supports only 8-bits.
+  //  kTailFlag is added if the tail section follows]
   // [edge character image size: little endian 4 byte int]
   // [trie image: "trie size" bytes]
   // [terminal image: "terminal size" bytes]
   // [edge character image: "edge character image size" bytes]
   //
+  // The tail section is as follows:
+  // [padding to 4 byte boundary]
+  // [tail bit vector size: little endian 4 byte int]
+  // [tail id array size: little endian 4 byte int]
+  // [num bits for each tail id: little endian 4 byte int]
+  // [tail trie size: little endian 4 byte int]
+  // [tail bit vector image: "tail bit vector size" bytes]
+  // [tail id array image: "tail id array size" bytes]
+  // [tail trie image: "tail trie size" bytes, in the format above
+  //  without the tail section]
+  //
   // Here, "terminal" means "the node is one of the end of a word."
   // For example, if we have a trie for "aa" and "aaa", the trie looks like:
   //         [0]
@@ -75,7 +104,8 @@ bool LoudsTrie::Open(const uint8 *image,
   // neither "" nor "a"), and [2] and [3] are terminal.
   const int louds_size = ReadInt32(image);
   const int terminal_size = ReadInt32(image + 4);
-  const int num_character_bits = ReadInt32(image + 8);
+  const int num_character_bits = ReadInt32(image + 8) & ~kTailFlag;
+  const bool has_tail = (ReadInt32(image + 8) & kTailFlag) != 0;
   const int edge_character_size = ReadInt32(image + 12);
   CHECK_EQ(num_character_bits, 8);
   CHECK_GT(edge_character_size, 0);
@@ -92,6 +122,29 @@ bool LoudsTrie::Open(const uint8 *image,
                             termvec_lb1_cache_size);
   edge_character_ = reinterpret_cast<const char*>(edge_character);
 
+  if (has_tail) {
+    const uint8 *tail_section =
+        edge_character + Align32(edge_character_size);
+    const int tail_bit_vector_size = ReadInt32(tail_section);
+    const int tail_id_array_size = ReadInt32(tail_section + 4);
+    tail_id_bits_ = ReadInt32(tail_section + 8);
+    CHECK_GT(tail_id_bits_, 0);
+    CHECK_LE(tail_id_bits_, 32);
+
+    const uint8 *tail_bit_vector_image = tail_section + 16;
+    tail_id_array_ = tail_bit_vector_image + tail_bit_vector_size;
+    const uint8 *tail_trie_image = tail_id_array_ + tail_id_array_size;
+    tail_bit_vector_.Init(tail_bit_vector_image, tail_bit_vector_size,
+                          0,  // Select0 is not carried out.
+                          termvec_lb1_cache_size);
+    tail_trie_.reset(new LoudsTrie);
+    // Tails are restored upward, so the cache is given for that direction.
+    if (!tail_trie_->Open(tail_trie_image, 0, louds_lb1_cache_size, 0,
+                          louds_select1_cache_size, termvec_lb1_cache_size)) {
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -99,6 +152,50 @@ void LoudsTrie::Close() {
   louds_.Reset();
   terminal_bit_vector_.Reset();
   edge_character_ = nullptr;
+  tail_bit_vector_.Reset();
+  tail_id_array_ = nullptr;
+  tail_id_bits_ = 0;
+  tail_trie_.reset();
+}
+
+size_t LoudsTrie::GetAllocatedBytes() const {
+  size_t bytes = louds_.GetAllocatedBytes() +
+                 terminal_bit_vector_.GetAllocatedBytes() +
+                 tail_bit_vector_.GetAllocatedBytes();
+  if (tail_trie_) {
+    bytes += sizeof(*tail_trie_) + tail_trie_->GetAllocatedBytes();
+  }
+  return bytes;
+}
+
+void LoudsTrie::GetTerminalNodeFromKeyId(int key_id, Node *node) const {
+  const int node_id = terminal_bit_vector_.Select1(key_id + 1) + 1;
+  louds_.InitNodeFromNodeId(node_id, &node->node_);
+  node->state_ = Node::kNotInTail;
+  if (!HasTail(node_id - 1)) {
+    return;
+  }
+  // Move to the last character of the tail, which is the child of the root
+  // in the tail trie.
+  MoveToFirstChild(node);
+  while (!IsEndOfTail(node->tail_node_)) {
+    tail_trie_->louds_.MoveToParent(&node->tail_node_);
+  }
+}
+
+int LoudsTrie::GetTailId(int index) const {
+  // Read |tail_id_bits_| bits from LSB to MSB.
+  const size_t offset = static_cast<size_t>(tail_bit_vector_.Rank1(index)) *
+                        tail_id_bits_;
+  uint64 value = 0;
+  const size_t begin = offset / 8;
+  const size_t end = (offset + tail_id_bits_ + 7) / 8;
+  for (size_t i = begin; i < end; ++i) {
+    value |= static_cast<uint64>(tail_id_array_[i]) << ((i - begin) * 8);
+  }
+  value >>= offset % 8;
+  const uint64 mask = (static_cast<uint64>(1) << tail_id_bits_) - 1;
+  return static_cast<int>(value & mask);
 }
 
 bool LoudsTrie::MoveToChildByLabel(char label, Node *node) const {
@@ -136,10 +233,32 @@ StringPiece LoudsTrie::RestoreKeyString(Node node, char *buf) const {
 
   // Climb up the trie to the root and fill |buf| backward.
   char *ptr = buf_end;
-  for (; !louds_.IsRoot(node); louds_.MoveToParent(&node)) {
-    *--ptr = GetEdgeLabelToParentNode(node);
+  for (Louds::Node n = node.node_; !louds_.IsRoot(n);
+       louds_.MoveToParent(&n)) {
+    *--ptr = edge_character_[n.node_id() - 1];
+  }
+  if (node.state_ != Node::kInTail) {
+    return StringPiece(ptr, buf_end - ptr);
+  }
+
+  // Append the tail up to |node|, which is read forward from the deepest
+  // node in the tail trie.
+  const size_t prefix_len = buf_end - ptr;
+  memmove(buf, ptr, prefix_len);
+  char *tail_ptr = buf + prefix_len;
+  Node tail;
+  tail.node_ = node.node_;
+  MoveToFirstChild(&tail);
+  for (;;) {
+    DCHECK_LT(tail_ptr, buf_end);
+    *tail_ptr++ = GetEdgeLabelToParentNode(tail);
+    if (tail.tail_node_ == node.tail_node_) {
+      break;
+    }
+    MoveToFirstChild(&tail);
   }
-  return StringPiece(ptr, buf_end - ptr);
+  *tail_ptr = '\0';
+  return StringPiece(buf, tail_ptr - buf);
 }
 
 }  // namespace louds
@@ -46,11 +46,36 @@ class LoudsTrie {
   // The max depth of the trie.
   static const size_t kMaxDepth = 256;
 
-  // This class stores a traversal state.
-  typedef Louds::Node Node;
+  // This class stores a traversal state.  When the trie is built with tail
+  // compression (see LoudsTrieBuilder), a node may also point to a character
+  // in a tail, which is restored from the tail trie.  Such a node behaves as
+  // an ordinary node having one child (or none at the end of the tail).
+  class Node {
+   public:
+    // Default instance represents the root node.
+    Node() : state_(kNotInTail) {}
+
+    friend bool operator==(const Node &x, const Node &y) {
+      return x.state_ == y.state_ && x.node_ == y.node_ &&
+             (x.state_ != kInTail || x.tail_node_ == y.tail_node_);
+    }
+
+   private:
+    enum State {
+      kNotInTail,
+      kInTail,
+      kInvalid,
+    };
+
+    Louds::Node node_;       // Location in the main LOUDS.
+    Louds::Node tail_node_;  // Location in the tail trie if kInTail.
+    State state_;
 
-  LoudsTrie() : edge_character_(nullptr) {}
-  ~LoudsTrie() {}
+    friend class LoudsTrie;
+  };
+
+  LoudsTrie();
+  ~LoudsTrie();
 
   // Opens the binary image and constructs the data structure.  The first four
   // cache sizes are passed to the underlying LOUDS.  See louds.h for more
@@ -73,35 +98,46 @@ class LoudsTrie {
   // clean up too).
   void Close();
 
+  // Returns the bytes allocated for the indices and caches of this trie.
+  // The image itself is not included.
+  size_t GetAllocatedBytes() const;
+
   // Generic APIs for tree traversal, some of which are delegated from Louds
   // class; see louds.h.
 
   // Returns true if |node| is in a valid state (returns true both for terminal
   // and non-terminal nodes).
-  bool IsValidNode(const Node &node) const { return louds_.IsValidNode(node); }
+  bool IsValidNode(const Node &node) const {
+    return node.state_ == Node::kNotInTail ? louds_.IsValidNode(node.node_)
+                                           : node.state_ == Node::kInTail;
+  }
 
   // Returns true if |node| is a terminal node.
   bool IsTerminalNode(const Node &node) const {
-    return terminal_bit_vector_.Get(node.node_id() - 1) != 0;
+    if (node.state_ == Node::kInTail) {
+      return IsEndOfTail(node.tail_node_);
+    }
+    const int index = node.node_.node_id() - 1;
+    return terminal_bit_vector_.Get(index) != 0 && !HasTail(index);
   }
 
   // Returns the label of the edge from |node|'s parent (predecessor) to |node|.
   char GetEdgeLabelToParentNode(const Node &node) const {
-    return edge_character_[node.node_id() - 1];
+    if (node.state_ == Node::kInTail) {
+      return tail_trie_->edge_character_[node.tail_node_.node_id() - 1];
+    }
+    return edge_character_[node.node_.node_id() - 1];
   }
 
   // Computes the ID of key that reaches to |node|.
   // REQUIRES: |node| is a terminal node.
   int GetKeyIdOfTerminalNode(const Node &node) const {
-    return terminal_bit_vector_.Rank1(node.node_id() - 1);
+    return terminal_bit_vector_.Rank1(node.node_.node_id() - 1);
   }
 
   // Initializes a node corresponding to |key_id|.
   // REQUIRES: |key_id| is a valid ID.
-  void GetTerminalNodeFromKeyId(int key_id, Node *node) const {
-    const int node_id = terminal_bit_vector_.Select1(key_id + 1) + 1;
-    louds_.InitNodeFromNodeId(node_id, node);
-  }
+  void GetTerminalNodeFromKeyId(int key_id, Node *node) const;
 
   Node GetTerminalNodeFromKeyId(int key_id) const {
     Node node;
@@ -130,14 +166,37 @@ class LoudsTrie {
 
   // Methods for moving node exported from Louds class; see louds.h.
   void MoveToFirstChild(Node *node) const {
-    louds_.MoveToFirstChild(node);
+    if (node->state_ == Node::kNotInTail) {
+      const int index = node->node_.node_id() - 1;
+      if (!HasTail(index)) {
+        louds_.MoveToFirstChild(&node->node_);
+        return;
+      }
+      // Enter the tail.  The tail trie stores each tail in reverse order, so
+      // the first character of the tail is on the deepest node.
+      tail_trie_->louds_.InitNodeFromNodeId(
+          tail_trie_->terminal_bit_vector_.Select1(GetTailId(index) + 1) + 1,
+          &node->tail_node_);
+      node->state_ = Node::kInTail;
+      return;
+    }
+    if (IsEndOfTail(node->tail_node_)) {
+      node->state_ = Node::kInvalid;
+      return;
+    }
+    tail_trie_->louds_.MoveToParent(&node->tail_node_);
   }
   Node MoveToFirstChild(Node node) const {
     MoveToFirstChild(&node);
     return node;
   }
   static void MoveToNextSibling(Node *node) {
-    Louds::MoveToNextSibling(node);
+    if (node->state_ == Node::kNotInTail) {
+      Louds::MoveToNextSibling(&node->node_);
+      return;
+    }
+    // A character in a tail has no sibling.
+    node->state_ = Node::kInvalid;
   }
   static Node MoveToNextSibling(Node node) {
     MoveToNextSibling(&node);
@@ -195,6 +254,23 @@ class LoudsTrie {
   }
 
  private:
+  // Returns true if the node at |index| (i.e., node ID - 1) in the main LOUDS
+  // is followed by a tail.
+  bool HasTail(int index) const {
+    return tail_trie_ != nullptr && tail_bit_vector_.Get(index) != 0;
+  }
+
+  // Returns the key ID in the tail trie for the tail following the node at
+  // |index|.
+  // REQUIRES: HasTail(index).
+  int GetTailId(int index) const;
+
+  // Returns true if |tail_node| points to the last character of a tail.
+  bool IsEndOfTail(Louds::Node tail_node) const {
+    tail_trie_->louds_.MoveToParent(&tail_node);
+    return Louds::IsRoot(tail_node);
+  }
+
   Louds louds_;  // Tree structure representation by LOUDS.
 
   // Bit-vector to represent whether each node in LOUDS tree is terminal.
@@ -210,6 +286,17 @@ class LoudsTrie {
   // In other words, id=2 in louds_ corresponds to edge_character_[1].
   const char *edge_character_;
 
+  // Members for tail compression.  A node with the bit in |tail_bit_vector_|
+  // is a leaf whose key continues with the tail.  The tails are stored in
+  // reverse order as keys of |tail_trie_|, so that common suffixes of them
+  // are shared, and their IDs are packed in |tail_id_array_| by
+  // |tail_id_bits_| bits in the order of the leaves.  |tail_trie_| is null if
+  // the trie has no tail.
+  SimpleSuccinctBitVectorIndex tail_bit_vector_;
+  const uint8 *tail_id_array_;
+  int tail_id_bits_;
+  std::unique_ptr<LoudsTrie> tail_trie_;
+
   DISALLOW_COPY_AND_ASSIGN(LoudsTrie);
 };
 
@@ -30,6 +30,8 @@
 #include "storage/louds/louds_trie_builder.h"
 
 #include <algorithm>
+#include <deque>
+#include <utility>
 #include <vector>
 
 #include "base/logging.h"
@@ -40,13 +42,19 @@ namespace mozc {
 namespace storage {
 namespace louds {
 
-LoudsTrieBuilder::LoudsTrieBuilder() : built_(false) {
+LoudsTrieBuilder::LoudsTrieBuilder()
+    : built_(false), use_tail_compression_(false) {
 }
 
 void LoudsTrieBuilder::Add(const string &word) {
+  Add(word, 0);
+}
+
+void LoudsTrieBuilder::Add(const string &word, double weight) {
   CHECK(!built_);
   CHECK(!word.empty());
   word_list_.push_back(word);
+  weight_list_.push_back(weight);
 }
 
 namespace {
@@ -61,6 +69,9 @@ class Entry {
   const string &word() const { return *word_; }
   size_t original_index() const { return original_index_; }
 
+  // Replaces the word, e.g., to drop the tail which has already been output.
+  void set_word(const string &word) { word_ = &word; }
+
  private:
   const string *word_;
   size_t original_index_;
@@ -79,6 +90,70 @@ class EntryLengthLessThan {
   size_t length_;
 };
 
+// A range of words sharing the node, and the total weight of the words.
+struct Group {
+  std::vector<size_t>::const_iterator begin;
+  std::vector<size_t>::const_iterator end;
+  double weight;
+};
+
+bool GroupWeightGreaterThan(const Group &lhs, const Group &rhs) {
+  return lhs.weight > rhs.weight;
+}
+
+// Reorders the indices in [begin, end), which point to sorted |words|
+// sharing the first |depth| bytes, so that the children of the node are
+// placed in descending order of their weights. The word terminating at the
+// node, if any, is kept at the first, as Build requires.
+void SortByWeight(const std::vector<string> &words,
+                  const std::vector<double> &weights, size_t depth,
+                  std::vector<size_t>::iterator begin,
+                  std::vector<size_t>::iterator end) {
+  if (begin != end && words[*begin].length() == depth) {
+    ++begin;
+  }
+  if (end - begin <= 1) {
+    return;
+  }
+
+  std::vector<Group> groups;
+  for (std::vector<size_t>::const_iterator iter = begin; iter != end; ) {
+    Group group;
+    group.begin = iter;
+    group.weight = 0;
+    const char label = words[*iter][depth];
+    for (; iter != end && words[*iter][depth] == label; ++iter) {
+      group.weight += weights[*iter];
+    }
+    group.end = iter;
+    groups.push_back(group);
+  }
+
+  // Keep the label order among the siblings with the same weight.
+  std::stable_sort(groups.begin(), groups.end(), GroupWeightGreaterThan);
+  std::vector<size_t> sorted;
+  sorted.reserve(end - begin);
+  std::vector<size_t> group_sizes;
+  for (size_t i = 0; i < groups.size(); ++i) {
+    sorted.insert(sorted.end(), groups[i].begin, groups[i].end);
+    group_sizes.push_back(groups[i].end - groups[i].begin);
+  }
+  std::copy(sorted.begin(), sorted.end(), begin);
+
+  for (size_t i = 0; i < group_sizes.size(); ++i) {
+    SortByWeight(words, weights, depth + 1, begin, begin + group_sizes[i]);
+    begin += group_sizes[i];
+  }
+}
+
+// The minimum length of the tail to be moved to the tail trie. A shorter
+// tail doesn't pay for its ID.
+const size_t kMinTailLength = 2;
+
+// The flag in the field of the num bits for each character, indicating that
+// the image has the tail section. See louds_trie.cc for the format.
+const int kTailFlag = 1 << 8;
+
 void PushInt(size_t value, string* image) {
   // Make sure the value is fit in the 32-bit value.
   CHECK_EQ(value & ~0xFFFFFFFF, 0);
@@ -94,29 +169,59 @@ void PushInt(size_t value, string* image) {
 void LoudsTrieBuilder::Build() {
   CHECK(!built_);
 
-  // Initialize for the build. Sort and de-dup the words.
-  std::sort(word_list_.begin(), word_list_.end());
-  word_list_.erase(std::unique(word_list_.begin(), word_list_.end()),
-                   word_list_.end());
+  // Initialize for the build. Sort and de-dup the words, summing up the
+  // weights of the same words.
+  std::vector<std::pair<string, double> > weighted_words;
+  weighted_words.reserve(word_list_.size());
+  for (size_t i = 0; i < word_list_.size(); ++i) {
+    weighted_words.push_back(std::make_pair(word_list_[i], weight_list_[i]));
+  }
+  std::sort(weighted_words.begin(), weighted_words.end());
+  word_list_.clear();
+  weight_list_.clear();
+  for (size_t i = 0; i < weighted_words.size(); ++i) {
+    if (!word_list_.empty() && word_list_.back() == weighted_words[i].first) {
+      weight_list_.back() += weighted_words[i].second;
+      continue;
+    }
+    word_list_.push_back(weighted_words[i].first);
+    weight_list_.push_back(weighted_words[i].second);
+  }
+
+  // Lay out the words so that the heavier siblings come first. The words
+  // sharing a node are still contiguous, which the traversal below relies on.
+  std::vector<size_t> order(word_list_.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  SortByWeight(word_list_, weight_list_, 0, order.begin(), order.end());
+
   std::vector<Entry> entry_list;
   entry_list.reserve(word_list_.size());
-  for (size_t i = 0; i < word_list_.size(); ++i) {
-    entry_list.push_back(Entry(word_list_[i], i));
+  for (size_t i = 0; i < order.size(); ++i) {
+    entry_list.push_back(Entry(word_list_[order[i]], order[i]));
   }
   id_list_.resize(word_list_.size(), - 1);
 
   // Output the tree to streams.
   BitStream trie_stream;
   BitStream terminal_stream;
+  BitStream tail_stream;
   string edge_character;
 
+  // Tails removed from the trie, in the order of the nodes they follow.
+  std::vector<string> tails;
+  // Words without their tails, referred to by the entries.
+  std::deque<string> truncated_words;
+
   // Push root.
   trie_stream.PushBit(1);
   trie_stream.PushBit(0);
   edge_character.push_back('\0');
   terminal_stream.PushBit(0);
+  tail_stream.PushBit(0);
 
-  // Then, traverse the sorted word list.
+  // Then, traverse the ordered word list.
   // The basic concept to output the trie is simple:
   // - Iterate the depth beginning with 0.
   // - If the entry is the first one in the word list, the corresponding
@@ -155,6 +260,12 @@ void LoudsTrieBuilder::Build() {
   // depth, and skip "edge check" for the entries.
   // This doesn't break the edge check condition, and stop bit check condition,
   // but adds a chance to output stop bits for leaves.
+  //
+  // With tail compression, when a new node is shared by no other entry, the
+  // rest of the word is a chain of single child nodes. If it's long enough,
+  // the node is output as a terminal with the tail bit, the rest is moved to
+  // the tail list, and the entry is truncated at the node so that it's
+  // handled as a leaf from the next depth.
   int id = 0;
   for (size_t depth = 0; !entry_list.empty(); ++depth) {
     for (size_t i = 0; i < entry_list.size(); ++i) {
@@ -170,16 +281,31 @@ void LoudsTrieBuilder::Build() {
         trie_stream.PushBit(1);
         edge_character.push_back(entry_list[i].word()[depth]);
 
-        if (entry_list[i].word().length() == depth + 1) {
+        if (use_tail_compression_ &&
+            word.length() >= depth + 1 + kMinTailLength &&
+            (i == entry_list.size() - 1 ||
+             word.compare(0, depth + 1,
+                          entry_list[i + 1].word(), 0, depth + 1) != 0)) {
+          terminal_stream.PushBit(1);
+          tail_stream.PushBit(1);
+          id_list_[entry_list[i].original_index()] = id;
+          ++id;
+          tails.push_back(word.substr(depth + 1));
+          // Note that |word| still refers to the original word.
+          truncated_words.push_back(word.substr(0, depth + 1));
+          entry_list[i].set_word(truncated_words.back());
+        } else if (entry_list[i].word().length() == depth + 1) {
           // This is a terminal node.
           // Note that the terminal string should be at the first of
           // strings sharing the node. So the check above should work well.
           terminal_stream.PushBit(1);
+          tail_stream.PushBit(0);
           id_list_[entry_list[i].original_index()] = id;
           ++id;
         } else {
           // This is not a terminal node.
           terminal_stream.PushBit(0);
+          tail_stream.PushBit(0);
         }
       }
 
@@ -204,16 +330,56 @@ void LoudsTrieBuilder::Build() {
   PushInt(trie_stream.ByteSize(), &image_);
   PushInt(terminal_stream.ByteSize(), &image_);
   // The num bits of each character annoated to each edge.
-  PushInt(8, &image_);
+  PushInt(tails.empty() ? 8 : (8 | kTailFlag), &image_);
   PushInt(edge_character.size(), &image_);
 
   image_.append(trie_stream.image());
   image_.append(terminal_stream.image());
   image_.append(edge_character);
 
+  if (!tails.empty()) {
+    AppendTails(tails, &tail_stream);
+  }
+
   built_ = true;
 }
 
+void LoudsTrieBuilder::AppendTails(const std::vector<string> &tails,
+                                   BitStream *tail_stream) {
+  // Store the tails in reverse order so that the common suffixes are shared.
+  LoudsTrieBuilder tail_builder;
+  for (size_t i = 0; i < tails.size(); ++i) {
+    tail_builder.Add(string(tails[i].rbegin(), tails[i].rend()));
+  }
+  tail_builder.Build();
+
+  int tail_id_bits = 1;
+  while ((static_cast<size_t>(1) << tail_id_bits) <
+         tail_builder.word_list_.size()) {
+    ++tail_id_bits;
+  }
+  BitStream tail_id_stream;
+  for (size_t i = 0; i < tails.size(); ++i) {
+    const int tail_id = tail_builder.GetId(
+        string(tails[i].rbegin(), tails[i].rend()));
+    for (int bit = 0; bit < tail_id_bits; ++bit) {
+      tail_id_stream.PushBit((tail_id >> bit) & 1);
+    }
+  }
+
+  tail_stream->FillPadding32();
+  tail_id_stream.FillPadding32();
+  image_.append((4 - image_.size() % 4) % 4, '\0');
+  PushInt(tail_stream->ByteSize(), &image_);
+  PushInt(tail_id_stream.ByteSize(), &image_);
+  PushInt(tail_id_bits, &image_);
+  PushInt(tail_builder.image().size(), &image_);
+
+  image_.append(tail_stream->image());
+  image_.append(tail_id_stream.image());
+  image_.append(tail_builder.image());
+}
+
 const string &LoudsTrieBuilder::image() const {
   CHECK(built_);
   return image_;
@@ -39,6 +39,8 @@ namespace mozc {
 namespace storage {
 namespace louds {
 
+class BitStream;
+
 class LoudsTrieBuilder {
  public:
   LoudsTrieBuilder();
@@ -47,6 +49,27 @@ class LoudsTrieBuilder {
   // before Build invocation.
   void Add(const string &word);
 
+  // Adds the word with the weight, i.e. how often the word is expected to
+  // be looked up. Siblings in the built trie are laid out in descending
+  // order of the total weight of the words below them, so that
+  // LoudsTrie::MoveToChildByLabel finds frequent paths first and the nodes
+  // on them are packed close to each other in each level. The weights of a
+  // word added more than once are summed up. Add(word) is the same as
+  // Add(word, 0); if all the weights are equal, siblings are ordered by
+  // their labels. The image can be read by LoudsTrie as usual either way.
+  void Add(const string &word, double weight);
+
+  // Enables tail compression: chains of single child nodes leading to a
+  // single word are removed from the trie, and the rest of the word (tail)
+  // is stored in a nested trie instead, sharing common suffixes with other
+  // tails. This makes the image smaller for long words, at the cost of
+  // restoring tails while traversing them. The image is read by LoudsTrie
+  // through the same APIs. It is necessary to call this method before Build
+  // invocation.
+  void set_use_tail_compression(bool use_tail_compression) {
+    use_tail_compression_ = use_tail_compression;
+  }
+
   // Builds the trie image.
   void Build();
 
@@ -59,9 +82,14 @@ class LoudsTrieBuilder {
   int GetId(const string &word) const;
 
  private:
+  // Appends the tail section for |tails| to the image.
+  void AppendTails(const std::vector<string> &tails, BitStream *tail_stream);
+
   bool built_;
+  bool use_tail_compression_;
 
   std::vector<string> word_list_;
+  std::vector<double> weight_list_;
   std::vector<int> id_list_;
   string image_;
 
@@ -433,6 +433,54 @@ TEST(LoudsTrieTest, ExactSearch) {
 }
 INSTANTIATE_TEST_CASE(GenHasKeyTest);
 
+TEST(LoudsTrieTest, WeightedLayout) {
+  LoudsTrieBuilder builder;
+  builder.Add("a", 1);
+  builder.Add("abc", 1);
+  builder.Add("ae", 5);
+  builder.Add("aecd", 0);
+  builder.Add("b", 3);
+  builder.Add("bcx", 8);
+  builder.Add("c");
+  // The weights of the same word are summed up.
+  builder.Add("abc", 1);
+  builder.Add("abc", 1);
+
+  builder.Build();
+  LoudsTrie trie;
+  trie.Open(reinterpret_cast<const uint8 *>(builder.image().data()));
+
+  // "b" (3 + 8) comes before "a" (1 + 3 + 5 + 0), and "c" (0) is the last.
+  LoudsTrie::Node node;
+  trie.MoveToFirstChild(&node);
+  EXPECT_EQ('b', trie.GetEdgeLabelToParentNode(node));
+  trie.MoveToNextSibling(&node);
+  EXPECT_EQ('a', trie.GetEdgeLabelToParentNode(node));
+  // Under "a", "ae" (5) comes before "ab" (3).
+  LoudsTrie::Node child = node;
+  trie.MoveToFirstChild(&child);
+  EXPECT_EQ('e', trie.GetEdgeLabelToParentNode(child));
+  trie.MoveToNextSibling(&child);
+  EXPECT_EQ('b', trie.GetEdgeLabelToParentNode(child));
+  trie.MoveToNextSibling(&node);
+  EXPECT_EQ('c', trie.GetEdgeLabelToParentNode(node));
+  trie.MoveToNextSibling(&node);
+  EXPECT_FALSE(trie.IsValidNode(node));
+
+  // The layout doesn't change the results of lookups.
+  const char *kWords[] = {"a", "abc", "ae", "aecd", "b", "bcx", "c"};
+  char buf[LoudsTrie::kMaxDepth + 1];
+  for (size_t i = 0; i < arraysize(kWords); ++i) {
+    const int id = builder.GetId(kWords[i]);
+    EXPECT_LE(0, id);
+    EXPECT_EQ(id, trie.ExactSearch(kWords[i]));
+    EXPECT_EQ(kWords[i], trie.RestoreKeyString(id, buf));
+  }
+  EXPECT_EQ(-1, trie.ExactSearch("ab"));
+  EXPECT_EQ(-1, trie.ExactSearch("bc"));
+  trie.Close();
+}
+
 TEST_P(LoudsTrieTest, PrefixSearch) {
   LoudsTrieBuilder builder;
   builder.Add("aa");
@@ -552,6 +600,89 @@ TEST_P(LoudsTrieTest, RestoreKeyString) {
 }
 INSTANTIATE_TEST_CASE(GenRestoreKeyStringTest);
 
+TEST_P(LoudsTrieTest, TailCompression) {
+  // "bcdxyz" and "cxyz" have tails sharing the suffix "xyz", while "a" and
+  // "bce" are too short to have tails.
+  const char *kWords[] = {
+    "a", "abcdefgh", "bcdxyz", "bce", "cxyz", "dddd", "ddddd",
+  };
+  LoudsTrieBuilder builder;
+  builder.set_use_tail_compression(true);
+  for (size_t i = 0; i < arraysize(kWords); ++i) {
+    builder.Add(kWords[i]);
+  }
+  builder.Build();
+
+  const CacheSizeParam &param = GetParam();
+  LoudsTrie trie;
+  trie.Open(reinterpret_cast<const uint8 *>(builder.image().data()),
+            param.louds_lb0_cache_size,
+            param.louds_lb1_cache_size,
+            param.louds_select0_cache_size,
+            param.louds_select1_cache_size,
+            param.termvec_lb1_cache_size);
+
+  char buf[LoudsTrie::kMaxDepth + 1];
+  for (size_t i = 0; i < arraysize(kWords); ++i) {
+    const int id = builder.GetId(kWords[i]);
+    EXPECT_LE(0, id);
+    EXPECT_EQ(id, trie.ExactSearch(kWords[i]));
+    EXPECT_EQ(kWords[i], trie.RestoreKeyString(id, buf));
+
+    const LoudsTrie::Node node = Traverse(trie, kWords[i]);
+    EXPECT_TRUE(trie.IsTerminalNode(node));
+    EXPECT_EQ(id, trie.GetKeyIdOfTerminalNode(node));
+    EXPECT_EQ(node, trie.GetTerminalNodeFromKeyId(id));
+    EXPECT_EQ(kWords[i], trie.RestoreKeyString(node, buf));
+  }
+  EXPECT_EQ(-1, trie.ExactSearch("ab"));
+  EXPECT_EQ(-1, trie.ExactSearch("abcdefg"));
+  EXPECT_EQ(-1, trie.ExactSearch("abcdefghi"));
+  EXPECT_EQ(-1, trie.ExactSearch("bcdxy"));
+  EXPECT_EQ(-1, trie.ExactSearch("bcdxz"));
+  EXPECT_EQ(-1, trie.ExactSearch("ddd"));
+
+  // Nodes in a tail behave as ordinary nodes having one child.
+  LoudsTrie::Node node = Traverse(trie, "abcd");
+  ASSERT_TRUE(trie.IsValidNode(node));
+  EXPECT_FALSE(trie.IsTerminalNode(node));
+  EXPECT_EQ('d', trie.GetEdgeLabelToParentNode(node));
+  EXPECT_EQ("abcd", trie.RestoreKeyString(node, buf));
+  EXPECT_FALSE(trie.IsValidNode(trie.MoveToNextSibling(node)));
+  trie.MoveToFirstChild(&node);
+  ASSERT_TRUE(trie.IsValidNode(node));
+  EXPECT_EQ('e', trie.GetEdgeLabelToParentNode(node));
+  EXPECT_FALSE(trie.MoveToChildByLabel('x', &node));
+
+  // Prefix search goes through tails.
+  std::vector<RecordCallbackArgs::CallbackArgs> args;
+  trie.PrefixSearch("dddddd", RecordCallbackArgs(&args));
+  ASSERT_EQ(2, args.size());
+  EXPECT_EQ(4, args[0].prefix_len);
+  EXPECT_EQ(builder.GetId("dddd"), trie.GetKeyIdOfTerminalNode(args[0].node));
+  EXPECT_EQ(5, args[1].prefix_len);
+  EXPECT_EQ(builder.GetId("ddddd"), trie.GetKeyIdOfTerminalNode(args[1].node));
+
+  // BFS visits all the words.
+  std::vector<LoudsTrie::Node> queue(1, LoudsTrie::Node());
+  size_t num_words = 0;
+  for (size_t i = 0; i < queue.size(); ++i) {
+    if (trie.IsTerminalNode(queue[i])) {
+      const StringPiece word = trie.RestoreKeyString(queue[i], buf);
+      EXPECT_EQ(builder.GetId(word.as_string()),
+                trie.GetKeyIdOfTerminalNode(queue[i]));
+      ++num_words;
+    }
+    for (LoudsTrie::Node child = trie.MoveToFirstChild(queue[i]);
+         trie.IsValidNode(child); trie.MoveToNextSibling(&child)) {
+      queue.push_back(child);
+    }
+  }
+  EXPECT_EQ(arraysize(kWords), num_words);
+  trie.Close();
+}
+INSTANTIATE_TEST_CASE(GenTailCompressionTest);
+
 }  // namespace
 }  // namespace louds
 }  // namespace storage
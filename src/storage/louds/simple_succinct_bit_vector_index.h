@@ -98,6 +98,12 @@ class SimpleSuccinctBitVectorIndex {
   int GetNum1Bits() const { return index_.back(); }
   int GetNum0Bits() const { return 8 * length_ - index_.back(); }
 
+  // Returns the bytes allocated for the index and the caches.
+  size_t GetAllocatedBytes() const {
+    return index_.capacity() * sizeof(index_[0]) +
+           (lb0_cache_.capacity() + lb1_cache_.capacity()) * sizeof(int *);
+  }
+
  private:
   const uint8 *data_;
   int length_;
@@ -96,6 +96,10 @@ class LRUCache {
   // Returns the number of entries currently in the cache.
   size_t Size() const;
 
+  // Returns the bytes held by the element blocks and the key table.  The heap
+  // memory owned by the values themselves is not included.
+  size_t GetAllocatedBytes() const;
+
   bool HasKey(const Key &key) const;
 
   // Returns the head of LRU list
@@ -407,6 +411,14 @@ size_t LRUCache<Key, Value>::Size() const {
   return table_->size();
 }
 
+template<typename Key, typename Value>
+size_t LRUCache<Key, Value>::GetAllocatedBytes() const {
+  // Each node of std::map holds the value, three links and the color.
+  return block_capacity_ * sizeof(Element) +
+      table_->size() * (sizeof(typename Table::value_type) +
+                        4 * sizeof(void *));
+}
+
 }  // namespace storage
 }  // namespace mozc
 #endif  // MOZC_STORAGE_LRU_CACHE_H_
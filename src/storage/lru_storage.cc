@@ -614,6 +614,13 @@ size_t LRUStorage::used_size() const {
   return lru_list_.get() == NULL ? 0 : lru_list_->size();
 }
 
+size_t LRUStorage::GetAllocatedBytes() const {
+  // Each node of std::map holds the value, three links and the color.
+  return map_.size() * (sizeof(std::map<uint64, Node *>::value_type) +
+                        4 * sizeof(void *)) +
+      used_size() * sizeof(Node);
+}
+
 uint32 LRUStorage::seed() const {
   return seed_;
 }
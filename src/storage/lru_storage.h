@@ -93,6 +93,10 @@ class LRUStorage {
   size_t size() const;
   size_t used_size() const;
   uint32 seed() const;
+
+  // Returns the heap memory held by the index of the entries.  The entries
+  // themselves live in the mapped file and are not counted.
+  size_t GetAllocatedBytes() const;
   const string &filename() const;
 
   // Write one entry at |i| th index.
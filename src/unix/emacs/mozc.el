@@ -333,38 +333,17 @@ EVENT is the last input event, which is usually passed by the command loop."
   (cond
    ;; Keyboard event
    ((or (integerp event) (symbolp event))
-    (let ((output (mozc-send-key-event event)))
-      (cond
-       ((null output)  ; Error occurred.
-        (mozc-clean-up-session)  ; Discard the current session.
-        (mozc-abort)
-        (signal 'mozc-response-error output))
-
-       ;; Mozc server consumed the key event.
-       ((mozc-protobuf-get output 'consumed)
-        (let ((result (mozc-protobuf-get output 'result))
-              (preedit (mozc-protobuf-get output 'preedit))
-              (candidates (mozc-protobuf-get output 'candidates)))
-          (if (not (or result preedit))
-              (mozc-clean-up-changes-on-buffer)  ; nothing to show
-            (when result  ; Insert the result first.
-              (mozc-clean-up-changes-on-buffer)
-              (unless (eq (mozc-protobuf-get result 'type) 'string)
-                (message "mozc.el: Unknown result type")
-                (signal 'mozc-type-error `('string
-                                           ,(mozc-protobuf-get result 'type))))
-              (insert (mozc-protobuf-get result 'value)))
-            (if preedit  ; Update the preedit.
-                (mozc-preedit-update preedit candidates)
-              (mozc-preedit-clear))
-            (if candidates  ; Update the candidate window.
-                (mozc-candidate-update candidates)
-              (mozc-candidate-clear)))))
-
-       (t  ; Mozc server didn't consume the key event.
-        (mozc-clean-up-changes-on-buffer)
-        ;; Process the key event as if Mozc didn't hook the key event.
-        (mozc-fall-back-on-default-binding event)))))
+    ;; Characters typed ahead are sent together with EVENT.
+    (let* ((events (cons event (mozc-read-typed-ahead-key-events)))
+           (outputs (mozc-send-key-events events)))
+      (while events
+        (setq event (pop events))
+        (let ((output (pop outputs)))
+          (when (null output)
+            ;; Leave the rest of the events to the command loop.
+            (setq unread-command-events (append events unread-command-events)
+                  events nil))
+          (mozc-handle-key-event-output event output)))))
 
    ;; Other events
    (t
@@ -372,18 +351,89 @@ EVENT is the last input event, which is usually passed by the command loop."
     ;; Leave the current preedit and candidate window as it is.
     (mozc-fall-back-on-default-binding event))))
 
-(defun mozc-send-key-event (event)
-  "Send a key event EVENT and return the resulting protobuf.
-The resulting protocol buffer, which is represented as alist, is
-mozc::commands::Output."
-  (let* ((key-and-modifiers (mozc-key-event-to-key-and-modifiers event))
-         (key (car key-and-modifiers))
-         (keymap (mozc-keymap-current-active-keymap))
-         (str (and (null (cdr key-and-modifiers))
-                   (mozc-keymap-get-entry keymap key))))
-    (mozc-session-sendkey (if str
-                              (list key str)
-                            key-and-modifiers))))
+(defun mozc-handle-key-event-output (event output)
+  "Render the resulting protobuf OUTPUT of a key event EVENT.
+If Mozc server didn't consume EVENT, process it with another command bound
+to the key sequence.  OUTPUT is nil on error."
+  (cond
+   ((null output)  ; Error occurred.
+    (mozc-clean-up-session)  ; Discard the current session.
+    (mozc-abort)
+    (signal 'mozc-response-error output))
+
+   ;; Mozc server consumed the key event.
+   ((mozc-protobuf-get output 'consumed)
+    (let ((result (mozc-protobuf-get output 'result))
+          (preedit (mozc-protobuf-get output 'preedit))
+          (candidates (mozc-protobuf-get output 'candidates)))
+      (if (not (or result preedit))
+          (mozc-clean-up-changes-on-buffer)  ; nothing to show
+        (when result  ; Insert the result first.
+          (mozc-clean-up-changes-on-buffer)
+          (unless (eq (mozc-protobuf-get result 'type) 'string)
+            (message "mozc.el: Unknown result type")
+            (signal 'mozc-type-error `('string
+                                       ,(mozc-protobuf-get result 'type))))
+          (insert (mozc-protobuf-get result 'value)))
+        (if preedit  ; Update the preedit.
+            (mozc-preedit-update preedit candidates)
+          (mozc-preedit-clear))
+        (if candidates  ; Update the candidate window.
+            (mozc-candidate-update candidates)
+          (mozc-candidate-clear)))))
+
+   (t  ; Mozc server didn't consume the key event.
+    (mozc-clean-up-changes-on-buffer)
+    ;; Process the key event as if Mozc didn't hook the key event.
+    (mozc-fall-back-on-default-binding event))))
+
+(defvar mozc-typed-ahead-key-events-max 64
+  "Maximum number of key events sent to the helper process at once.
+Printable characters typed ahead, e.g. by fast typing or pasting on
+a terminal, are sent without waiting for the response to the previous one,
+so that the helper process sends them to Mozc server in one round trip.
+Set 1 to disable it.")
+
+(defun mozc-read-typed-ahead-key-events ()
+  "Read printable characters which have already been typed and return them.
+The characters must be bound to `mozc-handle-event'.  Reading stops at any
+other event, which is left in the event queue.  Return nil while executing
+a keyboard macro."
+  (let ((events nil)
+        (count 1)
+        (done executing-kbd-macro))
+    (while (and (not done)
+                (< count mozc-typed-ahead-key-events-max)
+                (input-pending-p))
+      (let ((event (read-event nil nil 0)))
+        (cond
+         ((null event)
+          (setq done t))
+         ((and (integerp event) (<= ?\s event ?~)
+               (eq (key-binding (vector event)) #'mozc-handle-event))
+          (push event events)
+          (setq count (1+ count)))
+         (t
+          (push event unread-command-events)
+          (setq done t)))))
+    (nreverse events)))
+
+(defun mozc-send-key-events (events)
+  "Send key events EVENTS and return a list of the resulting protobufs.
+The resulting protocol buffers, which are represented as alist, are
+mozc::commands::Output in the order of EVENTS.  An element is nil on error."
+  (let ((keymap (mozc-keymap-current-active-keymap)))
+    (mozc-session-sendkeys
+     (mapcar (lambda (event)
+               (let* ((key-and-modifiers
+                       (mozc-key-event-to-key-and-modifiers event))
+                      (key (car key-and-modifiers))
+                      (str (and (null (cdr key-and-modifiers))
+                                (mozc-keymap-get-entry keymap key))))
+                 (if str
+                     (list key str)
+                   key-and-modifiers)))
+             events))))
 
 (defun mozc-key-event-to-key-and-modifiers (event)
   "Convert a keyboard event EVENT to a list of key and modifiers.
@@ -1471,12 +1521,35 @@ inserted (\"\\u3061\")."
   (when (mozc-session-create)
     (apply #'mozc-session-execute-command 'SendKey key-list)))
 
+(defun mozc-session-sendkeys (key-lists)
+  "Send key events to the helper process and return the resulting protobufs.
+KEY-LISTS is a list of KEY-LIST of `mozc-session-sendkey'.  All the key
+events are sent before receiving any response, so that the helper process
+can send them to Mozc server together.  Return a list of
+mozc::commands::Output in the order of KEY-LISTS, whose element is nil on
+error."
+  (if (mozc-session-create)
+      (let ((seqs (mapcar (lambda (key-list)
+                            (apply #'mozc-session-send-command
+                                   'SendKey key-list))
+                          key-lists)))
+        (mapcar (lambda (seq)
+                  (mozc-session-recv-command-output 'SendKey seq))
+                seqs))
+    (make-list (length key-lists) nil)))
+
 (defun mozc-session-execute-command (command &rest args)
   "Send a COMMAND and receive a corresponding response.
 And then return mozc::commands::Output protocol buffer as alist.
 If error occurred, return nil.
 
 ARGS must suit to a COMMAND.  See the document of the helper process."
+  (mozc-session-recv-command-output
+   command (apply #'mozc-session-send-command command args)))
+
+(defun mozc-session-send-command (command &rest args)
+  "Send a COMMAND with ARGS to the helper process and return its event ID.
+Receive the response with `mozc-session-recv-command-output'."
   (let ((seq mozc-session-seq))
     ;; Increment the seq first so that it produces another seq
     ;; when an error occurred.
@@ -1489,23 +1562,29 @@ ARGS must suit to a COMMAND.  See the document of the helper process."
            (if (eq command 'CreateSession)
                args
              (cons mozc-session-id args)))
-    ;; Check whether the session ID matches or not.
-    (let* ((resp (mozc-session-recv-corresponding-response seq))
-           (session-id (cdr (assq 'emacs-session-id resp)))
-           (output (mozc-protobuf-get resp 'output)))
-      ;; mozc-session-id should be nil when not yet connected.
-      ;; session-id is nil when an error occurred.
-      (cond
-       ((eq command 'CreateSession)
-        (if (setq mozc-session-id session-id)
-            output
-          (mozc-abort)
-          (message "mozc.el: Failed to start a new session.")
-          (signal 'mozc-session-error resp)))
-       ((eq session-id mozc-session-id)
-        output)
-       ;; Otherwise, return nil.
-       ))))
+    seq))
+
+(defun mozc-session-recv-command-output (command seq)
+  "Receive the response to a COMMAND whose event ID is SEQ.
+And then return mozc::commands::Output protocol buffer as alist.
+If error occurred, return nil."
+  ;; Check whether the session ID matches or not.
+  (let* ((resp (mozc-session-recv-corresponding-response seq))
+         (session-id (cdr (assq 'emacs-session-id resp)))
+         (output (mozc-protobuf-get resp 'output)))
+    ;; mozc-session-id should be nil when not yet connected.
+    ;; session-id is nil when an error occurred.
+    (cond
+     ((eq command 'CreateSession)
+      (if (setq mozc-session-id session-id)
+          output
+        (mozc-abort)
+        (message "mozc.el: Failed to start a new session.")
+        (signal 'mozc-session-error resp)))
+     ((eq session-id mozc-session-id)
+      output)
+     ;; Otherwise, return nil.
+     )))
 
 (defun mozc-session-recv-corresponding-response (seq)
   "Receive the response whose event ID is SEQ, and return it."
@@ -29,12 +29,18 @@
 
 #include <cstdio>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "base/flags.h"
 #include "base/init_mozc.h"
 #include "base/logging.h"
+#include "base/mutex.h"
 #include "base/protobuf/descriptor.h"
 #include "base/protobuf/message.h"
+#include "base/thread.h"
+#include "base/unnamed_event.h"
 #include "base/util.h"
 #include "base/version.h"
 #include "client/client.h"
@@ -70,58 +76,189 @@ void PrintGreetingMessage() {
   fflush(stdout);
 }
 
-// Main loop, which takes an input line as a command and print a corresponding
-// result returned by Mozc server in S-expression.
-void ProcessLoop() {
+// Maximum number of key events sent to the server in one round trip.
+const size_t kMaxBatchedKeys = 64;
+
+// A request given by an input line.
+struct Request {
+  Request() : event_id(0), session_id(0) {}
+
+  uint32 event_id;
+  uint32 session_id;
+  mozc::commands::Input input;
+};
+
+// Reads input lines in a separate thread, so that the lines which arrive
+// while the main loop is waiting for the server are processed together.
+// mozc.el sends the characters typed ahead without waiting for the replies.
+class InputLineReader : public mozc::Thread {
+ public:
+  InputLineReader() : eof_(false) {}
+  virtual ~InputLineReader() {}
+
+  virtual void Run() {
+    string line;
+    while (getline(std::cin, line)) {
+      {
+        mozc::scoped_lock l(&mutex_);
+        lines_.push_back(line);
+      }
+      event_.Notify();
+    }
+    {
+      mozc::scoped_lock l(&mutex_);
+      eof_ = true;
+    }
+    event_.Notify();
+  }
+
+  // Waits for input lines and moves all the lines read so far to |lines|.
+  // Returns false when the input has ended.
+  bool ReadLines(std::vector<string> *lines) {
+    lines->clear();
+    while (true) {
+      {
+        mozc::scoped_lock l(&mutex_);
+        if (!lines_.empty()) {
+          lines->swap(lines_);
+          return true;
+        }
+        if (eof_) {
+          return false;
+        }
+      }
+      event_.Wait(-1);
+    }
+  }
+
+ private:
+  mozc::Mutex mutex_;
+  std::vector<string> lines_;
+  bool eof_;
+  mozc::UnnamedEvent event_;
+
+  DISALLOW_COPY_AND_ASSIGN(InputLineReader);
+};
+
+// Prints a result returned by Mozc server in S-expression.
+void PrintResult(uint32 event_id, uint32 session_id,
+                 mozc::commands::Output *output) {
+  mozc::emacs::RemoveUsageData(output);
+
+  std::vector<string> buffer;
+  mozc::emacs::PrintMessage(*output, &buffer);
+  string output_string;
+  mozc::Util::JoinStrings(buffer, "", &output_string);
+  fprintf(stdout,
+          "((emacs-event-id . %u)(emacs-session-id . %u)(output . %s))\n",
+          event_id, session_id, output_string.c_str());
+}
+
+// Processes a single request.
+void ProcessRequest(mozc::emacs::ClientPool *client_pool, Request *request) {
   using mozc::emacs::ErrorExit;
 
+  mozc::commands::Output output;
+  switch (request->input.type()) {
+    case mozc::commands::Input::CREATE_SESSION:
+      request->session_id = client_pool->CreateClient();
+      break;
+    case mozc::commands::Input::DELETE_SESSION:
+      client_pool->DeleteClient(request->session_id);
+      break;
+    case mozc::commands::Input::SEND_KEY: {
+      std::shared_ptr<mozc::client::Client> client =
+          client_pool->GetClient(request->session_id);
+      CHECK(client.get());
+      if (!client->SendKey(request->input.key(), &output)) {
+        ErrorExit(mozc::emacs::kErrSessionError, "Session failed");
+      }
+      break;
+    }
+    default:
+      ErrorExit(mozc::emacs::kErrVoidFunction, "Unknown function");
+  }
+  PrintResult(request->event_id, request->session_id, &output);
+}
+
+// Processes SendKey requests for the same session in one round trip.  The
+// results are printed in the order of the requests.
+void ProcessKeyRequests(mozc::emacs::ClientPool *client_pool,
+                        const std::vector<Request> &requests) {
+  DCHECK_LT(1, requests.size());
+  std::vector<mozc::commands::KeyEvent> keys(requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    keys[i].CopyFrom(requests[i].input.key());
+  }
+  std::shared_ptr<mozc::client::Client> client =
+      client_pool->GetClient(requests[0].session_id);
+  CHECK(client.get());
+  std::vector<mozc::commands::Output> outputs;
+  if (!client->SendKeysWithOutputs(keys, &outputs)) {
+    mozc::emacs::ErrorExit(mozc::emacs::kErrSessionError, "Session failed");
+  }
+  DCHECK_EQ(requests.size(), outputs.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    PrintResult(requests[i].event_id, requests[i].session_id, &outputs[i]);
+  }
+}
+
+// Main loop, which takes input lines as commands and print corresponding
+// results returned by Mozc server in S-expression.
+//
+// The lines which have arrived while the previous ones are processed are
+// handled in order, and consecutive SendKey commands for the same session
+// are sent to the server in one round trip.  A line is parsed only after
+// all the lines before it are answered or batched with it, so a malformed
+// line terminates the process only after the preceding lines are answered.
+void ProcessLoop() {
   mozc::emacs::ClientPool client_pool;
-  mozc::commands::Command command;
-  string line;
-
-  while (getline(std::cin, line)) {
-    command.clear_input();
-    command.clear_output();
-    uint32 event_id = 0;
-    uint32 session_id = 0;
-
-    // Parse an input line.
-    mozc::emacs::ParseInputLine(line, &event_id, &session_id,
-                                command.mutable_input());
-
-    switch (command.input().type()) {
-      case mozc::commands::Input::CREATE_SESSION:
-        session_id = client_pool.CreateClient();
-        break;
-      case mozc::commands::Input::DELETE_SESSION:
-        client_pool.DeleteClient(session_id);
-        break;
-      case mozc::commands::Input::SEND_KEY: {
-        std::shared_ptr<mozc::client::Client> client =
-            client_pool.GetClient(session_id);
-        CHECK(client.get());
-        if (!client->SendKey(command.input().key(),
-                              command.mutable_output())) {
-          ErrorExit(mozc::emacs::kErrSessionError, "Session failed");
+  InputLineReader reader;
+  reader.SetJoinable(true);
+  reader.Start("EmacsInputLineReader");
+
+  std::vector<string> lines;
+  std::vector<Request> key_requests;
+  while (reader.ReadLines(&lines)) {
+    size_t next = 0;
+    while (next < lines.size()) {
+      Request request;
+      mozc::emacs::ParseInputLine(lines[next++], &request.event_id,
+                                  &request.session_id, &request.input);
+      if (request.input.type() != mozc::commands::Input::SEND_KEY) {
+        ProcessRequest(&client_pool, &request);
+        fflush(stdout);
+        continue;
+      }
+
+      // Collects the following SendKey requests for the same session.  A line
+      // which fails to parse ends the batch, and it is parsed again above
+      // after the batch is answered.
+      key_requests.clear();
+      key_requests.push_back(request);
+      while (next < lines.size() && key_requests.size() < kMaxBatchedKeys) {
+        Request key_request;
+        string error, message;
+        if (!mozc::emacs::TryParseInputLine(
+                lines[next], &key_request.event_id, &key_request.session_id,
+                &key_request.input, &error, &message) ||
+            !mozc::emacs::CanBatchInputs(
+                request.session_id, request.input,
+                key_request.session_id, key_request.input)) {
+          break;
         }
-        break;
+        key_requests.push_back(key_request);
+        ++next;
       }
-      default:
-        ErrorExit(mozc::emacs::kErrVoidFunction, "Unknown function");
+      if (key_requests.size() == 1) {
+        ProcessRequest(&client_pool, &request);
+      } else {
+        ProcessKeyRequests(&client_pool, key_requests);
+      }
+      fflush(stdout);
     }
-
-    mozc::emacs::RemoveUsageData(command.mutable_output());
-
-    // Output results.
-    std::vector<string> buffer;
-    mozc::emacs::PrintMessage(command.output(), &buffer);
-    string output;
-    mozc::Util::JoinStrings(buffer, "", &output);
-    fprintf(stdout,
-            "((emacs-event-id . %u)(emacs-session-id . %u)(output . %s))\n",
-            event_id, session_id, output.c_str());
-    fflush(stdout);
   }
+  reader.Join();
 }
 
 }  // namespace
@@ -58,6 +58,14 @@ void PrintFieldValue(
     const protobuf::FieldDescriptor &field,
     int index,
     std::vector<string>* output);
+
+// Stores an error symbol and a message for TryParseInputLine().
+bool SetParseError(const char *error_symbol, const char *error_message,
+                   string *error, string *message) {
+  *error = error_symbol;
+  *message = error_message;
+  return false;
+}
 }  // namespace
 
 
@@ -70,23 +78,27 @@ void PrintFieldValue(
 // ARGUMENTs depend on a command.
 // An input line must be surrounded by a pair of parentheses,
 // like a S-expression.
-void ParseInputLine(
+bool TryParseInputLine(
     const string &line, uint32 *event_id, uint32 *session_id,
-    mozc::commands::Input *input) {
+    mozc::commands::Input *input, string *error, string *message) {
   CHECK(event_id);
   CHECK(session_id);
   CHECK(input);
+  CHECK(error);
+  CHECK(message);
 
   std::vector<string> tokens;
   if (!TokenizeSExpr(line, &tokens) ||
       tokens.size() < 4 ||  // Must be at least '(' EVENT_ID COMMAND ')'.
       tokens.front() != "(" || tokens.back() != ")") {
-    ErrorExit(kErrScanError, "S expression in the wrong format");
+    return SetParseError(kErrScanError, "S expression in the wrong format",
+                         error, message);
   }
 
   // Read an event ID (a sequence number).
   if (!NumberUtil::SafeStrToUInt32(tokens[1], event_id)) {
-    ErrorExit(kErrWrongTypeArgument, "Event ID is not an integer");
+    return SetParseError(kErrWrongTypeArgument, "Event ID is not an integer",
+                         error, message);
   }
 
   // Read a command.
@@ -100,36 +112,41 @@ void ParseInputLine(
   } else {
     // Mozc has SendTestKey and SendCommand commands in addition to the above.
     // But this code doesn't support them because of no need so far.
-    ErrorExit(kErrVoidFunction, "Unknown function");
+    return SetParseError(kErrVoidFunction, "Unknown function", error, message);
   }
 
   switch (input->type()) {
     case mozc::commands::Input::CREATE_SESSION: {
       // Suppose: (EVENT_ID CreateSession)
       if (tokens.size() != 4) {
-        ErrorExit(kErrWrongNumberOfArguments, "Wrong number of arguments");
+        return SetParseError(kErrWrongNumberOfArguments,
+                             "Wrong number of arguments", error, message);
       }
       break;
     }
     case mozc::commands::Input::DELETE_SESSION: {
       // Suppose: (EVENT_ID DeleteSession SESSION_ID)
       if (tokens.size() != 5) {
-        ErrorExit(kErrWrongNumberOfArguments, "Wrong number of arguments");
+        return SetParseError(kErrWrongNumberOfArguments,
+                             "Wrong number of arguments", error, message);
       }
       // Parse session ID.
       if (!NumberUtil::SafeStrToUInt32(tokens[3], session_id)) {
-        ErrorExit(kErrWrongTypeArgument, "Session ID is not an integer");
+        return SetParseError(kErrWrongTypeArgument,
+                             "Session ID is not an integer", error, message);
       }
       break;
     }
     case mozc::commands::Input::SEND_KEY: {
       // Suppose: (EVENT_ID SendKey SESSION_ID KEY...)
       if (tokens.size() < 6) {
-        ErrorExit(kErrWrongNumberOfArguments, "Wrong number of arguments");
+        return SetParseError(kErrWrongNumberOfArguments,
+                             "Wrong number of arguments", error, message);
       }
       // Parse session ID.
       if (!NumberUtil::SafeStrToUInt32(tokens[3], session_id)) {
-        ErrorExit(kErrWrongTypeArgument, "Session ID is not an integer");
+        return SetParseError(kErrWrongTypeArgument,
+                             "Session ID is not an integer", error, message);
       }
       // Parse keys.
       std::vector<string> keys;
@@ -139,15 +156,18 @@ void ParseInputLine(
           uint32 key_code;
           if (!NumberUtil::SafeStrToUInt32(tokens[i], &key_code) ||
               key_code > 255) {
-            ErrorExit(kErrWrongTypeArgument, "Wrong character code");
+            return SetParseError(kErrWrongTypeArgument, "Wrong character code",
+                                 error, message);
           }
           keys.push_back(string(1, static_cast<char>(key_code)));
         } else if (tokens[i][0] == '\"') {  // String literal
           if (!key_string.empty()) {
-            ErrorExit(kErrWrongTypeArgument, "Wrong number of key strings");
+            return SetParseError(kErrWrongTypeArgument,
+                                 "Wrong number of key strings", error, message);
           }
           if (!UnquoteString(tokens[i], &key_string)) {
-            ErrorExit(kErrWrongTypeArgument, "Wrong key string literal");
+            return SetParseError(kErrWrongTypeArgument,
+                                 "Wrong key string literal", error, message);
           }
         } else {  // Key symbol
           keys.push_back(tokens[i]);
@@ -167,6 +187,26 @@ void ParseInputLine(
     default:
       DLOG(FATAL);  // Code must not reach here.
   }
+  return true;
+}
+
+void ParseInputLine(
+    const string &line, uint32 *event_id, uint32 *session_id,
+    mozc::commands::Input *input) {
+  string error, message;
+  if (!TryParseInputLine(line, event_id, session_id, input, &error,
+                         &message)) {
+    ErrorExit(error, message);
+  }
+}
+
+bool CanBatchInputs(uint32 prev_session_id,
+                    const mozc::commands::Input &prev,
+                    uint32 next_session_id,
+                    const mozc::commands::Input &next) {
+  return prev.type() == mozc::commands::Input::SEND_KEY &&
+      next.type() == mozc::commands::Input::SEND_KEY &&
+      prev_session_id == next_session_id;
 }
 
 
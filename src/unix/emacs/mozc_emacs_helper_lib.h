@@ -65,10 +65,25 @@ const char kErrSessionError[] = "session-error";
 // ARGUMENTs depend on a command.
 // An input line must be surrounded by a pair of parentheses,
 // like a S-expression.
+// Calls ErrorExit() if the line is in the wrong format.
 void ParseInputLine(
     const string &line, uint32 *event_id, uint32 *session_id,
     mozc::commands::Input *input);
 
+// Same as ParseInputLine() except that it returns false and stores the error
+// symbol and the message to |error| and |message| instead of ErrorExit().
+bool TryParseInputLine(
+    const string &line, uint32 *event_id, uint32 *session_id,
+    mozc::commands::Input *input, string *error, string *message);
+
+// Returns true if the input |next| can be sent to the server in the same
+// round trip as the input |prev|, i.e. both of them are SendKey commands for
+// the same session.  Such inputs are sent as one SEND_KEYS command.
+bool CanBatchInputs(uint32 prev_session_id,
+                    const mozc::commands::Input &prev,
+                    uint32 next_session_id,
+                    const mozc::commands::Input &next);
+
 
 // Prints the content of a protocol buffer in S-expression.
 // - 'message' and 'group' are mapped to alist (associative list)
@@ -147,6 +147,50 @@ TEST_F(MozcEmacsHelperLibTest, ParseInputLine) {
             "key_string: \"\\007\\010\\t\\n \\177\" }");
 }
 
+TEST_F(MozcEmacsHelperLibTest, TryParseInputLine) {
+  uint32 event_id = 0;
+  uint32 session_id = 0;
+  mozc::commands::Input input;
+  string error, message;
+  EXPECT_TRUE(mozc::emacs::TryParseInputLine(
+      "(3 SendKey 1 97)", &event_id, &session_id, &input, &error, &message));
+  EXPECT_EQ(3, event_id);
+  EXPECT_EQ(1, session_id);
+  EXPECT_EQ(mozc::commands::Input::SEND_KEY, input.type());
+  EXPECT_TRUE(error.empty());
+
+  // Errors are returned instead of terminating the process.
+  input.Clear();
+  EXPECT_FALSE(mozc::emacs::TryParseInputLine(
+      "(4 SendKey 1", &event_id, &session_id, &input, &error, &message));
+  EXPECT_EQ(mozc::emacs::kErrScanError, error);
+  EXPECT_FALSE(mozc::emacs::TryParseInputLine(
+      "(5 Unknown 1 97)", &event_id, &session_id, &input, &error, &message));
+  EXPECT_EQ(mozc::emacs::kErrVoidFunction, error);
+  EXPECT_FALSE(mozc::emacs::TryParseInputLine(
+      "(6 SendKey x 97)", &event_id, &session_id, &input, &error, &message));
+  EXPECT_EQ(mozc::emacs::kErrWrongTypeArgument, error);
+  EXPECT_EQ("Session ID is not an integer", message);
+}
+
+TEST_F(MozcEmacsHelperLibTest, CanBatchInputs) {
+  mozc::commands::Input create_session;
+  create_session.set_type(mozc::commands::Input::CREATE_SESSION);
+  mozc::commands::Input send_key1;
+  send_key1.set_type(mozc::commands::Input::SEND_KEY);
+  send_key1.mutable_key()->set_key_code('a');
+  mozc::commands::Input send_key2;
+  send_key2.set_type(mozc::commands::Input::SEND_KEY);
+  send_key2.mutable_key()->set_key_code('b');
+
+  EXPECT_TRUE(mozc::emacs::CanBatchInputs(1, send_key1, 1, send_key2));
+  // Different sessions
+  EXPECT_FALSE(mozc::emacs::CanBatchInputs(1, send_key1, 2, send_key2));
+  // Not a key event
+  EXPECT_FALSE(mozc::emacs::CanBatchInputs(1, create_session, 1, send_key2));
+  EXPECT_FALSE(mozc::emacs::CanBatchInputs(1, send_key1, 1, create_session));
+}
+
 TEST_F(MozcEmacsHelperLibTest, PrintMessage) {
   // KeyEvent
   mozc::commands::KeyEvent key_event;
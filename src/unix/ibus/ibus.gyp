@@ -141,6 +141,7 @@
         'engine_registrar.cc',
         'ibus_candidate_window_handler.cc',
         'key_event_handler.cc',
+        'key_event_pipeline.cc',
         'key_translator.cc',
         'mozc_engine.cc',
         'preedit_handler.cc',
@@ -206,6 +207,7 @@
       'type': 'executable',
       'sources': [
         'key_event_handler_test.cc',
+        'key_event_pipeline_test.cc',
         'key_translator_test.cc',
         'message_translator_test.cc',
         'mozc_engine_test.cc',
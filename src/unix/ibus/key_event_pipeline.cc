@@ -0,0 +1,260 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "unix/ibus/key_event_pipeline.h"
+
+#include <utility>
+
+#include "base/logging.h"
+#include "base/thread.h"
+#include "client/client_interface.h"
+
+namespace mozc {
+namespace ibus {
+
+class KeyEventPipeline::Worker : public Thread {
+ public:
+  explicit Worker(KeyEventPipeline *pipeline) : pipeline_(pipeline) {}
+
+  virtual void Run() {
+    while (pipeline_->ProcessNext()) {
+    }
+  }
+
+ private:
+  KeyEventPipeline *pipeline_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+KeyEventPipeline::KeyEventPipeline(client::ClientInterface *client)
+    : client_(client),
+      result_callback_(NULL),
+      result_callback_data_(NULL),
+      in_flight_(false),
+      paused_(false),
+      quit_(false) {}
+
+KeyEventPipeline::~KeyEventPipeline() {
+  {
+    scoped_lock l(&mutex_);
+    quit_ = true;
+  }
+  request_event_.Notify();
+  if (worker_.get() != NULL) {
+    worker_->Join();
+  }
+}
+
+void KeyEventPipeline::Start() {
+  if (worker_.get() != NULL) {
+    return;
+  }
+  worker_.reset(new Worker(this));
+  worker_->SetJoinable(true);
+  worker_->Start("KeyEventPipeline");
+}
+
+void KeyEventPipeline::set_result_callback(ResultCallback callback,
+                                           void *data) {
+  scoped_lock l(&mutex_);
+  result_callback_ = callback;
+  result_callback_data_ = data;
+}
+
+void KeyEventPipeline::Push(const Event &event,
+                            const commands::Context &context) {
+  {
+    scoped_lock l(&mutex_);
+    if (!queued_.empty() &&
+        (event.forward_only || CanCoalesce(*queued_.back(), event))) {
+      queued_.back()->events.push_back(event);
+      return;
+    }
+    std::unique_ptr<Result> result(new Result);
+    result->events.push_back(event);
+    result->context.CopyFrom(context);
+    queued_.push_back(std::move(result));
+  }
+  request_event_.Notify();
+}
+
+bool KeyEventPipeline::PopResult(Result *result) {
+  scoped_lock l(&mutex_);
+  if (completed_.empty()) {
+    return false;
+  }
+  result->events.swap(completed_.front()->events);
+  result->context.Swap(&completed_.front()->context);
+  result->output.Swap(&completed_.front()->output);
+  result->succeeded = completed_.front()->succeeded;
+  completed_.pop_front();
+  return true;
+}
+
+void KeyEventPipeline::WaitForResult() {
+  while (true) {
+    {
+      scoped_lock l(&mutex_);
+      // Nothing is sent while the worker is paused or not started.
+      if (!completed_.empty() || (queued_.empty() && !in_flight_) ||
+          paused_ || worker_.get() == NULL) {
+        return;
+      }
+    }
+    result_event_.Wait(-1);
+  }
+}
+
+bool KeyEventPipeline::IsIdle() const {
+  scoped_lock l(&mutex_);
+  return queued_.empty() && !in_flight_ && completed_.empty();
+}
+
+void KeyEventPipeline::Resume() {
+  {
+    scoped_lock l(&mutex_);
+    paused_ = false;
+  }
+  request_event_.Notify();
+}
+
+// static
+bool KeyEventPipeline::NeedsClient(const commands::Output &output) {
+  if (output.has_callback() || output.has_launch_tool_mode()) {
+    return true;
+  }
+  for (size_t i = 0; i < output.key_outputs_size(); ++i) {
+    if (NeedsClient(output.key_outputs(i).output())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// static
+bool KeyEventPipeline::IsNavigationKey(const commands::KeyEvent &key) {
+  if (!key.has_special_key() || key.has_key_code() ||
+      key.modifier_keys_size() > 0) {
+    return false;
+  }
+  switch (key.special_key()) {
+    case commands::KeyEvent::LEFT:
+    case commands::KeyEvent::RIGHT:
+    case commands::KeyEvent::UP:
+    case commands::KeyEvent::DOWN:
+    case commands::KeyEvent::PAGE_UP:
+    case commands::KeyEvent::PAGE_DOWN:
+    case commands::KeyEvent::HOME:
+    case commands::KeyEvent::END:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+bool KeyEventPipeline::CanCoalesce(const Result &queued, const Event &event) {
+  if (!IsNavigationKey(event.key)) {
+    return false;
+  }
+  size_t num_sent_events = 0;
+  for (size_t i = 0; i < queued.events.size(); ++i) {
+    const Event &queued_event = queued.events[i];
+    if (queued_event.forward_only) {
+      continue;
+    }
+    if (queued_event.engine != event.engine ||
+        !IsNavigationKey(queued_event.key)) {
+      return false;
+    }
+    ++num_sent_events;
+  }
+  return num_sent_events > 0 && num_sent_events < kMaxCoalescedKeys;
+}
+
+bool KeyEventPipeline::ProcessNext() {
+  std::unique_ptr<Result> result;
+  ResultCallback callback = NULL;
+  void *callback_data = NULL;
+  {
+    scoped_lock l(&mutex_);
+    if (quit_) {
+      return false;
+    }
+    if (!paused_ && !queued_.empty()) {
+      result = std::move(queued_.front());
+      queued_.pop_front();
+      in_flight_ = true;
+      callback = result_callback_;
+      callback_data = result_callback_data_;
+    }
+  }
+  if (result.get() == NULL) {
+    request_event_.Wait(-1);
+    return true;
+  }
+
+  std::vector<commands::KeyEvent> keys;
+  for (size_t i = 0; i < result->events.size(); ++i) {
+    if (!result->events[i].forward_only) {
+      keys.push_back(result->events[i].key);
+    }
+  }
+  if (keys.empty()) {
+    result->succeeded = true;
+  } else if (keys.size() == 1) {
+    result->succeeded = client_->SendKeyWithContext(
+        keys[0], result->context, &result->output);
+  } else {
+    result->succeeded = client_->SendKeysWithContext(
+        keys, result->context, &result->output);
+  }
+  if (!result->succeeded) {
+    LOG(ERROR) << "SendKey failed";
+  }
+
+  {
+    scoped_lock l(&mutex_);
+    if (result->succeeded && NeedsClient(result->output)) {
+      paused_ = true;
+    }
+    completed_.push_back(std::move(result));
+    in_flight_ = false;
+  }
+  result_event_.Notify();
+  if (callback != NULL) {
+    callback(callback_data);
+  }
+  return true;
+}
+
+}  // namespace ibus
+}  // namespace mozc
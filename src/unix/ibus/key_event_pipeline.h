@@ -0,0 +1,163 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef MOZC_UNIX_IBUS_KEY_EVENT_PIPELINE_H_
+#define MOZC_UNIX_IBUS_KEY_EVENT_PIPELINE_H_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "base/mutex.h"
+#include "base/port.h"
+#include "base/unnamed_event.h"
+#include "protocol/commands.pb.h"
+
+namespace mozc {
+
+namespace client {
+class ClientInterface;
+}  // namespace client
+
+namespace ibus {
+
+// Sends key events to the server on a worker thread so that the IBus main
+// loop is not blocked while the server is busy.  The results are returned in
+// the order the events are pushed.  Consecutive navigation keys, e.g. arrow
+// keys moving the focus in the candidate window, which are not sent yet are
+// coalesced into one SEND_KEYS round trip.
+//
+// Only the worker thread calls the client while events are pending, so the
+// owner has to wait for IsIdle() before calling the client by itself.  After
+// a result which needs the client on the owner side, e.g. with a callback or
+// a tool to launch, the worker stops until Resume() is called.
+class KeyEventPipeline {
+ public:
+  struct Event {
+    Event()
+        : keyval(0), keycode(0), modifiers(0), engine(NULL),
+          forward_only(false) {}
+
+    commands::KeyEvent key;
+    // The original IBus key event, to be forwarded if it is not consumed.
+    uint32 keyval;
+    uint32 keycode;
+    uint32 modifiers;
+    // Opaque pointer to the IBusEngine the event comes from.
+    void *engine;
+    // True if the event is not sent to the server, e.g. a key release.  Such
+    // an event is kept in the pipeline only to be forwarded in order.
+    bool forward_only;
+  };
+
+  struct Result {
+    Result() : succeeded(false) {}
+
+    // More than one event if they are coalesced.  The outputs of the sent
+    // events other than the last one are in |output.key_outputs()|, indexed
+    // among the sent events.
+    std::vector<Event> events;
+    commands::Context context;
+    commands::Output output;
+    bool succeeded;
+  };
+
+  // Called on the worker thread when a result gets available.
+  typedef void (*ResultCallback)(void *data);
+
+  // Does not take the ownership of |client|.
+  explicit KeyEventPipeline(client::ClientInterface *client);
+  ~KeyEventPipeline();
+
+  // Starts the worker thread.  The events pushed before are kept.
+  void Start();
+
+  void set_result_callback(ResultCallback callback, void *data);
+
+  // Queues |event| with |context|.
+  void Push(const Event &event, const commands::Context &context);
+
+  // Moves the oldest result to |result|.  Returns false if no result is
+  // available.
+  bool PopResult(Result *result);
+
+  // Blocks until a result is available or the pipeline gets idle.
+  void WaitForResult();
+
+  // Returns true if there is no event queued, in flight or waiting for
+  // PopResult().
+  bool IsIdle() const;
+
+  // Restarts the worker stopped after a result which needs the client.
+  void Resume();
+
+  // Returns true if the worker stops after |output| until Resume().
+  static bool NeedsClient(const commands::Output &output);
+
+  // Returns true if |key| can be coalesced with the adjacent navigation keys.
+  static bool IsNavigationKey(const commands::KeyEvent &key);
+
+ private:
+  class Worker;
+
+  // Returns true if |event| can be sent together with the events of |queued|.
+  static bool CanCoalesce(const Result &queued, const Event &event);
+
+  // Sends the oldest queued events.  Returns false if the worker should exit.
+  bool ProcessNext();
+
+  // The maximum number of navigation keys sent in one round trip.
+  static const size_t kMaxCoalescedKeys = 16;
+
+  client::ClientInterface *client_;
+  std::unique_ptr<Worker> worker_;
+  ResultCallback result_callback_;
+  void *result_callback_data_;
+
+  mutable Mutex mutex_;
+  // Events not sent yet.  The sent events coalesced into one entry have the
+  // same IBusEngine and are all navigation keys.
+  std::deque<std::unique_ptr<Result>> queued_;
+  std::deque<std::unique_ptr<Result>> completed_;
+  bool in_flight_;
+  bool paused_;
+  bool quit_;
+  // Notified when an event is queued, on resume and on quit.
+  UnnamedEvent request_event_;
+  // Notified when a result is completed.
+  UnnamedEvent result_event_;
+
+  DISALLOW_COPY_AND_ASSIGN(KeyEventPipeline);
+};
+
+}  // namespace ibus
+}  // namespace mozc
+
+#endif  // MOZC_UNIX_IBUS_KEY_EVENT_PIPELINE_H_
@@ -0,0 +1,197 @@
+// Copyright 2010-2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "unix/ibus/key_event_pipeline.h"
+
+#include <vector>
+
+#include "base/port.h"
+#include "client/client_mock.h"
+#include "protocol/commands.pb.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace ibus {
+namespace {
+
+KeyEventPipeline::Event SpecialKeyEvent(commands::KeyEvent::SpecialKey key) {
+  KeyEventPipeline::Event event;
+  event.key.set_special_key(key);
+  return event;
+}
+
+KeyEventPipeline::Event ForwardOnlyEvent() {
+  KeyEventPipeline::Event event;
+  event.forward_only = true;
+  return event;
+}
+
+KeyEventPipeline::Event KeyCodeEvent(char key_code) {
+  KeyEventPipeline::Event event;
+  event.key.set_key_code(key_code);
+  event.keyval = key_code;
+  return event;
+}
+
+// Pops the results until the pipeline gets idle or paused.
+void PopResults(KeyEventPipeline *pipeline,
+                std::vector<KeyEventPipeline::Result> *results) {
+  while (true) {
+    pipeline->WaitForResult();
+    KeyEventPipeline::Result result;
+    if (!pipeline->PopResult(&result)) {
+      return;
+    }
+    results->push_back(result);
+  }
+}
+
+class KeyEventPipelineTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    client_.SetBoolFunctionReturn("SendKeyWithContext", true);
+    client_.SetBoolFunctionReturn("SendKeysWithContext", true);
+    commands::Output output;
+    output.set_consumed(true);
+    client_.set_output_SendKeyWithContext(output);
+    client_.set_output_SendKeysWithContext(output);
+  }
+
+  client::ClientMock client_;
+};
+
+TEST_F(KeyEventPipelineTest, ResultsInOrder) {
+  KeyEventPipeline pipeline(&client_);
+  pipeline.Start();
+  pipeline.Push(KeyCodeEvent('a'), commands::Context());
+  pipeline.Push(KeyCodeEvent('b'), commands::Context());
+  pipeline.Push(KeyCodeEvent('c'), commands::Context());
+
+  std::vector<KeyEventPipeline::Result> results;
+  PopResults(&pipeline, &results);
+  EXPECT_TRUE(pipeline.IsIdle());
+  ASSERT_EQ(3, results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    ASSERT_EQ(1, results[i].events.size());
+    EXPECT_EQ('a' + i, results[i].events[0].keyval);
+    EXPECT_TRUE(results[i].succeeded);
+    EXPECT_TRUE(results[i].output.consumed());
+  }
+  EXPECT_EQ(3, client_.GetFunctionCallCount("SendKeyWithContext"));
+}
+
+TEST_F(KeyEventPipelineTest, CoalesceNavigationKeys) {
+  KeyEventPipeline pipeline(&client_);
+  // The events are queued before the worker starts.
+  pipeline.Push(SpecialKeyEvent(commands::KeyEvent::DOWN),
+                commands::Context());
+  // Releases between the navigation keys don't break the coalescing.
+  pipeline.Push(ForwardOnlyEvent(), commands::Context());
+  pipeline.Push(SpecialKeyEvent(commands::KeyEvent::DOWN),
+                commands::Context());
+  pipeline.Push(ForwardOnlyEvent(), commands::Context());
+  pipeline.Push(SpecialKeyEvent(commands::KeyEvent::RIGHT),
+                commands::Context());
+  pipeline.Push(KeyCodeEvent('a'), commands::Context());
+  pipeline.Push(SpecialKeyEvent(commands::KeyEvent::DOWN),
+                commands::Context());
+  KeyEventPipeline::Event shifted = SpecialKeyEvent(commands::KeyEvent::DOWN);
+  shifted.key.add_modifier_keys(commands::KeyEvent::SHIFT);
+  pipeline.Push(shifted, commands::Context());
+  pipeline.Start();
+
+  std::vector<KeyEventPipeline::Result> results;
+  PopResults(&pipeline, &results);
+  ASSERT_EQ(4, results.size());
+  ASSERT_EQ(5, results[0].events.size());
+  EXPECT_TRUE(results[0].events[1].forward_only);
+  EXPECT_TRUE(results[0].events[3].forward_only);
+  EXPECT_EQ(1, results[1].events.size());
+  EXPECT_EQ(1, results[2].events.size());
+  EXPECT_EQ(1, results[3].events.size());
+  EXPECT_EQ(1, client_.GetFunctionCallCount("SendKeysWithContext"));
+  EXPECT_EQ(3, client_.GetFunctionCallCount("SendKeyWithContext"));
+  ASSERT_EQ(3, client_.called_SendKeysWithContext().size());
+  EXPECT_EQ(commands::KeyEvent::RIGHT,
+            client_.called_SendKeysWithContext()[2].special_key());
+}
+
+TEST_F(KeyEventPipelineTest, ForwardOnly) {
+  KeyEventPipeline pipeline(&client_);
+  pipeline.Push(ForwardOnlyEvent(), commands::Context());
+  pipeline.Start();
+
+  std::vector<KeyEventPipeline::Result> results;
+  PopResults(&pipeline, &results);
+  ASSERT_EQ(1, results.size());
+  EXPECT_TRUE(results[0].succeeded);
+  EXPECT_EQ(0, client_.GetFunctionCallCount("SendKeyWithContext"));
+}
+
+TEST_F(KeyEventPipelineTest, PauseForClient) {
+  commands::Output output;
+  output.set_consumed(true);
+  output.mutable_callback()->mutable_session_command()->set_type(
+      commands::SessionCommand::UNDO);
+  client_.set_output_SendKeyWithContext(output);
+
+  KeyEventPipeline pipeline(&client_);
+  pipeline.Start();
+  pipeline.Push(KeyCodeEvent('a'), commands::Context());
+  pipeline.Push(KeyCodeEvent('b'), commands::Context());
+
+  // The worker stops after the result with the callback.
+  std::vector<KeyEventPipeline::Result> results;
+  PopResults(&pipeline, &results);
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ('a', results[0].events[0].keyval);
+  EXPECT_FALSE(pipeline.IsIdle());
+
+  pipeline.Resume();
+  PopResults(&pipeline, &results);
+  ASSERT_EQ(2, results.size());
+  EXPECT_EQ('b', results[1].events[0].keyval);
+}
+
+TEST_F(KeyEventPipelineTest, SendKeyFailure) {
+  client_.SetBoolFunctionReturn("SendKeyWithContext", false);
+  KeyEventPipeline pipeline(&client_);
+  pipeline.Start();
+  pipeline.Push(KeyCodeEvent('a'), commands::Context());
+
+  std::vector<KeyEventPipeline::Result> results;
+  PopResults(&pipeline, &results);
+  ASSERT_EQ(1, results.size());
+  EXPECT_FALSE(results[0].succeeded);
+}
+
+}  // namespace
+}  // namespace ibus
+}  // namespace mozc
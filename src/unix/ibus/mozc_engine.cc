@@ -54,6 +54,7 @@
 #include "unix/ibus/engine_registrar.h"
 #include "unix/ibus/ibus_candidate_window_handler.h"
 #include "unix/ibus/key_event_handler.h"
+#include "unix/ibus/key_event_pipeline.h"
 #include "unix/ibus/message_translator.h"
 #include "unix/ibus/mozc_engine_property.h"
 #include "unix/ibus/path_util.h"
@@ -75,6 +76,10 @@ DEFINE_bool(use_mozc_renderer, true,
             "The engine tries to use mozc_renderer if available.");
 #endif  // ENABLE_GTK_RENDERER
 
+DEFINE_bool(ibus_async_key_event, false,
+            "Send key events to the server on a worker thread so that the "
+            "IBus main loop is not blocked by the server.");
+
 namespace {
 
 // The ID for candidates which are not associated with texts.
@@ -265,11 +270,23 @@ MozcEngine::MozcEngine()
   }
 #endif  // MOZC_ENABLE_X11_SELECTION_MONITOR
 
+  if (FLAGS_ibus_async_key_event) {
+    key_event_pipeline_.reset(new KeyEventPipeline(client_.get()));
+    key_event_pipeline_->set_result_callback(&NotifyKeyEventResult, this);
+    key_event_pipeline_->Start();
+  }
+
   // TODO(yusukes): write a unit test to check if the capability is set
   // as expected.
 }
 
 MozcEngine::~MozcEngine() {
+  if (key_event_pipeline_.get() != NULL) {
+    // Stops the worker first so that no callback is added after this.
+    key_event_pipeline_.reset();
+    while (g_source_remove_by_user_data(this)) {
+    }
+  }
   SyncData(true);
 }
 
@@ -285,6 +302,7 @@ void MozcEngine::CandidateClicked(
   if (id == kBadCandidateId) {
     return;
   }
+  FlushKeyEvents();
   commands::Output output;
   commands::SessionCommand command;
   command.set_type(commands::SessionCommand::SELECT_CANDIDATE);
@@ -302,12 +320,14 @@ void MozcEngine::CursorUp(IBusEngine *engine) {
 }
 
 void MozcEngine::Disable(IBusEngine *engine) {
+  FlushKeyEvents();
   RevertSession(engine);
   GetCandidateWindowHandler(engine)->Hide(engine);
   key_event_handler_->Clear();
 }
 
 void MozcEngine::Enable(IBusEngine *engine) {
+  FlushKeyEvents();
   // Launch mozc_server
   client_->EnsureConnection();
   UpdatePreeditMethod();
@@ -324,11 +344,13 @@ void MozcEngine::Enable(IBusEngine *engine) {
 }
 
 void MozcEngine::FocusIn(IBusEngine *engine) {
+  FlushKeyEvents();
   property_handler_->Register(engine);
   UpdatePreeditMethod();
 }
 
 void MozcEngine::FocusOut(IBusEngine *engine) {
+  FlushKeyEvents();
   GetCandidateWindowHandler(engine)->Hide(engine);
   property_handler_->ResetContentType(engine);
 
@@ -373,17 +395,22 @@ gboolean MozcEngine::ProcessKeyEvent(
   if (!key_event_handler_->GetKeyEvent(
           keyval, keycode, modifiers, preedit_method_, layout_is_jp, &key)) {
     // Doesn't send a key event to mozc_server.
-    return FALSE;
+    return MaybeQueueForwardOnlyEvent(engine, keyval, keycode, modifiers);
   }
 
   VLOG(2) << key.DebugString();
-  if (!property_handler_->IsActivated() &&
-      !config::ImeSwitchUtil::IsDirectModeCommand(key)) {
-    return FALSE;
-  }
+  // While key events are in the pipeline, the server is ahead of
+  // |property_handler_|, e.g. a queued key may turn on the IME.  The
+  // activation is left to the server then.
+  if (key_event_pipeline_.get() == NULL || key_event_pipeline_->IsIdle()) {
+    if (!property_handler_->IsActivated() &&
+        !config::ImeSwitchUtil::IsDirectModeCommand(key)) {
+      return FALSE;
+    }
 
-  key.set_activated(property_handler_->IsActivated());
-  key.set_mode(property_handler_->GetOriginalCompositionMode());
+    key.set_activated(property_handler_->IsActivated());
+    key.set_mode(property_handler_->GetOriginalCompositionMode());
+  }
 
   commands::Context context;
   SurroundingTextInfo surrounding_text_info;
@@ -395,6 +422,20 @@ gboolean MozcEngine::ProcessKeyEvent(
     context.set_preceding_text(surrounding_text_info.preceding_text);
     context.set_following_text(surrounding_text_info.following_text);
   }
+
+  if (key_event_pipeline_.get() != NULL) {
+    KeyEventPipeline::Event event;
+    event.key.Swap(&key);
+    event.keyval = keyval;
+    event.keycode = keycode;
+    event.modifiers = modifiers;
+    event.engine = engine;
+    key_event_pipeline_->Push(event, context);
+    // The key is forwarded to the application later if the server doesn't
+    // consume it.
+    return TRUE;
+  }
+
   commands::Output output;
   if (!client_->SendKeyWithContext(key, context, &output)) {
     LOG(ERROR) << "SendKey failed";
@@ -412,6 +453,7 @@ gboolean MozcEngine::ProcessKeyEvent(
 void MozcEngine::PropertyActivate(IBusEngine *engine,
                                   const gchar *property_name,
                                   guint property_state) {
+  FlushKeyEvents();
   property_handler_->ProcessPropertyActivate(engine, property_name,
                                              property_state);
 }
@@ -427,6 +469,7 @@ void MozcEngine::PropertyShow(IBusEngine *engine,
 }
 
 void MozcEngine::Reset(IBusEngine *engine) {
+  FlushKeyEvents();
   RevertSession(engine);
 }
 
@@ -446,6 +489,7 @@ void MozcEngine::SetCursorLocation(IBusEngine *engine,
 void MozcEngine::SetContentType(IBusEngine *engine,
                                 guint purpose,
                                 guint hints) {
+  FlushKeyEvents();
   const bool prev_disabled =
       property_handler_->IsDisabled();
   property_handler_->UpdateContentType(engine);
@@ -757,6 +801,100 @@ bool MozcEngine::ExecuteCallback(IBusEngine *engine,
   return true;
 }
 
+bool MozcEngine::MaybeQueueForwardOnlyEvent(IBusEngine *engine, guint keyval,
+                                            guint keycode, guint modifiers) {
+  if (key_event_pipeline_.get() == NULL || key_event_pipeline_->IsIdle()) {
+    return false;
+  }
+  KeyEventPipeline::Event event;
+  event.keyval = keyval;
+  event.keycode = keycode;
+  event.modifiers = modifiers;
+  event.engine = engine;
+  event.forward_only = true;
+  key_event_pipeline_->Push(event, commands::Context::default_instance());
+  return true;
+}
+
+void MozcEngine::ApplyKeyEventResults() {
+  if (key_event_pipeline_.get() == NULL) {
+    return;
+  }
+  KeyEventPipeline::Result result;
+  while (key_event_pipeline_->PopResult(&result)) {
+    int num_sent_events = 0;
+    for (size_t i = 0; i < result.events.size(); ++i) {
+      if (!result.events[i].forward_only) {
+        ++num_sent_events;
+      }
+    }
+
+    int sent_index = 0;
+    int key_output_index = 0;
+    for (size_t i = 0; i < result.events.size(); ++i) {
+      const KeyEventPipeline::Event &event = result.events[i];
+      IBusEngine *engine = static_cast<IBusEngine *>(event.engine);
+      bool consumed = false;
+      if (!event.forward_only && result.succeeded) {
+        // The output of a coalesced key is omitted when the key doesn't need
+        // handling, e.g. it moves the focus and the last output covers it.
+        const commands::Output *output = NULL;
+        if (sent_index == num_sent_events - 1) {
+          output = &result.output;
+        } else if (key_output_index < result.output.key_outputs_size() &&
+                   result.output.key_outputs(key_output_index).index() ==
+                   sent_index) {
+          output = &result.output.key_outputs(key_output_index).output();
+          ++key_output_index;
+        }
+        if (output == NULL) {
+          consumed = true;
+        } else {
+          VLOG(2) << output->DebugString();
+          UpdateAll(engine, *output);
+          consumed = output->consumed();
+        }
+      }
+      if (!event.forward_only) {
+        ++sent_index;
+      }
+      if (!consumed) {
+        ibus_engine_forward_key_event(engine, event.keyval, event.keycode,
+                                      event.modifiers);
+      }
+    }
+
+    if (result.succeeded && KeyEventPipeline::NeedsClient(result.output)) {
+      key_event_pipeline_->Resume();
+    }
+  }
+}
+
+void MozcEngine::FlushKeyEvents() {
+  if (key_event_pipeline_.get() == NULL) {
+    return;
+  }
+  while (true) {
+    ApplyKeyEventResults();
+    if (key_event_pipeline_->IsIdle()) {
+      return;
+    }
+    key_event_pipeline_->WaitForResult();
+  }
+}
+
+// static
+void MozcEngine::NotifyKeyEventResult(void *data) {
+  // g_idle_add() can be called from any thread.
+  g_idle_add(&MozcEngine::ApplyKeyEventResultsCallback, data);
+}
+
+// static
+gboolean MozcEngine::ApplyKeyEventResultsCallback(gpointer data) {
+  static_cast<MozcEngine *>(data)->ApplyKeyEventResults();
+  return FALSE;
+}
+
 CandidateWindowHandlerInterface *MozcEngine::GetCandidateWindowHandler(
     IBusEngine *engine) {
 #ifndef ENABLE_GTK_RENDERER
@@ -49,6 +49,7 @@ namespace ibus {
 
 class CandidateWindowHandlerInterface;
 class KeyEventHandler;
+class KeyEventPipeline;
 class LaunchToolTest;
 class MessageTranslatorInterface;
 class PreeditHandlerInterface;
@@ -158,9 +159,25 @@ class MozcEngine : public EngineInterface {
   CandidateWindowHandlerInterface *GetCandidateWindowHandler(
       IBusEngine *engine);
 
+  // Queues a key event which is not sent to the server, so that it is
+  // forwarded after the key events in the pipeline.  Returns false if the
+  // pipeline is idle and the event can be passed through right away.
+  bool MaybeQueueForwardOnlyEvent(IBusEngine *engine, guint keyval,
+                                  guint keycode, guint modifiers);
+  // Reflects the results of the asynchronous key events in order.
+  void ApplyKeyEventResults();
+  // Waits for all the key events in the pipeline and reflects their results.
+  // Called before the other requests to the server.
+  void FlushKeyEvents();
+  // Called on the worker thread of |key_event_pipeline_|.
+  static void NotifyKeyEventResult(void *data);
+  static gboolean ApplyKeyEventResultsCallback(gpointer data);
+
   uint64 last_sync_time_;
   std::unique_ptr<KeyEventHandler> key_event_handler_;
   std::unique_ptr<client::ClientInterface> client_;
+  // Sends key events asynchronously.  NULL unless --ibus_async_key_event.
+  std::unique_ptr<KeyEventPipeline> key_event_pipeline_;
 #ifdef MOZC_ENABLE_X11_SELECTION_MONITOR
   std::unique_ptr<SelectionMonitorInterface> selection_monitor_;
 #endif  // MOZC_ENABLE_X11_SELECTION_MONITOR